@@ -0,0 +1,121 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "common/Log.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/operations.hpp"
+
+#include "Tools/Testing/BenchmarkReport.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace Tools {
+namespace Testing {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  std::string json_escape(const std::string& str)
+  {
+    std::string result;
+    result.reserve(str.size());
+    for(std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+    {
+      if(*it == '"' || *it == '\\')
+        result.push_back('\\');
+      result.push_back(*it);
+    }
+    return result;
+  }
+
+  /// Rate per second, or zero if the time was too short to measure
+  Real rate(const Real amount, const Real seconds)
+  {
+    return seconds > 0. ? amount / seconds : 0.;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BenchmarkReport& BenchmarkReport::instance()
+{
+  static BenchmarkReport report;
+  return report;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkReport::add(const std::string& name, const Real seconds, const boost::uint64_t nb_items, const std::string& item_unit, const boost::uint64_t nb_bytes)
+{
+  Entry entry;
+  entry.name = name;
+  entry.seconds = seconds;
+  entry.nb_items = nb_items;
+  entry.item_unit = item_unit;
+  entry.nb_bytes = nb_bytes;
+
+  if(PE::Comm::instance().is_active())
+  {
+    PE::Comm::instance().all_reduce(PE::max(), &seconds, 1, &entry.seconds);
+    PE::Comm::instance().all_reduce(PE::plus(), &nb_items, 1, &entry.nb_items);
+    PE::Comm::instance().all_reduce(PE::plus(), &nb_bytes, 1, &entry.nb_bytes);
+  }
+
+  CFinfo << "benchmark " << entry.name << ": " << entry.seconds << " s, "
+         << detail::rate(static_cast<Real>(entry.nb_items), entry.seconds) << " " << entry.item_unit << "/s";
+  if(entry.nb_bytes != 0)
+    CFinfo << ", " << detail::rate(static_cast<Real>(entry.nb_bytes), entry.seconds) * 1e-9 << " GB/s";
+  CFinfo << CFendl;
+
+  m_entries.push_back(entry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BenchmarkReport::write_json(const std::string& filename) const
+{
+  if(PE::Comm::instance().is_active() && PE::Comm::instance().rank() != 0)
+    return;
+
+  std::ofstream file(filename.c_str());
+  if(!file)
+  {
+    CFerror << "Could not open benchmark report file " << filename << CFendl;
+    return;
+  }
+
+  const Uint nb_procs = PE::Comm::instance().is_active() ? PE::Comm::instance().size() : 1;
+
+  file << std::setprecision(10);
+  file << "{\n\"nb_procs\":" << nb_procs << ",\n\"kernels\":[\n";
+  for(Uint i = 0; i != m_entries.size(); ++i)
+  {
+    const Entry& entry = m_entries[i];
+    file << "{\"name\":\"" << detail::json_escape(entry.name) << "\","
+         << "\"time\":" << entry.seconds << ","
+         << "\"items\":" << entry.nb_items << ","
+         << "\"unit\":\"" << detail::json_escape(entry.item_unit) << "\","
+         << "\"items_per_second\":" << detail::rate(static_cast<Real>(entry.nb_items), entry.seconds) << ","
+         << "\"bytes\":" << entry.nb_bytes << ","
+         << "\"gb_per_second\":" << detail::rate(static_cast<Real>(entry.nb_bytes), entry.seconds) * 1e-9 << "}"
+         << (i+1 == m_entries.size() ? "\n" : ",\n");
+  }
+  file << "]\n}\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Testing
+} // Tools
+} // cf3
@@ -0,0 +1,70 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Tools_Testing_BenchmarkReport_hpp
+#define cf3_Tools_Testing_BenchmarkReport_hpp
+
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "common/CF.hpp"
+
+#include "Tools/Testing/LibTesting.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace Tools {
+namespace Testing {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Collects the throughput of benchmarked kernels and writes it as JSON,
+/// so performance can be tracked by scripts across builds and machines.
+/// In parallel, add() must be called on all ranks: the item and byte counts are
+/// summed over the ranks and the time is the slowest rank's time.
+class Testing_API BenchmarkReport
+{
+public:
+
+  /// A single timed kernel
+  struct Entry
+  {
+    std::string name;
+    Real seconds;
+    boost::uint64_t nb_items;
+    std::string item_unit;
+    boost::uint64_t nb_bytes;
+  };
+
+  static BenchmarkReport& instance();
+
+  /// Record a kernel that processed nb_items items (e.g. elements) and moved nb_bytes bytes in the given time.
+  /// The counts are 64 bit, since their sums over the ranks easily overflow 32 bit types.
+  void add(const std::string& name, const Real seconds, const boost::uint64_t nb_items, const std::string& item_unit, const boost::uint64_t nb_bytes = 0);
+
+  /// Write all entries to the given file. Only rank 0 writes.
+  void write_json(const std::string& filename) const;
+
+  const std::vector<Entry>& entries() const { return m_entries; }
+
+private:
+  BenchmarkReport() {}
+
+  std::vector<Entry> m_entries;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // Testing
+} // Tools
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_Tools_Testing_BenchmarkReport_hpp
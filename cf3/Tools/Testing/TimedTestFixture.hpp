@@ -47,6 +47,12 @@ public:
     m_timer.restart();
   };
 
+  /// Seconds elapsed since the start of the test or the last restart_timer()
+  Real elapsed() const
+  {
+    return m_timer.elapsed();
+  }
+
   /// Stop timing when a test ends
   void test_unit_finish( boost::unit_test::test_unit const& unit ) {
     // TODO: Provide more generic support for output in CDash format
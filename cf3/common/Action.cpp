@@ -12,6 +12,7 @@
 #include "common/OptionList.hpp"
 #include "common/Action.hpp"
 #include "common/FindComponents.hpp"
+#include "common/TraceRecorder.hpp"
 
 #include "common/LibCommon.hpp"
 
@@ -20,7 +21,8 @@ namespace common {
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-Action::Action ( const std::string& name ) : Component(name)
+Action::Action ( const std::string& name ) : Component(name),
+  m_trace_name_id(0)
 {
   // signals
 
@@ -42,9 +44,21 @@ Action& Action::create_action(const std::string& action_provider,
 
 void Action::signal_execute ( common::SignalArgs& node )
 {
+  TraceScope trace(trace_name_id());
   this->execute();
 }
 
+
+Uint Action::trace_name_id()
+{
+  if(m_trace_name != name())
+  {
+    m_trace_name = name();
+    m_trace_name_id = TraceRecorder::instance().intern(m_trace_name);
+  }
+  return m_trace_name_id;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 
 } // common
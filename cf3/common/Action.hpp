@@ -44,6 +44,16 @@ public: // functions
 
   //@} END SIGNALS
 
+  /// Index of the name of this action in the TraceRecorder. The name is only looked up again after a rename.
+  Uint trace_name_id();
+
+private:
+
+  /// Name for which m_trace_name_id was obtained
+  std::string m_trace_name;
+
+  /// Cached result of trace_name_id()
+  Uint m_trace_name_id;
 };
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,7 @@
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 #include "common/Signal.hpp"
+#include "common/TraceRecorder.hpp"
 #include "common/URI.hpp"
 
 #include "common/XML/Protocol.hpp"
@@ -40,6 +41,9 @@ ActionDirector::ActionDirector(const std::string& name): Action(name)
 
 void ActionDirector::execute()
 {
+  // Building the debug messages is expensive, so only do it if they are shown
+  const bool log_debug = Logger::instance().getStream(DEBUG).is_active();
+
   BOOST_FOREACH(Component& child, *this)
   {
     Handle<Action> action(follow_link(child));
@@ -47,10 +51,12 @@ void ActionDirector::execute()
     const bool disabled = is_not_null(action) ? is_disabled(action->name()) : true;
     if(!disabled)
     {
-      CFdebug << name() << ": Executing action " << action->uri().path() << CFendl;
+      if(log_debug)
+        CFdebug << name() << ": Executing action " << action->uri().path() << CFendl;
+      TraceScope trace(action->trace_name_id());
       action->execute();
     }
-    else
+    else if(log_debug)
     {
       if(is_not_null(action))
         CFdebug << name() << ": Skipping disabled action " << action->uri().path() << CFendl;
@@ -32,6 +32,7 @@
 #include "common/PropertyList.hpp"
 #include "common/ComponentIterator.hpp"
 #include "common/TimedComponent.hpp"
+#include "common/TreeJournal.hpp"
 #include "common/UUCount.hpp"
 
 
@@ -234,6 +235,8 @@ void Component::rename ( const std::string& name )
     m_parent->m_component_lookup[name] = idx;
   }
 
+  TreeJournal::instance().record(TreeJournal::RENAMED, *this, name);
+
   m_name = name;
 }
 
@@ -301,6 +304,8 @@ Component& Component::add_component ( const boost::shared_ptr<Component>& subcom
 
   subcomp->m_parent = this;
 
+  TreeJournal::instance().record(TreeJournal::ADDED, *subcomp);
+
   raise_tree_updated_event();
 
   return *subcomp;
@@ -360,6 +365,8 @@ boost::shared_ptr<Component> Component::remove_component ( const std::string& na
     if(comp->has_tag(Tags::static_component()))
       throw BadValue(FromHere(), "Error removing component " + comp->uri().string() + ", it is static!");
 
+    TreeJournal::instance().record(TreeJournal::REMOVED, *comp);
+
     m_component_lookup.erase(itr);               // remove it from the lookup
 
     comp->change_parent( Handle<Component>() );                   // set parent to invalid
@@ -674,7 +681,7 @@ void Component::signal_print_info ( SignalArgs& args  ) const
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void Component::write_xml_tree( XmlNode& node, bool put_all_content ) const
+void Component::write_xml_tree( XmlNode& node, bool put_all_content, Uint depth ) const
 {
   cf3_assert( node.is_valid() );
 
@@ -712,9 +719,18 @@ void Component::write_xml_tree( XmlNode& node, bool put_all_content ) const
         signal_list_options( sf );
       }
 
-      boost_foreach( const Component& c, *this )
+      if( depth == 1 )
+      {
+        // the children are listed on demand
+        if( begin() != end() )
+          this_node.set_attribute( "expandable", "true" );
+      }
+      else
       {
-        c.write_xml_tree( this_node, put_all_content );
+        boost_foreach( const Component& c, *this )
+        {
+          c.write_xml_tree( this_node, put_all_content, depth == 0 ? 0 : depth - 1 );
+        }
       }
     }
   }
@@ -724,9 +740,61 @@ void Component::write_xml_tree( XmlNode& node, bool put_all_content ) const
 
 void Component::signal_list_tree( SignalArgs& args ) const
 {
+  SignalOptions options( args );
+  const Uint version = options.check("version") ? options.value<Uint>("version") : 0u;
+  const Uint depth = options.check("depth") ? options.value<Uint>("depth") : 0u;
+
+  TreeJournal& journal = TreeJournal::instance();
+  Uint reply_version = journal.version();
+  std::vector<TreeJournal::Change> changes;
+
   SignalFrame reply = args.create_reply( uri() );
 
-  write_xml_tree(reply.main_map.content, false);
+  if( version != 0 && journal.changes_since(version, changes) )
+  {
+    // only the changes since the version known by the requester
+    XmlNode changes_node = reply.main_map.content.add_node( "changes" );
+    const std::string path_prefix = uri().path() == "/" ? "/" : uri().path() + "/";
+
+    reply_version = version;
+    for( Uint i = 0 ; i != changes.size() ; ++i )
+    {
+      const TreeJournal::Change& change = changes[i];
+      reply_version = change.version;
+
+      if( change.path.path().compare(0, path_prefix.size(), path_prefix) != 0 )
+        continue;
+
+      XmlNode change_node = changes_node.add_node( "change" );
+      change_node.set_attribute( "type", TreeJournal::type_to_str(change.type) );
+      change_node.set_attribute( "path", change.path.string() );
+      if( change.type == TreeJournal::RENAMED )
+        change_node.set_attribute( "name", change.new_name );
+
+      // the current state of added and modified components, if they still exist
+      if( change.type != TreeJournal::ADDED && change.type != TreeJournal::MODIFIED )
+        continue;
+
+      const URI current_path = TreeJournal::path_after(changes, i);
+      if( current_path.empty() )
+        continue;
+
+      Handle<Component const> component = access_component(current_path);
+      if( is_null(component) )
+        continue;
+
+      if( change.type == TreeJournal::MODIFIED )
+        component->write_xml_tree( change_node, false, 1 );
+      else
+        component->write_xml_tree( change_node, false, depth );
+    }
+  }
+  else
+  {
+    write_xml_tree(reply.main_map.content, false, depth);
+  }
+
+  reply.set_option( "version", class_name<Uint>(), to_str(reply_version) );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -951,6 +1019,8 @@ void Component::signal_configure ( SignalArgs& args )
    }
  }
 
+ TreeJournal::instance().record(TreeJournal::MODIFIED, *this);
+
  // add a reply frame
  SignalFrame reply = args.create_reply( uri() );
  Map map_node = reply.map( Protocol::Tags::key_options() ).main_map;
@@ -1036,6 +1106,7 @@ void Component::raise_tree_updated_event ()
 Component& Component::mark_basic()
 {
   add_tag("basic");
+  TreeJournal::instance().record(TreeJournal::MODIFIED, *this);
   raise_tree_updated_event();
   return *this;
 }
@@ -311,6 +311,9 @@ public: // functions
   void signal_move_component ( SignalArgs& args );
 
   /// lists the sub components and puts them on the xml_tree
+  /// With option "version", only the changes to the tree since that version are
+  /// listed, if they are still known (see TreeJournal). Option "depth" limits
+  /// the number of listed levels. The reply gives the listed "version".
   void signal_list_tree( SignalArgs& args ) const;
 
   ///  prints tree recursively
@@ -410,7 +413,10 @@ private: // helper functions
   /// @param node            xml node to write
   /// @param put_all_content If @c false, options and properties are not put
   /// in the node.
-  void write_xml_tree( XML::XmlNode& node, bool put_all_content ) const;
+  /// @param depth           Number of levels to write, this component included.
+  /// Components whose children are left out get the attribute "expandable".
+  /// If 0, the whole tree is written.
+  void write_xml_tree( XML::XmlNode& node, bool put_all_content, Uint depth = 0 ) const;
 
   /// Triggered when the "ping" event is raised. Useful to find out what components still exist
   void on_ping_event( SignalArgs& args );
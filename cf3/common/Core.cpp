@@ -15,6 +15,7 @@
 #include "common/OSystemLayer.hpp"
 #include "common/NetworkInfo.hpp"
 #include "common/EventHandler.hpp"
+#include "common/TreeJournal.hpp"
 #include "common/OSystem.hpp"
 #include "common/Group.hpp"
 #include "common/Libraries.hpp"
@@ -56,6 +57,7 @@ Core::Core()
   OSystem::instance().layer()->platform_name();
   PE::Comm::instance();
   EventHandler::instance();
+  TreeJournal::instance();
 
   // create singleton objects inside core
   m_build_info.reset    ( new BuildInfo()    );
@@ -74,6 +76,7 @@ Core::Core()
   m_factories   = allocate_component<Factories>("Factories");
 
   m_root = allocate_component<Group>( "Root" );
+  TreeJournal::instance().set_root(*m_root);
   m_root->mark_basic();
   m_root->add_component(m_environment);
   m_root->add_component(m_libraries);
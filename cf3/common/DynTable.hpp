@@ -9,6 +9,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <deque>
 #include "common/BasicExceptions.hpp"
 #include "common/Component.hpp"
@@ -129,6 +130,8 @@ std::ostream& operator<<(std::ostream& os, const DynTable<std::string>& table);
 ////////////////////////////////////////////////////////////////////////////////
 
 
+/// Buffer to add and remove rows of a DynTable, working like ArrayBufferT.
+/// When the buffers are flushed, their rows are swapped into the table instead of copied.
 template <typename T>
 class DynArrayBufferT
 {
@@ -162,7 +165,11 @@ public:
 
   DynArrayBufferT(Array_t& array, const size_t nb_rows) :
     m_array(array),
-    m_buffersize(nb_rows)
+    m_buffersize(nb_rows),
+    m_nb_buffer_rows(0),
+    m_nb_new_buffer_rows(0),
+    m_reserved_begin(0),
+    m_reserved_end(0)
   {}
 
   ~DynArrayBufferT()
@@ -172,14 +179,13 @@ public:
 
   void reset()
   {
-    m_buffers.resize(0);
-    m_new_buffer_rows.clear();
-//    Uint idx = m_array.size();
-//    BOOST_FOREACH(Buffer& buffer, m_buffers)
-//    {
-//       buffer.reset();
-//       m_new_buffer_rows.push_back(idx++);
-//    }
+    m_buffers.clear();
+    m_buffer_starts.clear();
+    m_nb_buffer_rows = 0;
+    m_nb_new_buffer_rows = 0;
+    m_reserved_begin = 0;
+    m_reserved_end = 0;
+    m_is_reserved_row_filled.clear();
 
     m_empty_array_rows.clear();
     m_empty_buffer_rows.clear();
@@ -220,7 +226,7 @@ public:
             str += to_str(m_buffers[b].rows[i][j]) + " ";
           str += ")\n";
         }
-        else if( std::find(m_new_buffer_rows.begin(),m_new_buffer_rows.end(),s) != m_new_buffer_rows.end())
+        else if( b+1 == m_buffers.size() && i >= m_buffers[b].size()-m_nb_new_buffer_rows )
         {
           str += "\n";
         }
@@ -237,102 +243,151 @@ public:
   }
 
 
+  /// Reserve rows at the end of the table, that are filled by the next calls to add_row()
+  /// without passing through a buffer. Rows added or removed before keep their index,
+  /// and reserved rows that are not filled are removed again by the next flush().
+  /// @see ArrayBufferT::reserve()
+  void reserve(const Uint nb_rows)
+  {
+    if (nb_rows == 0)
+      return;
+
+    release_reserved_rows();
+
+    if (!m_buffers.empty() && (!m_empty_array_rows.empty() || !m_empty_buffer_rows.empty()))
+    {
+      // Flushing the pending removals would renumber the rows, so the rows go to one new buffer instead.
+      // The unused rows of the last buffer are given up.
+      if (nb_rows > m_nb_new_buffer_rows)
+      {
+        for (Uint buffer_row=m_nb_buffer_rows-m_nb_new_buffer_rows; buffer_row<m_nb_buffer_rows; ++buffer_row)
+          m_empty_buffer_rows.push_back(m_array.size()+buffer_row);
+        m_nb_new_buffer_rows = 0;
+        add_buffer(nb_rows);
+      }
+      return;
+    }
+
+    // Rows that are only added are moved into the table in the same resize, and keep their index.
+    // Removed table rows stay pending until the next flush().
+    const Uint old_size = m_array.size();
+    const Uint nb_added_rows = m_nb_buffer_rows - m_nb_new_buffer_rows;
+    m_reserved_begin = old_size + nb_added_rows;
+    m_reserved_end = m_reserved_begin + nb_rows;
+    m_is_reserved_row_filled.assign(nb_rows,false);
+    m_array.resize(m_reserved_end);
+    Uint array_idx = old_size;
+    BOOST_FOREACH (Buffer& buffer, m_buffers)
+    {
+      for (Uint row_idx=0; row_idx<buffer.size() && array_idx<m_reserved_begin; ++row_idx)
+        m_array[array_idx++].swap(buffer.rows[row_idx]);
+    }
+    m_buffers.clear();
+    m_buffer_starts.clear();
+    m_nb_buffer_rows = 0;
+    m_nb_new_buffer_rows = 0;
+  }
+
   template <typename VectorT>
   Uint add_row(const VectorT& row)
   {
-    if (m_new_buffer_rows.empty())
-      add_buffer();
-    Uint idx = m_new_buffer_rows.front();
-    set_row(idx,row);
-    m_new_buffer_rows.pop_front();
-    return idx;
+    // reserved array rows are filled first, skipping the ones already filled by set_row()
+    while (m_reserved_begin != m_reserved_end && is_reserved_row_filled(m_reserved_begin))
+      ++m_reserved_begin;
+    if (m_reserved_begin != m_reserved_end)
+    {
+      std::vector<T>& array_row = m_array[m_reserved_begin];
+      array_row.resize(row.size());
+      for (Uint i=0; i<row.size(); ++i)
+        array_row[i] = row[i];
+      return m_reserved_begin++;
+    }
+
+    if (m_nb_new_buffer_rows == 0)
+      add_buffer(m_buffersize);
+    Buffer& buffer = m_buffers.back();
+    const Uint row_idx = buffer.size() - m_nb_new_buffer_rows;
+    --m_nb_new_buffer_rows;
+    buffer.rows[row_idx].resize(row.size());
+    for (Uint i=0; i<row.size(); ++i)
+      buffer.rows[row_idx][i] = row[i];
+    buffer.is_not_empty[row_idx] = true;
+    return m_array.size() + m_buffer_starts.back() + row_idx;
   }
 
   template<typename vectorType>
   void set_row(const Uint array_idx, const vectorType& row)
   {
-    Uint cummulative_size = m_array.size();
-    if (array_idx < cummulative_size)
+    if (array_idx < m_array.size())
     {
+      std::vector<T>& array_row = m_array[array_idx];
+      array_row.resize(row.size());
       for (Uint i=0; i<row.size(); ++i)
-        m_array[array_idx][i] = row[i];
-      m_empty_array_rows.erase(std::find(m_empty_array_rows.begin(),m_empty_array_rows.end(),array_idx));
-      return;
-    }
-    else
-    {
-      BOOST_FOREACH(Buffer& buffer, m_buffers)
+        array_row[i] = row[i];
+      if (is_reserved_row(array_idx))
       {
-        if (array_idx<cummulative_size+buffer.size())
-        {
-          buffer.rows[array_idx-cummulative_size].resize(row.size());
-          for (Uint i=0; i<row.size(); ++i)
-            buffer.rows[array_idx-cummulative_size][i]=row[i];
-          buffer.is_not_empty[array_idx-cummulative_size]=true;
-          return;
-        }
-        cummulative_size += buffer.size();
+        m_is_reserved_row_filled[reserved_row(array_idx)] = true;
+        return;
       }
+      std::deque<Uint>::iterator empty_row = std::find(m_empty_array_rows.begin(),m_empty_array_rows.end(),array_idx);
+      if (empty_row != m_empty_array_rows.end())
+        m_empty_array_rows.erase(empty_row);
+      return;
     }
-    throw common::BadValue(FromHere(),"Trying to access index that is not allocated");
+
+    const Uint b = buffer_of_row(array_idx);
+    std::vector<T>& buffer_row = m_buffers[b].rows[array_idx-m_array.size()-m_buffer_starts[b]];
+    buffer_row.resize(row.size());
+    for (Uint i=0; i<row.size(); ++i)
+      buffer_row[i]=row[i];
+    m_buffers[b].is_not_empty[array_idx-m_array.size()-m_buffer_starts[b]]=true;
   }
 
 
- void rm_row(const Uint array_idx)
+  void rm_row(const Uint array_idx)
   {
-   Uint cummulative_size = m_array.size();
-   if (array_idx < cummulative_size)
-   {
-     m_empty_array_rows.push_back(array_idx);
-     return;
-   }
-   else
-   {
-     m_empty_buffer_rows.push_back(array_idx);
-
-     BOOST_FOREACH(Buffer& buffer, m_buffers)
-     {
-       if (array_idx<cummulative_size+buffer.size())
-       {
-         buffer.is_not_empty[array_idx-cummulative_size]=false;
-         return;
-       }
-       cummulative_size += buffer.size();
-     }
-   }
-   throw common::BadValue(FromHere(),"Trying to access index that is not allocated");
+    if (array_idx < m_array.size())
+    {
+      if (is_reserved_row(array_idx))
+        m_is_reserved_row_filled[reserved_row(array_idx)] = false;
+      else
+        m_empty_array_rows.push_back(array_idx);
+      return;
+    }
+
+    const Uint b = buffer_of_row(array_idx);
+    m_empty_buffer_rows.push_back(array_idx);
+    m_buffers[b].is_not_empty[array_idx-m_array.size()-m_buffer_starts[b]]=false;
   }
 
   Row get_row(const Uint idx)
   {
-    Uint cummulative_size = m_array.size();
-    if (idx < cummulative_size)
-    {
+    if (idx < m_array.size())
       return m_array[idx];
-    }
-    else
-    {
-      BOOST_FOREACH(Buffer& buffer, m_buffers)
-      {
-        if (idx<cummulative_size+buffer.size())
-          return buffer.rows[idx-cummulative_size];
-        cummulative_size += buffer.size();
-      }
-    }
-    throw common::BadValue(FromHere(),"Trying to access index that is not allocated: ["+common::to_str(idx)+">="+common::to_str(cummulative_size)+"]");
-    return m_array[0];
+
+    const Uint b = buffer_of_row(idx);
+    return m_buffers[b].rows[idx-m_array.size()-m_buffer_starts[b]];
   }
 
 
   void flush()
   {
+    // reserved rows that were not filled are removed like empty array rows
+    release_reserved_rows();
+
+    // nothing was added or removed, so the table is left untouched
+    if (m_buffers.empty() && m_empty_array_rows.empty())
+    {
+      reset();
+      return;
+    }
 
     // get total number of allocated rows
     Uint allocated_size = total_allocated();
     Uint old_array_size = m_array.size();
 
     // get total number of empty rows
-    Uint nb_emptyRows = m_empty_array_rows.size() + m_empty_buffer_rows.size() + m_new_buffer_rows.size();
+    Uint nb_emptyRows = m_empty_array_rows.size() + m_empty_buffer_rows.size() + m_nb_new_buffer_rows;
     Uint new_size = allocated_size-nb_emptyRows;
 
     if (new_size > old_array_size)
@@ -350,17 +405,18 @@ public:
           if (buffer.is_not_empty[row_idx])   // for each non-empty row from all buffers
           {
             // first find empty rows inside the old part array
+            // the buffers are discarded afterwards, so rows are swapped instead of copied
             if (!m_empty_array_rows.empty())
             {
               Row empty_array_row = get_row(m_empty_array_rows.front());
               m_empty_array_rows.pop_front();
-              empty_array_row = row;
+              empty_array_row.swap(row);
             }
             else // then select the new array rows to be filled
             {
               cf3_assert(array_idx < m_array.size());
               Row empty_array_row=m_array[array_idx++];
-              empty_array_row = row;
+              empty_array_row.swap(row);
             }
           }
         }
@@ -379,7 +435,7 @@ public:
             Uint empty_array_row_idx = m_empty_array_rows.front();
             m_empty_array_rows.pop_front();
             Row empty_array_row = get_row(empty_array_row_idx);
-            empty_array_row = row;
+            empty_array_row.swap(row);
           }
         }
       }
@@ -388,6 +444,9 @@ public:
       // The empty rows from the allocated part must be swapped with filled
       // rows from the part that will be deallocated
       Uint nb_empty_rows = m_empty_array_rows.size();
+      std::vector<bool> is_empty(m_array.size(),false);
+      for (Uint e=0; e<nb_empty_rows; ++e)
+        is_empty[m_empty_array_rows[e]] = true;
       for (Uint e=0; e<nb_empty_rows; ++e)
       {
         Uint empty_row_idx = m_empty_array_rows[e];
@@ -398,7 +457,7 @@ public:
 
           // 1) find next full row
           cf3_assert(full_row_idx<m_array.size());
-          while(is_array_row_empty(full_row_idx))
+          while(is_empty[full_row_idx])
           {
             full_row_idx++;
             cf3_assert(full_row_idx<m_array.size());
@@ -406,13 +465,14 @@ public:
 
           // 2) swap them
           cf3_assert(empty_row_idx<m_array.size());
-          m_array[empty_row_idx] = m_array[full_row_idx];
+          m_array[empty_row_idx].swap(m_array[full_row_idx]);
           full_row_idx++;
         }
       }
 
-      // make m_array smaller
-      m_array.resize(new_size);
+      // make m_array smaller, unless the added rows exactly filled the removed ones
+      if (new_size != m_array.size())
+        m_array.resize(new_size);
     }
 
     // clear all buffers
@@ -422,23 +482,56 @@ public:
 
   Array_t& get_appointed() { return m_array; }
 
-  Uint total_allocated()
+  Uint total_allocated() const { return m_array.size() + m_nb_buffer_rows; }
+
+private:
+
+  void add_buffer(const Uint size)
   {
-    Uint allocated=m_array.size();
-    BOOST_FOREACH(const Buffer& buffer, m_buffers)
-      allocated += buffer.size();
-    return allocated;
+    cf3_assert(m_nb_new_buffer_rows == 0);
+    m_buffer_starts.push_back(m_nb_buffer_rows);
+    m_buffers.push_back(Buffer());
+    m_buffers.back().resize(size);
+    m_nb_buffer_rows += size;
+    m_nb_new_buffer_rows = size;
   }
 
-private:
+  /// Mark the reserved rows that were not filled as empty array rows, and end the reserved range
+  void release_reserved_rows()
+  {
+    for (Uint idx=m_reserved_begin; idx<m_reserved_end; ++idx)
+    {
+      if (!is_reserved_row_filled(idx))
+        m_empty_array_rows.push_back(idx);
+    }
+    m_reserved_begin = m_reserved_end;
+    m_is_reserved_row_filled.clear();
+  }
+
+  bool is_reserved_row(const Uint idx) const
+  {
+    return idx >= m_reserved_begin && idx < m_reserved_end;
+  }
+
+  /// @return the index of the reserved row idx in m_is_reserved_row_filled
+  Uint reserved_row(const Uint idx) const
+  {
+    return idx + m_is_reserved_row_filled.size() - m_reserved_end;
+  }
 
-  void add_buffer()
+  bool is_reserved_row_filled(const Uint idx) const
   {
-    Uint idx = total_allocated();
-    m_buffers.push_back(Buffer(m_buffersize));
-    for (Uint i=0; i<m_buffersize; ++i)
-      m_new_buffer_rows.push_back(idx++);
-    cf3_assert(total_allocated()==idx);
+    return m_is_reserved_row_filled[reserved_row(idx)];
+  }
+
+  /// @return the index in m_buffers of the buffer holding the row idx, which must be beyond the array
+  Uint buffer_of_row(const Uint idx) const
+  {
+    cf3_assert(idx >= m_array.size());
+    const Uint buffer_row = idx - m_array.size();
+    if (buffer_row >= m_nb_buffer_rows)
+      throw common::BadValue(FromHere(),"Trying to access index that is not allocated: ["+common::to_str(idx)+">="+common::to_str(total_allocated())+"]");
+    return std::upper_bound(m_buffer_starts.begin(),m_buffer_starts.end(),buffer_row) - m_buffer_starts.begin() - 1;
   }
 
   bool is_array_row_empty(const Uint row) const
@@ -455,11 +548,24 @@ private:
   /// @note it is safe to change in the middle of buffer operations
   Uint m_buffersize;
 
-  /// buffer storage;
-  std::deque< std::vector<T> > m_buffer;
+  /// temporary buffers, in a deque so existing buffers are not copied when one is added
+  std::deque<Buffer> m_buffers;
+
+  /// first row of each buffer, counted from the end of the array
+  std::vector<Uint> m_buffer_starts;
 
-  /// vector of temporary buffers
-  std::vector<Buffer> m_buffers;
+  /// total number of rows in all buffers
+  Uint m_nb_buffer_rows;
+
+  /// number of rows at the end of the last buffer where rows can be added
+  Uint m_nb_new_buffer_rows;
+
+  /// range of reserved array rows that are not filled yet
+  Uint m_reserved_begin;
+  Uint m_reserved_end;
+
+  /// rows of the last reserved range that were filled by set_row() before add_row() reached them
+  std::vector<bool> m_is_reserved_row_filled;
 
   /// storage of removed array rows
   std::deque<Uint> m_empty_array_rows;
@@ -470,9 +576,6 @@ private:
   /// storage of removed buffer rows
   std::deque<Uint> m_empty_buffer_rows;
 
-  /// storage of buffer rows where rows can be added
-  std::deque<Uint> m_new_buffer_rows;
-
 
 };
 
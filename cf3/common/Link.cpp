@@ -10,6 +10,7 @@
 #include "common/Builder.hpp"
 #include "common/Signal.hpp"
 #include "common/LibCommon.hpp"
+#include "common/TreeJournal.hpp"
 
 #include "common/XML/SignalOptions.hpp"
 
@@ -62,6 +63,7 @@ Link& Link::link_to ( Component& lnkto )
     throw SetupError(FromHere(), "Cannot link a Link to another Link");
 
   m_link_component = lnkto.handle();
+  TreeJournal::instance().record(TreeJournal::MODIFIED, *this);
   return *this;
 }
 
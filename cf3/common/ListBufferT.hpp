@@ -9,6 +9,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <deque>
 
 #include "common/Foreach.hpp"
@@ -32,6 +33,9 @@ namespace common {
 /// The table is resized when the buffer is full, and values are copied from
 /// the buffer into the table.
 ///
+/// Buffers are filled like a bump allocator, and reserve() allows to write
+/// straight into the array when the number of rows to add is known. @see ArrayBufferT
+///
 /// @note Before using the matching table or array one has to be sure that
 /// the buffer is flushed.
 /// @author Willem Deconinck
@@ -88,10 +92,17 @@ public: // functions
   /// Change the buffer to the new size
   void change_buffersize(const size_t nbRows);
 
+  /// Reserve rows at the end of the array, that are filled by the next calls to add_row()
+  /// without passing through a buffer. Rows added or removed before keep their index,
+  /// and reserved rows that are not filled are removed again by the next flush().
+  /// @see ArrayBufferT::reserve()
+  /// @param [in] nb_rows number of rows to add to the array
+  void reserve(const Uint nb_rows);
+
   /// flush the buffer in the connectivity Buffer
   void flush();
   //
-  /// Add a row to the buffer.
+  /// Add a row to the buffer, or to the array if rows were reserved.
   /// @param [in] val value to be added to buffer
   /// @return the index in the array+buffers
   Uint add_row(const value_type& val);
@@ -117,7 +128,7 @@ public: // functions
   Array_t& get_appointed() {return m_array;}
 
   /// @return total number of allocated rows, including all buffers and the array
-  Uint total_allocated();
+  Uint total_allocated() const { return m_array.size() + m_nb_buffer_rows; }
 
   /// @return the number of buffers that are created
   Uint buffers_count() const { return m_buffers.size(); }
@@ -152,14 +163,13 @@ public: // functions
 
   void reset()
   {
-    m_buffers.resize(0);
-    m_new_buffer_rows.clear();
-//    Uint idx = m_array.size();
-//    boost_foreach(Buffer& buffer, m_buffers)
-//    {
-//       buffer.reset();
-//       m_new_buffer_rows.push_back(idx++);
-//    }
+    m_buffers.clear();
+    m_buffer_starts.clear();
+    m_nb_buffer_rows = 0;
+    m_nb_new_buffer_rows = 0;
+    m_reserved_begin = 0;
+    m_reserved_end = 0;
+    m_is_reserved_row_filled.clear();
 
     m_new_array_rows.clear();
     m_empty_array_rows.clear();
@@ -170,8 +180,30 @@ public: // functions
 
 private: // functions
 
-  /// Create a new buffer, allocate it with m_buffersize, and fill m_new_buffer_rows with the new ones.
-  void add_buffer();
+  /// Create a new buffer with the given number of rows, and mark all its rows as new.
+  void add_buffer(const Uint size);
+
+  /// Mark the reserved rows that were not filled as empty array rows, and end the reserved range
+  void release_reserved_rows();
+
+  bool is_reserved_row(const Uint idx) const
+  {
+    return idx >= m_reserved_begin && idx < m_reserved_end;
+  }
+
+  /// @return the index of the reserved row idx in m_is_reserved_row_filled
+  Uint reserved_row(const Uint idx) const
+  {
+    return idx + m_is_reserved_row_filled.size() - m_reserved_end;
+  }
+
+  bool is_reserved_row_filled(const Uint idx) const
+  {
+    return m_is_reserved_row_filled[reserved_row(idx)];
+  }
+
+  /// @return the index in m_buffers of the buffer holding the row idx, which must be beyond the array
+  Uint buffer_of_row(const Uint idx) const;
 
   bool is_array_row_empty(const Uint row) const
   {
@@ -187,8 +219,24 @@ private: // data
   /// @note it is safe to change in the middle of buffer operations
   Uint m_buffersize;
 
-  /// vector of temporary buffers
-  std::vector<Buffer> m_buffers;
+  /// temporary buffers, in a deque so existing buffers are not copied when one is added
+  std::deque<Buffer> m_buffers;
+
+  /// first row of each buffer, counted from the end of the array
+  std::vector<Uint> m_buffer_starts;
+
+  /// total number of rows in all buffers
+  Uint m_nb_buffer_rows;
+
+  /// number of rows at the end of the last buffer where rows can be added
+  Uint m_nb_new_buffer_rows;
+
+  /// range of reserved array rows that are not filled yet
+  Uint m_reserved_begin;
+  Uint m_reserved_end;
+
+  /// rows of the last reserved range that were filled by set_row() before add_row() reached them
+  std::vector<bool> m_is_reserved_row_filled;
 
   /// storage of removed array rows
   std::deque<Uint> m_empty_array_rows;
@@ -199,9 +247,6 @@ private: // data
   /// storage of removed buffer rows
   std::deque<Uint> m_empty_buffer_rows;
 
-  /// storage of buffer rows where rows can be added
-  std::deque<Uint> m_new_buffer_rows;
-
 }; // ConnectivityTable
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -209,7 +254,11 @@ private: // data
 template<typename T>
 ListBufferT<T>::ListBufferT (typename ListBufferT<T>::Array_t& array, size_t nbRows) :
   m_array(array),
-  m_buffersize(nbRows)
+  m_buffersize(nbRows),
+  m_nb_buffer_rows(0),
+  m_nb_new_buffer_rows(0),
+  m_reserved_begin(0),
+  m_reserved_end(0)
 {
 }
 
@@ -225,12 +274,71 @@ ListBufferT<T>::~ListBufferT()
 ////////////////////////////////////////////////////////////////////////////////
 
 template<typename T>
-inline Uint ListBufferT<T>::total_allocated()
+inline Uint ListBufferT<T>::buffer_of_row(const Uint idx) const
+{
+  cf3_assert(idx >= m_array.size());
+  const Uint buffer_row = idx - m_array.size();
+  if (buffer_row >= m_nb_buffer_rows)
+    throw common::BadValue(FromHere(),"Trying to access index that is not allocated: ["+common::to_str(idx)+">="+common::to_str(total_allocated())+"]");
+  return std::upper_bound(m_buffer_starts.begin(),m_buffer_starts.end(),buffer_row) - m_buffer_starts.begin() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+inline void ListBufferT<T>::reserve(const Uint nb_rows)
+{
+  if (nb_rows == 0)
+    return;
+
+  release_reserved_rows();
+
+  if (!m_buffers.empty() && (!m_empty_array_rows.empty() || !m_empty_buffer_rows.empty()))
+  {
+    // Flushing the pending removals would renumber the rows, so the rows go to one new buffer instead.
+    // The unused rows of the last buffer are given up.
+    if (nb_rows > m_nb_new_buffer_rows)
+    {
+      for (Uint buffer_row=m_nb_buffer_rows-m_nb_new_buffer_rows; buffer_row<m_nb_buffer_rows; ++buffer_row)
+        m_empty_buffer_rows.push_back(m_array.size()+buffer_row);
+      m_nb_new_buffer_rows = 0;
+      add_buffer(nb_rows);
+    }
+    return;
+  }
+
+  // Rows that are only added are moved into the array in the same resize, and keep their index.
+  // Removed array rows stay pending until the next flush().
+  const Uint old_size = m_array.size();
+  const Uint nb_added_rows = m_nb_buffer_rows - m_nb_new_buffer_rows;
+  m_reserved_begin = old_size + nb_added_rows;
+  m_reserved_end = m_reserved_begin + nb_rows;
+  m_is_reserved_row_filled.assign(nb_rows,false);
+  m_array.resize(boost::extents[m_reserved_end]);
+  Uint array_idx = old_size;
+  boost_foreach (Buffer& buffer, m_buffers)
+  {
+    for (Uint row_idx=0; row_idx<buffer.size() && array_idx<m_reserved_begin; ++row_idx)
+      m_array[array_idx++] = buffer.rows[row_idx];
+  }
+  m_buffers.clear();
+  m_buffer_starts.clear();
+  m_nb_buffer_rows = 0;
+  m_nb_new_buffer_rows = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+inline void ListBufferT<T>::release_reserved_rows()
 {
-  Uint allocated=m_array.size();
-  BOOST_FOREACH(const Buffer& buffer, m_buffers)
-    allocated += buffer.size();
-  return allocated;
+  for (Uint idx=m_reserved_begin; idx<m_reserved_end; ++idx)
+  {
+    if (!is_reserved_row_filled(idx))
+      m_empty_array_rows.push_back(idx);
+  }
+  m_reserved_begin = m_reserved_end;
+  m_is_reserved_row_filled.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -238,13 +346,22 @@ inline Uint ListBufferT<T>::total_allocated()
 template<typename T>
 void ListBufferT<T>::flush()
 {
+  // reserved rows that were not filled are removed like empty array rows
+  release_reserved_rows();
+
+  // nothing was added or removed, so the array is left untouched
+  if (m_buffers.empty() && m_empty_array_rows.empty())
+  {
+    reset();
+    return;
+  }
 
   // get total number of allocated rows
   Uint allocated_size = total_allocated();
   Uint old_array_size = m_array.size();
 
   // get total number of empty rows
-  Uint nb_emptyRows = m_empty_array_rows.size() + m_empty_buffer_rows.size() + m_new_buffer_rows.size();
+  Uint nb_emptyRows = m_empty_array_rows.size() + m_empty_buffer_rows.size() + m_nb_new_buffer_rows;
   Uint new_size = allocated_size-nb_emptyRows;
   if (new_size >= old_array_size)
   {
@@ -299,6 +416,9 @@ void ListBufferT<T>::flush()
     // The empty rows from the allocated part must be swapped with filled
     // rows from the part that will be deallocated
     Uint nb_empty_rows = m_empty_array_rows.size();
+    std::vector<bool> is_empty(m_array.size(),false);
+    for (Uint e=0; e<nb_empty_rows; ++e)
+      is_empty[m_empty_array_rows[e]] = true;
     for (Uint e=0; e<nb_empty_rows; ++e)
     {
       Uint empty_row_idx = m_empty_array_rows[e];
@@ -309,7 +429,7 @@ void ListBufferT<T>::flush()
 
         // 1) find next full row
         cf3_assert(full_row_idx<m_array.size());
-        while(is_array_row_empty(full_row_idx))
+        while(is_empty[full_row_idx])
         {
           full_row_idx++;
           cf3_assert(full_row_idx<m_array.size());
@@ -323,8 +443,9 @@ void ListBufferT<T>::flush()
       }
     }
 
-    // make m_array smaller
-    m_array.resize(boost::extents[new_size]);
+    // make m_array smaller, unless the added rows exactly filled the removed ones
+    if (new_size != m_array.size())
+      m_array.resize(boost::extents[new_size]);
   }
 
   // clear all buffers
@@ -336,22 +457,11 @@ void ListBufferT<T>::flush()
 template<typename T>
 inline typename ListBufferT<T>::value_type& ListBufferT<T>::get_row(const Uint idx)
 {
-  Uint cummulative_size = m_array.size();
-  if (idx < cummulative_size)
-  {
+  if (idx < m_array.size())
     return m_array[idx];
-  }
-  else
-  {
-    BOOST_FOREACH(Buffer& buffer, m_buffers)
-    {
-      if (idx<cummulative_size+buffer.size())
-        return buffer.rows[idx-cummulative_size];
-      cummulative_size += buffer.size();
-    }
-  }
-  throw common::BadValue(FromHere(),"Trying to access index that is not allocated: ["+common::to_str(idx)+">="+common::to_str(cummulative_size)+"]");
-  return m_array[0];
+
+  const Uint b = buffer_of_row(idx);
+  return m_buffers[b].rows[idx-m_array.size()-m_buffer_starts[b]];
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -371,13 +481,14 @@ inline void ListBufferT<T>::increase_array_size(const size_t increase)
 //////////////////////////////////////////////////////////////////////
 
 template<typename T>
-inline void ListBufferT<T>::add_buffer()
+inline void ListBufferT<T>::add_buffer(const Uint size)
 {
-  Uint idx = total_allocated();
-  m_buffers.push_back(Buffer(m_buffersize));
-  for (Uint i=0; i<m_buffersize; ++i)
-    m_new_buffer_rows.push_back(idx++);
-  cf3_assert(total_allocated()==idx);
+  cf3_assert(m_nb_new_buffer_rows == 0);
+  m_buffer_starts.push_back(m_nb_buffer_rows);
+  m_buffers.push_back(Buffer());
+  m_buffers.back().resize(size);
+  m_nb_buffer_rows += size;
+  m_nb_new_buffer_rows = size;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -385,12 +496,23 @@ inline void ListBufferT<T>::add_buffer()
 template<typename T>
 inline Uint ListBufferT<T>::add_row(const value_type& row)
 {
-  if (m_new_buffer_rows.empty())
-    add_buffer(); // will make a whole lot of new new_buffer_rows
-  Uint idx = m_new_buffer_rows.front();
-  set_row(idx,row);
-  m_new_buffer_rows.pop_front();
-  return idx;
+  // reserved array rows are filled first, skipping the ones already filled by set_row()
+  while (m_reserved_begin != m_reserved_end && is_reserved_row_filled(m_reserved_begin))
+    ++m_reserved_begin;
+  if (m_reserved_begin != m_reserved_end)
+  {
+    m_array[m_reserved_begin] = row;
+    return m_reserved_begin++;
+  }
+
+  if (m_nb_new_buffer_rows == 0)
+    add_buffer(m_buffersize); // will make a whole lot of new buffer rows
+  Buffer& buffer = m_buffers.back();
+  const Uint row_idx = buffer.size() - m_nb_new_buffer_rows;
+  --m_nb_new_buffer_rows;
+  buffer.rows[row_idx] = row;
+  buffer.is_not_empty[row_idx] = true;
+  return m_array.size() + m_buffer_starts.back() + row_idx;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -410,27 +532,25 @@ inline Uint ListBufferT<T>::add_row_directly(const value_type& row)
 template<typename T>
 inline void ListBufferT<T>::set_row(const Uint array_idx, const value_type& row)
 {
-  Uint cummulative_size = m_array.size();
-  if (array_idx < cummulative_size)
+  if (array_idx < m_array.size())
   {
     m_array[array_idx] = row;
-    m_empty_array_rows.erase(std::find(m_empty_array_rows.begin(),m_empty_array_rows.end(),array_idx));
-    return;
-  }
-  else
-  {
-    BOOST_FOREACH(Buffer& buffer, m_buffers)
+    if (is_reserved_row(array_idx))
     {
-      if (array_idx<cummulative_size+buffer.size())
-      {
-        buffer.rows[array_idx-cummulative_size]=row;
-        buffer.is_not_empty[array_idx-cummulative_size]=true;
-        return;
-      }
-      cummulative_size += buffer.size();
+      m_is_reserved_row_filled[reserved_row(array_idx)] = true;
+      return;
     }
+    std::deque<Uint>::iterator empty_row = std::find(m_empty_array_rows.begin(),m_empty_array_rows.end(),array_idx);
+    if (empty_row != m_empty_array_rows.end())
+      m_empty_array_rows.erase(empty_row);
+    return;
   }
-  throw common::BadValue(FromHere(),"Trying to access index that is not allocated");
+
+  const Uint b = buffer_of_row(array_idx);
+  Buffer& buffer = m_buffers[b];
+  const Uint row_idx = array_idx-m_array.size()-m_buffer_starts[b];
+  buffer.rows[row_idx]=row;
+  buffer.is_not_empty[row_idx]=true;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -438,27 +558,18 @@ inline void ListBufferT<T>::set_row(const Uint array_idx, const value_type& row)
 template<typename T>
 inline void ListBufferT<T>::rm_row(const Uint array_idx)
 {
-  Uint cummulative_size = m_array.size();
-  if (array_idx < cummulative_size)
+  if (array_idx < m_array.size())
   {
-    m_empty_array_rows.push_back(array_idx);
+    if (is_reserved_row(array_idx))
+      m_is_reserved_row_filled[reserved_row(array_idx)] = false;
+    else
+      m_empty_array_rows.push_back(array_idx);
     return;
   }
-  else
-  {
-    m_empty_buffer_rows.push_back(array_idx);
 
-    boost_foreach(Buffer& buffer, m_buffers)
-    {
-      if (array_idx<cummulative_size+buffer.size())
-      {
-        buffer.is_not_empty[array_idx-cummulative_size]=false;
-        return;
-      }
-      cummulative_size += buffer.size();
-    }
-  }
-  throw common::BadValue(FromHere(),"Trying to access index that is not allocated");
+  const Uint b = buffer_of_row(array_idx);
+  m_empty_buffer_rows.push_back(array_idx);
+  m_buffers[b].is_not_empty[array_idx-m_array.size()-m_buffer_starts[b]]=false;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -493,7 +604,7 @@ inline std::string ListBufferT<T>::string()
       str += "    " + to_str(s) + ":    ";
       if ( std::find(m_empty_buffer_rows.begin(),m_empty_buffer_rows.end(),s) != m_empty_buffer_rows.end())
         str += "X   (" + to_str(m_buffers[b].rows[i]) + ")\n";
-      else if( std::find(m_new_buffer_rows.begin(),m_new_buffer_rows.end(),s) != m_new_buffer_rows.end())
+      else if( b+1 == m_buffers.size() && i >= m_buffers[b].size()-m_nb_new_buffer_rows )
         str += "\n";
       else
         str += to_str(m_buffers[b].rows[i]) + "\n";
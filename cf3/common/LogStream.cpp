@@ -246,6 +246,29 @@ bool LogStream::isDestinationUsed(LogDestination destination) const
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+bool LogStream::is_active() const
+{
+  std::map<LogDestination, iostreams::filtering_ostream *>::const_iterator it;
+
+  for(it = m_destinations.begin() ; it != m_destinations.end() ; it++)
+  {
+    if(!this->isDestinationUsed(it->first))
+      continue;
+
+    if(it->first != SYNC_SCREEN && PE::Comm::instance().rank() != 0 && this->getFilterRankZero(it->first))
+      continue;
+
+    const LogLevelFilter & level_filter = this->getLevelFilter(it->first);
+    if(level_filter.get_log_level() >= static_cast<Uint>(level_filter.get_filter()))
+      return true;
+  }
+
+  return false;
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
 void LogStream::setStamp(LogDestination destination, const std::string & stampFormat)
 {
   this->getStampFilter(destination).setStamp(stampFormat);
@@ -193,6 +193,13 @@ class Common_API LogStream
   /// @return The use policy of the specified destination.
   bool isDestinationUsed(LogDestination destination) const;
 
+  /// @brief Checks whether anything written to the stream would reach a destination.
+
+  /// This allows skipping the construction of expensive messages, e.g. for debug output.
+  /// @return Returns @c true if at least one used destination lets the
+  /// messages of this stream pass on this rank.
+  bool is_active() const;
+
   /// @brief Sets a stamp format to a specified destination.
 
   /// If @c destination is @c #FILE but @c #isFileOpen() returns @c false,
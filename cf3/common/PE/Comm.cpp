@@ -4,6 +4,9 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/tss.hpp>
+
 #include "common/Log.hpp"
 
 #include "common/BasicExceptions.hpp"
@@ -17,6 +20,26 @@ namespace PE {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// Communicator set for the calling thread by Comm::set_thread_communicator
+  boost::thread_specific_ptr<Communicator>& thread_communicator()
+  {
+    static boost::thread_specific_ptr<Communicator> comm;
+    return comm;
+  }
+
+  /// Number of threads that have their own communicator. While it is zero, Comm::communicator()
+  /// skips the thread specific lookup
+  boost::detail::atomic_count& nb_thread_communicators()
+  {
+    static boost::detail::atomic_count count(0);
+    return count;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 Comm::Comm(int argc, char** args)
 {
   m_comm = nullptr;
@@ -84,7 +107,9 @@ void Comm::init(int argc, char** args)
 
   if( !is_initialized() && !is_finalized() ) // then initialize
   {
-    MPI_CHECK_RESULT(MPI_Init,(&argc,&args));
+    // Background threads, e.g. of asynchronous output, communicate while the main thread does
+    int provided;
+    MPI_CHECK_RESULT(MPI_Init_thread,(&argc,&args,MPI_THREAD_MULTIPLE,&provided));
     //  CFinfo << "MPI (version " <<  version() << ") -- initiated" << CFendl;
   }
 
@@ -115,9 +140,40 @@ void Comm::finalize()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Communicator Comm::communicator()
+{
+  cf3_assert( is_active() );
+  if ( detail::nb_thread_communicators() == 0 )
+    return m_comm;
+  const Communicator* thread_comm = detail::thread_communicator().get();
+  return thread_comm ? *thread_comm : m_comm;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Comm::set_thread_communicator( Communicator comm )
+{
+  const bool had_communicator = is_not_null(detail::thread_communicator().get());
+  if ( comm == MPI_COMM_NULL )
+  {
+    detail::thread_communicator().reset();
+    if ( had_communicator )
+      --detail::nb_thread_communicators();
+  }
+  else
+  {
+    detail::thread_communicator().reset(new Communicator(comm));
+    if ( !had_communicator )
+      ++detail::nb_thread_communicators();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Comm::barrier()
 {
-  if ( is_active() ) MPI_CHECK_RESULT(MPI_Barrier,(m_comm));
+  CF3_TRACE_SCOPE("MPI_barrier", TraceRecorder::MPI);
+  if ( is_active() ) MPI_CHECK_RESULT(MPI_Barrier,(communicator()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -126,6 +182,7 @@ void Comm::barrier( Communicator comm )
 {
   cf3_assert( comm != MPI_COMM_NULL );
 
+  CF3_TRACE_SCOPE("MPI_barrier", TraceRecorder::MPI);
   if ( is_active() ) MPI_CHECK_RESULT(MPI_Barrier,(comm));
 
 }
@@ -11,6 +11,7 @@
 #include <mpi.h>
 
 #include "common/StringConversion.hpp"
+#include "common/TraceRecorder.hpp"
 #include "common/WorkerStatus.hpp"
 
 #include "common/PE/types.hpp"
@@ -61,8 +62,14 @@ public:
   /// Return a reference to the current PE
   static Comm& instance();
 
-  /// @returns the generic communication channel
-  Communicator communicator() { cf3_assert( is_active() ); return m_comm; }
+  /// @returns the generic communication channel, or the communicator set for the calling thread
+  Communicator communicator();
+
+  /// Use the given communicator for all operations of the calling thread, instead of the world communicator.
+  /// A background thread can use a duplicate of the world communicator, so its collective operations
+  /// do not interfere with those of the main thread. Pass MPI_COMM_NULL to return to the world communicator,
+  /// which a thread must do before it ends.
+  void set_thread_communicator( Communicator comm );
 
   /// Returns the MPI version
   std::string version() const;
@@ -127,30 +134,37 @@ public:
 
   template<typename T> inline T*   all_to_all(const T* in_values, const int in_n, T* out_values, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_to_all", TraceRecorder::MPI);
     return PE::all_to_all(communicator(), in_values, in_n, out_values, stride);
   }
   template<typename T> inline void all_to_all(const std::vector<T>& in_values, std::vector<T>& out_values, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_to_all", TraceRecorder::MPI);
            PE::all_to_all(communicator(), in_values, out_values, stride);
   }
   template<typename T> inline T*   all_to_all(const T* in_values, const int *in_n, T* out_values, int *out_n, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_to_all", TraceRecorder::MPI);
     return PE::all_to_all(communicator(), in_values, in_n, out_values, out_n, stride);
   }
   template<typename T> inline T*   all_to_all(const T* in_values, const int *in_n, const int *in_map, T* out_values, int *out_n, const int *out_map, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_to_all", TraceRecorder::MPI);
     return PE::all_to_all(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, stride);
   }
   template<typename T> inline void all_to_all(const std::vector<T>& in_values, const std::vector<int>& in_n, std::vector<T>& out_values, std::vector<int>& out_n, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_to_all", TraceRecorder::MPI);
            PE::all_to_all(communicator(), in_values, in_n, out_values, out_n, stride);
   }
   template<typename T> inline void all_to_all(const std::vector<T>& in_values, const std::vector<int>& in_n, const std::vector<int>& in_map, std::vector<T>& out_values, std::vector<int>& out_n, const std::vector<int>& out_map, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_to_all", TraceRecorder::MPI);
            PE::all_to_all(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, stride);
   }
   template<typename T> inline void all_to_all( const std::vector<std::vector<T> >& send, std::vector<std::vector<T> >& recv)
   {
+    CF3_TRACE_SCOPE("MPI_all_to_all", TraceRecorder::MPI);
            PE::all_to_all(communicator(), send, recv);
   }
 
@@ -161,26 +175,32 @@ public:
 
   template<typename T> inline T*   gather(const T* in_values, const int in_n, T* out_values, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_gather", TraceRecorder::MPI);
     return PE::gather(communicator(), in_values, in_n, out_values, root, stride);
   }
   template<typename T> inline void gather(const std::vector<T>& in_values, std::vector<T>& out_values, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_gather", TraceRecorder::MPI);
            PE::gather(communicator(), in_values, out_values, root, stride);
   }
   template<typename T> inline T*   gather(const T* in_values, const int in_n, T* out_values, int *out_n, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_gather", TraceRecorder::MPI);
     return PE::gather(communicator(), in_values, in_n, out_values, out_n, root, stride);
   }
   template<typename T> inline T*   gather(const T* in_values, const int in_n, const int *in_map, T* out_values, int *out_n, const int *out_map, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_gather", TraceRecorder::MPI);
     return PE::gather(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, root, stride);
   }
   template<typename T> inline void gather(const std::vector<T>& in_values, const int in_n, std::vector<T>& out_values, std::vector<int>& out_n, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_gather", TraceRecorder::MPI);
            PE::gather(communicator(), in_values, in_n, out_values, out_n, root, stride);
   }
   template<typename T> inline void gather(const std::vector<T>& in_values, const int in_n, const std::vector<int>& in_map, std::vector<T>& out_values, std::vector<int>& out_n, const std::vector<int>& out_map, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_gather", TraceRecorder::MPI);
            PE::gather(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, root, stride);
   }
 
@@ -191,34 +211,42 @@ public:
 
   template<typename T> inline T*   all_gather(const T* in_values, const int in_n, T* out_values, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_gather", TraceRecorder::MPI);
     return PE::all_gather(communicator(), in_values, in_n, out_values, stride);
   }
   template<typename T> inline void all_gather(const std::vector<T>& in_values, std::vector<T>& out_values, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_gather", TraceRecorder::MPI);
            PE::all_gather(communicator(), in_values, out_values, stride);
   }
   template<typename T> inline void all_gather(const T& in_value, std::vector<T>& out_values)
   {
+    CF3_TRACE_SCOPE("MPI_all_gather", TraceRecorder::MPI);
            PE::all_gather(communicator(), in_value, out_values);
   }
   template<typename T> inline T*   all_gather(const T* in_values, const int in_n, T* out_values, int *out_n, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_gather", TraceRecorder::MPI);
     return PE::all_gather(communicator(), in_values, in_n, out_values, out_n, stride);
   }
   template<typename T> inline T*   all_gather(const T* in_values, const int in_n, const int *in_map, T* out_values, int *out_n, const int *out_map, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_gather", TraceRecorder::MPI);
     return PE::all_gather(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, stride);
   }
   template<typename T> inline void all_gather(const std::vector<T>& in_values, const int in_n, std::vector<T>& out_values, std::vector<int>& out_n, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_gather", TraceRecorder::MPI);
            PE::all_gather(communicator(), in_values, in_n, out_values, out_n, stride);
   }
   template<typename T> inline void all_gather(const std::vector<T>& in_values, const int in_n, const std::vector<int>& in_map, std::vector<T>& out_values, std::vector<int>& out_n, const std::vector<int>& out_map, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_gather", TraceRecorder::MPI);
            PE::all_gather(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, stride);
   }
   template<typename T> inline void all_gather(const std::vector<T>& send, std::vector< std::vector<T> >& recv)
   {
+    CF3_TRACE_SCOPE("MPI_all_gather", TraceRecorder::MPI);
            PE::all_gather(communicator(), send, recv);
   }
 
@@ -229,26 +257,32 @@ public:
 
   template<typename T> inline T*   scatter(const T* in_values, const int in_n, T* out_values, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_scatter", TraceRecorder::MPI);
     return PE::scatter(communicator(), in_values, in_n, out_values, root, stride);
   }
   template<typename T> inline void scatter(const std::vector<T>& in_values, std::vector<T>& out_values, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_scatter", TraceRecorder::MPI);
            PE::scatter(communicator(), in_values, out_values, root, stride);
   }
   template<typename T> inline T*   scatter(const T* in_values, const int* in_n, T* out_values, int& out_n, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_scatter", TraceRecorder::MPI);
     return PE::scatter(communicator(), in_values, in_n, out_values, out_n, root, stride);
   }
   template<typename T> inline T*   scatter(const T* in_values, const int *in_n, const int *in_map, T* out_values, int& out_n, const int *out_map, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_scatter", TraceRecorder::MPI);
     return PE::scatter(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, root, stride);
   }
   template<typename T> inline void scatter(const std::vector<T>& in_values, const std::vector<int>& in_n, std::vector<T>& out_values, int& out_n, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_scatter", TraceRecorder::MPI);
            PE::scatter(communicator(), in_values, in_n, out_values, out_n, root, stride);
   }
   template<typename T> inline void scatter(const std::vector<T>& in_values, const std::vector<int>& in_n, const std::vector<int>& in_map, std::vector<T>& out_values, int& out_n, const std::vector<int>& out_map, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_scatter", TraceRecorder::MPI);
            PE::scatter(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, root, stride);
   }
 
@@ -259,18 +293,22 @@ public:
 
   template<typename T, typename Op> inline T*   reduce(const Op& op, const T* in_values, const int in_n, T* out_values, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_reduce", TraceRecorder::MPI);
     return PE::reduce(communicator(), op, in_values, in_n, out_values, root, stride);
   }
   template<typename T, typename Op> inline void reduce(const Op& op, const std::vector<T>& in_values, std::vector<T>& out_values, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_reduce", TraceRecorder::MPI);
            PE::reduce(communicator(), op, in_values, out_values, root, stride);
   }
   template<typename T, typename Op> inline T*   reduce(const Op& op, const T* in_values, const int in_n, const int *in_map, T* out_values, const int *out_map, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_reduce", TraceRecorder::MPI);
     return PE::reduce(communicator(), op, in_values, in_n, in_map, out_values, out_map, root, stride);
   }
   template<typename T, typename Op> inline void reduce(const Op& op, const std::vector<T>& in_values, const std::vector<int>& in_map, std::vector<T>& out_values, const std::vector<int>& out_map, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_reduce", TraceRecorder::MPI);
            PE::reduce(communicator(), op, in_values, in_map, out_values, out_map, root, stride);
   }
 
@@ -281,18 +319,22 @@ public:
 
   template<typename T, typename Op> inline T*   all_reduce(const Op& op, const T* in_values, const int in_n, T* out_values, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_reduce", TraceRecorder::MPI);
     return PE::all_reduce(communicator(), op, in_values, in_n, out_values, stride);
   }
   template<typename T, typename Op> inline void all_reduce(const Op& op, const std::vector<T>& in_values, std::vector<T>& out_values, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_reduce", TraceRecorder::MPI);
            PE::all_reduce(communicator(), op, in_values, out_values, stride);
   }
   template<typename T, typename Op> inline T*   all_reduce(const Op& op, const T* in_values, const int in_n, const int *in_map, T* out_values, const int *out_map, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_reduce", TraceRecorder::MPI);
     return PE::all_reduce(communicator(), op, in_values, in_n, in_map, out_values, out_map, stride);
   }
   template<typename T, typename Op> inline void all_reduce(const Op& op, const std::vector<T>& in_values, const std::vector<int>& in_map, std::vector<T>& out_values, const std::vector<int>& out_map, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_all_reduce", TraceRecorder::MPI);
            PE::all_reduce(communicator(), op, in_values, in_map, out_values, out_map, stride);
   }
 
@@ -303,18 +345,22 @@ public:
 
   template<typename T> inline T*   broadcast(const T* in_values, const int in_n, T* out_values, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_broadcast", TraceRecorder::MPI);
     return PE::broadcast(communicator(), in_values, in_n, out_values, root, stride);
   }
   template<typename T> inline void broadcast(const std::vector<T>& in_values, std::vector<T>& out_values, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_broadcast", TraceRecorder::MPI);
            PE::broadcast(communicator(), in_values, out_values, root, stride);
   }
   template<typename T> inline T*   broadcast(const T* in_values, const int in_n, const int *in_map, T* out_values, const int *out_map, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_broadcast", TraceRecorder::MPI);
     return PE::broadcast(communicator(), in_values, in_n, in_map, out_values, out_map, root, stride);
   }
   template<typename T> inline void broadcast(const std::vector<T>& in_values, const std::vector<int>& in_map, std::vector<T>& out_values, const std::vector<int>& out_map, const int root, const int stride=1)
   {
+    CF3_TRACE_SCOPE("MPI_broadcast", TraceRecorder::MPI);
            PE::broadcast(communicator(), in_values, in_map, out_values, out_map, root, stride);
   }
 
@@ -34,6 +34,8 @@ namespace common {
 /// will resize the table and copy itself into the table.
 /// This happens automatically when the buffer is destroyed, or can
 /// also be done manually. @see class ArrayBufferT
+/// If the number of rows to add is known, Buffer::reserve() lets the
+/// buffer write them directly into the table.
 /// Before using the table one has to be sure that
 /// the buffer is flushed.
 ///
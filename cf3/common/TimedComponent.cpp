@@ -5,6 +5,10 @@
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
 #include <iostream>
+#include <limits>
+#include <map>
+
+#include <boost/functional/hash.hpp>
 
 #include "common/Component.hpp"
 #include "common/FindComponents.hpp"
@@ -35,75 +39,152 @@ void store_timings(Component& root)
 
 /////////////////////////////////////////////////////////////////////////////////////
 
-void print_timing_tree(cf3::common::Component& root, const bool print_untimed, const std::string& prefix)
+namespace detail
 {
-  if(prefix.empty()) // Top-level recursion
+  /// Number of values stored per timed component in the reduction buffer
+  const Uint nb_timing_values = 4;
+
+  /// Global timing statistics for a single component
+  struct TimingStats
   {
-    store_timings(root);
-    if(PE::Comm::instance().rank() == 0)
-      std::cout << "<DartMeasurement name=\"Timings\" type=\"text/plain\"><![CDATA[<html><body><pre>\n";
+    Real mean;
+    Real min;
+    Real max;
+    Uint count;
+  };
+
+  /// Collect the timed components of the tree, in the order in which they are printed
+  void collect_timed_components(Component& root, std::vector<Component*>& timed_components)
+  {
+    if(root.properties().check("timer_mean"))
+      timed_components.push_back(&root);
+
+    BOOST_FOREACH(Component& component, root)
+    {
+      collect_timed_components(component, timed_components);
+    }
   }
 
-  if(!root.properties().check("timer_mean") && print_untimed && PE::Comm::instance().rank() == 0)
+  /// True if all CPUs have the same timed components, so their statistics can be gathered in one go
+  bool timed_components_agree(const std::vector<Component*>& timed_components)
   {
-    std::cout << prefix << root.name() << ": no timing info\n";
-  }
+    std::size_t paths_hash = 0;
+    BOOST_FOREACH(Component* component, timed_components)
+    {
+      boost::hash_combine(paths_hash, component->uri().path());
+    }
 
+    const Uint local_signature[2] = { static_cast<Uint>(timed_components.size()), static_cast<Uint>(paths_hash) };
+    Uint min_signature[2];
+    Uint max_signature[2];
+    PE::Comm::instance().all_reduce(PE::min(), local_signature, 2, min_signature);
+    PE::Comm::instance().all_reduce(PE::max(), local_signature, 2, max_signature);
+    return min_signature[0] == max_signature[0] && min_signature[1] == max_signature[1];
+  }
 
-  if(root.properties().check("timer_mean"))
+  void print_timing_tree(Component& root, const bool print_untimed, const std::string& prefix, const bool is_top, const std::map<Component*, TimingStats>& stats)
   {
-    const Real local_mean = root.properties().value<Real>("timer_mean");
-    const Real local_min = root.properties().value<Real>("timer_minimum");
-    const Real local_max = root.properties().value<Real>("timer_maximum");
-    const Uint local_count = root.properties().value<Uint>("timer_count");
-
-    // Only bother with global averages if we have more than 1 process
-    if(PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    std::map<Component*, TimingStats>::const_iterator found = stats.find(&root);
+    if(found == stats.end())
+    {
+      if(print_untimed)
+        std::cout << prefix << root.name() << ": no timing info\n";
+    }
+    else
     {
-      // Average, minimum and maximum of each statistic over all CPUs
-      Real mean_mean, mean_min, mean_max, max_mean, max_min, max_max, min_mean, min_min, min_max;
-      Uint min_count, max_count;
-      PE::Comm::instance().all_reduce(PE::plus(), &local_mean, 1, &mean_mean);
-      PE::Comm::instance().all_reduce(PE::min(), &local_mean, 1, &mean_min);
-      PE::Comm::instance().all_reduce(PE::max(), &local_mean, 1, &mean_max);
-
-      PE::Comm::instance().all_reduce(PE::plus(), &local_min, 1, &min_mean);
-      PE::Comm::instance().all_reduce(PE::min(), &local_min, 1, &min_min);
-      PE::Comm::instance().all_reduce(PE::max(), &local_min, 1, &min_max);
-
-      PE::Comm::instance().all_reduce(PE::plus(), &local_max, 1, &max_mean);
-      PE::Comm::instance().all_reduce(PE::min(), &local_max, 1, &max_min);
-      PE::Comm::instance().all_reduce(PE::max(), &local_max, 1, &max_max);
-      
-      PE::Comm::instance().all_reduce(PE::min(), &local_count, 1, &min_count);
-      PE::Comm::instance().all_reduce(PE::max(), &local_count, 1, &max_count);
-      cf3_assert(min_count == max_count);
-
-      const Real nb_procs = static_cast<Real>(PE::Comm::instance().size());
-      mean_mean /= nb_procs; min_mean /= nb_procs; max_mean /= nb_procs;
-
-      if(PE::Comm::instance().rank() == 0)
+      const TimingStats& s = found->second;
+      if(PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
       {
-        if(prefix.empty()) std::cout << "Timings in seconds, with [min, mean, max] over CPUs\n";
+        if(is_top) std::cout << "Timings in seconds, with [min, mean, max] over CPUs\n";
         std::cout << prefix << root.name()
-          << ": mean: "  << mean_mean
-          << ", min: " << min_min
-          << ", max: " << max_max
-          << ", count: " << min_count << "\n";
+          << ": mean: "  << s.mean
+          << ", min: " << s.min
+          << ", max: " << s.max
+          << ", count: " << s.count << "\n";
+      }
+      else
+      {
+        std::cout << prefix << root.name() << ": mean: " << s.mean << ", max: " << s.max << ", min: " << s.min << ", count: " << s.count << "\n";
       }
     }
-    else
+
+    BOOST_FOREACH(Component& component, root)
     {
-      std::cout << prefix << root.name() << ": mean: " << local_mean << ", max: " << local_max << ", min: " << local_min << ", count: " << local_count << "\n";
+      print_timing_tree(component, print_untimed, prefix + "  ", false, stats);
     }
   }
+}
+
+void print_timing_tree(cf3::common::Component& root, const bool print_untimed, const std::string& prefix)
+{
+  if(prefix.empty()) // Top-level call
+    store_timings(root);
+
+  std::vector<Component*> timed_components;
+  detail::collect_timed_components(root, timed_components);
+  const Uint nb_timed = timed_components.size();
+
+  std::vector<Real> local_values(detail::nb_timing_values*nb_timed);
+  for(Uint i = 0; i != nb_timed; ++i)
+  {
+    const PropertyList& props = timed_components[i]->properties();
+    local_values[detail::nb_timing_values*i    ] = props.value<Real>("timer_mean");
+    local_values[detail::nb_timing_values*i + 1] = props.value<Real>("timer_minimum");
+    local_values[detail::nb_timing_values*i + 2] = props.value<Real>("timer_maximum");
+    local_values[detail::nb_timing_values*i + 3] = static_cast<Real>(props.value<Uint>("timer_count"));
+  }
+
+  bool is_parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
 
-  BOOST_FOREACH(Component& component, root)
+  // Gather the statistics of all components in one go, provided the timed components are the same on all CPUs
+  if(is_parallel && !detail::timed_components_agree(timed_components))
   {
-    print_timing_tree(component, print_untimed, prefix + "  ");
+    if(PE::Comm::instance().rank() == 0)
+      std::cout << "Warning: timed components differ between CPUs, only showing timings for rank 0\n";
+    is_parallel = false;
+  }
+  const Uint nb_procs = is_parallel ? PE::Comm::instance().size() : 1;
+
+  std::vector<Real> all_values;
+  if(is_parallel && nb_timed != 0)
+    PE::Comm::instance().gather(local_values, all_values, 0);
+  else
+    all_values.swap(local_values);
+
+  if(PE::Comm::instance().rank() != 0)
+    return;
+
+  std::map<Component*, detail::TimingStats> stats;
+  for(Uint i = 0; i != nb_timed; ++i)
+  {
+    detail::TimingStats& s = stats[timed_components[i]];
+    Real mean_sum = 0.;
+    Real min_min = std::numeric_limits<Real>::max();
+    Real max_max = -std::numeric_limits<Real>::max();
+    Real min_count = std::numeric_limits<Real>::max();
+    Real max_count = 0.;
+    for(Uint proc = 0; proc != nb_procs; ++proc)
+    {
+      const Real* values = &all_values[detail::nb_timing_values*(proc*nb_timed + i)];
+      mean_sum += values[0];
+      min_min = std::min(min_min, values[1]);
+      max_max = std::max(max_max, values[2]);
+      min_count = std::min(min_count, values[3]);
+      max_count = std::max(max_count, values[3]);
+    }
+    cf3_assert(min_count == max_count);
+    s.mean = mean_sum / static_cast<Real>(nb_procs);
+    s.min = min_min;
+    s.max = max_max;
+    s.count = static_cast<Uint>(min_count);
   }
 
-  if(prefix.empty() && PE::Comm::instance().rank() == 0)
+  if(prefix.empty())
+    std::cout << "<DartMeasurement name=\"Timings\" type=\"text/plain\"><![CDATA[<html><body><pre>\n";
+
+  detail::print_timing_tree(root, print_untimed, prefix, prefix.empty(), stats);
+
+  if(prefix.empty())
     std::cout << "</pre></body></html>]]></DartMeasurement>" << std::endl;
 }
 
@@ -0,0 +1,294 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/TraceRecorder.hpp"
+#include "common/URI.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#ifdef CF3_OS_LINUX
+extern "C"
+{
+  #include <time.h>
+}
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Escape a string for use in a JSON string literal
+  std::string json_escape(const std::string& str)
+  {
+    std::string result;
+    result.reserve(str.size());
+    for(std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+    {
+      if(*it == '"' || *it == '\\')
+        result.push_back('\\');
+      result.push_back(*it);
+    }
+    return result;
+  }
+
+  const char* category_names[] = { "action", "mpi" };
+
+  /// Serializes access to the recorder. Kept out of the header, which is included from PE/Comm.hpp
+  boost::mutex& recorder_mutex()
+  {
+    static boost::mutex mutex;
+    return mutex;
+  }
+
+  /// Small index for each thread that recorded an event, in order of first use
+  typedef std::map<boost::thread::id, Uint> ThreadIndicesT;
+  ThreadIndicesT& thread_indices()
+  {
+    static ThreadIndicesT indices;
+    return indices;
+  }
+
+  /// Index of the calling thread. Must be called with the recorder mutex locked
+  Uint thread_index()
+  {
+    ThreadIndicesT& indices = thread_indices();
+    const boost::thread::id id = boost::this_thread::get_id();
+    ThreadIndicesT::const_iterator found = indices.find(id);
+    if(found != indices.end())
+      return found->second;
+    const Uint index = indices.size();
+    indices.insert(std::make_pair(id, index));
+    return index;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+TraceRecorder::TraceRecorder() :
+  m_enabled(false),
+  m_next(0),
+  m_nb_events(0)
+{
+  // The creating thread gets index 0
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  detail::thread_index();
+}
+
+TraceRecorder& TraceRecorder::instance()
+{
+  static TraceRecorder recorder;
+  return recorder;
+}
+
+void TraceRecorder::enable(const Uint capacity)
+{
+  cf3_assert(capacity > 0);
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  m_events.resize(capacity);
+  m_next = 0;
+  m_nb_events = 0;
+  set_enabled(true);
+}
+
+void TraceRecorder::disable()
+{
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  set_enabled(false);
+}
+
+void TraceRecorder::set_enabled(const bool enabled)
+{
+  if(enabled && !is_enabled())
+    ++m_enabled;
+  else if(!enabled && is_enabled())
+    --m_enabled;
+}
+
+void TraceRecorder::clear()
+{
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  m_next = 0;
+  m_nb_events = 0;
+}
+
+Uint TraceRecorder::intern(const std::string& name)
+{
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  std::map<std::string, Uint>::const_iterator found = m_name_ids.find(name);
+  if(found != m_name_ids.end())
+    return found->second;
+
+  const Uint name_id = m_names.size();
+  m_names.push_back(name);
+  m_name_ids.insert(std::make_pair(name, name_id));
+  return name_id;
+}
+
+std::string TraceRecorder::name(const Uint name_id) const
+{
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  cf3_assert(name_id < m_names.size());
+  return m_names[name_id];
+}
+
+Real TraceRecorder::now()
+{
+#ifdef CF3_OS_LINUX
+  timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return static_cast<Real>(time.tv_sec) * 1e6 + static_cast<Real>(time.tv_nsec) * 1e-3;
+#else
+  static const boost::posix_time::ptime epoch = boost::posix_time::microsec_clock::universal_time();
+  return static_cast<Real>((boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds());
+#endif
+}
+
+void TraceRecorder::record(const Uint name_id, const Category category, const Real start, const Real end)
+{
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  if(m_events.empty())
+    return;
+  Event& event = m_events[m_next];
+  event.start = start;
+  event.duration = end - start;
+  event.name = name_id;
+  event.category = category;
+  event.thread = detail::thread_index();
+  m_next = (m_next + 1) % m_events.size();
+  if(m_nb_events != m_events.size())
+    ++m_nb_events;
+}
+
+Uint TraceRecorder::nb_events() const
+{
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  return m_nb_events;
+}
+
+TraceRecorder::Event TraceRecorder::event(const Uint i) const
+{
+  boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+  return stored_event(i);
+}
+
+const TraceRecorder::Event& TraceRecorder::stored_event(const Uint i) const
+{
+  cf3_assert(i < m_nb_events);
+  const Uint first = m_nb_events == m_events.size() ? m_next : 0;
+  return m_events[(first + i) % m_events.size()];
+}
+
+void TraceRecorder::write_chrome_trace(const URI& file)
+{
+  // Copy the events, so no lock is held during the collective operations below, which may be traced themselves
+  bool was_enabled;
+  std::vector<Event> events;
+  std::vector<std::string> names;
+  {
+    boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+    was_enabled = is_enabled();
+    set_enabled(false);
+    events.reserve(m_nb_events);
+    for(Uint i = 0; i != m_nb_events; ++i)
+      events.push_back(stored_event(i));
+    names = m_names;
+  }
+
+  PE::Comm& comm = PE::Comm::instance();
+  const bool parallel = comm.is_active() && comm.size() > 1;
+  const Uint rank = comm.rank();
+
+  // Timestamps are shifted so the earliest event over all ranks starts at zero. Events are stored when they end,
+  // so the first stored event is not necessarily the first one to start.
+  Real local_start = std::numeric_limits<Real>::max();
+  for(Uint i = 0; i != events.size(); ++i)
+    local_start = std::min(local_start, events[i].start);
+  Real global_start = local_start;
+  if(parallel)
+    comm.all_reduce(PE::min(), &local_start, 1, &global_start);
+
+  std::stringstream local_events;
+  local_events << std::fixed << std::setprecision(3);
+  for(Uint i = 0; i != events.size(); ++i)
+  {
+    const Event& evt = events[i];
+    local_events << "{\"name\":\"" << detail::json_escape(names[evt.name]) << "\","
+                 << "\"cat\":\"" << detail::category_names[evt.category] << "\","
+                 << "\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":" << evt.thread << ","
+                 << "\"ts\":" << evt.start - global_start << ",\"dur\":" << evt.duration << "},\n";
+  }
+  local_events << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+
+  const std::string local_str = local_events.str();
+  std::vector<char> send_buf(local_str.begin(), local_str.end());
+  std::vector<char> recv_buf;
+  if(parallel)
+  {
+    std::vector<int> recv_counts(comm.size(), -1);
+    comm.gather(send_buf, send_buf.size(), recv_buf, recv_counts, 0);
+
+    // Separate the blocks from different ranks with a comma
+    if(rank == 0)
+    {
+      std::vector<char> joined;
+      joined.reserve(recv_buf.size() + comm.size());
+      Uint offset = 0;
+      for(Uint i = 0; i != comm.size(); ++i)
+      {
+        if(i != 0)
+          joined.push_back(',');
+        joined.insert(joined.end(), recv_buf.begin() + offset, recv_buf.begin() + offset + recv_counts[i]);
+        offset += recv_counts[i];
+      }
+      recv_buf.swap(joined);
+    }
+  }
+  else
+  {
+    recv_buf.swap(send_buf);
+  }
+
+  if(rank == 0)
+  {
+    std::ofstream out(file.path().c_str());
+    if(!out.is_open())
+      throw FileSystemError(FromHere(), "Could not open trace file " + file.path());
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out.write(&recv_buf[0], recv_buf.size());
+    out << "\n]}\n";
+  }
+
+  if(was_enabled)
+  {
+    boost::lock_guard<boost::mutex> lock(detail::recorder_mutex());
+    set_enabled(true);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+/////////////////////////////////////////////////////////////////////////////////////
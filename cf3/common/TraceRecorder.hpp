@@ -0,0 +1,167 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_TraceRecorder_hpp
+#define cf3_common_TraceRecorder_hpp
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/detail/atomic_count.hpp>
+
+#include "common/CF.hpp"
+#include "common/CommonAPI.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+class URI;
+
+/// Records a per-rank execution timeline of actions and MPI calls.
+/// Events are stored in a ring buffer that is allocated once in enable(), so recording an event
+/// never allocates. When the buffer is full, the oldest events are overwritten.
+/// Recording, interning and reading back are serialized by a lock, so events may also be recorded from helper threads,
+/// which get their own row in the trace. Names and events are returned by value, since the storage may change
+/// as soon as the lock is released. Only the enabled flag is read without the lock.
+/// Timestamps come from a monotonic clock and are stored in microseconds, which is the unit used by
+/// the Chrome trace event format written by write_chrome_trace(). The resulting file can be loaded
+/// in chrome://tracing or Perfetto, with one process row per MPI rank.
+/// @note This header is included from PE/Comm.hpp and should stay lean
+class Common_API TraceRecorder : public boost::noncopyable
+{
+public:
+  /// Categories for the recorded events
+  enum Category { ACTION = 0, MPI = 1 };
+
+  /// One recorded event
+  struct Event
+  {
+    Real start;    ///< Start time, in microseconds
+    Real duration; ///< Duration, in microseconds
+    Uint name;     ///< Index into the name table
+    Uint category; ///< Category of the event
+    Uint thread;   ///< Index of the recording thread, 0 being the thread that created the recorder
+  };
+
+  /// Access to the single instance
+  static TraceRecorder& instance();
+
+  /// Start recording, allocating a ring buffer of the given number of events.
+  /// Previously recorded events are discarded.
+  void enable(const Uint capacity = 65536);
+
+  /// Stop recording. The recorded events are kept until the next call to enable() or clear().
+  void disable();
+
+  /// True if events are being recorded
+  bool is_enabled() const { return m_enabled != 0; }
+
+  /// Discard all recorded events
+  void clear();
+
+  /// Return a unique index for the given name
+  Uint intern(const std::string& name);
+
+  /// Name corresponding to an index returned by intern()
+  std::string name(const Uint name_id) const;
+
+  /// Current time from the monotonic clock, in microseconds
+  static Real now();
+
+  /// Add an event to the ring buffer
+  void record(const Uint name_id, const Category category, const Real start, const Real end);
+
+  /// Number of events currently stored
+  Uint nb_events() const;
+
+  /// Copy of a stored event, in chronological order
+  Event event(const Uint i) const;
+
+  /// Write the events of all ranks to a single file in the Chrome trace event (JSON) format.
+  /// This is a collective operation when the parallel environment is active. Recording is suspended while writing.
+  void write_chrome_trace(const URI& file);
+
+private:
+  TraceRecorder();
+
+  /// Change the enabled flag. Must be called with the recorder mutex locked
+  void set_enabled(const bool enabled);
+
+  /// Access to a stored event. Must be called with the recorder mutex locked
+  const Event& stored_event(const Uint i) const;
+
+  /// Non-zero if enabled. Atomic, since TraceScope reads it without taking the lock
+  boost::detail::atomic_count m_enabled;
+  std::vector<Event> m_events;
+  Uint m_next;
+  Uint m_nb_events;
+
+  std::map<std::string, Uint> m_name_ids;
+  std::vector<std::string> m_names;
+};
+
+/// Records an event spanning the lifetime of the object, if the TraceRecorder is enabled
+/// Use the CF3_TRACE_SCOPE macro for fixed names, to avoid looking up the name for every event.
+class Common_API TraceScope : public boost::noncopyable
+{
+public:
+  /// Construct using a name index obtained from TraceRecorder::intern()
+  TraceScope(const Uint name_id, const TraceRecorder::Category category = TraceRecorder::ACTION) :
+    m_active(TraceRecorder::instance().is_enabled())
+  {
+    if(m_active)
+      begin(name_id, category);
+  }
+
+  TraceScope(const std::string& name, const TraceRecorder::Category category = TraceRecorder::ACTION) :
+    m_active(TraceRecorder::instance().is_enabled())
+  {
+    if(m_active)
+      begin(TraceRecorder::instance().intern(name), category);
+  }
+
+  TraceScope(const char* name, const TraceRecorder::Category category = TraceRecorder::ACTION) :
+    m_active(TraceRecorder::instance().is_enabled())
+  {
+    if(m_active)
+      begin(TraceRecorder::instance().intern(name), category);
+  }
+
+  ~TraceScope()
+  {
+    if(m_active)
+      TraceRecorder::instance().record(m_name, m_category, m_start, TraceRecorder::now());
+  }
+
+private:
+  void begin(const Uint name_id, const TraceRecorder::Category category)
+  {
+    m_name = name_id;
+    m_category = category;
+    m_start = TraceRecorder::now();
+  }
+
+  const bool m_active;
+  Uint m_name;
+  TraceRecorder::Category m_category;
+  Real m_start;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+/// Trace the enclosing scope under a fixed name, which is interned only once per call site
+#define CF3_TRACE_SCOPE(name, category) \
+  static const cf3::Uint cf3_trace_name_id = cf3::common::TraceRecorder::instance().intern(name); \
+  cf3::common::TraceScope cf3_trace_scope(cf3_trace_name_id, category)
+
+#endif // cf3_common_TraceRecorder_hpp
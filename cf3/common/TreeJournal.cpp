@@ -0,0 +1,193 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <boost/thread/locks.hpp>
+
+#include "common/Assertions.hpp"
+#include "common/BasicExceptions.hpp"
+#include "common/Component.hpp"
+#include "common/TreeJournal.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+TreeJournal& TreeJournal::instance()
+{
+  static TreeJournal tree_journal;
+  return tree_journal;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TreeJournal::TreeJournal() :
+  m_enabled(0),
+  m_root(nullptr),
+  m_version(0),
+  m_capacity(10000)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TreeJournal::set_root( const Component& root )
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  m_root = &root;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TreeJournal::set_enabled( const bool enabled )
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  if(enabled == is_enabled())
+    return;
+
+  if(enabled)
+  {
+    // changes made while disabled are unknown: make all earlier versions unavailable
+    m_changes.clear();
+    ++m_version;
+    ++m_enabled;
+  }
+  else
+  {
+    --m_enabled;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint TreeJournal::version() const
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  return m_version;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TreeJournal::set_capacity( const Uint capacity )
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  m_capacity = capacity;
+  while(m_changes.size() > m_capacity)
+    m_changes.pop_front();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TreeJournal::record( const ChangeType type, const Component& component, const std::string& new_name )
+{
+  if(!is_enabled())
+    return;
+
+  // components that are being built outside of the tree are not recorded:
+  // adding them to the tree records their whole subtree at once
+  if(is_null(m_root) || component.root().get() != m_root)
+    return;
+
+  Change change;
+  change.type = type;
+  change.path = component.uri();
+  change.new_name = new_name;
+
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  change.version = ++m_version;
+  m_changes.push_back(change);
+  while(m_changes.size() > m_capacity)
+    m_changes.pop_front();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool TreeJournal::changes_since( const Uint version, std::vector<Change>& changes ) const
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+
+  changes.clear();
+
+  if(!is_enabled() || version > m_version)
+    return false;
+
+  // the change right after the requested version must still be there
+  if(version != m_version && (m_changes.empty() || m_changes.front().version > version + 1))
+    return false;
+
+  for(std::deque<Change>::const_iterator it = m_changes.begin(); it != m_changes.end(); ++it)
+  {
+    if(it->version > version)
+      changes.push_back(*it);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+URI TreeJournal::path_after( const std::vector<Change>& changes, const Uint index )
+{
+  cf3_assert(index < changes.size());
+
+  const Change& change = changes[index];
+  if(change.type == REMOVED)
+    return URI();
+
+  std::string path = change.type == RENAMED ? (change.path.base_path() / URI(change.new_name, URI::Scheme::CPATH)).path() : change.path.path();
+
+  // follow the renames and removals of the component and of its parents
+  for(Uint i = index + 1; i < changes.size(); ++i)
+  {
+    const Change& later = changes[i];
+    if(later.type != RENAMED && later.type != REMOVED)
+      continue;
+
+    const std::string later_path = later.path.path();
+    const bool is_same = path == later_path;
+    if(!is_same && path.compare(0, later_path.size() + 1, later_path + "/") != 0)
+      continue;
+
+    if(later.type == REMOVED)
+      return URI();
+
+    path = (later.path.base_path() / URI(later.new_name, URI::Scheme::CPATH)).path() + path.substr(later_path.size());
+  }
+
+  return URI(path, URI::Scheme::CPATH);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::string TreeJournal::type_to_str( const ChangeType type )
+{
+  switch(type)
+  {
+    case ADDED:    return "added";
+    case REMOVED:  return "removed";
+    case RENAMED:  return "renamed";
+    case MODIFIED: return "modified";
+  }
+  throw BadValue(FromHere(), "Unknown tree change type");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TreeJournal::ChangeType TreeJournal::type_from_str( const std::string& type )
+{
+  if(type == "added")    return ADDED;
+  if(type == "removed")  return REMOVED;
+  if(type == "renamed")  return RENAMED;
+  if(type == "modified") return MODIFIED;
+  throw BadValue(FromHere(), "Unknown tree change type [" + type + "]");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
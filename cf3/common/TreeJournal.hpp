@@ -0,0 +1,131 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_TreeJournal_hpp
+#define cf3_common_TreeJournal_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <deque>
+
+#include <boost/noncopyable.hpp>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "common/CommonAPI.hpp"
+#include "common/URI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+class Component;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Records the changes to the component tree under the root of the Core.
+/// Every change increments the tree version, so that a client that listed the
+/// tree at some version can ask for the changes since then instead of listing
+/// the complete tree again. Only the most recent changes are kept: clients that
+/// are too far behind have to list the complete tree.
+/// Nothing is recorded until a UI server enables the journal.
+class Common_API TreeJournal : public boost::noncopyable {
+
+public: // types
+
+  /// Kind of change
+  enum ChangeType { ADDED, REMOVED, RENAMED, MODIFIED };
+
+  /// A single change to the tree
+  struct Change
+  {
+    /// Tree version after the change
+    Uint version;
+    /// Kind of change
+    ChangeType type;
+    /// Path of the changed component, before the change
+    URI path;
+    /// New name for RENAMED changes, empty otherwise
+    std::string new_name;
+  };
+
+public: // functions
+
+  static TreeJournal& instance();
+
+  /// Sets the root of the tree whose changes are recorded
+  void set_root( const Component& root );
+
+  /// Starts or stops recording. While the journal is disabled, changes_since()
+  /// fails for every version, so that clients list the complete tree.
+  void set_enabled( const bool enabled );
+
+  /// True if changes are recorded
+  bool is_enabled() const { return m_enabled != 0; }
+
+  /// Current version of the tree. Version 0 is never used by a change.
+  Uint version() const;
+
+  /// Maximum number of changes that are kept
+  void set_capacity( const Uint capacity );
+
+  /// Records a change, if the journal is enabled and the component belongs to the tree
+  /// @param component The changed component. For RENAMED changes, it must
+  /// still have its old name.
+  void record( const ChangeType type, const Component& component, const std::string& new_name = std::string() );
+
+  /// Gives the changes after the given version
+  /// @return false if some of these changes are no longer in the journal
+  bool changes_since( const Uint version, std::vector<Change>& changes ) const;
+
+  /// Path of the component of a change once all the later changes are applied
+  /// @param changes Consecutive changes, as given by @c changes_since()
+  /// @param index Index of the change in @c changes
+  /// @return An empty URI if the component was removed later on
+  static URI path_after( const std::vector<Change>& changes, const Uint index );
+
+  /// Name of a change type, as used in the list_tree replies
+  static std::string type_to_str( const ChangeType type );
+
+  /// Change type from its name
+  static ChangeType type_from_str( const std::string& type );
+
+private: // functions
+
+  TreeJournal();
+
+private: // data
+
+  /// Non-zero if changes are recorded. Read without locking, so that
+  /// changes to the tree cost next to nothing when no UI server is attached.
+  boost::detail::atomic_count m_enabled;
+
+  /// Root of the recorded tree
+  const Component* m_root;
+
+  /// Current version
+  Uint m_version;
+
+  /// Maximum number of changes that are kept
+  Uint m_capacity;
+
+  /// The most recent changes, oldest first
+  std::deque<Change> m_changes;
+
+  /// Changes may be recorded and listed from different threads
+  mutable boost::mutex m_mutex;
+
+}; // class TreeJournal
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_TreeJournal_hpp
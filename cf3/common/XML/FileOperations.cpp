@@ -6,11 +6,17 @@
 
 #include <cstdio>
 #include <fstream>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
 
 #include "rapidxml/rapidxml_print.hpp" // includes rapidxml/rapidxml.hpp
 
 #include "common/Assertions.hpp"
 #include "common/BasicExceptions.hpp"
+#include "common/StringConversion.hpp"
+
+#include "common/XML/Protocol.hpp"
 
 #include "common/XML/FileOperations.hpp"
 
@@ -22,6 +28,40 @@ namespace XML {
 
 /////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// Appends the element nodes with a binary value, in document order
+  void find_binary_nodes( rapidxml::xml_node<>* node, std::vector< rapidxml::xml_node<>* >& found )
+  {
+    if( node->type() == rapidxml::node_element && is_not_null(node->first_attribute( Protocol::Tags::attr_encoding() )) )
+      found.push_back(node);
+
+    for( rapidxml::xml_node<>* child = node->first_node() ; is_not_null(child) ; child = child->next_sibling() )
+      find_binary_nodes(child, found);
+  }
+
+  /// Size of the attachment of a node, as written in its attribute
+  std::size_t attachment_size( rapidxml::xml_node<>* node )
+  {
+    rapidxml::xml_attribute<>* attr = node->first_attribute( Protocol::Tags::attr_attachment() );
+
+    if( is_null(attr) )
+      throw XmlError(FromHere(), "Binary node [" + std::string(node->name()) + "] does not give the size of its attachment.");
+
+    try
+    {
+      return boost::lexical_cast<std::size_t>( attr->value() );
+    }
+    catch( boost::bad_lexical_cast& )
+    {
+      throw XmlError(FromHere(), "Binary node [" + std::string(node->name()) + "] gives an invalid attachment size ["
+                     + std::string(attr->value()) + "].");
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 boost::shared_ptr<XmlDoc> parse_string ( const std::string& str )
 {
   return parse_cstring(str.c_str(), str.length());
@@ -117,6 +157,79 @@ void to_string ( const XmlNode& node, std::string& str )
   rapidxml::print(std::back_inserter(str), *node.content);
 }
 
+void to_string ( const XmlNode& node, std::string& str, std::string& attachments )
+{
+  cf3_assert( node.is_valid() );
+
+  std::vector< rapidxml::xml_node<>* > binary_nodes;
+  detail::find_binary_nodes( node.content, binary_nodes );
+
+  attachments.clear();
+
+  // move the values out of the way while the text is written
+  std::vector< std::pair<char*, std::size_t> > values( binary_nodes.size() );
+  for( Uint i = 0 ; i < binary_nodes.size() ; ++i )
+  {
+    rapidxml::xml_node<>* binary_node = binary_nodes[i];
+    values[i] = std::make_pair( binary_node->value(), binary_node->value_size() );
+    attachments.append( values[i].first, values[i].second );
+
+    XmlNode( binary_node ).set_attribute( Protocol::Tags::attr_attachment(), to_str( Uint(values[i].second) ) );
+    binary_node->value( "", 0 );
+  }
+
+  to_string( node, str );
+
+  for( Uint i = 0 ; i < binary_nodes.size() ; ++i )
+    binary_nodes[i]->value( values[i].first, values[i].second );
+}
+
+std::size_t attachments_size ( const XmlNode& node )
+{
+  cf3_assert( node.is_valid() );
+
+  std::vector< rapidxml::xml_node<>* > binary_nodes;
+  detail::find_binary_nodes( node.content, binary_nodes );
+
+  std::size_t size = 0;
+  for( Uint i = 0 ; i < binary_nodes.size() ; ++i )
+    size += detail::attachment_size( binary_nodes[i] );
+
+  return size;
+}
+
+void read_attachments ( XmlNode& node, const char * attachments, std::size_t size )
+{
+  cf3_assert( node.is_valid() );
+
+  std::vector< rapidxml::xml_node<>* > binary_nodes;
+  detail::find_binary_nodes( node.content, binary_nodes );
+
+  std::size_t offset = 0;
+  for( Uint i = 0 ; i < binary_nodes.size() ; ++i )
+  {
+    rapidxml::xml_node<>* binary_node = binary_nodes[i];
+    const std::size_t value_size = detail::attachment_size( binary_node );
+
+    // the size comes from the document, compare it with what is left so it cannot overflow
+    if( value_size > size - offset )
+      throw XmlError(FromHere(), "Attachments are too short: an attachment of " + boost::lexical_cast<std::string>( value_size ) + " bytes starts at byte "
+                     + to_str( Uint(offset) ) + " of " + to_str( Uint(size) ) + ".");
+
+    // allocate_string() measures the source when the size is zero
+    if( value_size == 0 )
+      binary_node->value( "", 0 );
+    else
+      binary_node->value( binary_node->document()->allocate_string( attachments + offset, value_size ), value_size );
+
+    offset += value_size;
+  }
+
+  if( offset != size )
+    throw XmlError(FromHere(), "Attachments contain " + to_str( Uint(size) ) + " bytes, while the document refers to "
+                   + to_str( Uint(offset) ) + ".");
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 } // XML
@@ -46,6 +46,29 @@ void to_file ( const XmlNode& node, const URI& fpath);
 /// @param node The node to write.
 void to_string ( const XmlNode& node, std::string& str );
 
+/// Writes the provided XML node to a string, leaving out the binary values.
+/// Nodes with a binary value are recognized by their
+/// @c Protocol::Tags::attr_encoding() attribute. Their values are appended to
+/// @c attachments, in document order, and the number of bytes taken by each of
+/// them is stored in its @c Protocol::Tags::attr_attachment() attribute.
+/// @param node The node to write.
+/// @param str The string to which the node has to be written.
+/// @param attachments The string to which the binary values are written.
+void to_string ( const XmlNode& node, std::string& str, std::string& attachments );
+
+/// Gives the number of bytes of attachments that follow a document written
+/// by the three-argument version of @c to_string.
+/// @param node The node that was written.
+std::size_t attachments_size ( const XmlNode& node );
+
+/// Restores the binary values left out by the three-argument version of
+/// @c to_string. The values are copied to the memory of the document.
+/// @param node The node that was written.
+/// @param attachments The attachments that followed the text.
+/// @param size Number of bytes in @c attachments. Must match
+/// @c attachments_size(node).
+void read_attachments ( XmlNode& node, const char * attachments, std::size_t size );
+
 } // XML
 } // common
 } // cf3
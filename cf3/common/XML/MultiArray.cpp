@@ -4,7 +4,15 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cstring>
+
 #include <boost/algorithm/string.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/range/as_literal.hpp>
 #include <boost/tokenizer.hpp>
@@ -30,6 +38,49 @@ namespace XML {
 
 ////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// Binary data is little-endian, whatever the platform
+  bool is_little_endian()
+  {
+    const Uint one = 1;
+    return *reinterpret_cast<const char*>(&one) == 1;
+  }
+
+  /// Appends the little-endian representation of a value
+  void append_binary(std::string & str, const Real value)
+  {
+    const char * bytes = reinterpret_cast<const char*>(&value);
+
+    if( is_little_endian() )
+      str.append(bytes, sizeof(Real));
+    else
+    {
+      const std::string big_endian(bytes, sizeof(Real));
+      str.append(big_endian.rbegin(), big_endian.rend());
+    }
+  }
+
+  /// Reads a value from its little-endian representation
+  Real read_binary(const char * bytes)
+  {
+    Real value;
+    char * value_bytes = reinterpret_cast<char*>(&value);
+
+    if( is_little_endian() )
+      std::memcpy(value_bytes, bytes, sizeof(Real));
+    else
+      std::reverse_copy(bytes, bytes + sizeof(Real), value_bytes);
+
+    return value;
+  }
+
+  const char * encoding_binary() { return "binary"; }
+  const char * encoding_zlib() { return "zlib"; }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 XmlNode add_multi_array_in( Map & map, const std::string & name,
                             const boost::multi_array<Real, 2> & array,
                             const std::string & delimiter,
@@ -83,6 +134,64 @@ XmlNode add_multi_array_in( Map & map, const std::string & name,
 
 ////////////////////////////////////////////////////////////////////////////
 
+XmlNode add_binary_multi_array_in( Map & map, const std::string & name,
+                                   const boost::multi_array<Real, 2> & array,
+                                   const std::vector<std::string> & labels,
+                                   bool compress,
+                                   Uint first_row )
+{
+  cf3_assert( map.content.is_valid() );
+  cf3_assert( !name.empty())
+  cf3_assert( !map.check_entry(name) );
+
+  const std::string delimiter(";"); // only used by the labels
+
+  XmlNode array_node =  map.content.add_node( Protocol::Tags::node_array() );
+
+  array_node.add_node( common::class_name<std::string>(), boost::algorithm::join(labels, delimiter) );
+
+  XmlNode data_node = array_node.add_node( common::class_name<Real>() );
+
+  const Uint nb_rows = first_row < array.size() ? array.size() - first_row : 0;
+  const Uint nb_cols = array.size() != 0 ? array[0].size() : 0;
+
+  array_node.set_attribute( Protocol::Tags::attr_key(), name );
+
+  data_node.set_attribute( "dimensions", to_str((Uint)array.dimensionality) );
+  data_node.set_attribute( Protocol::Tags::attr_array_delimiter(), delimiter );
+  data_node.set_attribute( Protocol::Tags::attr_array_size(), to_str(nb_rows) + ':' + to_str(nb_cols) );
+  data_node.set_attribute( Protocol::Tags::attr_encoding(), compress ? detail::encoding_zlib() : detail::encoding_binary() );
+
+  std::string raw;
+  raw.reserve( nb_rows * nb_cols * sizeof(Real) );
+
+  for(Uint row = first_row ; row < first_row + nb_rows ; ++row)
+  {
+    for(Uint col = 0 ; col < nb_cols ; ++col)
+      detail::append_binary( raw, array[row][col] );
+  }
+
+  std::string compressed;
+  if( compress )
+  {
+    boost::iostreams::filtering_ostream compressed_stream;
+    compressed_stream.push( boost::iostreams::zlib_compressor() );
+    compressed_stream.push( boost::iostreams::back_inserter(compressed) );
+    compressed_stream.write( raw.data(), raw.size() );
+    compressed_stream.reset(); // flushes the compressor
+  }
+
+  const std::string & value = compress ? compressed : raw;
+
+  // the value is binary: its size is given explicitly since it is not null-terminated
+  if( !value.empty() )
+    data_node.content->value( data_node.content->document()->allocate_string(value.data(), value.size()), value.size() );
+
+  return array_node;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void get_multi_array( const Map & map, const std::string & name,
                           boost::multi_array<Real, 2> & array,
                           std::vector<std::string> & labels )
@@ -146,6 +255,49 @@ void get_multi_array( const Map & map, const std::string & name,
   // 2. Fill the multi-array
   //
 
+  // 2a. binary values
+  attr = data_node.content->first_attribute( Protocol::Tags::attr_encoding() );
+
+  if( is_not_null(attr) )
+  {
+    const std::string encoding( attr->value() );
+    std::string raw;
+
+    if( encoding == detail::encoding_zlib() )
+    {
+      try
+      {
+        boost::iostreams::filtering_istream compressed_stream;
+        compressed_stream.push( boost::iostreams::zlib_decompressor() );
+        compressed_stream.push( boost::iostreams::array_source(data_node.content->value(), data_node.content->value_size()) );
+        boost::iostreams::copy( compressed_stream, boost::iostreams::back_inserter(raw) );
+      }
+      catch(boost::iostreams::zlib_error & e)
+      {
+        throw XmlError(FromHere(), "Could not decompress the data of multi-array [" + name + "]: " + e.what());
+      }
+    }
+    else if( encoding == detail::encoding_binary() )
+      raw.assign( data_node.content->value(), data_node.content->value_size() );
+    else
+      throw XmlError(FromHere(), "Unknown encoding [" + encoding + "] for multi-array [" + name + "].");
+
+    if( raw.size() != sizes[0] * sizes[1] * sizeof(Real) )
+      throw XmlError(FromHere(), "Multi-array [" + name + "] has " + to_str(Uint(raw.size())) + " bytes of data, expected "
+                     + to_str(Uint(sizes[0] * sizes[1] * sizeof(Real))) + ".");
+
+    const char * bytes = raw.data();
+    for(Uint row = 0 ; row < sizes[0] ; ++row)
+    {
+      for(Uint col = 0 ; col < sizes[1] ; ++col, bytes += sizeof(Real))
+        array[row][col] = detail::read_binary(bytes);
+    }
+
+    return;
+  }
+
+  // 2b. text values
+
   // the array is written in the XML as a 2D array, with a new line after each
   // row. Thus we first need to tokenize the string on line breaks and then
   // split the line depending on the delimiter and cast each element to Real.
@@ -27,6 +27,19 @@ XmlNode add_multi_array_in(Map & map, const std::string & name,
                            const std::string & delimiter = ";",
                            const std::vector<std::string> & labels = std::vector<std::string>());
 
+/// Adds a multi array in the provided @c Map, with the values stored as raw
+/// little-endian binary data, optionally compressed with zlib. On the network,
+/// the values travel as an attachment of the frame instead of as text.
+/// @param first_row Index of the first row of @c array to add. The rows before
+/// it are left out, so that a table that grows can be sent incrementally.
+XmlNode add_binary_multi_array_in(Map & map, const std::string & name,
+                                  const boost::multi_array<Real, 2> & array,
+                                  const std::vector<std::string> & labels = std::vector<std::string>(),
+                                  bool compress = true,
+                                  Uint first_row = 0);
+
+/// Reads a multi array written by @c add_multi_array_in or
+/// @c add_binary_multi_array_in.
 void get_multi_array(const Map & map, const std::string & name,
                          boost::multi_array<Real, 2> & array,
                          std::vector<std::string> & labels);
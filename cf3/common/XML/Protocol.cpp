@@ -33,6 +33,10 @@ namespace XML {
 
   const char * Protocol::Tags::attr_array_type() { return "type"; }
 
+  const char * Protocol::Tags::attr_encoding() { return "encoding"; }
+
+  const char * Protocol::Tags::attr_attachment() { return "attachment"; }
+
   const char * Protocol::Tags::attr_clientid() { return "clientid"; }
 
   const char * Protocol::Tags::attr_descr() { return "descr"; }
@@ -45,7 +45,12 @@ namespace XML {
       static const char * attr_array_size ();
       /// @returns Returns the name for attribute 'type' of arrays.
       static const char * attr_array_type ();
-
+      /// @returns Returns the name for attribute 'encoding' of nodes with a
+      /// binary value.
+      static const char * attr_encoding ();
+      /// @returns Returns the name for attribute that maintains the size in
+      /// bytes of the attachment holding a binary value on the network.
+      static const char * attr_attachment ();
 
       /// @returns Returns the name for attribute that maintains the client UUID.
       static const char * attr_clientid ();
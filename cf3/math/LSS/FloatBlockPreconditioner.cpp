@@ -0,0 +1,300 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "common/Assertions.hpp"
+#include "common/BasicExceptions.hpp"
+#include "common/StringConversion.hpp"
+
+#include "math/LSS/FloatBlockPreconditioner.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  const Uint no_entry = std::numeric_limits<Uint>::max();
+
+  /// Smallest allowed magnitude of an ILU pivot, relative to the largest entry of its row
+  const float pivot_threshold = 1e-4f;
+
+  /// Dot product of float vectors, accumulated in double
+  double dot(const float* a, const float* b, const Uint n)
+  {
+    double result = 0.;
+    for(Uint i = 0; i != n; ++i)
+      result += a[i]*b[i];
+    return result;
+  }
+
+  /// Orders the entries of a row by column
+  struct ColumnLess
+  {
+    bool operator()(const std::pair<Uint, Real>& a, const std::pair<Uint, Real>& b) const
+    {
+      return a.first < b.first;
+    }
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+FloatBlockPreconditioner::FloatBlockPreconditioner() :
+  m_inner_iterations(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FloatBlockPreconditioner::set_matrix(const std::vector<Uint>& row_starts, const std::vector<Uint>& columns, const std::vector<Real>& values)
+{
+  cf3_assert(!row_starts.empty());
+  cf3_assert(columns.size() == values.size());
+  cf3_assert(row_starts.back() == columns.size());
+
+  const Uint nb_rows = row_starts.size() - 1;
+  m_row_starts = row_starts;
+  m_columns.resize(columns.size());
+  m_values.resize(values.size());
+  m_diagonal.assign(nb_rows, detail::no_entry);
+
+  // Copy the rows with sorted columns, as required by the factorization
+  std::vector< std::pair<Uint, Real> > row;
+  for(Uint i = 0; i != nb_rows; ++i)
+  {
+    row.clear();
+    for(Uint p = row_starts[i]; p != row_starts[i+1]; ++p)
+    {
+      cf3_assert(columns[p] < nb_rows);
+      row.push_back(std::make_pair(columns[p], values[p]));
+    }
+    std::sort(row.begin(), row.end(), detail::ColumnLess());
+    for(Uint p = row_starts[i]; p != row_starts[i+1]; ++p)
+    {
+      m_columns[p] = row[p - row_starts[i]].first;
+      m_values[p] = static_cast<float>(row[p - row_starts[i]].second);
+      if(m_columns[p] == i)
+        m_diagonal[i] = p;
+    }
+    if(m_diagonal[i] == detail::no_entry)
+      throw common::BadValue(FromHere(), "No diagonal entry in row " + common::to_str(i) + " of the preconditioner block");
+  }
+
+  // ILU(0): Gaussian elimination, restricted to the sparsity pattern of the matrix
+  m_factors = m_values;
+  std::vector<Uint> position(nb_rows, detail::no_entry);
+  for(Uint i = 0; i != nb_rows; ++i)
+  {
+    const Uint row_end = m_row_starts[i+1];
+    for(Uint p = m_row_starts[i]; p != row_end; ++p)
+      position[m_columns[p]] = p;
+
+    for(Uint p = m_row_starts[i]; p != m_diagonal[i]; ++p)
+    {
+      const Uint k = m_columns[p];
+      m_factors[p] /= m_factors[m_diagonal[k]];
+      for(Uint q = m_diagonal[k] + 1; q != m_row_starts[k+1]; ++q)
+      {
+        const Uint j_position = position[m_columns[q]];
+        if(j_position != detail::no_entry)
+          m_factors[j_position] -= m_factors[p]*m_factors[q];
+      }
+    }
+
+    // Replace (nearly) zero pivots, which occur for indefinite matrices, by a small value of the scale of the row
+    float row_scale = 0.f;
+    for(Uint p = m_row_starts[i]; p != row_end; ++p)
+      row_scale = std::max(row_scale, std::abs(m_values[p]));
+    const float min_pivot = detail::pivot_threshold*(row_scale == 0.f ? 1.f : row_scale);
+    float& pivot = m_factors[m_diagonal[i]];
+    if(std::abs(pivot) < min_pivot)
+      pivot = pivot < 0.f ? -min_pivot : min_pivot;
+
+    for(Uint p = m_row_starts[i]; p != row_end; ++p)
+      position[m_columns[p]] = detail::no_entry;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FloatBlockPreconditioner::apply(const Real* rhs, Real* result, const Uint nb_inner_iterations, const Real inner_tolerance) const
+{
+  const Uint n = nb_rows();
+
+  // Layout of the work storage: b, x, then the GMRES vectors
+  const Uint work_size = nb_inner_iterations == 0 ? n : (nb_inner_iterations + 5)*n;
+  if(m_work.size() < work_size)
+    m_work.resize(work_size);
+
+  float* b = &m_work[0];
+  for(Uint i = 0; i != n; ++i)
+    b[i] = static_cast<float>(rhs[i]);
+
+  float* x = b;
+  if(nb_inner_iterations == 0)
+  {
+    ilu_solve(b);
+    m_inner_iterations = 0;
+  }
+  else
+  {
+    x = b + n;
+    gmres(b, x, nb_inner_iterations, static_cast<float>(inner_tolerance));
+  }
+
+  for(Uint i = 0; i != n; ++i)
+    result[i] = x[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FloatBlockPreconditioner::multiply(const float* x, float* y) const
+{
+  const Uint n = nb_rows();
+  for(Uint i = 0; i != n; ++i)
+  {
+    float sum = 0.f;
+    for(Uint p = m_row_starts[i]; p != m_row_starts[i+1]; ++p)
+      sum += m_values[p]*x[m_columns[p]];
+    y[i] = sum;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FloatBlockPreconditioner::ilu_solve(float* x) const
+{
+  const Uint n = nb_rows();
+
+  // Forward substitution with the unit lower triangle
+  for(Uint i = 0; i != n; ++i)
+  {
+    float sum = x[i];
+    for(Uint p = m_row_starts[i]; p != m_diagonal[i]; ++p)
+      sum -= m_factors[p]*x[m_columns[p]];
+    x[i] = sum;
+  }
+
+  // Backward substitution with the upper triangle
+  for(Uint i = n; i != 0; --i)
+  {
+    const Uint row = i-1;
+    float sum = x[row];
+    for(Uint p = m_diagonal[row] + 1; p != m_row_starts[row+1]; ++p)
+      sum -= m_factors[p]*x[m_columns[p]];
+    x[row] = sum / m_factors[m_diagonal[row]];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FloatBlockPreconditioner::gmres(const float* b, float* x, const Uint max_iterations, const float tolerance) const
+{
+  const Uint n = nb_rows();
+  const Uint m = max_iterations;
+  float* basis = x + n; // m+1 Krylov vectors
+  float* z = basis + (m+1)*n;
+  float* w = z + n;
+
+  std::fill(x, x + n, 0.f);
+  m_inner_iterations = 0;
+
+  const float beta = static_cast<float>(std::sqrt(detail::dot(b, b, n)));
+  if(beta == 0.f)
+    return;
+
+  // Hessenberg matrix (column major, (m+1) x m), Givens rotations and rotated residual
+  std::vector<float> h((m+1)*m, 0.f);
+  std::vector<float> cs(m, 0.f);
+  std::vector<float> sn(m, 0.f);
+  std::vector<float> g(m+1, 0.f);
+  g[0] = beta;
+
+  for(Uint i = 0; i != n; ++i)
+    basis[i] = b[i] / beta;
+
+  Uint nb_iterations = 0;
+  for(Uint j = 0; j != m; ++j)
+  {
+    // w = A M^-1 v_j
+    std::copy(basis + j*n, basis + (j+1)*n, z);
+    ilu_solve(z);
+    multiply(z, w);
+
+    // Modified Gram-Schmidt
+    float* hj = &h[j*(m+1)];
+    for(Uint i = 0; i <= j; ++i)
+    {
+      const float* vi = basis + i*n;
+      hj[i] = static_cast<float>(detail::dot(w, vi, n));
+      for(Uint k = 0; k != n; ++k)
+        w[k] -= hj[i]*vi[k];
+    }
+    hj[j+1] = static_cast<float>(std::sqrt(detail::dot(w, w, n)));
+    if(hj[j+1] != 0.f)
+    {
+      float* next = basis + (j+1)*n;
+      for(Uint k = 0; k != n; ++k)
+        next[k] = w[k] / hj[j+1];
+    }
+
+    // Apply the previous rotations to the new column, then eliminate its subdiagonal entry
+    for(Uint i = 0; i != j; ++i)
+    {
+      const float tmp = cs[i]*hj[i] + sn[i]*hj[i+1];
+      hj[i+1] = -sn[i]*hj[i] + cs[i]*hj[i+1];
+      hj[i] = tmp;
+    }
+    const float r = std::sqrt(hj[j]*hj[j] + hj[j+1]*hj[j+1]);
+    cs[j] = hj[j] / r;
+    sn[j] = hj[j+1] / r;
+    hj[j] = r;
+    hj[j+1] = 0.f;
+    g[j+1] = -sn[j]*g[j];
+    g[j] = cs[j]*g[j];
+
+    nb_iterations = j+1;
+    if(std::abs(g[j+1]) <= tolerance*beta || sn[j] == 0.f)
+      break;
+  }
+
+  // Solve the triangular system for the Krylov coefficients, in place in g
+  for(Uint i = nb_iterations; i != 0; --i)
+  {
+    const Uint row = i-1;
+    float sum = g[row];
+    for(Uint k = row+1; k != nb_iterations; ++k)
+      sum -= h[k*(m+1) + row]*g[k];
+    g[row] = sum / h[row*(m+1) + row];
+  }
+
+  // x = M^-1 V y
+  std::fill(z, z + n, 0.f);
+  for(Uint i = 0; i != nb_iterations; ++i)
+  {
+    const float* vi = basis + i*n;
+    for(Uint k = 0; k != n; ++k)
+      z[k] += g[i]*vi[k];
+  }
+  ilu_solve(z);
+  std::copy(z, z + n, x);
+
+  m_inner_iterations = nb_iterations;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // LSS
+} // math
+} // cf3
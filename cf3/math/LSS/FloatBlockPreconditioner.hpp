@@ -0,0 +1,88 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_math_LSS_FloatBlockPreconditioner_hpp
+#define cf3_math_LSS_FloatBlockPreconditioner_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "math/LSS/LibLSS.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Single precision preconditioner for the block of a matrix that is local to a rank.
+/// The block is stored in CRS format as float, together with its ILU(0) factorization,
+/// halving the memory traffic of a double precision preconditioner. Applying it either
+/// performs the triangular solves with the ILU factors, or a few iterations of
+/// ILU-preconditioned GMRES on the local block, all in single precision.
+/// The interface is in double precision, so it can serve as the (variable) preconditioner of
+/// a double precision flexible Krylov method.
+class LSS_API FloatBlockPreconditioner
+{
+public:
+  FloatBlockPreconditioner();
+
+  /// Store the block and compute its ILU(0) factorization. Pivots that are (nearly) zero
+  /// are replaced by a small value, so the factorization also exists for indefinite blocks.
+  /// @param row_starts Start of each row in columns and values, with nb_rows+1 entries
+  /// @param columns Column indices, which must be smaller than the number of rows
+  /// @param values Matrix values, converted to float
+  /// @throws common::BadValue if a diagonal entry is missing
+  void set_matrix(const std::vector<Uint>& row_starts, const std::vector<Uint>& columns, const std::vector<Real>& values);
+
+  /// Apply the preconditioner, i.e. compute an approximate solution of block*result = rhs
+  /// @param nb_inner_iterations If zero, only the ILU factors are applied. Otherwise the maximum number of GMRES iterations
+  /// @param inner_tolerance Relative residual reduction at which the inner GMRES stops
+  void apply(const Real* rhs, Real* result, const Uint nb_inner_iterations = 0, const Real inner_tolerance = 1e-2) const;
+
+  /// Number of rows of the block
+  Uint nb_rows() const { return m_row_starts.empty() ? 0 : m_row_starts.size() - 1; }
+
+  /// Number of iterations of the last inner GMRES solve
+  Uint inner_iterations() const { return m_inner_iterations; }
+
+private:
+  /// y = A*x in single precision
+  void multiply(const float* x, float* y) const;
+
+  /// Solve L*U*x = b in place
+  void ilu_solve(float* x) const;
+
+  /// Up to max_iterations of right-preconditioned GMRES, starting from a zero initial guess
+  void gmres(const float* b, float* x, const Uint max_iterations, const float tolerance) const;
+
+  std::vector<Uint> m_row_starts;
+  std::vector<Uint> m_columns;
+  std::vector<float> m_values;
+
+  /// ILU(0) factors, sharing the sparsity of the matrix. L has a unit diagonal that is not stored
+  std::vector<float> m_factors;
+
+  /// Position of the diagonal entry in each row
+  std::vector<Uint> m_diagonal;
+
+  /// Work storage for the inner GMRES
+  mutable std::vector<float> m_work;
+  mutable Uint m_inner_iterations;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // LSS
+} // math
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_math_LSS_FloatBlockPreconditioner_hpp
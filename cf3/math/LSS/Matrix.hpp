@@ -91,6 +91,14 @@ public:
   /// eigen, templatization on top level
   virtual void add_values(const BlockAccumulator& values) = 0;
 
+  /// Add the values of an element matrix. Matrices that support it cache the positions of the
+  /// entries in their storage for each element, so repeated assembly on the same sparsity
+  /// pattern does not need to search the rows. The cache is dropped when the matrix is created again.
+  /// @param values element matrix, with the element nodes as indices
+  /// @param elements component holding the element, used as cache key
+  /// @param element_idx index of the element in elements
+  virtual void add_element_values(const BlockAccumulator& values, const common::Component& elements, const Uint element_idx) { add_values(values); }
+
   /// Add a list of values
   virtual void get_values(BlockAccumulator& values) = 0;
 
@@ -107,6 +115,21 @@ public:
   /// @warning Structural symmetry is not checked, incorrect results will appear if you use this on a non structurally symmetric matrix
   virtual void symmetric_dirichlet(const Uint blockrow, const Uint ieq, const Real value, LSS::Vector& rhs) = 0;
 
+  /// Apply a set of symmetric dirichlet boundary conditions at once. Matrices that support it keep
+  /// the modified positions for the given set of equations, so applying the same set again only updates values.
+  /// The default implementation applies the conditions one by one.
+  /// @param dofs equations to fix, numbered as blockrow*neq+ieq
+  /// @param values value for each equation in dofs
+  /// @pre The matrix must be structurally symmetric
+  virtual void symmetric_dirichlet_batch(const std::vector<Uint>& dofs, const std::vector<Real>& values, LSS::Vector& rhs)
+  {
+    cf3_assert(dofs.size() == values.size());
+    const Uint nb_eqs = neq();
+    const Uint nb_dofs = dofs.size();
+    for(Uint i = 0; i != nb_dofs; ++i)
+      symmetric_dirichlet(dofs[i] / nb_eqs, dofs[i] % nb_eqs, values[i], rhs);
+  }
+
   /// Add one line to another and tie to it via dirichlet-style (applying periodicity)
   virtual void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from) = 0;
 
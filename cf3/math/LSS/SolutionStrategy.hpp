@@ -56,6 +56,9 @@ public:
 
   virtual Real compute_residual() = 0;
 
+  /// Number of iterations of the last solve, or zero if the strategy does not keep track of it
+  virtual Uint iterations() const { return 0; }
+
 }; // end of class SolutionStrategy
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -4,10 +4,13 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 #include "common/Builder.hpp"
 
+#include "math/Consts.hpp"
 #include "math/LSS/System.hpp"
 
 #include "SolveLSS.hpp"
@@ -18,12 +21,27 @@ namespace LSS {
 
 using namespace common;
 
+namespace detail
+{
+  /// Polynomial extrapolation coefficients for equally spaced solutions, most recent solution first.
+  /// Row n-1 is used when n solutions are available
+  const Real extrapolation_coefficients[3][3] =
+  {
+    { 1.,  0., 0. },
+    { 2., -1., 0. },
+    { 3., -3., 1. }
+  };
+
+  const Uint max_history_size = 3;
+}
+
 common::ComponentBuilder < SolveLSS, common::Action, LibLSS > SolveLSS_Builder;
 
 ////////////////////////////////////////////////////////////////////////////////
 
 SolveLSS::SolveLSS( const std::string& name  ) :
-  Action ( name )
+  Action ( name ),
+  m_history_step(math::Consts::uint_max())
 {
   mark_basic();
 
@@ -37,6 +55,20 @@ SolveLSS::SolveLSS( const std::string& name  ) :
       .pretty_name("LSS")
       .mark_basic()
       .link_to(&m_lss);
+
+  options().add("history_size", 0u)
+      .description("Number of previous solutions used to extrapolate the initial guess. "
+                   "0 uses the solution vector as is, 1 starts from the previous solution, "
+                   "2 and 3 use linear and quadratic extrapolation")
+      .pretty_name("History Size");
+
+  options().add("step", math::Consts::uint_max())
+      .description("Index of the time step the system is solved for. With history_size, only the first solve "
+                   "of a step is extrapolated, and the last solve of a step is stored. "
+                   "If not set, each execution is a new time step")
+      .pretty_name("Step");
+
+  properties().add("iterations", 0u);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,7 +83,77 @@ void SolveLSS::execute ()
   if(!lss.is_created())
     throw SetupError(FromHere(), "LSS at " + lss.uri().string() + " is not created!");
 
+  const Uint history_size = std::min(options().value<Uint>("history_size"), detail::max_history_size);
+  const Uint step = options().value<Uint>("step");
+  const bool step_is_set = step != math::Consts::uint_max();
+  const bool same_step = step_is_set && !m_solution_history.empty() && step == m_history_step;
+
+  if(history_size == 0)
+  {
+    m_solution_history.clear();
+  }
+  else if(!same_step)
+  {
+    // The extrapolation assumes consecutive steps, so start over after a jump in steps, e.g. on restart
+    if(step_is_set && !m_solution_history.empty() && step != m_history_step+1)
+      m_solution_history.clear();
+    extrapolate_solution(lss, history_size);
+  }
+
   lss.solve();
+  properties().set("iterations", lss.solution_strategy()->iterations());
+
+  if(history_size != 0)
+  {
+    store_solution(lss, same_step);
+    m_history_step = step;
+    while(m_solution_history.size() > history_size)
+      m_solution_history.pop_front();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SolveLSS::extrapolate_solution(LSS::System& lss, const Uint history_size)
+{
+  LSS::Vector& solution = *lss.solution();
+  const Uint nb_rows = solution.blockrow_size();
+  const Uint neq = solution.neq();
+
+  // Start over if the system was recreated with a different size
+  if(!m_solution_history.empty() && (m_solution_history.back().shape()[0] != nb_rows || m_solution_history.back().shape()[1] != neq))
+    m_solution_history.clear();
+
+  if(m_solution_history.empty())
+    return;
+
+  const Uint nb_solutions = std::min(static_cast<Uint>(m_solution_history.size()), history_size);
+  const Real* coefficients = detail::extrapolation_coefficients[nb_solutions-1];
+
+  m_initial_guess.resize(boost::extents[nb_rows][neq]);
+  for(Uint i = 0; i != nb_rows; ++i)
+  {
+    for(Uint j = 0; j != neq; ++j)
+    {
+      Real value = 0.;
+      for(Uint k = 0; k != nb_solutions; ++k)
+        value += coefficients[k] * m_solution_history[m_solution_history.size()-1-k][i][j];
+      m_initial_guess[i][j] = value;
+    }
+  }
+
+  solution.set(m_initial_guess);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SolveLSS::store_solution(LSS::System& lss, const bool same_step)
+{
+  LSS::Vector& solution = *lss.solution();
+  if(same_step)
+    m_solution_history.pop_back();
+  m_solution_history.push_back(boost::multi_array<Real, 2>(boost::extents[solution.blockrow_size()][solution.neq()]));
+  solution.get(m_solution_history.back());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
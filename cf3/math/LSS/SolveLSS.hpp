@@ -9,6 +9,10 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <deque>
+
+#include <boost/multi_array.hpp>
+
 #include "common/Action.hpp"
 
 #include "LibLSS.hpp"
@@ -22,6 +26,13 @@ class System;
 ////////////////////////////////////////////////////////////////////////////////
 
 /// SolveLSS wraps a linear system math in an action that will execute the solve
+///
+/// If the option history_size is set, the solutions of the last time steps are kept, and the
+/// initial guess for the first solve of a time step is extrapolated from them, assuming they are
+/// equally spaced in time. The time step is given by the option "step". Later solves in the same step,
+/// e.g. in an inner loop, start from the solution vector as is, and the last of them is kept as the
+/// solution of the step. If "step" is not set, each execution counts as a new time step.
+/// The number of iterations of the last solve is stored in the property "iterations".
 /// @author Bart Janssens
 class LSS_API SolveLSS : public common::Action
 {
@@ -38,7 +49,20 @@ public: // functions
   void execute();
 
 private:
+  /// Overwrite the solution vector with the extrapolation of at most history_size stored solutions
+  void extrapolate_solution(LSS::System& lss, const Uint history_size);
+
+  /// Add the solution vector to the stored solutions, replacing the last one if it is from the same step
+  void store_solution(LSS::System& lss, const bool same_step);
+
   Handle<math::LSS::System> m_lss;
+
+  /// Previous solutions, the most recent one last
+  std::deque< boost::multi_array<Real, 2> > m_solution_history;
+
+  /// Time step of the most recent stored solution
+  Uint m_history_step;
+  boost::multi_array<Real, 2> m_initial_guess;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
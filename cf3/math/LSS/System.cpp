@@ -48,7 +48,8 @@ using namespace cf3::math;
 common::ComponentBuilder < LSS::System, LSS::System, LSS::LibLSS > System_Builder;
 
 LSS::System::System(const std::string& name) :
-  Component(name)
+  Component(name),
+  m_dirichlet_batch_depth(0)
 {
   options().add( "matrix_builder" , "cf3.math.LSS.TrilinosFEVbrMatrix")
     .pretty_name("Matrix Builder")
@@ -197,6 +198,7 @@ void LSS::System::destroy()
 void LSS::System::solve()
 {
   cf3_assert(is_created());
+  cf3_assert(m_dirichlet_batch_depth == 0);
   m_solution_strategy->solve();
 }
 
@@ -236,7 +238,12 @@ void LSS::System::dirichlet(const Uint iblockrow, const Uint ieq, const Real val
 {
   cf3_assert(is_created());
 
-  if (preserve_symmetry)
+  if (preserve_symmetry && m_dirichlet_batch_depth != 0)
+  {
+    m_dirichlet_dofs.push_back(iblockrow*m_mat->neq()+ieq);
+    m_dirichlet_values.push_back(value);
+  }
+  else if (preserve_symmetry)
   {
     m_mat->symmetric_dirichlet(iblockrow, ieq, value, *m_rhs);
   }
@@ -251,6 +258,31 @@ void LSS::System::dirichlet(const Uint iblockrow, const Uint ieq, const Real val
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+void LSS::System::begin_dirichlet_batch()
+{
+  ++m_dirichlet_batch_depth;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void LSS::System::end_dirichlet_batch()
+{
+  cf3_assert(m_dirichlet_batch_depth != 0);
+  if (--m_dirichlet_batch_depth != 0)
+    return;
+
+  if (!m_dirichlet_dofs.empty())
+  {
+    cf3_assert(is_created());
+    m_mat->symmetric_dirichlet_batch(m_dirichlet_dofs, m_dirichlet_values, *m_rhs);
+  }
+
+  m_dirichlet_dofs.clear();
+  m_dirichlet_values.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void LSS::System::periodicity (const Uint iblockrow_to, const Uint iblockrow_from)
 {
   cf3_assert(is_created());
@@ -110,6 +110,13 @@ public:
   /// When preserve_symmetry is true than blockrow*numequations+eq column is is zeroed by moving it to the right hand side (however this usually results in performance penalties).
   void dirichlet(const Uint iblockrow, const Uint ieq, const Real value, const bool preserve_symmetry=false);
 
+  /// Start collecting the symmetric dirichlet conditions instead of applying them one by one.
+  /// The solution is still set immediately. Calls may be nested.
+  void begin_dirichlet_batch();
+
+  /// Apply the symmetric dirichlet conditions collected since the matching begin_dirichlet_batch, in a single call to the matrix
+  void end_dirichlet_batch();
+
   /// Applying periodicity by adding one line to another and dirichlet-style fixing it to
   /// Note that prerequisite for this is to work that the matrix sparsity should be compatible (same nonzero pattern for the two block rows).
   /// Note that only structural symmetry can be preserved (again, if sparsity input was symmetric).
@@ -185,6 +192,15 @@ private:
   /// Strategy for the solution
   Handle<LSS::SolutionStrategy> m_solution_strategy;
 
+  /// Number of open dirichlet batches
+  Uint m_dirichlet_batch_depth;
+
+  /// Collected symmetric dirichlet conditions, as blockrow*neq+ieq
+  std::vector<Uint> m_dirichlet_dofs;
+
+  /// Values of the collected symmetric dirichlet conditions
+  std::vector<Real> m_dirichlet_values;
+
 }; // end of class System
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -294,6 +294,13 @@ Real ConstantPoissonStrategy::compute_residual()
   return m_implementation->compute_residual();
 }
 
+Uint ConstantPoissonStrategy::iterations() const
+{
+  if(is_null(m_implementation->m_solver.get()))
+    return 0;
+  return m_implementation->m_solver->getNumIters();
+}
+
 void ConstantPoissonStrategy::set_rhs(const Handle< Vector >& rhs)
 {
   m_implementation->m_rhs = Handle<TrilinosVector>(rhs);
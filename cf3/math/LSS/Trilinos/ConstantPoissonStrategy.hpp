@@ -40,6 +40,9 @@ public:
   void solve();
   Real compute_residual();
 
+  /// Number of iterations of the last solve
+  Uint iterations() const;
+
 private:
   void on_parameters_changed_event(common::SignalArgs& args);
   /// Hide the implementation to avoid pulling in lots of Trilinos headers
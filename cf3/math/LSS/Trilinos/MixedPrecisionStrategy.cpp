@@ -0,0 +1,357 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <boost/bind.hpp>
+
+#include "Epetra_CrsMatrix.h"
+#include "Epetra_Vector.h"
+
+#include "Teuchos_RCP.hpp"
+
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+
+#include "math/LSS/FloatBlockPreconditioner.hpp"
+
+#include "TrilinosVector.hpp"
+#include "TrilinosCrsMatrix.hpp"
+#include "MixedPrecisionStrategy.hpp"
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+common::ComponentBuilder<MixedPrecisionStrategy, SolutionStrategy, LibLSS> MixedPrecisionStrategy_builder;
+
+struct MixedPrecisionStrategy::Implementation
+{
+  Implementation(common::Component& self) :
+    m_self(self),
+    m_nb_factorizations(0),
+    m_iterations(0)
+  {
+  }
+
+  void check_setup()
+  {
+    if(is_null(m_matrix))
+      throw common::SetupError(FromHere(), "Null or unsupported matrix for " + m_self.uri().path() + ", only TrilinosCrsMatrix is supported");
+
+    if(is_null(m_rhs))
+      throw common::SetupError(FromHere(), "Null RHS for " + m_self.uri().path());
+
+    if(is_null(m_solution))
+      throw common::SetupError(FromHere(), "Null solution vector for " + m_self.uri().path());
+  }
+
+  /// Find the entries of the matrix that couple the rows of this rank, i.e. the block the preconditioner works on
+  void setup_block_pattern(const Epetra_CrsMatrix& matrix)
+  {
+    const Epetra_Map& row_map = matrix.RowMap();
+    const Epetra_Map& col_map = matrix.ColMap();
+    const int nb_rows = matrix.NumMyRows();
+
+    int* row_offsets;
+    int* column_indices;
+    double* crs_values;
+    TRILINOS_THROW(matrix.ExtractCrsDataPointers(row_offsets, column_indices, crs_values));
+
+    m_block_row_starts.assign(1, 0);
+    m_block_row_starts.reserve(nb_rows+1);
+    m_block_columns.clear();
+    m_block_positions.clear();
+    for(int i = 0; i != nb_rows; ++i)
+    {
+      for(int p = row_offsets[i]; p != row_offsets[i+1]; ++p)
+      {
+        const int local_row = row_map.LID(col_map.GID(column_indices[p]));
+        if(local_row >= 0)
+        {
+          m_block_columns.push_back(local_row);
+          m_block_positions.push_back(p);
+        }
+      }
+      m_block_row_starts.push_back(m_block_columns.size());
+    }
+    m_block_values.clear();
+  }
+
+  /// Copy the block of the matrix into the preconditioner and factorize it, unless the values are the same as for the previous solve
+  void setup_preconditioner(const Teuchos::RCP<Epetra_CrsMatrix const>& matrix)
+  {
+    if(matrix.get() != m_block_matrix.get())
+    {
+      setup_block_pattern(*matrix);
+      m_block_matrix = matrix;
+    }
+
+    int* row_offsets;
+    int* column_indices;
+    double* crs_values;
+    TRILINOS_THROW(matrix->ExtractCrsDataPointers(row_offsets, column_indices, crs_values));
+
+    const Uint nb_entries = m_block_positions.size();
+    std::vector<Real> values(nb_entries);
+    for(Uint i = 0; i != nb_entries; ++i)
+      values[i] = crs_values[m_block_positions[i]];
+
+    if(values == m_block_values && m_preconditioner.nb_rows() == m_block_row_starts.size() - 1)
+      return;
+
+    m_preconditioner.set_matrix(m_block_row_starts, m_block_columns, values);
+    m_block_values.swap(values);
+    ++m_nb_factorizations;
+  }
+
+  /// Allocate the Krylov vectors, unless they are still valid for the given map
+  void allocate_vectors(const Epetra_Map& map, const Uint krylov_size)
+  {
+    if(m_basis.size() == krylov_size+1 && m_basis.front()->Map().SameAs(map))
+      return;
+
+    m_basis.resize(krylov_size+1);
+    m_preconditioned.resize(krylov_size);
+    for(Uint i = 0; i != krylov_size+1; ++i)
+      m_basis[i] = Teuchos::rcp(new Epetra_Vector(map));
+    for(Uint i = 0; i != krylov_size; ++i)
+      m_preconditioned[i] = Teuchos::rcp(new Epetra_Vector(map));
+    m_residual = Teuchos::rcp(new Epetra_Vector(map));
+  }
+
+  /// residual = rhs - matrix*solution, returning its norm
+  Real residual(const Epetra_CrsMatrix& matrix, const Epetra_Vector& rhs, const Epetra_Vector& solution)
+  {
+    TRILINOS_THROW(matrix.Multiply(false, solution, *m_residual));
+    TRILINOS_THROW(m_residual->Update(1., rhs, -1.));
+    Real norm;
+    TRILINOS_THROW(m_residual->Norm2(&norm));
+    return norm;
+  }
+
+  void solve()
+  {
+    check_setup();
+
+    const Uint krylov_size = m_self.options().value<Uint>("krylov_size");
+    const Uint max_iterations = m_self.options().value<Uint>("max_iterations");
+    const Real tolerance = m_self.options().value<Real>("tolerance");
+    const Uint inner_iterations = m_self.options().value<Uint>("inner_iterations");
+    const Real inner_tolerance = m_self.options().value<Real>("inner_tolerance");
+
+    const Teuchos::RCP<Epetra_CrsMatrix const> matrix_ptr = m_matrix->epetra_matrix();
+    const Epetra_CrsMatrix& matrix = *matrix_ptr;
+    const Epetra_Map& map = matrix.RowMap();
+
+    // The rows of this rank come first in the LSS vectors
+    Epetra_Vector rhs(View, map, m_rhs->epetra_vector()->Values());
+    Epetra_Vector solution(View, map, m_solution->epetra_vector()->Values());
+
+    setup_preconditioner(matrix_ptr);
+    allocate_vectors(map, krylov_size);
+
+    m_iterations = 0;
+    Real rhs_norm;
+    TRILINOS_THROW(rhs.Norm2(&rhs_norm));
+    if(rhs_norm == 0.)
+    {
+      TRILINOS_THROW(solution.PutScalar(0.));
+      return;
+    }
+    const Real abs_tolerance = tolerance*rhs_norm;
+
+    // Hessenberg matrix (column major), Givens rotations and rotated residual
+    std::vector<Real> h((krylov_size+1)*krylov_size);
+    std::vector<Real> cs(krylov_size);
+    std::vector<Real> sn(krylov_size);
+    std::vector<Real> g(krylov_size+1);
+
+    Real beta = residual(matrix, rhs, solution);
+    while(beta > abs_tolerance && m_iterations < max_iterations)
+    {
+      TRILINOS_THROW(m_basis[0]->Scale(1./beta, *m_residual));
+      std::fill(g.begin(), g.end(), 0.);
+      g[0] = beta;
+
+      Uint nb_krylov = 0;
+      for(Uint j = 0; j != krylov_size && m_iterations < max_iterations; ++j)
+      {
+        // The preconditioner only sees the local rows, so it is applied directly to the vector values
+        m_preconditioner.apply(m_basis[j]->Values(), m_preconditioned[j]->Values(), inner_iterations, inner_tolerance);
+        Epetra_Vector& w = *m_basis[j+1];
+        TRILINOS_THROW(matrix.Multiply(false, *m_preconditioned[j], w));
+
+        // Modified Gram-Schmidt
+        Real* hj = &h[j*(krylov_size+1)];
+        for(Uint i = 0; i <= j; ++i)
+        {
+          TRILINOS_THROW(w.Dot(*m_basis[i], &hj[i]));
+          TRILINOS_THROW(w.Update(-hj[i], *m_basis[i], 1.));
+        }
+        TRILINOS_THROW(w.Norm2(&hj[j+1]));
+        if(hj[j+1] != 0.)
+          TRILINOS_THROW(w.Scale(1./hj[j+1]));
+
+        for(Uint i = 0; i != j; ++i)
+        {
+          const Real tmp = cs[i]*hj[i] + sn[i]*hj[i+1];
+          hj[i+1] = -sn[i]*hj[i] + cs[i]*hj[i+1];
+          hj[i] = tmp;
+        }
+        const Real r = std::sqrt(hj[j]*hj[j] + hj[j+1]*hj[j+1]);
+        cs[j] = hj[j] / r;
+        sn[j] = hj[j+1] / r;
+        hj[j] = r;
+        hj[j+1] = 0.;
+        g[j+1] = -sn[j]*g[j];
+        g[j] = cs[j]*g[j];
+
+        ++m_iterations;
+        nb_krylov = j+1;
+        if(std::abs(g[j+1]) <= abs_tolerance || sn[j] == 0.)
+          break;
+      }
+
+      // Update the solution with the preconditioned basis vectors, which is what makes the method flexible
+      for(Uint i = nb_krylov; i != 0; --i)
+      {
+        const Uint row = i-1;
+        Real sum = g[row];
+        for(Uint k = row+1; k != nb_krylov; ++k)
+          sum -= h[k*(krylov_size+1) + row]*g[k];
+        g[row] = sum / h[row*(krylov_size+1) + row];
+      }
+      for(Uint i = 0; i != nb_krylov; ++i)
+        TRILINOS_THROW(solution.Update(g[i], *m_preconditioned[i], 1.));
+
+      beta = residual(matrix, rhs, solution);
+    }
+
+    if(m_self.options().value<int>("verbosity_level") > 0)
+    {
+      CFinfo << "MixedPrecisionStrategy finished after " << m_iterations << " iterations with relative residual " << beta / rhs_norm
+             << (beta > abs_tolerance ? " (not converged)" : "") << ", preconditioner factorized " << m_nb_factorizations << " times so far" << CFendl;
+    }
+  }
+
+  Real compute_residual()
+  {
+    check_setup();
+
+    const Epetra_CrsMatrix& matrix = *m_matrix->epetra_matrix();
+    const Epetra_Map& map = matrix.RowMap();
+    Epetra_Vector rhs(View, map, m_rhs->epetra_vector()->Values());
+    Epetra_Vector solution(View, map, m_solution->epetra_vector()->Values());
+    if(m_residual.is_null() || !m_residual->Map().SameAs(map))
+      m_residual = Teuchos::rcp(new Epetra_Vector(map));
+
+    return residual(matrix, rhs, solution);
+  }
+
+  common::Component& m_self;
+
+  Handle<TrilinosCrsMatrix> m_matrix;
+  Handle<TrilinosVector> m_rhs;
+  Handle<TrilinosVector> m_solution;
+
+  FloatBlockPreconditioner m_preconditioner;
+
+  /// Matrix the block pattern was computed for. Holding it guarantees a new matrix is recognized
+  Teuchos::RCP<Epetra_CrsMatrix const> m_block_matrix;
+  /// Block in CRS format, with the position of each entry in the value array of the matrix
+  std::vector<Uint> m_block_row_starts;
+  std::vector<Uint> m_block_columns;
+  std::vector<int> m_block_positions;
+  /// Block values the preconditioner was factorized for
+  std::vector<Real> m_block_values;
+  /// Number of times the preconditioner was factorized
+  Uint m_nb_factorizations;
+
+  std::vector< Teuchos::RCP<Epetra_Vector> > m_basis;
+  std::vector< Teuchos::RCP<Epetra_Vector> > m_preconditioned;
+  Teuchos::RCP<Epetra_Vector> m_residual;
+
+  Uint m_iterations;
+};
+
+MixedPrecisionStrategy::MixedPrecisionStrategy(const std::string& name) :
+  SolutionStrategy(name),
+  m_implementation(new Implementation(*this))
+{
+  options().add("max_iterations", 500u)
+    .pretty_name("Maximum Iterations")
+    .description("Maximum number of outer (double precision) iterations")
+    .mark_basic();
+
+  options().add("krylov_size", 50u)
+    .pretty_name("Krylov Size")
+    .description("Number of outer iterations before restarting")
+    .mark_basic();
+
+  options().add("tolerance", 1e-8)
+    .pretty_name("Tolerance")
+    .description("Relative residual reduction at which the solve stops")
+    .mark_basic();
+
+  options().add("inner_iterations", 0u)
+    .pretty_name("Inner Iterations")
+    .description("Maximum number of single precision GMRES iterations on the local block in each preconditioner application. If zero, only the single precision ILU(0) factors are applied")
+    .mark_basic();
+
+  options().add("inner_tolerance", 1e-2)
+    .pretty_name("Inner Tolerance")
+    .description("Relative residual reduction at which the inner single precision iterations stop")
+    .mark_basic();
+
+  options().add("verbosity_level", 1)
+    .pretty_name("Verbosity Level")
+    .description("Print the number of iterations and the residual after each solve if larger than zero")
+    .mark_basic();
+}
+
+MixedPrecisionStrategy::~MixedPrecisionStrategy()
+{
+}
+
+void MixedPrecisionStrategy::set_matrix(const Handle< Matrix >& matrix)
+{
+  m_implementation->m_matrix = Handle<TrilinosCrsMatrix>(matrix);
+}
+
+void MixedPrecisionStrategy::set_rhs(const Handle< Vector >& rhs)
+{
+  m_implementation->m_rhs = Handle<TrilinosVector>(rhs);
+}
+
+void MixedPrecisionStrategy::set_solution(const Handle< Vector >& solution)
+{
+  m_implementation->m_solution = Handle<TrilinosVector>(solution);
+}
+
+void MixedPrecisionStrategy::solve()
+{
+  m_implementation->solve();
+}
+
+Real MixedPrecisionStrategy::compute_residual()
+{
+  return m_implementation->compute_residual();
+}
+
+Uint MixedPrecisionStrategy::iterations() const
+{
+  return m_implementation->m_iterations;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
@@ -0,0 +1,66 @@
+// Copyright (C) 2010 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_MixedPrecisionStrategy_hpp
+#define cf3_Math_LSS_MixedPrecisionStrategy_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/scoped_ptr.hpp>
+
+#include "math/LSS/SolutionStrategy.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file MixedPrecisionStrategy.hpp Flexible GMRES in double precision with a single precision preconditioner
+**/
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Solves the system with restarted flexible GMRES in double precision, preconditioned by a
+/// FloatBlockPreconditioner on the rows of each rank (block Jacobi). The preconditioner is
+/// stored and applied in single precision and may run inner GMRES iterations of its own, so
+/// most of the memory traffic is in float, while the outer iterations still converge to the
+/// requested double precision residual.
+/// The preconditioner is only factorized again when the values of the local block differ from the previous solve.
+/// Only TrilinosCrsMatrix is supported.
+class LSS_API MixedPrecisionStrategy : public SolutionStrategy
+{
+public:
+  MixedPrecisionStrategy(const std::string& name);
+  ~MixedPrecisionStrategy();
+
+  /// name of the type
+  static std::string type_name () { return "MixedPrecisionStrategy"; }
+
+  void set_matrix(const Handle<LSS::Matrix>& matrix);
+  void set_rhs(const Handle<LSS::Vector>& rhs);
+  void set_solution(const Handle<LSS::Vector>& solution);
+  void solve();
+  Real compute_residual();
+
+  /// Number of outer iterations of the last solve
+  Uint iterations() const;
+
+private:
+  /// Hide the implementation to avoid pulling in lots of Trilinos headers
+  struct Implementation;
+  boost::scoped_ptr<Implementation> m_implementation;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_MixedPrecisionStrategy_hpp
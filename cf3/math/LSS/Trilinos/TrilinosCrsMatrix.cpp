@@ -6,6 +6,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iostream>
 
 #include <boost/pointer_cast.hpp>
@@ -98,9 +99,15 @@ TrilinosCrsMatrix::TrilinosCrsMatrix(const std::string& name) :
   m_num_my_elements(0),
   m_p2m(0),
   m_converted_indices(0),
-  m_comm(common::PE::Comm::instance().communicator())
+  m_comm(common::PE::Comm::instance().communicator()),
+  m_use_scatter_maps(true)
 {
   properties().add("vector_type", std::string("cf3.math.LSS.TrilinosVector"));
+
+  options().add("use_scatter_maps", m_use_scatter_maps)
+    .pretty_name("Use Scatter Maps")
+    .description("Add element matrices through cached positions in the CRS value array. If false, the column indices are searched at every assembly, as in add_values.")
+    .link_to(&m_use_scatter_maps);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -201,6 +208,8 @@ void TrilinosCrsMatrix::destroy()
   }
   m_p2m.resize(0);
   m_p2m.reserve(0);
+  m_scatter_maps.clear();
+  m_dirichlet_patterns.clear();
   m_neq=0;
   m_num_my_elements=0;
   m_is_created=false;
@@ -296,6 +305,107 @@ void TrilinosCrsMatrix::add_values(const BlockAccumulator& values)
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+void TrilinosCrsMatrix::add_element_values(const BlockAccumulator& values, const common::Component& elements, const Uint element_idx)
+{
+  if(!m_use_scatter_maps)
+  {
+    add_values(values);
+    return;
+  }
+
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  const Uint num_entries = nb_nodes*m_neq;
+  cf3_assert(values.mat.rows() == num_entries);
+  const Uint element_positions = nb_nodes*num_entries;
+
+  ScatterMap& scatter_map = m_scatter_maps[std::make_pair(&elements, nb_nodes)];
+  // The elements the map was computed for may have been removed, and other elements created at the same address
+  if(scatter_map.elements.get() != &elements)
+  {
+    scatter_map.elements = elements.handle();
+    scatter_map.nodes.clear();
+    scatter_map.positions.clear();
+  }
+  if(scatter_map.positions.size() < (element_idx+1)*element_positions)
+  {
+    scatter_map.nodes.resize((element_idx+1)*nb_nodes);
+    scatter_map.positions.resize((element_idx+1)*element_positions, -2);
+  }
+
+  // Convert the index vector
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Uint local_start_idx = values.indices[i]*m_neq;
+    for(int j = 0; j != m_neq; ++j)
+      m_converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
+  }
+
+  Uint* nodes = &scatter_map.nodes[element_idx*nb_nodes];
+  int* positions = &scatter_map.positions[element_idx*element_positions];
+  if(positions[0] == -2 || !std::equal(values.indices.begin(), values.indices.end(), nodes))
+  {
+    std::copy(values.indices.begin(), values.indices.end(), nodes);
+    compute_scatter_map(nb_nodes, positions);
+  }
+
+  int* row_offsets;
+  int* column_indices;
+  Real* crs_values;
+  TRILINOS_THROW(m_mat->ExtractCrsDataPointers(row_offsets, column_indices, crs_values));
+
+  const Real* block = values.mat.data();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const int* node_positions = positions + i*num_entries;
+    if(node_positions[0] < 0)
+      continue;
+    for(Uint k = 0; k != m_neq; ++k)
+    {
+      const Uint block_row = i*m_neq+k;
+      Real* row_values = crs_values + row_offsets[m_converted_indices[block_row]];
+      const Real* block_row_values = block + block_row*num_entries;
+      for(Uint j = 0; j != num_entries; ++j)
+        row_values[node_positions[j]] += block_row_values[j];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosCrsMatrix::compute_scatter_map(const Uint nb_nodes, int* positions)
+{
+  const int num_entries = nb_nodes*m_neq;
+
+  int* row_offsets;
+  int* column_indices;
+  Real* crs_values;
+  TRILINOS_THROW(m_mat->ExtractCrsDataPointers(row_offsets, column_indices, crs_values));
+
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    int* node_positions = positions + i*num_entries;
+    // All rows of the node have the same columns, so the first one is representative
+    const int mat_row = m_converted_indices[i*m_neq];
+    if(mat_row >= m_num_my_elements)
+    {
+      std::fill(node_positions, node_positions + num_entries, -1);
+      continue;
+    }
+    const int* row_begin = column_indices + row_offsets[mat_row];
+    const int* row_end = column_indices + row_offsets[mat_row+1];
+    for(int j = 0; j != num_entries; ++j)
+    {
+      const int* found = std::find(row_begin, row_end, m_converted_indices[j]);
+      if(found == row_end)
+        throw common::BadValue(FromHere(), "Element matrix entry is not part of the sparsity pattern");
+      node_positions[j] = found - row_begin;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void TrilinosCrsMatrix::get_values(BlockAccumulator& values)
 {
   cf3_assert(m_is_created);
@@ -426,6 +536,142 @@ void TrilinosCrsMatrix::symmetric_dirichlet(const Uint blockrow, const Uint ieq,
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+void TrilinosCrsMatrix::symmetric_dirichlet_batch(const std::vector<Uint>& dofs, const std::vector<Real>& values, Vector& rhs)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(dofs.size() == values.size());
+  const DirichletPattern& pattern = dirichlet_pattern(dofs);
+
+  int* row_offsets;
+  int* column_indices;
+  Real* crs_values;
+  TRILINOS_THROW(m_mat->ExtractCrsDataPointers(row_offsets, column_indices, crs_values));
+
+  // Move the constrained columns to the RHS
+  const Uint nb_rows = pattern.rows.size();
+  for(Uint i = 0; i != nb_rows; ++i)
+  {
+    Real correction = 0.;
+    const Uint entries_end = pattern.rows_begin[i+1];
+    for(Uint j = pattern.rows_begin[i]; j != entries_end; ++j)
+    {
+      Real& entry = crs_values[pattern.entry_offsets[j]];
+      correction += entry * values[pattern.entry_conditions[j]];
+      entry = 0.;
+    }
+    const Uint row = pattern.rows[i];
+    rhs.add_value(row / m_neq, row % m_neq, -correction);
+  }
+
+  // Constrained rows only keep the diagonal
+  const Uint nb_bc_rows = pattern.bc_conditions.size();
+  for(Uint i = 0; i != nb_bc_rows; ++i)
+  {
+    std::fill(crs_values + pattern.bc_rows_begin[i], crs_values + pattern.bc_rows_end[i], 0.);
+    crs_values[pattern.bc_diagonals[i]] = 1.;
+  }
+
+  const Uint nb_dofs = dofs.size();
+  for(Uint i = 0; i != nb_dofs; ++i)
+    rhs.set_value(dofs[i] / m_neq, dofs[i] % m_neq, values[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+const TrilinosCrsMatrix::DirichletPattern& TrilinosCrsMatrix::dirichlet_pattern(const std::vector<Uint>& dofs)
+{
+  // Only a few different sets of conditions are expected, i.e. one per boundary condition action
+  static const Uint max_nb_patterns = 16;
+
+  const Uint nb_patterns = m_dirichlet_patterns.size();
+  for(Uint i = 0; i != nb_patterns; ++i)
+  {
+    if(m_dirichlet_patterns[i].dofs == dofs)
+      return m_dirichlet_patterns[i];
+  }
+
+  if(nb_patterns == max_nb_patterns)
+    m_dirichlet_patterns.erase(m_dirichlet_patterns.begin());
+  m_dirichlet_patterns.push_back(DirichletPattern());
+  DirichletPattern& pattern = m_dirichlet_patterns.back();
+  pattern.dofs = dofs;
+
+  int* row_offsets;
+  int* column_indices;
+  Real* crs_values;
+  TRILINOS_THROW(m_mat->ExtractCrsDataPointers(row_offsets, column_indices, crs_values));
+
+  // Marks the constrained columns with the index of their condition
+  std::vector<int> column_condition(m_p2m.size(), -1);
+  const Uint nb_dofs = dofs.size();
+  for(Uint i = 0; i != nb_dofs; ++i)
+    column_condition[m_p2m[dofs[i]]] = i;
+
+  std::vector<bool> row_done(m_p2m.size(), false);
+  for(Uint i = 0; i != nb_dofs; ++i)
+  {
+    row_done[dofs[i]] = true;
+    const int mat_row = m_p2m[dofs[i]];
+    if(mat_row >= m_num_my_elements)
+      continue;
+
+    const int* row_begin = column_indices + row_offsets[mat_row];
+    const int* row_end = column_indices + row_offsets[mat_row+1];
+    const int* diagonal = std::find(row_begin, row_end, mat_row);
+    if(diagonal == row_end)
+      throw common::BadValue(FromHere(), "Dirichlet condition on a row without diagonal entry");
+
+    pattern.bc_conditions.push_back(i);
+    pattern.bc_rows_begin.push_back(row_offsets[mat_row]);
+    pattern.bc_rows_end.push_back(row_offsets[mat_row+1]);
+    pattern.bc_diagonals.push_back(diagonal - column_indices);
+  }
+
+  // By structural symmetry, the rows with constrained columns are those of the neighbours of the constrained nodes
+  for(Uint i = 0; i != nb_dofs; ++i)
+  {
+    const Uint blockrow = dofs[i] / m_neq;
+    const int neighbours_end = m_starting_indices[blockrow+1];
+    for(int neighbour_idx = m_starting_indices[blockrow]; neighbour_idx != neighbours_end; ++neighbour_idx)
+    {
+      const Uint node = m_node_connectivity[neighbour_idx];
+      for(Uint j = 0; j != m_neq; ++j)
+      {
+        const Uint row = node*m_neq + j;
+        if(row_done[row])
+          continue;
+        row_done[row] = true;
+
+        const int mat_row = m_p2m[row];
+        if(mat_row >= m_num_my_elements)
+          continue;
+
+        const Uint first_entry = pattern.entry_offsets.size();
+        const int entries_end = row_offsets[mat_row+1];
+        for(int k = row_offsets[mat_row]; k != entries_end; ++k)
+        {
+          const int condition = column_condition[column_indices[k]];
+          if(condition >= 0)
+          {
+            pattern.entry_offsets.push_back(k);
+            pattern.entry_conditions.push_back(condition);
+          }
+        }
+        if(pattern.entry_offsets.size() != first_entry)
+        {
+          pattern.rows.push_back(row);
+          pattern.rows_begin.push_back(first_entry);
+        }
+      }
+    }
+  }
+  pattern.rows_begin.push_back(pattern.entry_offsets.size());
+
+  return pattern;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void TrilinosCrsMatrix::tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from)
 {
   cf3_assert(m_is_created);
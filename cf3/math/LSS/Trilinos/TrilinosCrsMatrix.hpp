@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+
 #include <Epetra_MpiComm.h>
 #include <Epetra_CrsMatrix.h>
 #include <Teuchos_RCP.hpp>
@@ -89,6 +91,10 @@ public:
   /// eigen, templatization on top level
   void add_values(const BlockAccumulator& values);
 
+  /// Add the values of an element matrix, directly into the CRS value array using cached offsets.
+  /// Falls back to add_values if the option use_scatter_maps is false.
+  void add_element_values(const BlockAccumulator& values, const common::Component& elements, const Uint element_idx);
+
   /// Add a list of values
   void get_values(BlockAccumulator& values);
 
@@ -101,6 +107,9 @@ public:
 
   virtual void symmetric_dirichlet(const Uint blockrow, const Uint ieq, const Real value, Vector& rhs);
 
+  /// Apply a set of symmetric dirichlet conditions in a single pass over the affected rows
+  virtual void symmetric_dirichlet_batch(const std::vector<Uint>& dofs, const std::vector<Real>& values, Vector& rhs);
+
   /// Add one line to another and tie to it via dirichlet-style (applying periodicity)
   void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from);
 
@@ -178,6 +187,45 @@ public:
 
 private:
 
+  /// Positions of the entries of the element matrices of a group of elements in the CRS rows.
+  /// All rows of a node share the same column pattern, so a position is stored for each node row and column of the element,
+  /// relative to the start of the CRS row. The first position for a ghost node is -1.
+  struct ScatterMap
+  {
+    /// Elements the map was computed for, to detect that they were removed
+    Handle<common::Component const> elements;
+    /// Nodes of each element at the time its positions were computed, to detect connectivity changes
+    std::vector<Uint> nodes;
+    /// Positions for each element, nb_nodes*nb_nodes*neq ints per element
+    std::vector<int> positions;
+  };
+
+  /// Compute the positions of the entries of the given block, using the matrix indices in m_converted_indices
+  void compute_scatter_map(const Uint nb_nodes, int* positions);
+
+  /// Positions in the CRS value array that are modified by a batch of symmetric dirichlet conditions
+  struct DirichletPattern
+  {
+    /// Equations the pattern was computed for
+    std::vector<Uint> dofs;
+    /// Owned, unconstrained rows that have entries in constrained columns, as blockrow*neq+ieq
+    std::vector<Uint> rows;
+    /// Start of the entries of each row in entry_offsets, with one extra element marking the end
+    std::vector<Uint> rows_begin;
+    /// Offsets of the entries in constrained columns
+    std::vector<int> entry_offsets;
+    /// Index in dofs of the column of each entry
+    std::vector<Uint> entry_conditions;
+    /// Owned constrained rows: index in dofs, range in the value array and offset of the diagonal
+    std::vector<Uint> bc_conditions;
+    std::vector<int> bc_rows_begin;
+    std::vector<int> bc_rows_end;
+    std::vector<int> bc_diagonals;
+  };
+
+  /// Get the pattern for the given set of equations, computing it if needed
+  const DirichletPattern& dirichlet_pattern(const std::vector<Uint>& dofs);
+
   /// teuchos style smart pointer wrapping the matrix
   Teuchos::RCP<Epetra_CrsMatrix> m_mat;
 
@@ -201,6 +249,15 @@ private:
 
   /// Copy of the connectivity data
   std::vector<int> m_node_connectivity, m_starting_indices;
+
+  /// Cached scatter maps, for each group of elements and number of nodes per element
+  std::map< std::pair<const common::Component*, Uint>, ScatterMap > m_scatter_maps;
+
+  /// Cached dirichlet patterns, most recently computed last
+  std::vector<DirichletPattern> m_dirichlet_patterns;
+
+  /// Linked to the option use_scatter_maps
+  bool m_use_scatter_maps;
 }; // end of class Matrix
 
 ////////////////////////////////////////////////////////////////////////////////////////////
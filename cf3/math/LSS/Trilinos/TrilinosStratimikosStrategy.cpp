@@ -53,7 +53,8 @@ struct TrilinosStratimikosStrategy::Implementation
 {
   Implementation(common::Component& self) :
     m_self(self),
-    m_parameter_list(Teuchos::createParameterList())
+    m_parameter_list(Teuchos::createParameterList()),
+    m_iterations(0)
   {
     Teko::addTekoToStratimikosBuilder(m_linear_solver_builder);
     m_linear_solver_builder.setParameterList(m_parameter_list);
@@ -145,6 +146,11 @@ struct TrilinosStratimikosStrategy::Implementation
 
     Thyra::SolveStatus<double> status = Thyra::solve<double>(*m_lows, Thyra::NOTRANS, *m_rhs->thyra_vector(m_matrix->thyra_operator()->range()), m_solution->thyra_vector(m_matrix->thyra_operator()->domain()).ptr());
     CFinfo << "Thyra::solve finished with status " << status.message << CFendl;
+
+    m_iterations = 0;
+    if(Teuchos::nonnull(status.extraParameters) && status.extraParameters->isType<int>("Belos/Iteration Count"))
+      m_iterations = status.extraParameters->get<int>("Belos/Iteration Count");
+
     if(m_self.options().option("compute_residual").value<bool>())
       CFinfo << "Solver residual: " << compute_residual() << CFendl;
   }
@@ -197,6 +203,7 @@ struct TrilinosStratimikosStrategy::Implementation
   Handle<ThyraMultiVector> m_solution;
   Teuchos::RCP< Thyra::MultiVectorBase<Real> > m_residual_vec;
   Handle<ParameterList> m_parameters;
+  Uint m_iterations;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -242,6 +249,11 @@ Real TrilinosStratimikosStrategy::compute_residual()
   return m_implementation->compute_residual();
 }
 
+Uint TrilinosStratimikosStrategy::iterations() const
+{
+  return m_implementation->m_iterations;
+}
+
 
 void TrilinosStratimikosStrategy::set_default_parameters(const string& builder_name)
 {
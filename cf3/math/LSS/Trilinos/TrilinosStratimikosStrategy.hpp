@@ -45,6 +45,9 @@ public:
   void solve();
   Real compute_residual();
 
+  /// Number of iterations of the last solve, as reported by Belos. Zero for other solvers
+  Uint iterations() const;
+
   /// Construct default parameters using the builder for a ParameterListDefaults object.
   void set_default_parameters(const std::string& builder_name);
 
@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <set>
+
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/foreach.hpp>
 #include <boost/progress.hpp>
@@ -17,6 +19,7 @@
 #include "common/FindComponents.hpp"
 #include "common/BasicExceptions.hpp"
 #include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
 
 #include "math/VariablesDescriptor.hpp"
 
@@ -28,6 +31,7 @@
 #include "mesh/MeshElements.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/MeshTransformer.hpp"
+#include "mesh/MeshAdaptor.hpp"
 
 #include "mesh/CGNS/Reader.hpp"
 
@@ -45,12 +49,45 @@ common::ComponentBuilder< Reader, MeshReader, LibCGNS > aCGNSReader_Builder;
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// First of the nb_obj objects in the contiguous block of a rank, distributed as in ParallelDistribution
+  Uint block_begin(const Uint nb_obj, const Uint rank, const Uint nb_ranks)
+  {
+    return nb_obj/nb_ranks*rank;
+  }
+
+  /// One past the last object in the contiguous block of a rank
+  Uint block_end(const Uint nb_obj, const Uint rank, const Uint nb_ranks)
+  {
+    return rank == nb_ranks-1 ? nb_obj : block_begin(nb_obj, rank+1, nb_ranks);
+  }
+
+  /// Rank whose block contains the given object
+  Uint block_owner(const Uint obj, const Uint nb_obj, const Uint nb_ranks)
+  {
+    const Uint block_size = nb_obj/nb_ranks;
+    return block_size == 0 ? nb_ranks-1 : std::min(nb_ranks-1, obj/block_size);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 Reader::Reader(const std::string& name)
-: MeshReader(name), Shared()
+: MeshReader(name), Shared(),
+  m_distributed(false),
+  m_node_block_begin(0),
+  m_node_block_end(0)
 {
   options().add( "SectionsAreBCs", false )
       .description("Treat Sections of lower dimensionality as BC. "
                         "This means no BCs from cgns will be read");
+
+  options().add( "distributed", false )
+      .pretty_name("Distributed")
+      .description("When running in parallel, every rank reads only a contiguous block of the nodes and "
+                   "of every section, and fetches the nodes used by its elements from the other ranks. "
+                   "Only files with a single unstructured zone are supported.");
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -69,6 +106,9 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   // Set the internal mesh pointer
   m_mesh = Handle<Mesh>(mesh.handle());
 
+  m_distributed = options().value<bool>("distributed") && PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  m_section_blocks.clear();
+
   // open file in read mode
   CALL_CGNS(cg_open(file.path().c_str(),CG_MODE_READ,&m_file.idx));
 
@@ -85,6 +125,9 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   // close the CGNS file
   CALL_CGNS(cg_close(m_file.idx));
 
+  if (m_distributed)
+    distribute_nodes();
+
   // Fix global numbering
   /// @todo remove this and read glb_index ourself
   build_component_abstract_type<MeshTransformer>("cf3.mesh.actions.GlobalNumbering","glb_numbering")->transform(m_mesh);
@@ -113,6 +156,10 @@ void Reader::read_base(Mesh& parent_region)
   // check how many zones we have
   CALL_CGNS(cg_nzones(m_file.idx,m_base.idx,&m_base.nbZones));
   m_zone.unique = m_base.nbZones == 1 ? true : false;
+
+  if (m_distributed && !(m_base.unique && m_zone.unique))
+    throw NotSupported(FromHere(),"CGNS: distributed reading is only supported for files with a single base and zone");
+
   // Read every zone in this base
   for (m_zone.idx = 1; m_zone.idx<=m_base.nbZones; ++m_zone.idx)
     read_zone(parent_region);
@@ -173,20 +220,37 @@ void Reader::read_zone(Mesh& mesh)
     m_zone_map[m_zone.idx] = &this_region;
 
     // read coordinates in this zone
+    // (in distributed mode, every rank reads its own block of the nodes and of each section)
     for (int i=1; i<=m_zone.nbGrids; ++i)
-      read_coordinates_unstructured(this_region);
+    {
+      if (m_distributed)
+        read_coordinates_distributed(this_region);
+      else
+        read_coordinates_unstructured(this_region);
+    }
 
     // read sections (or subregions) in this zone
-    m_global_to_region.reserve(m_zone.total_nbElements);
+    if (!m_distributed)
+      m_global_to_region.reserve(m_zone.total_nbElements);
     for (m_section.idx=1; m_section.idx<=m_zone.nbSections; ++m_section.idx)
-      read_section(this_region);
+    {
+      if (m_distributed)
+        read_section_distributed(this_region);
+      else
+        read_section(this_region);
+    }
 
 //    // Only read boco's if sections are not defined as BC's
 //    if (!option("SectionsAreBCs")->value<bool>())
 //    {
       // read boundaryconditions (or subregions) in this zone
       for (m_boco.idx=1; m_boco.idx<=m_zone.nbBocos; ++m_boco.idx)
-        read_boco_unstructured(this_region);
+      {
+        if (m_distributed)
+          read_boco_distributed(this_region);
+        else
+          read_boco_unstructured(this_region);
+      }
 //
 //      // Remove regions flagged as bc
 //      BOOST_FOREACH(Region& region, find_components_recursively_with_tag<Region>(this_region,"remove_this_tmp_component"))
@@ -207,6 +271,9 @@ void Reader::read_zone(Mesh& mesh)
   }
   else if(m_zone.type == Structured)
   {
+    if (m_distributed)
+      throw NotSupported(FromHere(),"CGNS: distributed reading is only supported for Unstructured zones");
+
     int isize[3][3];
     char zone_name_char[CGNS_CHAR_MAX];
     CALL_CGNS(cg_zone_read(m_file.idx,m_base.idx,m_zone.idx,zone_name_char,isize[0]));
@@ -965,7 +1032,7 @@ void Reader::read_flowsolution()
     switch (m_flowsol.grid_loc)
     {
       case Vertex:
-        datasize = m_zone.total_nbVertices;
+        datasize = m_distributed ? m_node_block_end - m_node_block_begin : m_zone.total_nbVertices;
         dict = m_mesh->geometry_fields().handle<Dictionary>();
         break;
       case CellCenter:
@@ -980,7 +1047,7 @@ void Reader::read_flowsolution()
         throw NotSupported(FromHere(), "Flow solution Grid location ["+to_str((int)m_flowsol.grid_loc)+"] is not supported");
     }
 
-    cf3_assert(datasize == m_zone.total_nbVertices);
+    cf3_assert(m_distributed || datasize == m_zone.total_nbVertices);
     cf3_assert(datasize == m_mesh->geometry_fields().size());
 
     boost::shared_ptr<math::VariablesDescriptor> variables = allocate_component<math::VariablesDescriptor>("variables");
@@ -1008,9 +1075,13 @@ void Reader::read_flowsolution()
       CALL_CGNS(cg_field_info(m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,m_field.idx,&m_field.datatype,field_name_char));
       m_field.name=field_name_char;
 
+      if (datasize == 0)
+        continue;
+
+      // in distributed mode only the block of nodes of this rank is read
       std::vector<double> field_data(datasize);
-      cgsize_t imin = 1;
-      cgsize_t imax = datasize;
+      cgsize_t imin = m_distributed ? m_node_block_begin + 1 : 1;
+      cgsize_t imax = imin + datasize - 1;
       CALL_CGNS(cg_field_read( m_file.idx,m_base.idx,m_zone.idx,m_flowsol.idx,
                                field_name_char,RealDouble,&imin,&imax,(void*)(&field_data[0]) ));
 
@@ -1055,6 +1126,371 @@ Uint Reader::get_total_nbElements()
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Reader::read_coordinates_distributed(Region& parent_region)
+{
+  CFinfo << "creating coordinates in " << parent_region.uri().string() << CFendl;
+
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_ranks = PE::Comm::instance().size();
+
+  Dictionary& nodes = m_mesh->geometry_fields();
+  m_zone.nodes = &nodes;
+  m_zone.nodes_start_idx = 0;
+
+  m_node_block_begin = detail::block_begin(m_zone.total_nbVertices, rank, nb_ranks);
+  m_node_block_end   = detail::block_end(m_zone.total_nbVertices, rank, nb_ranks);
+  const Uint nb_nodes = m_node_block_end - m_node_block_begin;
+
+  m_mesh->initialize_nodes(nb_nodes, (Uint)m_zone.coord_dim);
+
+  common::Table<Real>& coords = nodes.coordinates();
+  for (Uint i=0; i<nb_nodes; ++i)
+  {
+    nodes.glb_idx()[i] = m_node_block_begin + i;
+    nodes.rank()[i] = rank;
+  }
+
+  if (nb_nodes == 0)
+    return;
+
+  // read the block one coordinate at a time
+  const char* coord_names[3] = { "CoordinateX", "CoordinateY", "CoordinateZ" };
+  const cgsize_t range_min = m_node_block_begin + 1;
+  const cgsize_t range_max = m_node_block_end;
+  std::vector<Real> coord(nb_nodes);
+  for (int d=0; d<m_zone.coord_dim; ++d)
+  {
+    CALL_CGNS(cg_coord_read(m_file.idx,m_base.idx,m_zone.idx, coord_names[d], RealDouble, &range_min, &range_max, &coord[0]));
+    for (Uint i=0; i<nb_nodes; ++i)
+      coords[i][d] = coord[i];
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_section_distributed(Region& parent_region)
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_ranks = PE::Comm::instance().size();
+
+  char section_name_char[CGNS_CHAR_MAX];
+
+  // read section information
+  CALL_CGNS(cg_section_read(m_file.idx, m_base.idx, m_zone.idx, m_section.idx, section_name_char, &m_section.type,
+                            &m_section.eBegin, &m_section.eEnd, &m_section.nbBdry, &m_section.parentFlag));
+  m_section.name=section_name_char;
+
+  // replace whitespace by underscore
+  boost::algorithm::replace_all(m_section.name," ","_");
+  boost::algorithm::replace_all(m_section.name,".","_");
+  boost::algorithm::replace_all(m_section.name,":","_");
+  boost::algorithm::replace_all(m_section.name,"/","_");
+
+  // Create a new region for this section
+  Region& this_region = parent_region.create_region(m_section.name);
+
+  Dictionary& all_nodes = *m_zone.nodes;
+
+  // The block of the section for this rank
+  SectionBlock block;
+  block.region = this_region.handle<Region>();
+  block.section_begin = m_section.eBegin-1;
+  block.section_end = m_section.eEnd;
+  const Uint nb_section_elems = block.section_end - block.section_begin;
+  block.block_begin = block.section_begin + detail::block_begin(nb_section_elems, rank, nb_ranks);
+  block.block_end = block.section_begin + detail::block_end(nb_section_elems, rank, nb_ranks);
+  block.local_begin = m_global_to_region.size();
+  m_section_blocks.push_back(block);
+
+  const Uint nb_elems = block.block_end - block.block_begin;
+
+  // Read the element nodes of the block. The parent data is not used.
+  std::vector<cgsize_t> elemNodes;
+  if (nb_elems != 0)
+  {
+    const cgsize_t start = block.block_begin + 1;
+    const cgsize_t end = block.block_end;
+    cgsize_t data_size;
+    CALL_CGNS(cg_ElementPartialSize(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,start,end,&data_size));
+    elemNodes.resize(data_size);
+    CALL_CGNS(cg_elements_partial_read(m_file.idx,m_base.idx,m_zone.idx,m_section.idx,start,end,&elemNodes[0],NULL));
+  }
+
+  // The connectivity holds global node indices until distribute_nodes() is called
+  if (m_section.type == MIXED) // Different element types, Can also be faces
+  {
+    // Create Elements component for each element type.
+    std::map<std::string,Handle< Elements > > cells = create_cells_in_region(this_region,all_nodes,get_supported_element_types());
+    std::map<std::string,Handle< Elements > > faces = create_faces_in_region(this_region,all_nodes,get_supported_element_types());
+    std::map<std::string,Handle< Elements > > elements;
+    elements.insert(cells.begin(),cells.end());
+    elements.insert(faces.begin(),faces.end());
+    std::map<std::string, boost::shared_ptr< ArrayBufferT<Uint> > > buffer = create_connectivity_buffermap(elements);
+
+    // Every element is stored as its type followed by its nodes.
+    // Count the elements of each type first, so every connectivity table is resized only once.
+    std::map<std::string,Uint> nb_elems_per_type;
+    Uint pos = 0;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      ElementType_t etype_cgns = static_cast<ElementType_t>(elemNodes[pos]);
+      CALL_CGNS(cg_npe(etype_cgns,&m_section.elemNodeCount));
+      ++nb_elems_per_type[m_elemtype_CGNS_to_CF[etype_cgns]+to_str(m_zone.coord_dim)+"D"];
+      pos += 1+m_section.elemNodeCount;
+    }
+    for (std::map<std::string,Uint>::const_iterator it=nb_elems_per_type.begin(); it!=nb_elems_per_type.end(); ++it)
+    {
+      cf3_assert(buffer[it->first]);
+      buffer[it->first]->reserve(it->second);
+    }
+
+    std::vector<Uint> row;
+    pos = 0;
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      ElementType_t etype_cgns = static_cast<ElementType_t>(elemNodes[pos++]);
+      CALL_CGNS(cg_npe(etype_cgns,&m_section.elemNodeCount));
+
+      row.resize(m_section.elemNodeCount);
+      for (int n=0; n<m_section.elemNodeCount; ++n)
+        row[n] = m_zone.nodes_start_idx + elemNodes[pos++]-1; // -1 because cgns has index-base 1 instead of 0
+
+      const std::string& etype_CF = m_elemtype_CGNS_to_CF[etype_cgns]+to_str(m_zone.coord_dim)+"D";
+      cf3_assert(buffer[etype_CF]);
+      Uint table_idx = buffer[etype_CF]->add_row(row);
+
+      m_global_to_region.push_back(Region_TableIndex_pair(find_component_ptr_with_name<Elements>(this_region, etype_CF),table_idx));
+      cf3_assert( m_global_to_region.back().first );
+    }
+  }
+  else // Single element type in this section
+  {
+    CALL_CGNS(cg_npe(m_section.type,&m_section.elemNodeCount));
+
+    // Create the element component on all ranks, even if this block is empty
+    const std::string& etype_CF = m_elemtype_CGNS_to_CF[m_section.type]+to_str<int>(m_base.phys_dim)+"D";
+    Elements& element_region = this_region.create_elements(etype_CF,all_nodes);
+
+    Connectivity& node_connectivity = element_region.geometry_space().connectivity();
+    node_connectivity.resize(nb_elems);
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      for (int node=0;node<m_section.elemNodeCount;++node)
+        node_connectivity[elem][node] = m_zone.nodes_start_idx + elemNodes[node+elem*m_section.elemNodeCount]-1;
+
+      m_global_to_region.push_back(Region_TableIndex_pair(element_region.handle<Elements>(),elem));
+    }
+  }
+
+  // Only removes element types that are empty on all ranks
+  remove_empty_element_regions(this_region);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_boco_distributed(Region& parent_region)
+{
+  // Read the info for this boundary condition.
+  char boco_name_char[CGNS_CHAR_MAX];
+  CALL_CGNS(cg_boco_info(m_file.idx, m_base.idx, m_zone.idx, m_boco.idx, boco_name_char, &m_boco.boco_type, &m_boco.ptset_type,
+                         &m_boco.nBC_elem, &m_boco.normalIndex, &m_boco.normalListFlag, &m_boco.normalDataType, &m_boco.nDataSet));
+  m_boco.name = boco_name_char;
+
+  // replace whitespace by underscore
+  boost::algorithm::replace_all(m_boco.name," ","_");
+  boost::algorithm::replace_all(m_boco.name,".","_");
+  boost::algorithm::replace_all(m_boco.name,":","_");
+  boost::algorithm::replace_all(m_boco.name,"/","_");
+
+  // UNOFFICIAL CONVENTION/PRACTICE:
+  // When there exists a CGNS section with the same name as a BC, then this section is taken as BC
+  if (Handle<Component> section = parent_region.get_child(m_boco.name))
+    return;
+
+  const bool is_range = m_boco.ptset_type == PointRange || m_boco.ptset_type == ElementRange;
+  if (!is_range && m_boco.ptset_type != PointList && m_boco.ptset_type != ElementList)
+    throw NotImplemented(FromHere(),"CGNS: pointset_type " + to_str<int>(m_boco.ptset_type) + " for boundary "+m_boco.name+" not supported in CF yet");
+
+  if (m_boco.nBC_elem == 0)
+    return;
+
+  // The element lists of the boundary conditions are small, every rank reads them completely
+  std::vector<cgsize_t> boco_elems(m_boco.nBC_elem);
+  void* NormalList(NULL);
+  CALL_CGNS(cg_boco_read(m_file.idx, m_base.idx, m_zone.idx, m_boco.idx, &boco_elems[0], NormalList));
+
+  // global element numbers, 0-based
+  const Uint nb_bc_elems = is_range ? boco_elems[1]-boco_elems[0]+1 : m_boco.nBC_elem;
+  const Uint first_elem = boco_elems[0]-1;
+  const Uint last_elem = is_range ? boco_elems[1]-1 : boco_elems[m_boco.nBC_elem-1]-1;
+
+  // A boundary condition that covers a complete section is taken as that section.
+  // The global ranges are used, since the element counts differ per rank.
+  BOOST_FOREACH(const SectionBlock& block, m_section_blocks)
+  {
+    if (is_not_null(block.region) && block.region->name() != m_boco.name &&
+        first_elem == block.section_begin && last_elem+1 == block.section_end &&
+        nb_bc_elems == block.section_end - block.section_begin)
+    {
+      block.region->properties()["cgns_section_name"] = block.region->name();
+      block.region->rename(m_boco.name);
+      return;
+    }
+  }
+
+  // Create a region inside mesh/regions/bc-regions with the name of the cgns boco.
+  Region& this_region = parent_region.create_region(m_boco.name);
+  Dictionary& nodes = *m_zone.nodes;
+
+  std::map<std::string,Handle< Elements > > elements = create_faces_in_region(this_region,nodes,get_supported_element_types());
+  std::map<std::string,boost::shared_ptr< ArrayBufferT<Uint > > > buffer = create_connectivity_buffermap(elements);
+
+  // Elements read by other ranks are added there
+  std::vector<const Region_TableIndex_pair*> bc_elements;
+  bc_elements.reserve(nb_bc_elems);
+  std::map<std::string,Uint> nb_elems_per_type;
+  for (Uint i=0; i<nb_bc_elems; ++i)
+  {
+    const Region_TableIndex_pair* element = local_element(is_range ? first_elem+i : boco_elems[i]-1);
+    if (is_null(element))
+      continue;
+    bc_elements.push_back(element);
+    ++nb_elems_per_type[element->first->element_type().derived_type_name()];
+  }
+  for (std::map<std::string,Uint>::const_iterator it=nb_elems_per_type.begin(); it!=nb_elems_per_type.end(); ++it)
+  {
+    cf3_assert(buffer[it->first]);
+    buffer[it->first]->reserve(it->second);
+  }
+
+  BOOST_FOREACH(const Region_TableIndex_pair* element, bc_elements)
+  {
+    const std::string& etype = element->first->element_type().derived_type_name();
+    buffer[etype]->add_row(element->first->geometry_space().connectivity()[element->second]);
+  }
+
+  // Flush all buffers and remove empty element regions
+  for (BufferMap::iterator it=buffer.begin(); it!=buffer.end(); ++it)
+    it->second->flush();
+  buffer.clear();
+
+  remove_empty_element_regions(this_region);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+const Reader::Region_TableIndex_pair* Reader::local_element(const Uint global_element) const
+{
+  BOOST_FOREACH(const SectionBlock& block, m_section_blocks)
+  {
+    if (global_element >= block.block_begin && global_element < block.block_end)
+      return &m_global_to_region[block.local_begin + global_element - block.block_begin];
+  }
+  return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::distribute_nodes()
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_ranks = PE::Comm::instance().size();
+  const Uint nb_nodes = m_zone.total_nbVertices;
+
+  m_mesh->update_structures();
+  Dictionary& nodes = m_mesh->geometry_fields();
+
+  Uint dict_idx = 0;
+  while (m_mesh->dictionaries()[dict_idx].get() != &nodes)
+    ++dict_idx;
+
+  // Nodes of the local elements, either in the block of this rank or to request from the rank that read them
+  std::vector<bool> used_in_block(m_node_block_end - m_node_block_begin, false);
+  std::vector< std::set<Uint> > missing_nodes(nb_ranks);
+  BOOST_FOREACH(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()))
+  {
+    const Connectivity& connectivity = elements.geometry_space().connectivity();
+    const Uint nb_elems = connectivity.size();
+    const Uint nb_elem_nodes = connectivity.row_size();
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      for (Uint n=0; n<nb_elem_nodes; ++n)
+      {
+        const Uint glb_node = connectivity[elem][n];
+        if (glb_node >= m_node_block_begin && glb_node < m_node_block_end)
+          used_in_block[glb_node - m_node_block_begin] = true;
+        else
+          missing_nodes[detail::block_owner(glb_node, nb_nodes, nb_ranks)].insert(glb_node);
+      }
+    }
+  }
+
+  std::vector< std::vector<Uint> > send_requests(nb_ranks);
+  for (Uint pid=0; pid<nb_ranks; ++pid)
+    send_requests[pid].assign(missing_nodes[pid].begin(), missing_nodes[pid].end());
+  missing_nodes.clear();
+
+  std::vector< std::vector<Uint> > recv_requests(nb_ranks);
+  PE::Comm::instance().all_to_all(send_requests, recv_requests);
+
+  // The requested nodes are sent with the flow solution fields
+  std::vector< std::vector< std::vector<Uint> > > exported_nodes(nb_ranks, std::vector< std::vector<Uint> >(m_mesh->dictionaries().size()));
+  for (Uint pid=0; pid<nb_ranks; ++pid)
+  {
+    BOOST_FOREACH(const Uint glb_node, recv_requests[pid])
+    {
+      cf3_assert(glb_node >= m_node_block_begin && glb_node < m_node_block_end);
+      exported_nodes[pid][dict_idx].push_back(glb_node - m_node_block_begin);
+    }
+  }
+
+  nodes.rebuild_map_glb_to_loc();
+
+  MeshAdaptor mesh_adaptor(*m_mesh);
+  mesh_adaptor.prepare();
+
+  std::vector< std::vector< std::vector<boost::uint64_t> > > imported_nodes;
+  mesh_adaptor.send_nodes(exported_nodes, imported_nodes);
+
+  // Nodes of the block that no local element uses are only kept by the ranks that requested them
+  for (Uint n=0; n<used_in_block.size(); ++n)
+  {
+    if (!used_in_block[n])
+      mesh_adaptor.remove_node(dict_idx, n);
+  }
+
+  // Each node is owned by the lowest rank that has it
+  mesh_adaptor.fix_node_ranks();
+  mesh_adaptor.clear_node_buffers();
+  mesh_adaptor.clear_element_buffers();
+
+  // Make the element-node connectivity local
+  const common::Map<boost::uint64_t,Uint>& glb_to_loc = nodes.glb_to_loc();
+  BOOST_FOREACH(Elements& elements, find_components_recursively<Elements>(m_mesh->topology()))
+  {
+    Connectivity& connectivity = elements.geometry_space().connectivity();
+    const Uint nb_elems = connectivity.size();
+    const Uint nb_elem_nodes = connectivity.row_size();
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      for (Uint n=0; n<nb_elem_nodes; ++n)
+      {
+        cf3_assert(glb_to_loc.exists(connectivity[elem][n]));
+        connectivity[elem][n] = glb_to_loc[connectivity[elem][n]];
+      }
+    }
+
+    elements.rank().resize(nb_elems);
+    for (Uint elem=0; elem<nb_elems; ++elem)
+      elements.rank()[elem] = rank;
+  }
+
+  m_mesh->properties()["local_nb_nodes"] = nodes.size();
+  m_mesh->update_structures();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // CGNS
 } // mesh
 } // cf3
@@ -31,6 +31,17 @@ private: // typedefs
 
   typedef std::pair<Handle<Elements>,Uint> Region_TableIndex_pair;
 
+  /// Block of a section that was read by this rank in distributed mode
+  struct SectionBlock
+  {
+    Handle<Region> region;   ///< region created for the section
+    Uint section_begin;      ///< first global element of the section (0-based)
+    Uint section_end;        ///< one past the last global element of the section
+    Uint block_begin;        ///< first global element read by this rank
+    Uint block_end;          ///< one past the last global element read by this rank
+    Uint local_begin;        ///< index of the first element of the block in m_global_to_region
+  };
+
 public: // functions
 
   /// Contructor
@@ -59,6 +70,17 @@ private: // functions
   void read_flowsolution();
   Uint get_total_nbElements();
 
+  /// @name Distributed reading
+  //@{
+  void read_coordinates_distributed(Region& parent_region);
+  void read_section_distributed(Region& parent_region);
+  void read_boco_distributed(Region& parent_region);
+  /// Fetch the nodes used by the local elements from the ranks that read them, and make the connectivity local
+  void distribute_nodes();
+  /// Local element of a global CGNS element, or null if another rank read it
+  const Region_TableIndex_pair* local_element(const Uint global_element) const;
+  //@}
+
   Uint structured_node_idx(Uint i, Uint j, Uint k)
   {
     return i + j*m_zone.nbVertices[XX] + k*m_zone.nbVertices[XX]*m_zone.nbVertices[YY];
@@ -74,6 +96,14 @@ private: // data
   Handle<Mesh> m_mesh;
   Uint m_coord_start_idx;
 
+  /// True if every rank reads only a contiguous block of the nodes and elements
+  bool m_distributed;
+  /// Global nodes read by this rank in distributed mode
+  Uint m_node_block_begin;
+  Uint m_node_block_end;
+  /// Sections read in distributed mode
+  std::vector<SectionBlock> m_section_blocks;
+
 }; // end Reader
 
 
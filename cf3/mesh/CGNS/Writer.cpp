@@ -4,15 +4,23 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <iomanip>
+#include <sstream>
+
 #include "common/BoostFilesystem.hpp"
 
 #include "common/Log.hpp"
 #include "common/Builder.hpp"
 #include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
 #include "common/Table.hpp"
 
 #include "mesh/CGNS/Writer.hpp"
 #include "mesh/Mesh.hpp"
+#include "mesh/MeshMetadata.hpp"
 #include "mesh/Region.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
@@ -36,9 +44,15 @@ common::ComponentBuilder < CGNS::Writer, MeshWriter, LibCGNS > aCGNSWriter_Build
 
 Writer::Writer( const std::string& name )
 : MeshWriter(name),
-  Shared()
+  Shared(),
+  m_series_offset(0),
+  m_geometry_hash(0)
 {
-
+  options().add("time_series", false)
+    .pretty_name("Time Series")
+    .description("Treat every write to the same file as a new step of a time series. The mesh is written only once, "
+                 "and every step adds its fields as FlowSolution_t nodes with the mesh time in BaseIterativeData_t. "
+                 "If the coordinates or the connectivity change, the following steps go to a new file <file>_<step>.cgns.");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -54,15 +68,77 @@ std::vector<std::string> Writer::get_extensions()
 
 void Writer::write()
 {
-  m_fileBasename = m_file_path.base_name(); // filename without extension
+  const bool time_series = options().value<bool>("time_series");
+
+  URI file_path = m_file_path;
+  bool append = false;
+  if (time_series)
+  {
+    const std::size_t current_geometry_hash = geometry_hash();
+    if (m_series_path != m_file_path.path())
+    {
+      m_series_path = m_file_path.path();
+      m_series_file.clear();
+      m_series_offset = 0;
+    }
+    else if (current_geometry_hash != m_geometry_hash)
+    {
+      // Earlier steps stay in their file, together with the mesh they belong to
+      CFinfo << "Geometry changed, continuing time series " << m_series_path << " in a new file" << CFendl;
+      m_series_file.clear();
+      m_series_offset += m_series_times.size();
+    }
 
+    if (m_series_file.empty())
+    {
+      std::stringstream step;
+      step << std::setw(4) << std::setfill('0') << m_series_offset;
+      m_series_file = m_series_offset == 0 ? m_series_path
+                                           : (m_file_path.base_path() / (m_file_path.base_name() + "_" + step.str() + ".cgns")).path();
+      m_series_times.clear();
+      m_series_solutions.clear();
+      m_geometry_hash = current_geometry_hash;
+    }
+    else
+    {
+      append = true;
+    }
+    file_path = URI(m_series_file, URI::Scheme::FILE);
+  }
+
+  m_fileBasename = file_path.base_name(); // filename without extension
 
-  CFdebug << "Opening file " << m_file_path.path() << CFendl;
-  CALL_CGNS(cg_open(m_file_path.path().c_str(),CG_MODE_WRITE,&m_file.idx));
+  CFdebug << "Opening file " << file_path.path() << CFendl;
+  if (append)
+  {
+    // Base and zone were written by the first step of this file
+    CALL_CGNS(cg_open(file_path.path().c_str(),CG_MODE_MODIFY,&m_file.idx));
+    m_base.idx = 1;
+    m_zone.idx = 1;
+  }
+  else
+  {
+    CALL_CGNS(cg_open(file_path.path().c_str(),CG_MODE_WRITE,&m_file.idx));
+    write_base(*m_mesh);
+  }
 
-  write_base(*m_mesh);
+  if (time_series)
+  {
+    const Uint step_idx = m_series_offset + m_series_times.size();
+    std::stringstream step;
+    step << std::setw(4) << std::setfill('0') << step_idx;
+
+    const PropertyList& metadata = this->metadata();
+    m_series_solutions.push_back(write_solution(step.str()));
+    m_series_times.push_back(metadata.check("time") ? metadata.value<Real>("time") : static_cast<Real>(step_idx));
+    write_iterative_data();
+  }
+  else
+  {
+    write_solution("");
+  }
 
-  CFdebug << "Closing file " << m_file_path.path() << CFendl;
+  CFdebug << "Closing file " << file_path.path() << CFendl;
   CALL_CGNS(cg_close(m_file.idx));
 
 }
@@ -184,6 +260,8 @@ void Writer::write_zone(const Region& region, const Mesh& mesh)
     }
   }
 
+  m_zone_elements.clear();
+
   GroupsMapType grouped_elements_map;
   BOOST_FOREACH(const Elements& elements, find_components_recursively<Elements>(region))
   {
@@ -247,6 +325,7 @@ void Writer::write_section(const GroupedElements& grouped_elements)
       BOOST_FOREACH(const Handle< Elements const>& elements, grouped_elements)
       {
         int nbElems = elements->size();
+        m_zone_elements.push_back(elements);
         m_section.elemNodeCount = elements->element_type().nb_nodes();
         m_section.elemStartIdx = m_section.elemEndIdx + 1;
         m_section.elemEndIdx = m_section.elemEndIdx + nbElems;
@@ -276,6 +355,7 @@ void Writer::write_section(const GroupedElements& grouped_elements)
     {
       const Elements& elements = *grouped_elements[0];
       int nbElems = elements.size();
+      m_zone_elements.push_back(grouped_elements[0]);
       m_section.elemNodeCount = elements.element_type().nb_nodes();
       m_section.elemStartIdx = m_section.elemEndIdx + 1;
       m_section.elemEndIdx = m_section.elemEndIdx + nbElems;
@@ -319,6 +399,119 @@ void Writer::write_section(const GroupedElements& grouped_elements)
 
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+std::string Writer::write_solution(const std::string& suffix)
+{
+  const std::string vertex_solution_name = "FlowSolution" + suffix;
+  const std::string cell_solution_name = "CellSolution" + suffix;
+  int vertex_solution_idx = 0;
+  int cell_solution_idx = 0;
+
+  std::vector<Real> values;
+  BOOST_FOREACH(const Handle<Field const>& field_ptr, m_fields)
+  {
+    const Field& field = *field_ptr;
+
+    const bool at_vertices = &field.dict() == &m_mesh->geometry_fields();
+    bool at_cells = !at_vertices && field.discontinuous();
+    BOOST_FOREACH(const Handle<Space>& space, field.dict().spaces())
+    {
+      if (space->connectivity().row_size() != 1)
+        at_cells = false;
+    }
+    if (!at_vertices && !at_cells)
+    {
+      CFwarn << "CGNS writer skips field " << field.uri().string() << ": only fields of the geometry dictionary or with one value per element are supported" << CFendl;
+      continue;
+    }
+
+    int* solution_idx = at_vertices ? &vertex_solution_idx : &cell_solution_idx;
+    if (*solution_idx == 0)
+    {
+      const std::string& solution_name = at_vertices ? vertex_solution_name : cell_solution_name;
+      CFdebug << "Writing solution " << solution_name << CFendl;
+      CALL_CGNS(cg_sol_write(m_file.idx,m_base.idx,m_zone.idx,solution_name.c_str(),at_vertices ? Vertex : CellCenter,solution_idx));
+    }
+
+    values.resize(at_vertices ? m_zone.total_nbVertices : m_zone.nbElements);
+    if (values.empty())
+      continue;
+
+    for (Uint var_idx=0; var_idx<field.nb_vars(); ++var_idx)
+    {
+      const Uint var_length = field.var_length(var_idx);
+      for (Uint component=0; component<var_length; ++component)
+      {
+        const Uint column = field.var_offset(var_idx) + component;
+        if (at_vertices)
+        {
+          for (Uint i=0; i<field.size(); ++i)
+            values[i] = field[i][column];
+        }
+        else
+        {
+          // Elements without a space for this field get a zero value
+          Uint idx=0;
+          BOOST_FOREACH(const Handle<Elements const>& elements, m_zone_elements)
+          {
+            if (field.dict().defined_for_entities(elements))
+            {
+              const Connectivity& field_connectivity = field.dict().space(*elements).connectivity();
+              for (Uint e=0; e<elements->size(); ++e)
+                values[idx++] = field[field_connectivity[e][0]][column];
+            }
+            else
+            {
+              std::fill(values.begin()+idx, values.begin()+idx+elements->size(), 0.);
+              idx += elements->size();
+            }
+          }
+        }
+
+        std::string name = field.var_name(var_idx);
+        if (var_length == static_cast<Uint>(m_zone.coord_dim) && var_length > 1)
+          name += std::string("XYZ").substr(component,1);
+        else if (var_length > 1)
+          name += to_str(component);
+
+        int field_idx;
+        CALL_CGNS(cg_field_write(m_file.idx,m_base.idx,m_zone.idx,*solution_idx,RealDouble,name.c_str(),&values[0],&field_idx));
+      }
+    }
+  }
+
+  if (vertex_solution_idx != 0)
+    return vertex_solution_name;
+  if (cell_solution_idx != 0)
+    return cell_solution_name;
+  return "Null";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_iterative_data()
+{
+  int nb_steps = m_series_times.size();
+
+  // Existing nodes are replaced, since the file is opened in modify mode for all steps but the first
+  CALL_CGNS(cg_simulation_type_write(m_file.idx,m_base.idx,TimeAccurate));
+
+  CALL_CGNS(cg_biter_write(m_file.idx,m_base.idx,"TimeIterValues",nb_steps));
+  CALL_CGNS(cg_goto(m_file.idx,m_base.idx,"BaseIterativeData_t",1,"end"));
+  CALL_CGNS(cg_array_write("TimeValues",RealDouble,1,&nb_steps,&m_series_times[0]));
+
+  // Solution names are stored as 32 character strings, padded with spaces
+  std::vector<char> pointers(32*nb_steps, ' ');
+  for (Uint i=0; i<m_series_solutions.size(); ++i)
+    std::copy(m_series_solutions[i].begin(), m_series_solutions[i].begin()+std::min<Uint>(32,m_series_solutions[i].size()), pointers.begin()+32*i);
+
+  int dimensions[2] = {32, nb_steps};
+  CALL_CGNS(cg_ziter_write(m_file.idx,m_base.idx,m_zone.idx,"ZoneIterativeData"));
+  CALL_CGNS(cg_goto(m_file.idx,m_base.idx,"Zone_t",m_zone.idx,"ZoneIterativeData_t",1,"end"));
+  CALL_CGNS(cg_array_write("FlowSolutionPointers",Character,2,dimensions,&pointers[0]));
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 
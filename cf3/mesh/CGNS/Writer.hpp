@@ -58,6 +58,14 @@ private: // functions
 
   void write_section(const GroupedElements& grouped_elements);
 
+  /// Write the configured fields as FlowSolution_t nodes of the zone.
+  /// Fields of the geometry dictionary are written at the vertices, fields with one value per element at the cell centers.
+  /// @return the name of the solution that is referenced in the iterative data
+  std::string write_solution(const std::string& suffix);
+
+  /// Write the time values and solution pointers of all steps of the time series
+  void write_iterative_data();
+
 //  void write_boco(const GroupedElements& grouped_elements);
 
 private: // data
@@ -66,6 +74,23 @@ private: // data
 
   std::map<const common::Table<Real>*, Uint> m_global_start_idx;
 
+  /// Elements of the zone, in the order of the sections
+  std::vector<Handle<Elements const> > m_zone_elements;
+
+  /// Path configured for the time series, and path of the file the current steps are appended to
+  std::string m_series_path;
+  std::string m_series_file;
+
+  /// Time and solution name of each step in the current series file
+  std::vector<Real> m_series_times;
+  std::vector<std::string> m_series_solutions;
+
+  /// Number of steps written in earlier files of the same series
+  Uint m_series_offset;
+
+  /// Geometry hash of the mesh written to the current series file
+  std::size_t m_geometry_hash;
+
 }; // end Writer
 
 
@@ -36,6 +36,7 @@
 #include "mesh/Space.hpp"
 #include "mesh/Entities.hpp"
 #include "mesh/Connectivity.hpp"
+#include "mesh/Functions.hpp"
 
 #include "math/Consts.hpp"
 #include "math/VariablesDescriptor.hpp"
@@ -53,7 +54,8 @@ RegistTypeInfo<Dictionary, LibMesh> regist_Dictionary_type;
 
 Dictionary::Dictionary ( const std::string& name  ) :
   Component( name ),
-  m_is_continuous(true) // default continuous
+  m_is_continuous(true), // default continuous
+  m_revision(0)
 {
   mark_basic();
 
@@ -122,6 +124,7 @@ void Dictionary::resize(const Uint size)
   boost_foreach(Field& field, find_components<Field>(*this))
       field.resize(size);
 
+  increment_revision();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -355,6 +358,31 @@ void Dictionary::update_structures()
   {
     m_fields.push_back(field.handle<Field>());
   }
+
+  increment_revision();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Dictionary::increment_revision()
+{
+  ++m_revision;
+  m_used_nodes.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+boost::shared_ptr< List<Uint> const > Dictionary::used_nodes(const Component& node_user) const
+{
+  std::map<const Component*, UsedNodes>::const_iterator cached = m_used_nodes.find(&node_user);
+  // The handle expires if the node user was removed and another component reuses its address
+  if(cached != m_used_nodes.end() && cached->second.node_user.get() == &node_user)
+    return cached->second.nodes;
+
+  UsedNodes& entry = m_used_nodes[&node_user];
+  entry.node_user = node_user.handle();
+  entry.nodes = build_used_nodes_list(node_user, *this, true);
+  return entry.nodes;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
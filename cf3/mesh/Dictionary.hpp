@@ -139,6 +139,19 @@ public: // functions
 
   virtual void rebuild_node_to_element_connectivity() = 0;
 
+  /// Revision of the dictionary, incremented when it is resized, its structures are updated or the entities of its spaces are resized.
+  /// Data derived from the dictionary and the connectivity of its spaces can be cached against it.
+  Uint revision() const { return m_revision; }
+
+  /// Start a new revision, dropping the cached data.
+  /// Code that changes the connectivity of a space in place, without a mesh update afterwards, must call this
+  void increment_revision();
+
+  /// Sorted list of the nodes used by the entities in node_user, including ghost elements.
+  /// The list is built once per node_user and kept until the revision changes.
+  /// @param [in] node_user  component being entities, or holding entities somewhere down in its tree
+  boost::shared_ptr< common::List<Uint> const > used_nodes(const common::Component& node_user) const;
+
 private: // functions
 
   void config_space();
@@ -170,6 +183,18 @@ protected:
 
 private:
 
+  /// Cached used nodes for a node user
+  struct UsedNodes
+  {
+    Handle<common::Component const> node_user;
+    boost::shared_ptr< common::List<Uint> const > nodes;
+  };
+
+  Uint m_revision;
+
+  /// Cached used nodes, by node user
+  mutable std::map<const common::Component*, UsedNodes> m_used_nodes;
+
   std::map< Handle<Entities const> , Handle<Space const> > m_spaces_map;
   std::vector< Handle<Space   > > m_spaces;
   std::vector< Handle<Entities> > m_entities;
@@ -11,6 +11,7 @@
 
 #include "mesh/ElementFinder.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/Space.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -28,5 +29,23 @@ ElementFinder::ElementFinder(const std::string &name) : common::Component(name)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Uint ElementFinder::find_elements(const RealMatrix& target_coords, std::vector<SpaceElem>& elements, std::vector<bool>& found)
+{
+  elements.resize(target_coords.rows());
+  found.assign(target_coords.rows(),false);
+  Uint nb_found = 0;
+  RealVector target_coord(target_coords.cols());
+  for (Uint i=0; i<target_coords.rows(); ++i)
+  {
+    target_coord = target_coords.row(i).transpose();
+    found[i] = find_element(target_coord,elements[i]);
+    if (found[i])
+      ++nb_found;
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
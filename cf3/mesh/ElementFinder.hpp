@@ -40,6 +40,14 @@ public:
   /// @return if element was found
   virtual bool find_element(const RealVector& target_coord, SpaceElem& element) = 0;
 
+  /// @brief Find which elements contain the given coordinates
+  /// The default implementation calls find_element() for every coordinate.
+  /// @param [in]  target_coords  The coordinates used to find the elements, one per row
+  /// @param [out] elements       For each coordinate, the found element
+  /// @param [out] found          For each coordinate, if its element was found
+  /// @return the number of coordinates whose element was found
+  virtual Uint find_elements(const RealMatrix& target_coords, std::vector<SpaceElem>& elements, std::vector<bool>& found);
+
 protected:
   Handle<Dictionary> m_dict;
 };
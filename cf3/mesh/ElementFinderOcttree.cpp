@@ -99,8 +99,9 @@ bool ElementFinderOcttree::find_element(const RealVector& target_coord, SpaceEle
       boost_foreach(const Entity& pool_elem, boost::make_iterator_range(m_elements_pool.begin()+pool_size,m_elements_pool.end()))
       {
         cf3_assert(is_not_null(pool_elem.comp));
-        const RealMatrix elem_coordinates = pool_elem.get_coordinates();
-        if (pool_elem.element_type().is_coord_in_element(t_coord,elem_coordinates))
+        pool_elem.allocate_coordinates(m_coordinates);
+        pool_elem.put_coordinates(m_coordinates);
+        if (pool_elem.element_type().is_coord_in_element(t_coord,m_coordinates))
         {
           element = SpaceElem(*const_cast<Space*>(&m_dict->space(*pool_elem.comp)),pool_elem.idx);
           return true;
@@ -113,8 +114,9 @@ bool ElementFinderOcttree::find_element(const RealVector& target_coord, SpaceEle
     boost_foreach(const Entity& pool_elem, boost::make_iterator_range(m_elements_pool.begin()+pool_size,m_elements_pool.end()))
     {
       cf3_assert(is_not_null(pool_elem.comp));
-      const RealMatrix elem_coordinates = pool_elem.get_coordinates();
-      if (pool_elem.element_type().is_coord_in_element(t_coord,elem_coordinates))
+      pool_elem.allocate_coordinates(m_coordinates);
+      pool_elem.put_coordinates(m_coordinates);
+      if (pool_elem.element_type().is_coord_in_element(t_coord,m_coordinates))
       {
         element = SpaceElem(*const_cast<Space*>(&m_dict->space(*pool_elem.comp)),pool_elem.idx);
         return true;
@@ -177,5 +179,32 @@ bool ElementFinderOcttree::find_element(const RealVector& target_coord, SpaceEle
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Uint ElementFinderOcttree::find_elements(const RealMatrix& target_coords, std::vector<SpaceElem>& elements, std::vector<bool>& found)
+{
+  cf3_assert(m_octtree);
+
+  Uint nb_found = m_octtree->find_elements(target_coords,m_entities,found);
+
+  elements.resize(target_coords.rows());
+  RealVector target_coord(target_coords.cols());
+  for (Uint i=0; i<target_coords.rows(); ++i)
+  {
+    if (found[i])
+    {
+      elements[i] = SpaceElem(*const_cast<Space*>(&m_dict->space(*m_entities[i].comp)),m_entities[i].idx);
+    }
+    else if (m_closest)
+    {
+      target_coord = target_coords.row(i).transpose();
+      found[i] = find_element(target_coord,elements[i]);
+      if (found[i])
+        ++nb_found;
+    }
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
@@ -32,6 +32,10 @@ public:
 
   virtual bool find_element(const RealVector& target_coord, SpaceElem& element);
 
+  /// @brief Find which elements contain the given coordinates, searching the octtree for all of them at once
+  /// Coordinates that are not inside any element fall back on find_element(), to find the closest element.
+  virtual Uint find_elements(const RealMatrix& target_coords, std::vector<SpaceElem>& elements, std::vector<bool>& found);
+
 private:
 
   void configure_octtree();
@@ -48,6 +52,8 @@ private:
 
   RealMatrix m_coordinates;
 
+  std::vector<Entity> m_entities;
+
 
 };
 
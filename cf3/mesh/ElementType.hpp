@@ -110,6 +110,14 @@ public: // functions
   /// @param [out] mapped_coord  result
   virtual void compute_mapped_coordinate(const RealVector& coord, const RealMatrix& nodes, RealVector& mapped_coord) const = 0;
 
+  /// Compute Mapped Coordinates of many points inside the same element.
+  /// Per-element work is done only once, so this is cheaper than repeated calls
+  /// to compute_mapped_coordinate()
+  /// @param [in]  coords         coordinates to be mapped, one point per row (nb_points x dimension)
+  /// @param [in]  nodes          coordinates of the element nodes (nb_nodes x dimension)
+  /// @param [out] mapped_coords  result, one point per row (nb_points x dimensionality)
+  virtual void compute_mapped_coordinates(const RealMatrix& coords, const RealMatrix& nodes, RealMatrix& mapped_coords) const = 0;
+
   /// Compute the determinant of the jacobian dX/dKSI
   /// @param [in] mapped_coord  coordinates in mapped space (dimensionality x 1)
   /// @param [in] nodes         coordinates of the element nodes (nb_nodes x dimension)
@@ -167,6 +175,14 @@ public: // functions
   /// @param [in] nodes  the nodes of the element
   virtual bool is_coord_in_element(const RealVector& coord, const RealMatrix& nodes) const = 0;
 
+  /// Check many points against the same element. For linear elements, points outside
+  /// the bounding box of the nodes are rejected without calling is_coord_in_element()
+  /// @return the number of points that are in the element
+  /// @param [in]  coords     the coordinates that will be checked, one point per row
+  /// @param [in]  nodes      the nodes of the element
+  /// @param [out] is_inside  for each point, if it is in the element
+  virtual Uint are_coords_in_element(const RealMatrix& coords, const RealMatrix& nodes, std::vector<bool>& is_inside) const = 0;
+
   /// Compute the jacobian of the plane or section of the element.
   /// The section is given by a mapped coordinate, and a direction perpendicular
   /// to the plane.
@@ -19,6 +19,9 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <vector>
+
 #include "common/StringConversion.hpp"
 #include "math/MatrixTypes.hpp"
 #include "mesh/GeoShape.hpp"
@@ -81,6 +84,8 @@ public:
   static MappedCoordsT mapped_coordinate(const CoordsT& coord, const NodesT& nodes);
   static JacobianT jacobian(const MappedCoordsT& mapped_coord, const NodesT& nodes);
   static CoordsT plane_jacobian_normal(const MappedCoordsT& mapped_coord, const NodesT& nodes, const CoordRef orientation);
+  static void compute_mapped_coordinates(const RealMatrix& coords, const NodesT& nodes, RealMatrix& mapped_coords);
+  static Uint are_coords_in_element(const RealMatrix& coords, const NodesT& nodes, std::vector<bool>& is_inside);
 
 private:
 
@@ -232,6 +237,53 @@ void ElementTypeBase<ETYPE,TR>::compute_plane_jacobian_normal(const MappedCoords
 
 ////////////////////////////////////////////////////////////////////////////////
 
+template <typename ETYPE,typename TR>
+void ElementTypeBase<ETYPE,TR>::compute_mapped_coordinates(const RealMatrix& coords, const NodesT& nodes, RealMatrix& mapped_coords)
+{
+  mapped_coords.resize(coords.rows(), dimensionality);
+  CoordsT coord;
+  MappedCoordsT mapped_coord;
+  for (Uint i=0; i<coords.rows(); ++i)
+  {
+    coord = coords.row(i).transpose();
+    ETYPE::compute_mapped_coordinate(coord, nodes, mapped_coord);
+    mapped_coords.row(i) = mapped_coord.transpose();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename ETYPE,typename TR>
+Uint ElementTypeBase<ETYPE,TR>::are_coords_in_element(const RealMatrix& coords, const NodesT& nodes, std::vector<bool>& is_inside)
+{
+  is_inside.assign(coords.rows(), false);
+
+  // Linear shape functions are non-negative inside the element, so the element lies
+  // within the bounding box of its nodes, and points outside of it are rejected cheaply.
+  CoordsT box_min = nodes.colwise().minCoeff().transpose();
+  CoordsT box_max = nodes.colwise().maxCoeff().transpose();
+  const Real tolerance = 1e-6 * std::max(1., (box_max-box_min).maxCoeff());
+  box_min.array() -= tolerance;
+  box_max.array() += tolerance;
+
+  Uint nb_inside = 0;
+  CoordsT coord;
+  for (Uint i=0; i<coords.rows(); ++i)
+  {
+    coord = coords.row(i).transpose();
+    if (order == 1 && ( (coord.array() < box_min.array()).any() || (coord.array() > box_max.array()).any() ) )
+      continue;
+    if (ETYPE::is_coord_in_element(coord, nodes))
+    {
+      is_inside[i] = true;
+      ++nb_inside;
+    }
+  }
+  return nb_inside;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
 
@@ -104,6 +104,11 @@ public: // functions
     mapped_coord = mapped_c;
   }
 
+  virtual void compute_mapped_coordinates(const RealMatrix& coords, const RealMatrix& nodes, RealMatrix& mapped_coords) const
+  {
+    ETYPE::compute_mapped_coordinates(coords, nodes, mapped_coords);
+  }
+
   virtual Real jacobian_determinant(const RealVector& mapped_coord, const RealMatrix& nodes) const
   {
     return ETYPE::jacobian_determinant(mapped_coord,nodes);
@@ -166,6 +171,11 @@ public: // functions
     return ETYPE::is_coord_in_element(coord,nodes);
   }
 
+  virtual Uint are_coords_in_element(const RealMatrix& coords, const RealMatrix& nodes, std::vector<bool>& is_inside) const
+  {
+    return ETYPE::are_coords_in_element(coords,nodes,is_inside);
+  }
+
   virtual RealVector plane_jacobian_normal(const RealVector& mapped_coord,
                                            const RealMatrix& nodes,
                                            const CoordRef orientation) const
@@ -124,20 +124,46 @@ ElementType& Entities::element_type() const
 common::List<Uint>& Entities::used_nodes(Component& parent, const bool rebuild)
 {
   Handle< common::List<Uint> > used_nodes = find_component_ptr_with_tag<common::List<Uint> >(parent,mesh::Tags::nodes_used());
-  if (rebuild && is_not_null(used_nodes))
+
+  // Without entities there is no node in use, nor a dictionary to check the stored copy against
+  Handle<Entities> first_entities = find_component_ptr_recursively<Entities>(parent);
+  if (is_null(first_entities))
+  {
+    if (is_null(used_nodes))
+    {
+      used_nodes = parent.create_component< List<Uint> >(mesh::Tags::nodes_used());
+      used_nodes->add_tag(mesh::Tags::nodes_used());
+      used_nodes->properties()["brief"] = std::string("The local node indices used by the parent component");
+    }
+    return *used_nodes;
+  }
+
+  const Dictionary& dict = first_entities->geometry_fields();
+  // The stored copy is outdated once the dictionary changed. Copies without a revision were not made here and are never trusted
+  if (is_not_null(used_nodes))
   {
-    parent.remove_component(*used_nodes);
-    used_nodes.reset();
+    const bool has_revision = used_nodes->properties().check("revision");
+    if (rebuild || !has_revision || used_nodes->properties().value<Uint>("revision") != dict.revision())
+    {
+      parent.remove_component(*used_nodes);
+      used_nodes.reset();
+    }
   }
 
   if (is_null(used_nodes))
   {
-    const Dictionary& dict = find_components_recursively<Entities>(parent).begin()->geometry_fields();
-    boost::shared_ptr< List<Uint> > used_nodes_shr = build_used_nodes_list(parent, dict, true);
-    used_nodes = Handle< List<Uint> >(used_nodes_shr);
-    parent.add_component(used_nodes_shr);
+    // An explicit rebuild doesn't trust the cache of the dictionary either
+    boost::shared_ptr< List<Uint> const > nodes;
+    if (rebuild)
+      nodes = build_used_nodes_list(parent, dict, true);
+    else
+      nodes = dict.used_nodes(parent);
+    used_nodes = parent.create_component< List<Uint> >(mesh::Tags::nodes_used());
+    used_nodes->resize(nodes->size());
+    std::copy(nodes->array().begin(), nodes->array().end(), used_nodes->array().begin());
     used_nodes->add_tag(mesh::Tags::nodes_used());
     used_nodes->properties()["brief"] = std::string("The local node indices used by the parent component");
+    used_nodes->properties()["revision"] = dict.revision();
   }
 
   return *used_nodes;
@@ -249,6 +275,7 @@ void Entities::resize(const Uint nb_elem)
   boost_foreach(Space& space, find_components_recursively<Space>(*m_spaces_group))
   {
     space.connectivity().resize(nb_elem);
+    space.dict().increment_revision();
   }
 }
 
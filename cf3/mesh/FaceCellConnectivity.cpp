@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
@@ -17,6 +19,7 @@
 #include "math/Consts.hpp"
 
 #include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/FaceMatcher.hpp"
 #include "mesh/NodeElementConnectivity.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Mesh.hpp"
@@ -127,7 +130,6 @@ void FaceCellConnectivity::build_connectivity()
   common::List<bool>::Buffer is_bdry_face = m_is_bdry_face->create_buffer();
   Dictionary& geometry_fields = find_parent_component<Mesh>(*used()[0]).geometry_fields();
   Uint tot_nb_nodes = geometry_fields.size();
-  std::vector < std::vector<Uint> > mapNodeFace(tot_nb_nodes);
   std::vector<Uint> face_nodes;  face_nodes.reserve(100);
   std::vector<Entity> dummy_element_row(2);
   std::vector<Uint> dummy_idx_row(2);
@@ -165,18 +167,18 @@ void FaceCellConnectivity::build_connectivity()
     }
   }
 
-  // Declarations to save frequent allocations in the loop algorithm
+  // Faces are matched on their sorted node lists
+  Uint max_nb_face_nodes(1);
+  boost_foreach ( Handle< Component > elements_comp, used() )
+  {
+    const ElementType& etype = Handle<Elements>(elements_comp)->element_type();
+    for (Uint face_idx = 0; face_idx != etype.nb_faces(); ++face_idx)
+      max_nb_face_nodes = std::max(max_nb_face_nodes, etype.face_type(face_idx).nb_nodes());
+  }
+  FaceMatcher matcher(max_nb_face_nodes, max_nb_faces / 2);
+
   Uint nb_inner_faces = 0;
-  Uint nb_matched_nodes = 1;
-  Uint face_node_idx;
-  Uint face_node;
-  Uint face;
-  Uint connected_face;
-  Uint node;
   Uint nb_nodes;
-  bool found_face = false;
-  Handle< Component > elem_location_comp;
-  Uint elem_location_idx;
 
   // loop over the element types
   m_nb_faces=0;
@@ -209,80 +211,24 @@ void FaceCellConnectivity::build_connectivity()
         Uint i(0);
         boost_foreach(const Uint face_node_idx, elements.element_type().faces().nodes_range(face_idx))
             face_nodes[i++] = elem_nodes[face_node_idx];
+        cf3_assert(*std::max_element(face_nodes.begin(), face_nodes.end()) < tot_nb_nodes);
 
-
-        // consider the first node belonging to the current face
-        // check if you find a face ID shared between all the other
-        // nodes building a face
-        node = face_nodes[0];
-        cf3_assert(node<tot_nb_nodes);
-
-        found_face = false;
-        // search for matching face if they are registered to the node yet
-        boost_foreach( face, mapNodeFace[node] )
+        const Uint face = matcher.find_or_insert(&face_nodes[0], nb_nodes, m_nb_faces);
+        if (face != m_nb_faces)
         {
-          nb_matched_nodes = 1;
-          if (nb_nodes > 1)
-          {
-            for (face_node_idx=1; face_node_idx!=nb_nodes; ++face_node_idx)
-            {
-              boost_foreach (connected_face, mapNodeFace[face_nodes[face_node_idx]])
-              {
-                if (connected_face == face)
-                {
-                  ++nb_matched_nodes;
-                  break;
-                }
-              }
-
-
-              if (nb_matched_nodes == nb_nodes) // face matches the nodes
-              {
-                // the corresponding face already exists, meaning
-                // that the face is an internal one, shared by two elements
-                // here you set the second element (==state) neighbor of the face
-                found_face = true;
-                //(*m_connectivity)[elemID][iFace] = currFaceID;
-                f2c.get_row(face)[1]=element;
-                face_number.get_row(face)[1]=face_idx;
-                is_bdry_face.get_row(face)=false;
-                // since it has two neighbor cells,
-                // this face is surely NOT a boundary face
-                // m_isBFace[currFaceID] = false;
-
-                // increment number of inner faces (they always have 2 states)
-                ++nb_inner_faces;
-                break;
-              }
-            }
-          }
-          else // this only applies to the 1D case
-          {
-            // the corresponding faceID already exists, meaning
-            // that the face is an internal one, shared by two elements
-            // here you set the second element (==state) neighbor of the face
-            found_face = true;
-            //(*elem_to_face)[elemID][iFace] = currFaceID;
-            f2c.get_row(face)[1]=element;
-            face_number.get_row(face)[1]=face_idx;
-            is_bdry_face.get_row(face)=false;
-
-            // increment number of inner faces (they always have 2 states)
-            ++nb_inner_faces;
-            break;
-          }
+          // the corresponding face already exists, meaning
+          // that the face is an internal one, shared by two elements
+          // here you set the second element (==state) neighbor of the face
+          f2c.get_row(face)[1]=element;
+          face_number.get_row(face)[1]=face_idx;
+          is_bdry_face.get_row(face)=false;
+
+          // increment number of inner faces (they always have 2 states)
+          ++nb_inner_faces;
         }
-        if (found_face == false)
+        else
         {
           // a new face has been found
-          // add the ID of the new face in the corresponding nodes
-          // referencing it
-          boost_foreach (face_node, face_nodes)
-          {
-            mapNodeFace[face_node].push_back(m_nb_faces);
-          }
-
-          // increment the number of faces
           dummy_element_row[0]=element;
           f2c.add_row(dummy_element_row);
 
@@ -0,0 +1,187 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/functional/hash.hpp>
+
+#include "common/Assertions.hpp"
+
+#include "mesh/FaceMatcher.hpp"
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+const Uint FaceMatcher::not_found = std::numeric_limits<Uint>::max();
+
+////////////////////////////////////////////////////////////////////////////////
+
+FaceMatcher::FaceMatcher(const Uint max_nb_nodes, const Uint expected_size) :
+  m_key_size(max_nb_nodes),
+  m_key(max_nb_nodes),
+  m_largest_face(0)
+{
+  cf3_assert(max_nb_nodes > 0);
+
+  // Keep the load factor below 0.5
+  Uint nb_slots = 16;
+  while(nb_slots < 2*expected_size)
+    nb_slots *= 2;
+  m_slots.assign(nb_slots, not_found);
+
+  m_keys.reserve(expected_size*m_key_size);
+  m_hashes.reserve(expected_size);
+  m_values.reserve(expected_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::find_or_insert(const Uint* nodes, const Uint nb_nodes, const Uint value)
+{
+  cf3_assert(value != not_found);
+
+  const std::size_t hash = make_key(nodes, nb_nodes);
+  const Uint slot = find_slot(hash);
+  if(m_slots[slot] != not_found)
+    return m_values[m_slots[slot]];
+
+  m_slots[slot] = m_values.size();
+  m_keys.insert(m_keys.end(), m_key.begin(), m_key.end());
+  m_hashes.push_back(hash);
+  m_values.push_back(value);
+  m_largest_face = std::max(m_largest_face, nb_nodes);
+  m_node_faces_begin.clear();
+
+  if(2*m_values.size() > m_slots.size())
+    grow();
+
+  return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::find(const Uint* nodes, const Uint nb_nodes) const
+{
+  const Uint slot = find_slot(make_key(nodes, nb_nodes));
+  return m_slots[slot] == not_found ? not_found : m_values[m_slots[slot]];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::find_containing(const Uint* nodes, const Uint nb_nodes) const
+{
+  if(nb_nodes == 0 || nb_nodes >= m_largest_face)
+    return not_found;
+
+  if(m_node_faces_begin.empty())
+    build_node_faces();
+
+  make_key(nodes, nb_nodes);
+  // Every candidate is attached to the first node, and both keys are sorted
+  const Uint first_node = m_key[0];
+  if(first_node + 1 >= m_node_faces_begin.size())
+    return not_found;
+  const Uint faces_end = m_node_faces_begin[first_node+1];
+  for(Uint i = m_node_faces_begin[first_node]; i != faces_end; ++i)
+  {
+    const Uint face = m_node_faces[i];
+    std::vector<Uint>::const_iterator face_key = m_keys.begin() + face*m_key_size;
+    const Uint face_nb_nodes = std::find(face_key, face_key + m_key_size, not_found) - face_key;
+    if(face_nb_nodes > nb_nodes && std::includes(face_key, face_key + face_nb_nodes, m_key.begin(), m_key.begin() + nb_nodes))
+      return m_values[face];
+  }
+  return not_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::build_node_faces() const
+{
+  Uint nb_nodes = 0;
+  for(std::vector<Uint>::const_iterator node = m_keys.begin(); node != m_keys.end(); ++node)
+  {
+    if(*node != not_found)
+      nb_nodes = std::max(nb_nodes, *node + 1);
+  }
+
+  // Count the faces of each node, then fill in insertion order
+  m_node_faces_begin.assign(nb_nodes+1, 0);
+  for(std::vector<Uint>::const_iterator node = m_keys.begin(); node != m_keys.end(); ++node)
+  {
+    if(*node != not_found)
+      ++m_node_faces_begin[*node+1];
+  }
+  for(Uint node = 0; node != nb_nodes; ++node)
+    m_node_faces_begin[node+1] += m_node_faces_begin[node];
+
+  m_node_faces.resize(m_node_faces_begin.back());
+  std::vector<Uint> fill_position(m_node_faces_begin.begin(), m_node_faces_begin.end()-1);
+  const Uint nb_faces = m_values.size();
+  for(Uint face = 0; face != nb_faces; ++face)
+  {
+    for(Uint i = 0; i != m_key_size; ++i)
+    {
+      const Uint node = m_keys[face*m_key_size + i];
+      if(node == not_found)
+        break;
+      m_node_faces[fill_position[node]++] = face;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t FaceMatcher::make_key(const Uint* nodes, const Uint nb_nodes) const
+{
+  cf3_assert(nb_nodes <= m_key_size);
+
+  std::copy(nodes, nodes + nb_nodes, m_key.begin());
+  std::sort(m_key.begin(), m_key.begin() + nb_nodes);
+  std::fill(m_key.begin() + nb_nodes, m_key.end(), not_found);
+
+  return boost::hash_range(m_key.begin(), m_key.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint FaceMatcher::find_slot(const std::size_t hash) const
+{
+  const Uint mask = m_slots.size() - 1;
+  Uint slot = hash & mask;
+  while(true)
+  {
+    const Uint face = m_slots[slot];
+    if(face == not_found)
+      return slot;
+    if(m_hashes[face] == hash && std::equal(m_key.begin(), m_key.end(), m_keys.begin() + face*m_key_size))
+      return slot;
+    slot = (slot + 1) & mask; // linear probing
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceMatcher::grow()
+{
+  m_slots.assign(2*m_slots.size(), not_found);
+  const Uint mask = m_slots.size() - 1;
+  const Uint nb_faces = m_values.size();
+  for(Uint face = 0; face != nb_faces; ++face)
+  {
+    Uint slot = m_hashes[face] & mask;
+    while(m_slots[slot] != not_found)
+      slot = (slot + 1) & mask;
+    m_slots[slot] = face;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
@@ -0,0 +1,101 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_FaceMatcher_hpp
+#define cf3_mesh_FaceMatcher_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "mesh/LibMesh.hpp"
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Finds faces by their nodes, regardless of the order in which the nodes are given.
+/// Each face is keyed by its sorted node list, and the keys are stored contiguously
+/// in an open-addressing hash table, so matching N faces costs O(N) instead of
+/// scanning the faces attached to each node.
+class Mesh_API FaceMatcher
+{
+public: // functions
+
+  /// Value returned when a face is not in the table
+  static const Uint not_found;
+
+  /// @param max_nb_nodes Largest number of nodes of the faces that will be inserted
+  /// @param expected_size Number of faces to reserve space for
+  FaceMatcher(const Uint max_nb_nodes, const Uint expected_size = 0);
+
+  /// Look up the face with the given nodes, inserting it with the given value if it is not found
+  /// @return The value of the existing face, or the new value if it was inserted
+  Uint find_or_insert(const Uint* nodes, const Uint nb_nodes, const Uint value);
+
+  /// Look up the face with the given nodes
+  /// @return The value of the face, or not_found
+  Uint find(const Uint* nodes, const Uint nb_nodes) const;
+
+  /// Look up the first inserted face with more nodes than given, that contains all the given nodes.
+  /// This finds e.g. the face of a cell that a boundary face with only part of its nodes lies on.
+  /// The node to face lists this needs are built on the first call after an insertion.
+  /// @return The value of the face, or not_found
+  Uint find_containing(const Uint* nodes, const Uint nb_nodes) const;
+
+  /// Number of faces in the table
+  Uint size() const { return m_values.size(); }
+
+private: // functions
+
+  /// Copy the sorted nodes in the key buffer, padded to the key size, and return the hash of the key
+  std::size_t make_key(const Uint* nodes, const Uint nb_nodes) const;
+
+  /// Slot containing the key in the key buffer, or the empty slot where it should go
+  Uint find_slot(const std::size_t hash) const;
+
+  /// Double the number of slots
+  void grow();
+
+  /// Build the lists of faces attached to each node
+  void build_node_faces() const;
+
+private: // data
+
+  /// Number of Uints in a key
+  const Uint m_key_size;
+
+  /// Keys of the inserted faces, in insertion order
+  std::vector<Uint> m_keys;
+  /// Hashes of the inserted faces
+  std::vector<std::size_t> m_hashes;
+  /// Values of the inserted faces
+  std::vector<Uint> m_values;
+
+  /// Index of the face stored in each slot, or not_found. The size is a power of two.
+  std::vector<Uint> m_slots;
+
+  /// Buffer for the key that is looked up
+  mutable std::vector<Uint> m_key;
+
+  /// Largest number of nodes of an inserted face
+  Uint m_largest_face;
+
+  /// Faces attached to each node, as a compressed table, in insertion order for every node.
+  /// Empty when it needs to be rebuilt
+  mutable std::vector<Uint> m_node_faces_begin;
+  mutable std::vector<Uint> m_node_faces;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_FaceMatcher_hpp
@@ -31,5 +31,23 @@ InterpolationFunction::InterpolationFunction( const std::string& name )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void InterpolationFunction::compute_interpolation_weights_of_points(const RealMatrix& coordinates, const std::vector<SpaceElem>& stencil,
+                                                                    std::vector< std::vector<Uint> >& source_field_points,
+                                                                    std::vector< std::vector<Real> >& source_field_weights)
+{
+  source_field_points.resize(coordinates.rows());
+  source_field_weights.resize(coordinates.rows());
+  RealVector coordinate(coordinates.cols());
+  for (Uint i=0; i<coordinates.rows(); ++i)
+  {
+    coordinate = coordinates.row(i).transpose();
+    source_field_points[i].clear();
+    source_field_weights[i].clear();
+    compute_interpolation_weights(coordinate,stencil,source_field_points[i],source_field_weights[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
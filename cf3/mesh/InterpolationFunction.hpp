@@ -38,6 +38,13 @@ public:
   virtual void compute_interpolation_weights(const RealVector& coordinate, const std::vector<SpaceElem>& stencil,
                                              std::vector<Uint>& source_field_points, std::vector<Real>& source_field_weights) = 0;
 
+  /// @brief Compute interpolation points and weights for several coordinates sharing the same stencil
+  /// The default implementation calls compute_interpolation_weights() for every coordinate.
+  /// @param [in]  coordinates  the coordinates to interpolate to, one per row
+  virtual void compute_interpolation_weights_of_points(const RealMatrix& coordinates, const std::vector<SpaceElem>& stencil,
+                                                       std::vector< std::vector<Uint> >& source_field_points,
+                                                       std::vector< std::vector<Real> >& source_field_weights);
+
 protected:
 
   Handle<Dictionary> m_dict;
@@ -141,29 +141,31 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
 
     std::vector<Uint> send_found_coords;  send_found_coords.reserve(nb_received_coords);
 
-    Uint dim = target_coords.row_size();
-    RealVector t_point(dim);
-    SpaceElem element;
-    std::vector<SpaceElem> stencil;
-    std::vector<Uint> points;
-    std::vector<Real> weights;
+    // Look for all received coordinates at once
+    RealMatrix t_points(nb_received_coords,dim);
+    for (Uint t=0; t<nb_received_coords; ++t)
+      t_points.row(t) = RealRowVector::MapType(&received_coords[t*dim],dim);
+
+    std::vector<SpaceElem> elements;
+    std::vector< std::vector<SpaceElem> > stencils;
+    std::vector< std::vector<Uint> > points;
+    std::vector< std::vector<Real> > weights;
+    std::vector<bool> interpolation_possible_on_this_proc;
+    m_point_interpolator->compute_storage(t_points,
+                                          elements,
+                                          stencils,
+                                          points,
+                                          weights,
+                                          interpolation_possible_on_this_proc);
 
     for (Uint t=0; t<nb_received_coords; ++t)
     {
-      t_point = RealVector::MapType(&received_coords[t*dim],dim);
-      bool interpolation_possible_on_this_proc =
-          m_point_interpolator->compute_storage(t_point,
-                                                element,
-                                                stencil,
-                                                points,
-                                                weights);
-
-      if (interpolation_possible_on_this_proc)
+      if (interpolation_possible_on_this_proc[t])
       {
-        m_stored_element[pid_recv_coords].push_back(element);
-        m_stored_stencil[pid_recv_coords].push_back(stencil);
-        m_stored_source_field_points[pid_recv_coords].push_back(points);
-        m_stored_source_field_weights[pid_recv_coords].push_back(weights);
+        m_stored_element[pid_recv_coords].push_back(elements[t]);
+        m_stored_stencil[pid_recv_coords].push_back(stencils[t]);
+        m_stored_source_field_points[pid_recv_coords].push_back(points[t]);
+        m_stored_source_field_weights[pid_recv_coords].push_back(weights[t]);
 
         // mark found
         send_found_coords.push_back(t);
@@ -33,6 +33,107 @@ common::ComponentBuilder < ElementTypeT<Hexa3D>, ElementType , LibLagrangeP1 >
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// Local coordinate system of a hexahedron, used to invert its mapping.
+  /// It only depends on the element nodes, so it is computed once per element
+  /// and reused for all points that are mapped into the same element.
+  struct Hexa3DFrame
+  {
+    typedef Hexa3D::CoordsT CoordsT;
+    typedef Hexa3D::NodesT NodesT;
+    typedef Hexa3D::MappedCoordsT MappedCoordsT;
+    typedef Hexa3D::SF SF;
+
+    Hexa3DFrame(const NodesT& nodes)
+    {
+      // Axes of the local coordinate system, centered around the centroid and going through the center of each face
+      SF::ValueT sf;
+      SF::compute_value(CoordsT(1.,0.,0.), sf);
+      CoordsT ux = (sf*nodes).transpose();
+      SF::compute_value(CoordsT(0.,1.,0.), sf);
+      CoordsT uy = (sf*nodes).transpose();
+      SF::compute_value(CoordsT(0.,0.,1.), sf);
+      CoordsT uz = (sf*nodes).transpose();
+
+      SF::compute_value(CoordsT(-1.,0.,0.), sf);
+      CoordsT ux_neg = (sf*nodes).transpose();
+      SF::compute_value(CoordsT(0.,-1.,0.), sf);
+      CoordsT uy_neg = (sf*nodes).transpose();
+      SF::compute_value(CoordsT(0.,0.,-1.), sf);
+      CoordsT uz_neg = (sf*nodes).transpose();
+
+      centroid[XX] = (ux[XX] + ux_neg[XX]) * 0.5;
+      centroid[YY] = (uy[YY] + uy_neg[YY]) * 0.5;
+      centroid[ZZ] = (uz[ZZ] + uz_neg[ZZ]) * 0.5;
+
+      ux -= ux_neg;
+      uy -= uy_neg;
+      uz -= uz_neg;
+
+      ux *= 0.5; // because the origin is at the center
+      uy *= 0.5;
+      uz *= 0.5;
+
+      const Real ux_len_inv = 1. / ux.norm();
+      const Real uy_len_inv = 1. / uy.norm();
+      const Real uz_len_inv = 1. / uz.norm();
+
+      ux *= ux_len_inv;
+      uy *= uy_len_inv;
+      uz *= uz_len_inv;
+
+      // Normal vectors
+      nyz = uy.cross(uz);
+      nxz = ux.cross(uz);
+      nxy = ux.cross(uy);
+
+      // division factors for line-plane intersection
+      fx = ux_len_inv / ux.dot(nyz);
+      fy = uy_len_inv / uy.dot(nxz);
+      fz = uz_len_inv / uz.dot(nxy);
+    }
+
+    /// Compute the mapped coordinates of coord, for the element with the nodes this frame was built from
+    void invert(const CoordsT& coord, const NodesT& nodes, MappedCoordsT& mapped_coord) const
+    {
+      SF::ValueT sf;
+      CoordsT diff = coord-centroid;
+      CoordsT test;
+      const Real threshold = 1e-24; // 1e-12 squared, because we compare the squared distance
+      Uint nb_iters = 0;
+      // Initial guess will be correct if our element is a parallelepiped
+      mapped_coord[KSI] = diff.dot(nyz) * fx;
+      mapped_coord[ETA] = diff.dot(nxz) * fy;
+      mapped_coord[ZTA] = diff.dot(nxy) * fz;
+      while (nb_iters < 100 && diff.dot(diff) > threshold)
+      {
+        SF::compute_value(mapped_coord, sf);
+        test = (sf*nodes).transpose();
+        diff = coord - test;
+        test[XX] = diff.dot(nyz) * fx;  // Transform difference to the relative coordinate system and
+        test[YY] = diff.dot(nxz) * fy;  // use it to adjust our initial guess
+        test[ZZ] = diff.dot(nxy) * fz;
+        mapped_coord += test;
+        ++nb_iters;
+      }
+
+      if(nb_iters > 100)
+        throw common::FailedToConverge(FromHere(), "Failed to find Hexa3DLagrangeP1 mapped coordinates");
+    }
+
+    CoordsT centroid;
+    CoordsT nyz;
+    CoordsT nxz;
+    CoordsT nxy;
+    Real fx;
+    Real fy;
+    Real fz;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 const cf3::mesh::ElementType::FaceConnectivity& Hexa3D::faces()
 {
   static ElementType::FaceConnectivity connectivity;
@@ -84,75 +185,24 @@ bool Hexa3D::is_coord_in_element(const CoordsT& coord, const NodesT& nodes)
 
 void Hexa3D::compute_mapped_coordinate(const CoordsT& coord, const NodesT& nodes, MappedCoordsT& mapped_coord)
 {
-  // Axes of the local coordinate system, centered around the centroid and going through the center of each face
-  SF::ValueT sf;
-  SF::compute_value(CoordsT(1.,0.,0.), sf);
-  CoordsT ux = (sf*nodes).transpose();
-  SF::compute_value(CoordsT(0.,1.,0.), sf);
-  CoordsT uy = (sf*nodes).transpose();
-  SF::compute_value(CoordsT(0.,0.,1.), sf);
-  CoordsT uz = (sf*nodes).transpose();
-
-  SF::compute_value(CoordsT(-1.,0.,0.), sf);
-  CoordsT ux_neg = (sf*nodes).transpose();
-  SF::compute_value(CoordsT(0.,-1.,0.), sf);
-  CoordsT uy_neg = (sf*nodes).transpose();
-  SF::compute_value(CoordsT(0.,0.,-1.), sf);
-  CoordsT uz_neg = (sf*nodes).transpose();
-
-  CoordsT centroid;
-  centroid[XX] = (ux[XX] + ux_neg[XX]) * 0.5;
-  centroid[YY] = (uy[YY] + uy_neg[YY]) * 0.5;
-  centroid[ZZ] = (uz[ZZ] + uz_neg[ZZ]) * 0.5;
-
-  ux -= ux_neg;
-  uy -= uy_neg;
-  uz -= uz_neg;
-
-  ux *= 0.5; // because the origin is at the center
-  uy *= 0.5;
-  uz *= 0.5;
-
-  const Real ux_len_inv = 1. / ux.norm();
-  const Real uy_len_inv = 1. / uy.norm();
-  const Real uz_len_inv = 1. / uz.norm();
-
-  ux *= ux_len_inv;
-  uy *= uy_len_inv;
-  uz *= uz_len_inv;
-
-  // Normal vectors
-  CoordsT nyz = uy.cross(uz);
-  CoordsT nxz = ux.cross(uz);
-  CoordsT nxy = ux.cross(uy);
-
-  // division factors for line-plane intersection
-  const Real fx = ux_len_inv / ux.dot(nyz);
-  const Real fy = uy_len_inv / uy.dot(nxz);
-  const Real fz = uz_len_inv / uz.dot(nxy);
-
-  CoordsT diff = coord-centroid;
-  CoordsT test;
-  const Real threshold = 1e-24; // 1e-12 squared, because we compare the squared distance
-  Uint nb_iters = 0;
-  // Initial guess will be correct if our element is a parallelepiped
-  mapped_coord[KSI] = diff.dot(nyz) * fx;
-  mapped_coord[ETA] = diff.dot(nxz) * fy;
-  mapped_coord[ZTA] = diff.dot(nxy) * fz;
-  while (nb_iters < 100 && diff.dot(diff) > threshold)
+  const detail::Hexa3DFrame frame(nodes);
+  frame.invert(coord, nodes, mapped_coord);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Hexa3D::compute_mapped_coordinates(const RealMatrix& coords, const NodesT& nodes, RealMatrix& mapped_coords)
+{
+  const detail::Hexa3DFrame frame(nodes);
+  mapped_coords.resize(coords.rows(), dimensionality);
+  CoordsT coord;
+  MappedCoordsT mapped_coord;
+  for (Uint i=0; i<coords.rows(); ++i)
   {
-    SF::compute_value(mapped_coord, sf);
-    test = (sf*nodes).transpose();
-    diff = coord - test;
-    test[XX] = diff.dot(nyz) * fx;  // Transform difference to the relative coordinate system and
-    test[YY] = diff.dot(nxz) * fy;  // use it to adjust our initial guess
-    test[ZZ] = diff.dot(nxy) * fz;
-    mapped_coord += test;
-    ++nb_iters;
+    coord = coords.row(i).transpose();
+    frame.invert(coord, nodes, mapped_coord);
+    mapped_coords.row(i) = mapped_coord.transpose();
   }
-
-  if(nb_iters > 100)
-    throw common::FailedToConverge(FromHere(), "Failed to find Hexa3DLagrangeP1 mapped coordinates");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -50,6 +50,7 @@ struct Mesh_LagrangeP1_API Hexa3D : public ElementTypeBase<Hexa3D,Hexa3D_traits>
 
   static MappedCoordsT mapped_coordinate(const CoordsT& coord, const NodesT& nodes);
   static void compute_mapped_coordinate(const CoordsT& coord, const NodesT& nodes, MappedCoordsT& mapped_coord);
+  static void compute_mapped_coordinates(const RealMatrix& coords, const NodesT& nodes, RealMatrix& mapped_coords);
   static Real jacobian_determinant(const MappedCoordsT& mapped_coord, const NodesT& nodes);
   static JacobianT jacobian(const MappedCoordsT& mapped_coord, const NodesT& nodes);
   static void compute_jacobian(const MappedCoordsT& mapped_coord, const NodesT& nodes, JacobianT& jacobian);
@@ -392,6 +392,22 @@ void MeshAdaptor::add_element(const PackedElement& packed_element)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MeshAdaptor::reserve_elements(const Uint entities_idx, const Uint nb_elements)
+{
+  if (has_element_buffers == false)
+    create_element_buffers();
+
+  cf3_assert(entities_idx < element_glb_idx.size());
+  element_glb_idx[entities_idx]->reserve(nb_elements);
+  element_rank[entities_idx]->reserve(nb_elements);
+  for (Uint space_idx=0; space_idx<element_connected_nodes[entities_idx].size(); ++space_idx)
+    element_connected_nodes[entities_idx][space_idx]->reserve(nb_elements);
+  if (nb_elements != 0)
+    elem_flush_required = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MeshAdaptor::remove_element(const PackedElement& packed_element)
 {
   remove_element(packed_element.entities_idx(),packed_element.loc_idx());
@@ -441,6 +457,22 @@ void MeshAdaptor::add_node(const PackedNode& packed_node)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void MeshAdaptor::reserve_nodes(const Uint dict_idx, const Uint nb_nodes)
+{
+  if (has_node_buffers == false)
+    create_node_buffers();
+
+  cf3_assert(dict_idx < node_glb_idx.size());
+  node_glb_idx[dict_idx]->reserve(nb_nodes);
+  node_rank[dict_idx]->reserve(nb_nodes);
+  for (Uint fields_idx=0; fields_idx<node_field_values[dict_idx].size(); ++fields_idx)
+    node_field_values[dict_idx][fields_idx]->reserve(nb_nodes);
+  if (nb_nodes != 0)
+    node_flush_required = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void MeshAdaptor::remove_node(const PackedNode& packed_node)
 {
   remove_node(packed_node.dict_idx(),packed_node.loc_idx());
@@ -638,6 +670,29 @@ void MeshAdaptor::send_elements(const std::vector< std::vector< std::vector<Uint
   // Element-node connectivity tables must be GLOBAL
   make_element_node_connectivity_global();
 
+  // Allocate the send buffer once, all packed elements of the same entities have the same size
+  Uint send_size = 0;
+  for (Uint entities_idx=0; entities_idx<nb_entities; ++entities_idx)
+  {
+    Uint nb_exported = 0;
+    Uint sample_elem = 0;
+    for (Uint pid=0; pid<PE::Comm::instance().size(); ++pid)
+    {
+      const std::vector<Uint>& exported = exported_elements_loc_id[pid][entities_idx];
+      if (nb_exported == 0 && !exported.empty())
+        sample_elem = exported.front();
+      nb_exported += exported.size();
+    }
+    if (nb_exported)
+    {
+      PE::Buffer sample;
+      PackedElement packed_elem(*m_mesh, entities_idx, sample_elem);
+      sample << packed_elem;
+      send_size += nb_exported*sample.size();
+    }
+  }
+  send_buffer.reserve(send_size);
+
   // 1) Sending elements, and building nodes_to_send change set
   for (Uint pid=0; pid<PE::Comm::instance().size(); ++pid)
   {
@@ -675,6 +730,23 @@ void MeshAdaptor::send_elements(const std::vector< std::vector< std::vector<Uint
     }
   }
 
+  // Count the received elements that will be added, so the element tables are grown only once
+  {
+    if (has_element_buffers == false)
+      create_element_buffers();
+    std::vector< std::set<boost::uint64_t> > new_elements(nb_entities);
+    PackedElement unpacked_elem(*m_mesh);
+    while (receive_buffer.more_to_unpack())
+    {
+      receive_buffer >> unpacked_elem;
+      if (mesh_elems.count(unpacked_elem.glb_idx()) == 0 && added_elements[unpacked_elem.entities_idx()].count(unpacked_elem.glb_idx()) == 0)
+        new_elements[unpacked_elem.entities_idx()].insert(unpacked_elem.glb_idx());
+    }
+    receive_buffer.unpacked_idx() = 0;
+    for (Uint entities_idx=0; entities_idx<nb_entities; ++entities_idx)
+      reserve_elements(entities_idx,new_elements[entities_idx].size());
+  }
+
   // Unpack elements from the receive_buffer on the receiving side
   std::vector< std::vector< std::set<boost::uint64_t> > > received_glb_elements_pid(PE::Comm::instance().size(), std::vector< std::set<boost::uint64_t> >(m_mesh->elements().size()));
 
@@ -738,6 +810,29 @@ void MeshAdaptor::send_nodes(const std::vector< std::vector< std::vector<Uint> >
   // Declaration of send/receive buffers
   PE::Buffer send_buffer, receive_buffer;
 
+  // Allocate the send buffer once, all packed nodes of the same dictionary have the same size
+  Uint send_size = 0;
+  for (Uint dict_idx=0; dict_idx<nb_dicts; ++dict_idx)
+  {
+    Uint nb_exported = 0;
+    Uint sample_node = 0;
+    for (Uint pid=0; pid<PE::Comm::instance().size(); ++pid)
+    {
+      const std::vector<Uint>& exported = exported_nodes_loc_id[pid][dict_idx];
+      if (nb_exported == 0 && !exported.empty())
+        sample_node = exported.front();
+      nb_exported += exported.size();
+    }
+    if (nb_exported)
+    {
+      PE::Buffer sample;
+      PackedNode packed_node(*m_mesh, dict_idx, sample_node);
+      sample << packed_node;
+      send_size += nb_exported*sample.size();
+    }
+  }
+  send_buffer.reserve(send_size);
+
   // 3) Send nodes
   // Prepare send-buffer to be used again, now for nodes
 
@@ -763,6 +858,25 @@ void MeshAdaptor::send_nodes(const std::vector< std::vector< std::vector<Uint> >
   //////PECheckArrivePoint(100,"nodes sent/received");
 
   // 4) Add nodes on receiving side
+
+  // Count the received nodes that will be added, so the node tables are grown only once
+  {
+    if (has_node_buffers == false)
+      create_node_buffers();
+    std::vector< std::set<boost::uint64_t> > new_nodes(nb_dicts);
+    PackedNode unpacked_node(*m_mesh);
+    while (receive_buffer.more_to_unpack())
+    {
+      receive_buffer >> unpacked_node;
+      const common::Map<boost::uint64_t,Uint>& glb_to_loc = m_mesh->dictionaries()[unpacked_node.dict_idx()]->glb_to_loc();
+      if (!glb_to_loc.exists(unpacked_node.glb_idx()) && added_nodes[unpacked_node.dict_idx()].count(unpacked_node.glb_idx()) == 0)
+        new_nodes[unpacked_node.dict_idx()].insert(unpacked_node.glb_idx());
+    }
+    receive_buffer.unpacked_idx() = 0;
+    for (Uint dict_idx=0; dict_idx<nb_dicts; ++dict_idx)
+      reserve_nodes(dict_idx,new_nodes[dict_idx].size());
+  }
+
   std::vector< std::vector<std::set<boost::uint64_t> > > received_glb_nodes_pid(PE::Comm::instance().size(),std::vector<std::set<boost::uint64_t> >(nb_dicts));
   // Scope this
   {
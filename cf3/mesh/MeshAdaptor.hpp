@@ -76,6 +76,12 @@ public:
   /// @pre create_element_buffers() must have been called before
   void add_element(const PackedElement& packed_element);
 
+  /// @brief Reserve room for elements that will be added with add_element()
+  /// @note Indices of elements that are added or removed before stay valid
+  /// @param [in] entities_idx  index of the entities in the mesh
+  /// @param [in] nb_elements   number of elements to add, or an upper bound
+  void reserve_elements(const Uint entities_idx, const Uint nb_elements);
+
   /// @brief Remove element from the mesh
   /// @note Changes are only applied after flush_elements() or finish() is called
   /// @pre create_element_buffers() must have been called before
@@ -95,6 +101,12 @@ public:
   /// @pre create_node_buffers() must have been called before
   void add_node(const PackedNode& packed_node);
 
+  /// @brief Reserve room for nodes that will be added with add_node()
+  /// @note Indices of nodes that are added or removed before stay valid
+  /// @param [in] dict_idx  index of the dictionary in the mesh
+  /// @param [in] nb_nodes  number of nodes to add, or an upper bound
+  void reserve_nodes(const Uint dict_idx, const Uint nb_nodes);
+
   /// @brief Remove node from the mesh
   /// @note Changes are only applied after flush_nodes() or finish() is called
   /// @pre create_node_buffers() must have been called before
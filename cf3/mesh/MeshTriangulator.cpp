@@ -27,6 +27,19 @@ using namespace common;
 
 common::ComponentBuilder < MeshTriangulator, MeshTransformer, LibMesh> MeshTriangulator_Builder;
 
+const Uint MeshTriangulator::quad_triangles[2][3] = {
+  {0, 1, 2},
+  {2, 3, 0}
+};
+
+const Uint MeshTriangulator::hexa_tetrahedra[5][4] = {
+  {0, 1, 2, 5},
+  {0, 2, 3, 7},
+  {5, 7, 6, 2},
+  {4, 7, 5, 0},
+  {0, 7, 5, 2}
+};
+
 MeshTriangulator::MeshTriangulator(const std::string& name) : MeshTransformer(name)
 {
 }
@@ -53,13 +66,11 @@ void MeshTriangulator::execute()
       Connectivity::Row triag_row1 = triag_conn[i*2];
       Connectivity::Row triag_row2 = triag_conn[i*2+1];
 
-      triag_row1[0] = quad_row[0];
-      triag_row1[1] = quad_row[1];
-      triag_row1[2] = quad_row[2];
-
-      triag_row2[0] = quad_row[2];
-      triag_row2[1] = quad_row[3];
-      triag_row2[2] = quad_row[0];
+      for(Uint j = 0; j != 3; ++j)
+      {
+        triag_row1[j] = quad_row[quad_triangles[0][j]];
+        triag_row2[j] = quad_row[quad_triangles[1][j]];
+      }
     }
 
     to_remove.push_back(quads.handle());
@@ -67,15 +78,6 @@ void MeshTriangulator::execute()
 
   // Convert 3D mesh
 
-  // Keeps track of the per-tetrahedron indices
-  const Uint tetra_indices[5][4] = {
-    {0, 1, 2, 5},
-    {0, 2, 3, 7},
-    {5, 7, 6, 2},
-    {4, 7, 5, 0},
-    {0, 7, 5, 2}
-  };
-
   // local node indices for the triangles that split each side of the hexahedron
   const Uint face_nodes[6][2][3] = {
     {{0, 3, 2}, {2, 1, 0}},
@@ -128,7 +130,7 @@ void MeshTriangulator::execute()
         Connectivity::Row tetra_row = tetra_conn[i*5+j];
         for(Uint k = 0; k != 4; ++k) // loop over tetra nodes
         {
-          tetra_row[k] = hexa_row[tetra_indices[j][k]];
+          tetra_row[k] = hexa_row[hexa_tetrahedra[j][k]];
         }
       }
 
@@ -34,6 +34,12 @@ public: // functions
   static std::string type_name () { return "MeshTriangulator"; }
 
   virtual void execute();
+
+  /// Local node indices of the two triangles that split a quadrilateral
+  static const Uint quad_triangles[2][3];
+
+  /// Local node indices of the five tetrahedra that split a hexahedron
+  static const Uint hexa_tetrahedra[5][4];
 };
 
   ////////////////////////////////////////////////////////////////////////////////
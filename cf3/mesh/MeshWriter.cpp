@@ -4,13 +4,15 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <boost/functional/hash.hpp>
+
 #include "common/Log.hpp"
 #include "common/Signal.hpp"
 #include "common/OptionURI.hpp"
 #include "common/OptionArray.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
-#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
 #include "common/Environment.hpp"
 #include "common/Core.hpp"
 #include "common/FindComponents.hpp"
@@ -24,6 +26,8 @@
 #include "mesh/Cells.hpp"
 #include "mesh/Faces.hpp"
 #include "mesh/CellFaces.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
 
 namespace cf3 {
 namespace mesh {
@@ -33,7 +37,8 @@ using namespace common;
 ////////////////////////////////////////////////////////////////////////////////
 
 MeshWriter::MeshWriter ( const std::string& name  ) :
-  Action ( name )
+  Action ( name ),
+  m_snapshot_metadata(0)
 {
   mark_basic();
 
@@ -128,16 +133,24 @@ void MeshWriter::config_regions()
   if (is_null(m_mesh))
     throw SetupError(FromHere(),"Mesh was not configured in mesh-writer ["+uri().string()+"]");
 
+  m_regions = selected_regions(*m_mesh);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<Handle<Region const> > MeshWriter::selected_regions(const Mesh& mesh) const
+{
   std::vector<URI> region_uris = options()["regions"].value< std::vector<URI> >();
   cf3_assert(region_uris.size());
-  m_regions.clear();
-  m_regions.reserve(region_uris.size());
+  std::vector<Handle<Region const> > regions;
+  regions.reserve(region_uris.size());
   boost_foreach ( const URI& uri, region_uris)
   {
-    m_regions.push_back(Handle<Region const>(m_mesh->access_component_checked(uri)));
-    if ( is_null(m_regions.back()) )
+    regions.push_back(Handle<Region const>(mesh.access_component_checked(uri)));
+    if ( is_null(regions.back()) )
       throw ValueNotFound(FromHere(),"Invalid URI ["+uri.string()+"]");
   }
+  return regions;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -162,6 +175,38 @@ void MeshWriter::execute()
   // Configure the regions to write
   config_regions();
 
+  write_regions();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MeshWriter::write_snapshot(const Mesh& mesh,
+                                const URI& file_path,
+                                const std::vector<Handle<Field const> >& fields,
+                                const std::vector<Handle<Region const> >& regions,
+                                const PropertyList& metadata)
+{
+  m_mesh = mesh.handle<Mesh const>();
+  m_file_path = file_path;
+  m_fields = fields;
+  m_regions = regions;
+  m_snapshot_metadata = &metadata;
+  try
+  {
+    write_regions();
+  }
+  catch(...)
+  {
+    m_snapshot_metadata = 0;
+    throw;
+  }
+  m_snapshot_metadata = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void MeshWriter::write_regions()
+{
   m_filtered_entities.clear();
   boost_foreach(const Handle<Region const>& region, m_regions)
     boost_foreach(const Entities& entities, find_components_recursively_with_filter<Entities>(*region,m_entities_filter))
@@ -173,6 +218,14 @@ void MeshWriter::execute()
 
 //////////////////////////////////////////////////////////////////////////////
 
+const PropertyList& MeshWriter::metadata() const
+{
+  cf3_assert(is_not_null(m_mesh));
+  return m_snapshot_metadata ? *m_snapshot_metadata : m_mesh->metadata().properties();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void MeshWriter::write_from_to(const Mesh& mesh, const URI& file_path)
 {
   options().set("mesh",mesh.handle<Mesh const>());
@@ -181,6 +234,28 @@ void MeshWriter::write_from_to(const Mesh& mesh, const URI& file_path)
 };
 
 
+//////////////////////////////////////////////////////////////////////////////
+
+std::size_t MeshWriter::geometry_hash() const
+{
+  cf3_assert(is_not_null(m_mesh));
+
+  const Field& coordinates = m_mesh->geometry_fields().coordinates();
+  std::size_t seed = 0;
+  boost::hash_combine(seed, coordinates.size());
+  boost::hash_combine(seed, coordinates.row_size());
+  boost::hash_range(seed, coordinates.array().data(), coordinates.array().data() + coordinates.array().num_elements());
+
+  boost_foreach(const Entities& entities, find_components_recursively<Entities>(m_mesh->topology()))
+  {
+    const Connectivity::ArrayT& connectivity = entities.geometry_space().connectivity().array();
+    boost::hash_combine(seed, entities.size());
+    boost::hash_range(seed, connectivity.data(), connectivity.data() + connectivity.num_elements());
+  }
+
+  return seed;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 bool MeshWriter::RegionFilter::operator()(const Component& component)
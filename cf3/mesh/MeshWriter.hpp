@@ -13,7 +13,7 @@
 #include "mesh/LibMesh.hpp"
 
 namespace cf3 {
-namespace common {  class URI;  }
+namespace common {  class URI; class PropertyList;  }
 namespace mesh {
 
   class Mesh;
@@ -55,6 +55,27 @@ public: // functions
 
   virtual void write_from_to(const Mesh& mesh, const common::URI& file_path);
 
+  /// Regions selected by the "regions" option, looked up in the given mesh
+  std::vector<Handle<Region const> > selected_regions(const Mesh& mesh) const;
+
+  /// Write the given fields and regions of a mesh, using a copy of the metadata instead of the metadata of the mesh.
+  /// No options are set and no component paths are looked up, so this may be called from a background thread
+  /// while other parts of the component tree change. The mesh itself must not change while it is written.
+  void write_snapshot(const Mesh& mesh,
+                      const common::URI& file_path,
+                      const std::vector<Handle<Field const> >& fields,
+                      const std::vector<Handle<Region const> >& regions,
+                      const common::PropertyList& metadata);
+
+protected: // functions
+
+  /// Metadata to write, i.e. the metadata of the mesh or the copy passed to write_snapshot()
+  const common::PropertyList& metadata() const;
+
+  /// Hash of the coordinates and the geometry connectivity of the configured mesh.
+  /// Writers that output time series use it to detect if the geometry changed since the previous step.
+  std::size_t geometry_hash() const;
+
 private: // functions
 
   virtual void write() {};
@@ -62,6 +83,9 @@ private: // functions
   void config_fields();  ///< configure fields from URI's
   void config_regions(); ///< configure regions from URI's
 
+  /// Select the entities of the configured regions and call write()
+  void write_regions();
+
 private:
 
   /// Predicate to check if a component directly contains any Entities component
@@ -92,6 +116,10 @@ protected:
   std::vector<Handle<Entities const> > m_filtered_entities;  ///< Handle to selected entities
   bool                                 m_enable_overlap;     ///< If true, writing of overlap will be enabled
 
+private:
+
+  const common::PropertyList*          m_snapshot_metadata;  ///< Metadata passed to write_snapshot(), null otherwise
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,7 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <map>
 #include <set>
 
 #include <boost/function.hpp>
@@ -418,48 +419,121 @@ bool Octtree::find_element(const RealVector& target_coord, Entity& element)
 
   cf3_assert(target_coord.size() <= (long)m_dim);
   RealVector t_coord(m_dim);
+  t_coord.setZero();
   for (Uint d=0; d<target_coord.size(); ++d)
     t_coord[d] = target_coord[d];
 
-  for (Uint t=0; t<target_coord.size(); ++t)
-
   if (find_octtree_cell(t_coord,m_octtree_idx))
   {
-    m_elements_pool.clear();
-    Uint pool_size = 0;
-    Uint rings=0;
-    for ( ; pool_size==0 ; ++rings)
+    m_missing_points.assign(1,0);
+    m_missing_coords = t_coord.transpose();
+    m_point_elements.resize(1);
+    m_points_found.assign(1,false);
+    if (search_rings(m_point_elements,m_points_found))
     {
-      pool_size=m_elements_pool.size();
-      gather_elements_around_idx(m_octtree_idx,rings,m_elements_pool);
-      boost_foreach(const Entity& pool_elem, boost::make_iterator_range(m_elements_pool.begin()+pool_size,m_elements_pool.end()))
-      {
-        cf3_assert(is_not_null(pool_elem.comp));
-        const RealMatrix elem_coordinates = pool_elem.get_coordinates();
-        if (pool_elem.element_type().is_coord_in_element(t_coord,elem_coordinates))
-        {
-          element = pool_elem;
-          return true;
-        }
-      }
+      element = m_point_elements[0];
+      return true;
     }
-    // if arrived here, keep searching
-    // it means no element has been found. The search is enlarged with one more ring, for possible misses.
+  }
+  // if arrived here, it means no element has been found in the octtree cell. Give up.
+  element = Entity();
+  CFdebug << "coord " << t_coord.transpose() << " has not been found in the octtree cell" << CFendl;
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint Octtree::find_elements(const RealMatrix& target_coords, std::vector<Entity>& elements, std::vector<bool>& found)
+{
+  if ( !is_created() )
+    create_octtree();
+
+  cf3_assert(target_coords.cols() <= (long)m_dim);
+  elements.assign(target_coords.rows(),Entity());
+  found.assign(target_coords.rows(),false);
+
+  // Points in the same octtree cell have the same elements around them,
+  // so they are searched for together
+  typedef std::map< std::vector<Uint>, std::vector<Uint> > PointsPerCell;
+  PointsPerCell points_per_cell;
+  RealVector t_coord(m_dim);
+  t_coord.setZero();
+  for (Uint i=0; i<target_coords.rows(); ++i)
+  {
+    t_coord.head(target_coords.cols()) = target_coords.row(i).transpose();
+    if (find_octtree_cell(t_coord,m_octtree_idx))
+      points_per_cell[m_octtree_idx].push_back(i);
+  }
+
+  Uint nb_found = 0;
+  boost_foreach(const PointsPerCell::value_type& cell, points_per_cell)
+  {
+    m_octtree_idx = cell.first;
+    m_missing_points = cell.second;
+    m_missing_coords.setZero(m_missing_points.size(),m_dim);
+    for (Uint i=0; i<m_missing_points.size(); ++i)
+      m_missing_coords.row(i).head(target_coords.cols()) = target_coords.row(m_missing_points[i]);
+    search_rings(elements,found);
+    nb_found += cell.second.size() - m_missing_points.size();
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Octtree::search_rings(std::vector<Entity>& elements, std::vector<bool>& found)
+{
+  m_elements_pool.clear();
+  bool pool_was_empty = true;
+  Uint rings=0;
+  for ( ; pool_was_empty ; ++rings)
+  {
+    pool_was_empty = m_elements_pool.empty();
+    const Uint pool_size = m_elements_pool.size();
     gather_elements_around_idx(m_octtree_idx,rings,m_elements_pool);
-    boost_foreach(const Entity& pool_elem, boost::make_iterator_range(m_elements_pool.begin()+pool_size,m_elements_pool.end()))
+    if (search_pool(pool_size,elements,found))
+      return true;
+  }
+  // if arrived here, keep searching
+  // it means not all elements have been found. The search is enlarged with one more ring, for possible misses.
+  const Uint pool_size = m_elements_pool.size();
+  gather_elements_around_idx(m_octtree_idx,rings,m_elements_pool);
+  return search_pool(pool_size,elements,found);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Octtree::search_pool(const Uint pool_begin, std::vector<Entity>& elements, std::vector<bool>& found)
+{
+  for (Uint p=pool_begin; p<m_elements_pool.size(); ++p)
+  {
+    const Entity& pool_elem = m_elements_pool[p];
+    cf3_assert(is_not_null(pool_elem.comp));
+    pool_elem.allocate_coordinates(m_elem_coordinates);
+    pool_elem.put_coordinates(m_elem_coordinates);
+    if (pool_elem.element_type().are_coords_in_element(m_missing_coords,m_elem_coordinates,m_is_inside) == 0)
+      continue;
+
+    // Points that are found are not searched for anymore
+    Uint nb_missing = 0;
+    for (Uint i=0; i<m_missing_points.size(); ++i)
     {
-      cf3_assert(is_not_null(pool_elem.comp));
-      const RealMatrix elem_coordinates = pool_elem.get_coordinates();
-      if (pool_elem.element_type().is_coord_in_element(t_coord,elem_coordinates))
+      if (m_is_inside[i])
       {
-        element = pool_elem;
-        return true;
+        elements[m_missing_points[i]] = pool_elem;
+        found[m_missing_points[i]] = true;
+      }
+      else
+      {
+        m_missing_coords.row(nb_missing) = m_missing_coords.row(i);
+        m_missing_points[nb_missing++] = m_missing_points[i];
       }
     }
+    m_missing_points.resize(nb_missing);
+    m_missing_coords.conservativeResize(nb_missing,m_missing_coords.cols());
+    if (nb_missing == 0)
+      return true;
   }
-  // if arrived here, it means no element has been found in the octtree cell. Give up.
-  element = Entity();
-  CFdebug << "coord " << t_coord.transpose() << " has not been found in the octtree cell" << CFendl;
   return false;
 }
 
@@ -55,6 +55,15 @@ public: // functions
   /// @return if element was found
   virtual bool find_element(const RealVector& target_coord, Entity& element);
 
+  /// @brief Find which elements contain the given coordinates
+  /// Coordinates in the same octtree cell are checked together against each candidate element,
+  /// so elements are gathered only once for all of them.
+  /// @param [in]  target_coords  the coordinates to look for, one per row
+  /// @param [out] elements       for each coordinate, the element it was found in
+  /// @param [out] found          for each coordinate, if its element was found
+  /// @return the number of coordinates whose element was found
+  Uint find_elements(const RealMatrix& target_coords, std::vector<Entity>& elements, std::vector<bool>& found);
+
   /// Given a coordinate, find which box in the octtree it is located in
   /// @param coordinate  [in]  The coordinate to look for
   /// @param octtree_idx [out] location of the box (i,j,k) in which the coordinate sits
@@ -75,6 +84,16 @@ public: // functions
 
   const Uint dimension() { return m_dim; }
 
+private: // functions
+
+  /// Search the elements in rings around m_octtree_idx, for the points in m_missing_points
+  /// @return true if all points were found
+  bool search_rings(std::vector<Entity>& elements, std::vector<bool>& found);
+
+  /// Check the elements of the pool, starting from pool_begin, for the points in m_missing_points
+  /// @return true if all points were found
+  bool search_pool(const Uint pool_begin, std::vector<Entity>& elements, std::vector<bool>& found);
+
 private: // data
 
   ArrayT m_octtree;
@@ -89,6 +108,16 @@ private: // data
 
   std::vector<Entity> m_elements_pool;
 
+  /// Points that are searched for, as indices of the given coordinates, and their coordinates
+  std::vector<Uint> m_missing_points;
+  RealMatrix m_missing_coords;
+
+  /// Temporary variables to avoid allocation in the search
+  RealMatrix m_elem_coordinates;
+  std::vector<bool> m_is_inside;
+  std::vector<Entity> m_point_elements;
+  std::vector<bool> m_points_found;
+
   math::BoundingBox m_bounding_box;
 
 }; // end Octtree
@@ -0,0 +1,125 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/OutputAggregation.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Largest number of bytes passed to a single MPI call, to stay within the range of an int count
+  const boost::uint64_t max_message_size = 1u << 30;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OutputAggregation::OutputAggregation(const Uint ratio) :
+  m_ratio(std::max(ratio, 1u)),
+  m_rank(0),
+  m_size(1),
+  m_group_comm(MPI_COMM_NULL)
+{
+  if(PE::Comm::instance().is_active())
+  {
+    m_rank = PE::Comm::instance().rank();
+    m_size = PE::Comm::instance().size();
+  }
+
+  // Same condition on all ranks, since the split is collective
+  if(m_ratio > 1 && m_size > 1)
+    MPI_CHECK_RESULT(MPI_Comm_split, (PE::Comm::instance().communicator(), static_cast<int>(group()), static_cast<int>(m_rank), &m_group_comm));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+OutputAggregation::~OutputAggregation()
+{
+  if(m_group_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&m_group_comm);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint OutputAggregation::group_size() const
+{
+  return std::min(m_size, aggregator() + m_ratio) - aggregator();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+boost::uint64_t OutputAggregation::offset_in_group(const boost::uint64_t size) const
+{
+  if(m_group_comm == MPI_COMM_NULL)
+    return 0;
+
+  // The result of the exclusive scan is undefined on the first rank of the group
+  boost::uint64_t offset = 0;
+  MPI_CHECK_RESULT(MPI_Exscan, (const_cast<boost::uint64_t*>(&size), &offset, 1, MPI_UINT64_T, MPI_SUM, m_group_comm));
+  return is_aggregator() ? 0 : offset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void OutputAggregation::gather(const std::string& data, std::vector<std::string>& received) const
+{
+  received.clear();
+
+  if(group_size() == 1)
+  {
+    received.push_back(data);
+    return;
+  }
+
+  CF3_TRACE_SCOPE("MPI_aggregate_output", TraceRecorder::MPI);
+
+  // Ranks are numbered within the group, the aggregator being rank 0
+  const int tag = 0;
+
+  if(!is_aggregator())
+  {
+    boost::uint64_t size = data.size();
+    MPI_CHECK_RESULT(MPI_Send, (&size, 1, MPI_UINT64_T, 0, tag, m_group_comm));
+    for(boost::uint64_t begin = 0; begin < size; begin += detail::max_message_size)
+    {
+      const boost::uint64_t count = std::min(detail::max_message_size, size - begin);
+      MPI_CHECK_RESULT(MPI_Send, (const_cast<char*>(data.data()) + begin, static_cast<int>(count), MPI_BYTE, 0, tag, m_group_comm));
+    }
+    return;
+  }
+
+  received.resize(group_size());
+  received[0] = data;
+  for(Uint i = 1; i != group_size(); ++i)
+  {
+    const int source = static_cast<int>(i);
+    boost::uint64_t size;
+    MPI_CHECK_RESULT(MPI_Recv, (&size, 1, MPI_UINT64_T, source, tag, m_group_comm, MPI_STATUS_IGNORE));
+    std::vector<char> buffer(size);
+    for(boost::uint64_t begin = 0; begin < size; begin += detail::max_message_size)
+    {
+      const boost::uint64_t count = std::min(detail::max_message_size, size - begin);
+      MPI_CHECK_RESULT(MPI_Recv, (&buffer[begin], static_cast<int>(count), MPI_BYTE, source, tag, m_group_comm, MPI_STATUS_IGNORE));
+    }
+    if(size != 0)
+      received[i].assign(&buffer[0], size);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
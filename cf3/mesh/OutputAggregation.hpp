@@ -0,0 +1,89 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_OutputAggregation_hpp
+#define cf3_mesh_OutputAggregation_hpp
+
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "common/CF.hpp"
+#include "common/PE/types.hpp"
+#include "mesh/LibMesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Grouping of ranks for aggregated (N-to-M) parallel output
+///
+/// Consecutive ranks are grouped per aggregation ratio. The first rank of each group
+/// is the aggregator: it receives the already formatted data of all ranks in its group
+/// and writes a single file for the group, so the number of files per output step is
+/// divided by the ratio. A ratio of 1 gives the classic one file per rank.
+/// The ranks of a group communicate over their own communicator, split off in the constructor.
+class Mesh_API OutputAggregation : public boost::noncopyable
+{
+public: // functions
+
+  /// Construct the grouping for the current communicator. Collective when the ratio is above 1.
+  /// @param ratio number of ranks in a group, 0 is treated as 1
+  OutputAggregation(const Uint ratio);
+
+  ~OutputAggregation();
+
+  /// Number of ranks per group
+  Uint ratio() const { return m_ratio; }
+
+  /// Group of this rank
+  Uint group() const { return m_rank / m_ratio; }
+
+  /// Total number of groups, i.e. the number of files that is written
+  Uint nb_groups() const { return (m_size + m_ratio - 1) / m_ratio; }
+
+  /// True if this rank writes the file of its group
+  bool is_aggregator() const { return m_rank % m_ratio == 0; }
+
+  /// Rank that writes the file of its group
+  Uint aggregator() const { return group() * m_ratio; }
+
+  /// Ranks in the group of this rank, including the aggregator
+  Uint group_size() const;
+
+  /// Position of the data of this rank in the data of its group, i.e. the sum of the sizes of
+  /// the lower ranks in the group. Collective over the group.
+  /// @param [in] size size of the data of this rank
+  boost::uint64_t offset_in_group(const boost::uint64_t size) const;
+
+  /// Send the data of this rank to the aggregator of the group. Collective over the group.
+  /// @param [in]  data     data of this rank
+  /// @param [out] received on the aggregator, the data of every rank in the group in rank order. Empty on the other ranks.
+  void gather(const std::string& data, std::vector<std::string>& received) const;
+
+private: // data
+
+  Uint m_ratio;
+  Uint m_rank;
+  Uint m_size;
+
+  /// Communicator of the group, MPI_COMM_NULL if the group has only one rank
+  common::PE::Communicator m_group_comm;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_OutputAggregation_hpp
@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <map>
+
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
@@ -58,6 +60,81 @@ void APointInterpolator::configure_dict()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Uint APointInterpolator::compute_storage(const RealMatrix& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils,
+                                         std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found)
+{
+  const Uint nb_coords = coordinates.rows();
+  elements.resize(nb_coords);
+  stencils.resize(nb_coords);
+  points.resize(nb_coords);
+  weights.resize(nb_coords);
+  found.assign(nb_coords,false);
+
+  Uint nb_found = 0;
+  RealVector coordinate(coordinates.cols());
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    coordinate = coordinates.row(i).transpose();
+    found[i] = compute_storage(coordinate,elements[i],stencils[i],points[i],weights[i]);
+    if (found[i])
+      ++nb_found;
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint APointInterpolator::compute_grouped_storage(ElementFinder& element_finder, StencilComputer& stencil_computer, InterpolationFunction& interpolator_function,
+                                                 const RealMatrix& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils,
+                                                 std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found)
+{
+  const Uint nb_coords = coordinates.rows();
+
+  // 1) Find the elements the coordinates fall in
+  const Uint nb_found = element_finder.find_elements(coordinates,elements,found);
+  stencils.resize(nb_coords);
+  points.resize(nb_coords);
+  weights.resize(nb_coords);
+
+  // Coordinates falling in the same element share its stencil
+  typedef std::map< std::pair<Space*,Uint>, std::vector<Uint> > PointsPerElement;
+  PointsPerElement points_per_element;
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    if (found[i])
+      points_per_element[std::make_pair(elements[i].comp,elements[i].idx)].push_back(i);
+  }
+
+  std::vector<SpaceElem> stencil;
+  RealMatrix element_coords;
+  std::vector< std::vector<Uint> > element_points;
+  std::vector< std::vector<Real> > element_weights;
+  boost_foreach(const PointsPerElement::value_type& element_points_idx, points_per_element)
+  {
+    const std::vector<Uint>& idx = element_points_idx.second;
+
+    // 2) Find stencil of elements to use
+    stencil.clear();
+    stencil_computer.compute_stencil(elements[idx[0]],stencil);
+
+    // 3) Find interpolation
+    element_coords.resize(idx.size(),coordinates.cols());
+    for (Uint i=0; i<idx.size(); ++i)
+      element_coords.row(i) = coordinates.row(idx[i]);
+    interpolator_function.compute_interpolation_weights_of_points(element_coords,stencil,element_points,element_weights);
+
+    for (Uint i=0; i<idx.size(); ++i)
+    {
+      stencils[idx[i]] = stencil;
+      points[idx[i]].swap(element_points[i]);
+      weights[idx[i]].swap(element_weights[i]);
+    }
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 cf3::common::ComponentBuilder<PointInterpolator,APointInterpolator,LibMesh> PointInterpolator_builder;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -154,5 +231,17 @@ bool PointInterpolator::compute_storage(const RealVector& coordinate, SpaceElem&
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Uint PointInterpolator::compute_storage(const RealMatrix& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils,
+                                        std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found)
+{
+  cf3_assert(m_element_finder);
+  cf3_assert(m_stencil_computer);
+  cf3_assert(m_interpolator_function);
+  return compute_grouped_storage(*m_element_finder,*m_stencil_computer,*m_interpolator_function,
+                                 coordinates,elements,stencils,points,weights,found);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
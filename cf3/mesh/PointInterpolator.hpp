@@ -55,10 +55,26 @@ public: // functions
 
   virtual bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights) = 0;
 
+  /// @brief Compute the interpolation storage for several coordinates at once
+  /// The default implementation calls compute_storage() for every coordinate.
+  /// @param [in]  coordinates  the coordinates to interpolate to, one per row
+  /// @param [out] found        for each coordinate, if it can be interpolated
+  /// @return the number of coordinates that can be interpolated
+  virtual Uint compute_storage(const RealMatrix& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils,
+                               std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found);
+
 private: // functions
 
   void configure_dict();
 
+protected: // functions
+
+  /// Find the elements of all coordinates in one pass, and compute the stencil and
+  /// interpolation weights only once for all coordinates falling in the same element
+  Uint compute_grouped_storage(ElementFinder& element_finder, StencilComputer& stencil_computer, InterpolationFunction& interpolator_function,
+                               const RealMatrix& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils,
+                               std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found);
+
 protected: // data
   
   /// source dictionary
@@ -119,6 +135,9 @@ public: // functions
 
   virtual bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights);
 
+  virtual Uint compute_storage(const RealMatrix& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils,
+                               std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found);
+
 private: // functions
 
   void configure_element_finder();
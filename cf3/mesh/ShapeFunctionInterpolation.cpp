@@ -71,6 +71,42 @@ void ShapeFunctionInterpolation::compute_interpolation_weights(const RealVector&
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+void ShapeFunctionInterpolation::compute_interpolation_weights_of_points(const RealMatrix& coordinates, const std::vector<SpaceElem>& stencil,
+                                                                         std::vector< std::vector<Uint> >& source_field_points,
+                                                                         std::vector< std::vector<Real> >& source_field_weights)
+{
+  cf3_assert_desc("Dictionary not configured in "+uri().string(), is_not_null(m_dict) );
+
+  if (stencil.size()>1)
+    throw SetupError(FromHere(),"The stencil for this interpolation function should be the centre cell itself");
+
+  const SpaceElem& element = stencil[0];
+
+  RealMatrix element_coords = element.comp->support().geometry_space().get_coordinates(element.idx);
+  RealMatrix mapped_coords;
+  element.comp->support().element_type().compute_mapped_coordinates(coordinates,element_coords,mapped_coords);
+
+  const Uint nb_nodes = element.shape_function().nb_nodes();
+  RealVector mapped_coord(mapped_coords.cols());
+  RealRowVector sf_values(nb_nodes);
+  source_field_points.resize(coordinates.rows());
+  source_field_weights.resize(coordinates.rows());
+  for (Uint i=0; i<coordinates.rows(); ++i)
+  {
+    mapped_coord = mapped_coords.row(i).transpose();
+    element.shape_function().compute_value(mapped_coord,sf_values);
+    source_field_points[i].resize(nb_nodes);
+    source_field_weights[i].resize(nb_nodes);
+    for (Uint n=0; n<nb_nodes; ++n)
+    {
+      source_field_points[i][n] = element.nodes()[n];
+      source_field_weights[i][n] = sf_values[n];
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 } // mesh
@@ -33,6 +33,11 @@ public:
 
   virtual void compute_interpolation_weights(const RealVector& coordinate, const std::vector<SpaceElem>& stencil,
                                              std::vector<Uint>& source_field_points, std::vector<Real>& source_field_weights);
+
+  /// Maps all coordinates to the element at once, gathering its nodes only once
+  virtual void compute_interpolation_weights_of_points(const RealMatrix& coordinates, const std::vector<SpaceElem>& stencil,
+                                                       std::vector< std::vector<Uint> >& source_field_points,
+                                                       std::vector< std::vector<Real> >& source_field_weights);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
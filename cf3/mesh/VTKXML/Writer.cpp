@@ -4,8 +4,11 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <set>
+#include <sstream>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/assign/list_of.hpp>
@@ -21,6 +24,7 @@
 #include "common/PE/Comm.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
 #include "common/Builder.hpp"
 #include "common/FindComponents.hpp"
 #include "common/StringConversion.hpp"
@@ -32,11 +36,13 @@
 #include "mesh/VTKXML/Writer.hpp"
 #include "mesh/GeoShape.hpp"
 #include "mesh/Mesh.hpp"
+#include "mesh/MeshMetadata.hpp"
 #include "mesh/Region.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Connectivity.hpp"
+#include "mesh/OutputAggregation.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -110,12 +116,16 @@ namespace detail
     /// Finish writing the current array
     void finish_array()
     {
+      // Nothing was written for an empty array
+      if(m_header.nb_blocks == 0)
+        return;
+
       // Write the last block
       cf3_assert(static_cast<Uint>(m_current_block.tellp()) == static_cast<Uint>(m_header.last_blocksize));
       compress_block();
 
       // go back to the header
-      const Uint stream_end = data_stream.tellp();
+      const std::streampos stream_end = data_stream.tellp();
       data_stream.seekp(m_compressed_sizes_start);
 
       // Write actual compressed block sizes
@@ -137,10 +147,10 @@ namespace detail
       m_current_block.write(reinterpret_cast<const char*>(&value), m_wordsize);
     }
 
-    // Offset to put in the VTK XML (= offset after the _)
-    Uint offset()
+    // Offset to put in the VTK XML (= offset after the _). 64 bit, since the data of an aggregated file may exceed 4 GB
+    boost::uint64_t offset()
     {
-      return static_cast<Uint>(data_stream.tellp()) - 1u;
+      return static_cast<boost::uint64_t>(data_stream.tellp()) - 1u;
     }
 
     // Compress the current block and append it to the data stream
@@ -152,9 +162,9 @@ namespace detail
       compressed_stream.push(m_current_block);
 
       // write data and store compressed size
-      const Uint before = data_stream.tellp();
+      const std::streampos before = data_stream.tellp();
       data_stream << compressed_stream.rdbuf();
-      m_header.compressed_blocksizes.push_back(static_cast<Uint>(data_stream.tellp()) - before);
+      m_header.compressed_blocksizes.push_back(static_cast<boost::uint32_t>(data_stream.tellp() - before));
 
       // clear current block
       m_current_block.str(std::string());
@@ -163,7 +173,7 @@ namespace detail
     CompressedStreamHeader m_header;
 
     /// File pointer where the compressed sizes start
-    Uint m_compressed_sizes_start;
+    std::streampos m_compressed_sizes_start;
 
     Uint m_wordsize;
 
@@ -192,6 +202,59 @@ namespace detail
     }
   }
 
+  // Append the bytes of a value to a binary buffer
+  template<typename ValueT>
+  void append_raw(std::string& data, const ValueT& value)
+  {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(ValueT));
+  }
+
+  // Write the binary data of all ranks in the group to the file of the group, returning the position of the data of this rank
+  boost::uint64_t write_binary(const OutputAggregation& aggregation, const URI& path, const std::string& data)
+  {
+    const boost::uint64_t offset = aggregation.offset_in_group(data.size());
+
+    std::vector<std::string> group_data;
+    aggregation.gather(data, group_data);
+
+    if(aggregation.is_aggregator())
+    {
+      boost::filesystem::fstream fout(path.path(), std::ios_base::out | std::ios_base::binary);
+      boost_foreach(const std::string& rank_data, group_data)
+      {
+        fout.write(rank_data.data(), rank_data.size());
+      }
+      fout.close();
+    }
+
+    return offset;
+  }
+
+  // Add an XDMF data item that refers to an array in a binary file
+  void add_binary_item(XmlNode& parent, const std::string& file, const boost::uint64_t seek, const Uint rows, const Uint columns, const std::string& number_type, const Uint precision)
+  {
+    XmlNode item = parent.add_node("DataItem", file);
+    item.set_attribute("Dimensions", to_str(rows) + " " + to_str(columns));
+    item.set_attribute("NumberType", number_type);
+    item.set_attribute("Precision", to_str(precision));
+    item.set_attribute("Format", "Binary");
+    item.set_attribute("Endian", "Native");
+    item.set_attribute("Seek", to_str(seek));
+  }
+
+  // Recursively add a shift to the offset of the appended data arrays
+  void shift_offsets(XmlNode& node, const boost::uint64_t shift)
+  {
+    rapidxml::xml_attribute<char>* attr = node.content->first_attribute("offset");
+    if(attr)
+      node.set_attribute("offset", to_str(from_str<boost::uint64_t>(std::string(attr->value(), attr->value_size())) + shift));
+    XmlNode child;
+    for (child.content = node.content->first_node(); child.is_valid() ; child.content = child.content->next_sibling() )
+    {
+      shift_offsets(child, shift);
+    }
+  }
+
 } // namespace detail
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -201,11 +264,34 @@ common::ComponentBuilder < VTKXML::Writer, MeshWriter, LibVTKXML> aVTKXMLWriter_
 //////////////////////////////////////////////////////////////////////////////
 
 Writer::Writer( const std::string& name )
-: MeshWriter(name)
+: MeshWriter(name),
+  m_aggregation_comm(MPI_COMM_NULL),
+  m_series_step(0),
+  m_xdmf_size(0),
+  m_geometry_offset(0),
+  m_geometry_hash(0)
 {
     options().add("distributed_files", false)
     .pretty_name("Distributed Files")
     .description("Indicate if the filesystem is local to each note. When true, the pvtu file is written on each node.");
+
+    options().add("aggregation_ratio", 1u)
+    .pretty_name("Aggregation Ratio")
+    .description("Number of ranks that write their pieces to a single vtu file. The first rank of each group collects "
+                 "the compressed data of the others and writes the file, reducing the number of files per output step.");
+
+    options().add("time_series", false)
+    .pretty_name("Time Series")
+    .description("Treat every write to the same file as a new step of a time series, listed with the mesh time in the "
+                 "XDMF file <file>.xmf. The points and cells are written once, to <file>_<n>_mesh_P<rank>.bin, and every "
+                 "step refers to them, so step n only writes its fields to <file>_<n>_P<rank>.bin. The geometry is "
+                 "written again when the coordinates or the connectivity change. The binary data is not compressed.");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+Writer::~Writer()
+{
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -215,18 +301,46 @@ std::vector<std::string> Writer::get_extensions()
   std::vector<std::string> extensions;
   extensions.push_back(".vtu");
   extensions.push_back(".pvtu");
+  extensions.push_back(".xmf");
   return extensions;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
+const OutputAggregation& Writer::aggregation()
+{
+  const Uint ratio = std::max(options().value<Uint>("aggregation_ratio"), 1u);
+  const PE::Communicator comm = PE::Comm::instance().communicator();
+  if(!m_aggregation || m_aggregation->ratio() != ratio || comm != m_aggregation_comm)
+  {
+    // free the old communicators before splitting off new ones
+    m_aggregation.reset();
+    m_all_ranks.reset();
+    m_aggregation.reset(new OutputAggregation(ratio));
+    m_aggregation_comm = comm;
+  }
+  return *m_aggregation;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 void Writer::write()
 {
-  // Path for the file written by the current node
+  const OutputAggregation& aggregation = this->aggregation();
+  const bool aggregate = aggregation.ratio() > 1;
+
+  if(options().value<bool>("time_series"))
+  {
+    write_time_series(aggregation);
+    return;
+  }
+
+  // Path for the file written by the current node, or by the aggregator of its group
   URI my_path(m_file_path.path());
   const URI my_dir = my_path.base_path();
   const std::string basename = my_path.base_name();
-  my_path = my_dir / (basename + "_P" + to_str(PE::Comm::instance().rank()) + ".vtu");
+  my_path = aggregate ? my_dir / (basename + "_G" + to_str(aggregation.group()) + ".vtu")
+                      : my_dir / (basename + "_P" + to_str(PE::Comm::instance().rank()) + ".vtu");
 
   XmlDoc doc("1.0", "ISO-8859-1");
 
@@ -236,6 +350,8 @@ void Writer::write()
   vtkfile.set_attribute("version", "0.1");
   vtkfile.set_attribute("byte_order", "LittleEndian");
   vtkfile.set_attribute("compressor", "vtkZLibDataCompressor");
+  // Block headers are 32 bit, which is enough for blocks of 32 kB. The offsets into the appended data are 64 bit.
+  vtkfile.set_attribute("header_type", "UInt32");
 
   XmlNode unstructured_grid = vtkfile.add_node("UnstructuredGrid");
 
@@ -243,8 +359,12 @@ void Writer::write()
   const Uint npoints = coords.size();
   const Uint dim = coords.row_size();
 
+  // Only the elements of the highest dimensionality are written, e.g. triangles for a surface in 3D
+  const Uint cell_dim = m_mesh->dimensionality();
+
   // map for element types
   std::map<GeoShape::Type,int> etype_map = boost::assign::map_list_of
+    (GeoShape::LINE,3)
     (GeoShape::TRIAG,5)
     (GeoShape::QUAD, 9)
     (GeoShape::TETRA, 10)
@@ -255,7 +375,7 @@ void Writer::write()
   Uint nb_conn_nodes = 0;
   boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
   {
-    if(elements.element_type().dimensionality() == dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
+    if(elements.element_type().dimensionality() == cell_dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
     {
       const Uint n_elems = elements.size();
       nb_elems += n_elems;
@@ -297,7 +417,7 @@ void Writer::write()
   appended_data.start_array(nb_conn_nodes, 4);
   boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
   {
-    if(elements.element_type().dimensionality() == dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
+    if(elements.element_type().dimensionality() == cell_dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
     {
       const Uint n_elems = elements.size();
       const Connectivity& conn_table = elements.geometry_space().connectivity();
@@ -322,7 +442,7 @@ void Writer::write()
   appended_data.start_array(nb_elems, 4);
   boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
   {
-    if(elements.element_type().dimensionality() == dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
+    if(elements.element_type().dimensionality() == cell_dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
     {
       const Uint n_elems = elements.size();
       const Uint n_el_nodes = elements.element_type().nb_nodes();
@@ -343,7 +463,7 @@ void Writer::write()
   appended_data.start_array(nb_elems, 1);
   boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
   {
-    if(elements.element_type().dimensionality() == dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
+    if(elements.element_type().dimensionality() == cell_dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
     {
       const Uint n_elems = elements.size();
       const boost::uint8_t vtk_e_type = etype_map[elements.element_type().shape()];
@@ -414,7 +534,7 @@ void Writer::write()
         boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
         {
           const Connectivity& field_connectivity = field.dict().space(elements).connectivity();
-          if(elements.element_type().dimensionality() == dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
+          if(elements.element_type().dimensionality() == cell_dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
           {
             const Uint n_elems = elements.size();
             if(dim == 2 && var_size == 2)
@@ -448,28 +568,71 @@ void Writer::write()
     }
   }
 
-  // Write to file, inserting the binary data at the end
-  std::cout << "writing file " << my_path.path() << std::endl;
-  boost::filesystem::fstream fout(my_path.path(), std::ios_base::out | std::ios_base::binary);
-
   // Remove the closing tag
   std::string xml_string;
   to_string(doc, xml_string);
   boost::algorithm::erase_last(xml_string, "</VTKFile>");
   boost::algorithm::trim_right(xml_string);
 
-  // Write XML meta data
-  fout << xml_string;
+  if(aggregate)
+  {
+    // The appended data of the group is the concatenation of the data of its ranks, without the leading _
+    const std::string my_data = appended_data.data_stream.str().substr(1);
+    detail::shift_offsets(piece, aggregation.offset_in_group(my_data.size()));
+
+    std::string piece_string;
+    to_string(piece, piece_string);
+
+    std::vector<std::string> group_pieces, group_data;
+    aggregation.gather(piece_string, group_pieces);
+    aggregation.gather(my_data, group_data);
+
+    if(aggregation.is_aggregator())
+    {
+      // Replace the piece of the aggregator by the shifted pieces of the whole group
+      boost::algorithm::erase_last(xml_string, "</UnstructuredGrid>");
+      boost::algorithm::trim_right(xml_string);
+      xml_string.erase(xml_string.rfind("<Piece"));
+      boost::algorithm::trim_right(xml_string);
+
+      CFinfo << "Writing file " << my_path.path() << CFendl;
+      boost::filesystem::fstream fout(my_path.path(), std::ios_base::out | std::ios_base::binary);
+      fout << xml_string << "\n";
+      boost_foreach(const std::string& group_piece, group_pieces)
+      {
+        fout << group_piece << "\n";
+      }
+      fout << "</UnstructuredGrid>";
+
+      fout << "\n<AppendedData encoding=\"raw\">\n_";
+      boost_foreach(const std::string& data, group_data)
+      {
+        fout.write(data.data(), data.size());
+      }
+      fout << "\n</AppendedData>\n</VTKFile>\n";
+
+      fout.close();
+    }
+  }
+  else
+  {
+    // Write to file, inserting the binary data at the end
+    CFinfo << "Writing file " << my_path.path() << CFendl;
+    boost::filesystem::fstream fout(my_path.path(), std::ios_base::out | std::ios_base::binary);
 
-  // Append  compressed data
-  fout << "\n<AppendedData encoding=\"raw\">\n";
-  fout << appended_data.data_stream.rdbuf();
-  fout << "\n</AppendedData>\n</VTKFile>\n";
+    // Write XML meta data
+    fout << xml_string;
 
-  fout.close();
+    // Append  compressed data
+    fout << "\n<AppendedData encoding=\"raw\">\n";
+    fout << appended_data.data_stream.rdbuf();
+    fout << "\n</AppendedData>\n</VTKFile>\n";
+
+    fout.close();
+  }
 
   // Write the parallel header, if needed
-  if(PE::Comm::instance().rank() == 0 || options().value<bool>("distributed_files"))
+  if(PE::Comm::instance().rank() == 0 || (options().value<bool>("distributed_files") && aggregation.is_aggregator()))
   {
     URI pvtu_path = my_dir / (basename + ".pvtu");
 
@@ -488,10 +651,21 @@ void Writer::write()
     detail::make_pvtu(punstruc);
     punstruc.set_attribute("GhostLevel", "0");
 
-    for(Uint i = 0; i != PE::Comm::instance().size(); ++i)
+    if(aggregate)
     {
-      const std::string piece_path = basename + "_P" + to_str(i) + ".vtu";
-      punstruc.add_node("Piece").set_attribute("Source", piece_path);
+      for(Uint i = 0; i != aggregation.nb_groups(); ++i)
+      {
+        const std::string piece_path = basename + "_G" + to_str(i) + ".vtu";
+        punstruc.add_node("Piece").set_attribute("Source", piece_path);
+      }
+    }
+    else
+    {
+      for(Uint i = 0; i != PE::Comm::instance().size(); ++i)
+      {
+        const std::string piece_path = basename + "_P" + to_str(i) + ".vtu";
+        punstruc.add_node("Piece").set_attribute("Source", piece_path);
+      }
     }
 
     to_file(pvtu_doc, pvtu_path);
@@ -500,6 +674,239 @@ void Writer::write()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Writer::write_time_series(const OutputAggregation& aggregation)
+{
+  const bool aggregate = aggregation.ratio() > 1;
+  const Uint rank = PE::Comm::instance().rank();
+
+  const URI series_path(m_file_path.path());
+  const URI dir = series_path.base_path();
+  const std::string basename = series_path.base_name();
+
+  if(m_series_path != m_file_path.path())
+  {
+    m_series_path = m_file_path.path();
+    m_series_step = 0;
+    m_xdmf_size = 0;
+    m_geometry_file.clear();
+  }
+
+  std::stringstream step_str;
+  step_str << std::setw(4) << std::setfill('0') << m_series_step;
+  const std::string file_suffix = aggregate ? "_G" + to_str(aggregation.group()) + ".bin" : "_P" + to_str(rank) + ".bin";
+
+  const Field& coords = m_mesh->geometry_fields().coordinates();
+  const Uint npoints = coords.size();
+  const Uint dim = coords.row_size();
+  const Uint cell_dim = m_mesh->dimensionality();
+
+  // XDMF topology types of the supported elements, the same as for the vtu output
+  std::map<GeoShape::Type,std::string> etype_map = boost::assign::map_list_of
+    (GeoShape::LINE, std::string("Polyline"))
+    (GeoShape::TRIAG, std::string("Triangle"))
+    (GeoShape::QUAD, std::string("Quadrilateral"))
+    (GeoShape::TETRA, std::string("Tetrahedron"))
+    (GeoShape::HEXA, std::string("Hexahedron"));
+
+  // Every block of elements becomes an XDMF grid that shares the points of the rank
+  std::vector< Handle<Elements const> > blocks;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(m_mesh->topology()) )
+  {
+    if(elements.element_type().dimensionality() == cell_dim && elements.element_type().order() == 1 && etype_map.count(elements.element_type().shape()))
+      blocks.push_back(elements.handle<Elements const>());
+  }
+
+  // The geometry is written again if it changed on any rank, since writing is collective over the aggregation groups
+  const std::size_t hash = geometry_hash();
+  Uint geometry_changed = m_geometry_file.empty() || hash != m_geometry_hash;
+  if(PE::Comm::instance().is_active())
+    PE::Comm::instance().all_reduce(PE::max(), &geometry_changed, 1, &geometry_changed);
+
+  if(geometry_changed)
+  {
+    std::string geometry_data;
+    for(Uint i = 0; i != npoints; ++i)
+    {
+      const Field::ConstRow row = coords[i];
+      for(Uint j = 0; j != dim; ++j)
+        detail::append_raw(geometry_data, row[j]);
+      if(dim == 2) detail::append_raw(geometry_data, Real(0.));
+    }
+    boost_foreach(const Handle<Elements const>& elements, blocks)
+    {
+      const Connectivity& conn_table = elements->geometry_space().connectivity();
+      const Uint n_elems = elements->size();
+      const Uint n_el_nodes = elements->element_type().nb_nodes();
+      for(Uint i = 0; i != n_elems; ++i)
+      {
+        const Connectivity::ConstRow row = conn_table[i];
+        for(Uint j = 0; j != n_el_nodes; ++j)
+          detail::append_raw(geometry_data, static_cast<boost::uint32_t>(row[j]));
+      }
+    }
+
+    m_geometry_file = basename + "_" + step_str.str() + "_mesh" + file_suffix;
+    m_geometry_offset = detail::write_binary(aggregation, dir / m_geometry_file, geometry_data);
+    m_geometry_hash = hash;
+  }
+
+  // Grids of this rank, referring to the geometry written before
+  XmlDoc grids_doc;
+  XmlNode rank_grid = grids_doc.add_node("Grid");
+  rank_grid.set_attribute("Name", "P" + to_str(rank));
+  rank_grid.set_attribute("GridType", "Collection");
+  rank_grid.set_attribute("CollectionType", "Spatial");
+
+  std::vector<XmlNode> block_grids;
+  boost::uint64_t conn_offset = m_geometry_offset + static_cast<boost::uint64_t>(npoints) * 3 * sizeof(Real);
+  for(Uint b = 0; b != blocks.size(); ++b)
+  {
+    const Elements& elements = *blocks[b];
+    const Uint n_el_nodes = elements.element_type().nb_nodes();
+
+    XmlNode grid = rank_grid.add_node("Grid");
+    grid.set_attribute("Name", "P" + to_str(rank) + "_" + to_str(b));
+    grid.set_attribute("GridType", "Uniform");
+
+    XmlNode topology = grid.add_node("Topology");
+    topology.set_attribute("TopologyType", etype_map[elements.element_type().shape()]);
+    topology.set_attribute("NumberOfElements", to_str(elements.size()));
+    if(elements.element_type().shape() == GeoShape::LINE)
+      topology.set_attribute("NodesPerElement", to_str(n_el_nodes));
+    detail::add_binary_item(topology, m_geometry_file, conn_offset, elements.size(), n_el_nodes, "UInt", 4);
+    conn_offset += static_cast<boost::uint64_t>(elements.size()) * n_el_nodes * 4;
+
+    XmlNode geometry = grid.add_node("Geometry");
+    geometry.set_attribute("GeometryType", "XYZ");
+    detail::add_binary_item(geometry, m_geometry_file, m_geometry_offset, npoints, 3, "Float", sizeof(Real));
+
+    block_grids.push_back(grid);
+  }
+
+  // Field values of this step, laid out as in the vtu output
+  std::string field_data;
+  std::vector<std::string> attribute_names;
+  std::vector<Uint> attribute_components;
+  std::vector<bool> attribute_at_nodes;
+  std::vector< std::vector<boost::uint64_t> > attribute_offsets; // per attribute, the position of the values of each block
+
+  std::set<std::string> added_fields;
+  boost_foreach(Handle<Field const> field_ptr, m_fields)
+  {
+    const Field& field = *field_ptr;
+
+    if(!added_fields.insert(field.uri().string()).second)
+      continue;
+
+    for(Uint var_idx = 0; var_idx != field.nb_vars(); ++var_idx)
+    {
+      const Uint var_begin = field.var_offset(var_idx);
+      const Uint var_size = field.var_length(var_idx);
+      const Uint var_end = var_begin + var_size;
+      const bool pad = dim == 2 && var_size == 2;
+
+      attribute_names.push_back(field.var_name(var_idx));
+      attribute_components.push_back(pad ? 3 : var_size);
+      attribute_at_nodes.push_back(field.continuous());
+      attribute_offsets.push_back(std::vector<boost::uint64_t>());
+
+      if(field.continuous())
+      {
+        attribute_offsets.back().assign(blocks.size(), field_data.size());
+        for(Uint i = 0; i != field.size(); ++i)
+        {
+          for(Uint j = var_begin; j != var_end; ++j)
+            detail::append_raw(field_data, field[i][j]);
+          if(pad) detail::append_raw(field_data, Real(0.));
+        }
+      }
+      else
+      {
+        boost_foreach(const Handle<Elements const>& elements, blocks)
+        {
+          attribute_offsets.back().push_back(field_data.size());
+          const Connectivity& field_connectivity = field.dict().space(*elements).connectivity();
+          const Uint n_elems = elements->size();
+          for(Uint i = 0; i != n_elems; ++i)
+          {
+            for(Uint j = var_begin; j != var_end; ++j)
+            {
+              /// @bug the field values of the space should be interpolated to the cell-centre, similar to the tecplot writer
+              detail::append_raw(field_data, field[field_connectivity[i][0]][j]);
+            }
+            if(pad) detail::append_raw(field_data, Real(0.));
+          }
+        }
+      }
+    }
+  }
+
+  const std::string field_file = basename + "_" + step_str.str() + file_suffix;
+  const boost::uint64_t field_offset = detail::write_binary(aggregation, dir / field_file, field_data);
+
+  for(Uint a = 0; a != attribute_names.size(); ++a)
+  {
+    const Uint nb_components = attribute_components[a];
+    for(Uint b = 0; b != blocks.size(); ++b)
+    {
+      XmlNode attribute = block_grids[b].add_node("Attribute");
+      attribute.set_attribute("Name", attribute_names[a]);
+      attribute.set_attribute("AttributeType", nb_components == 1 ? "Scalar" : (nb_components == 3 ? "Vector" : "Matrix"));
+      attribute.set_attribute("Center", attribute_at_nodes[a] ? "Node" : "Cell");
+      const Uint rows = attribute_at_nodes[a] ? npoints : blocks[b]->size();
+      detail::add_binary_item(attribute, field_file, field_offset + attribute_offsets[a][b], rows, nb_components, "Float", sizeof(Real));
+    }
+  }
+
+  // Rank 0 collects the grids of all ranks and appends the step to the XDMF file, so it is always valid even if the run stops
+  std::string rank_grid_string;
+  to_string(rank_grid, rank_grid_string);
+
+  if(!m_all_ranks)
+    m_all_ranks.reset(new OutputAggregation(PE::Comm::instance().size()));
+  std::vector<std::string> all_grids;
+  m_all_ranks->gather(rank_grid_string, all_grids);
+
+  if(rank == 0)
+  {
+    const PropertyList& metadata = this->metadata();
+    const Real time = metadata.check("time") ? metadata.value<Real>("time") : static_cast<Real>(m_series_step);
+
+    const URI xdmf_path = dir / (basename + ".xmf");
+    boost::filesystem::fstream fout;
+    if(m_series_step == 0)
+    {
+      CFinfo << "Writing time series " << xdmf_path.path() << CFendl;
+      fout.open(xdmf_path.path(), std::ios_base::out | std::ios_base::binary);
+      fout << "<?xml version=\"1.0\" ?>\n";
+      fout << "<Xdmf Version=\"2.0\">\n<Domain>\n";
+      fout << "<Grid Name=\"" << basename << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+    }
+    else
+    {
+      // overwrite the closing tags with the new step
+      fout.open(xdmf_path.path(), std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+      fout.seekp(m_xdmf_size);
+    }
+
+    fout << "<Grid Name=\"step_" << step_str.str() << "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n";
+    fout << "<Time Value=\"" << to_str(time) << "\"/>\n";
+    boost_foreach(const std::string& grid, all_grids)
+    {
+      fout << grid << "\n";
+    }
+    fout << "</Grid>\n";
+
+    m_xdmf_size = static_cast<boost::uint64_t>(fout.tellp());
+    fout << "</Grid>\n</Domain>\n</Xdmf>\n";
+    fout.close();
+  }
+
+  ++m_series_step;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // VTKXML
 } // mesh
 } // cf3
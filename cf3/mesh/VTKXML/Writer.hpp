@@ -9,6 +9,11 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "common/PE/types.hpp"
+
 #include "mesh/MeshWriter.hpp"
 #include "mesh/GeoShape.hpp"
 
@@ -19,6 +24,7 @@
 namespace cf3 {
 namespace mesh {
   class ElementType;
+  class OutputAggregation;
 namespace VTKXML {
 
 //////////////////////////////////////////////////////////////////////////////
@@ -37,6 +43,8 @@ public: // functions
   /// constructor
   Writer( const std::string& name );
 
+  virtual ~Writer();
+
   /// Gets the Class name
   static std::string type_name() { return "Writer"; }
 
@@ -45,6 +53,42 @@ public: // functions
   virtual std::string get_format() { return "VTKXML"; }
 
   virtual std::vector<std::string> get_extensions();
+
+private:
+
+  /// Aggregation for the current aggregation ratio, only split off again when the ratio or the communicator changes.
+  /// Collective when it has to be rebuilt.
+  const OutputAggregation& aggregation();
+
+  /// Write the current step of a time series and append it to the XDMF file that lists the steps
+  void write_time_series(const OutputAggregation& aggregation);
+
+  /// Grouping of the ranks for the aggregated output
+  boost::scoped_ptr<OutputAggregation> m_aggregation;
+
+  /// A single group with all ranks, to collect the XDMF grids of a time series step on rank 0
+  boost::scoped_ptr<OutputAggregation> m_all_ranks;
+
+  /// Communicator the groupings were made for
+  common::PE::Communicator m_aggregation_comm;
+
+  /// Path of the time series that is being written, empty if no time series was started
+  std::string m_series_path;
+
+  /// Number of steps written so far in the time series
+  Uint m_series_step;
+
+  /// Size of the XDMF file without its closing tags, i.e. where the next step is written. Only used on rank 0.
+  boost::uint64_t m_xdmf_size;
+
+  /// Binary file with the points and connectivity of the current geometry, relative to the directory of the series
+  std::string m_geometry_file;
+
+  /// Position of the geometry of this rank in m_geometry_file
+  boost::uint64_t m_geometry_offset;
+
+  /// Geometry hash of the mesh when m_geometry_file was written
+  std::size_t m_geometry_hash;
 }; // end Writer
 
 
@@ -112,22 +112,37 @@ void WriteMesh::update_list_of_available_writers()
     ("cf3.mesh.neu.Writer")
     ("cf3.mesh.tecplot.Writer")
     ("cf3.mesh.VTKLegacy.Writer")
-    ("cf3.mesh.VTKXML.Writer");
+    ("cf3.mesh.VTKXML.Writer")
+    ("cf3.mesh.checkpoint.Writer")
+    ("cf3.mesh.cf3mesh.Writer");
+
+  // Writers are rebuilt when the options change. Otherwise they are kept, so their options
+  // and the state of time series outputs persist between calls.
+  const bool rebuild = m_writers_mesh != m_mesh || m_writers_file != m_file || m_writers_fields != m_fields;
+  m_writers_mesh = m_mesh;
+  m_writers_file = m_file;
+  m_writers_fields = m_fields;
 
   boost_foreach(const std::string& writer_name, known_writers)
   {
-    if(is_not_null(get_child(writer_name)))
+    if(rebuild && is_not_null(get_child(writer_name)))
       remove_component(writer_name);
-    
-    boost::shared_ptr<MeshWriter> writer = boost::dynamic_pointer_cast<MeshWriter>(build_component_nothrow(writer_name, writer_name));
-    
+
+    Handle<MeshWriter> writer(get_child(writer_name));
+
     if(is_null(writer))
-      continue;
-    
-    add_component(writer);
-  
+    {
+      boost::shared_ptr<MeshWriter> new_writer = boost::dynamic_pointer_cast<MeshWriter>(build_component_nothrow(writer_name, writer_name));
+
+      if(is_null(new_writer))
+        continue;
+
+      add_component(new_writer);
+      writer = new_writer->handle<MeshWriter>();
+    }
+
     boost_foreach(const std::string& extension, writer->get_extensions())
-      m_extensions_to_writers[extension].push_back(writer->handle<MeshWriter>());
+      m_extensions_to_writers[extension].push_back(writer);
   }
 }
 
@@ -160,19 +175,23 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file )
 
 void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector<URI>& fields)
 {
-  update_list_of_available_writers();
+  const URI filepath = resolve_file_path(mesh.metadata().properties(), file);
 
-  /// @todo this should be improved to allow http(s) which would then upload the mesh
-  ///       to a remote location after writing to a temporary file
-  ///       uploading can be achieved using the curl library (which we already search for in the build system)
+  Handle< MeshWriter > writer = writer_for(filepath);
+  writer->options().set("fields",fields);
+  writer->options().set("mesh",mesh.handle<Mesh>());
+  writer->options().set("file", filepath);
 
-  URI filepath = file;
+  writer->execute();
+}
 
-  if( filepath.scheme() != URI::Scheme::FILE )
-    filepath.scheme( URI::Scheme::FILE );
+////////////////////////////////////////////////////////////////////////////////
 
+Handle<MeshWriter> WriteMesh::writer_for( const URI& file )
+{
+  update_list_of_available_writers();
 
-  const std::string extension = filepath.extension();
+  const std::string extension = file.extension();
 
   if ( m_extensions_to_writers.count(extension) == 0 )
     throw FileFormatError (FromHere(), "No meshwriter exists for files with extension " + extension);
@@ -180,16 +199,30 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector
   if (m_extensions_to_writers[extension].size()>1)
   {
      std::string msg;
-     msg = filepath.string() + " has ambiguous extension " + extension + "\n"
+     msg = file.string() + " has ambiguous extension " + extension + "\n"
        +  "Possible writers for this extension are: \n";
      boost_foreach(const Handle< MeshWriter > writer , m_extensions_to_writers[extension])
        msg += " - " + writer->name() + "\n";
      throw FileFormatError( FromHere(), msg);
    }
 
-  // substitute the regex wildcards in the file name
+  return m_extensions_to_writers[extension][0];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+URI WriteMesh::resolve_file_path( const PropertyList& metadata, const URI& file ) const
+{
+  /// @todo this should be improved to allow http(s) which would then upload the mesh
+  ///       to a remote location after writing to a temporary file
+  ///       uploading can be achieved using the curl library (which we already search for in the build system)
 
-  const MeshMetadata& metadata = mesh.metadata();
+  URI filepath = file;
+
+  if( filepath.scheme() != URI::Scheme::FILE )
+    filepath.scheme( URI::Scheme::FILE );
+
+  // substitute the regex wildcards in the file name
 
   std::string file_str = filepath.path();
   boost::regex re("\\$\\{(\\w+)\\}");
@@ -209,18 +242,18 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector
       if (matches[i].second == "iter")
       {
         std::stringstream ss;
-        ss << std::setw( 4 ) << std::setfill( '0' ) << metadata.properties().value<Uint>(matches[i].second);
+        ss << std::setw( 4 ) << std::setfill( '0' ) << metadata.value<Uint>(matches[i].second);
         replace_str = ss.str();
       }
       else if (matches[i].second == "time")
       {
         std::stringstream ss;
-        ss << std::setprecision(4) << std::setiosflags(std::ios_base::scientific) << std::setw(10) << metadata.properties().value<Real>(matches[i].second);
+        ss << std::setprecision(4) << std::setiosflags(std::ios_base::scientific) << std::setw(10) << metadata.value<Real>(matches[i].second);
         replace_str = ss.str();
       }
       else
       {
-        replace_str = metadata.properties().value_str(matches[i].second);
+        replace_str = metadata.value_str(matches[i].second);
       }
       boost::algorithm::replace_first(file_str,matches[i].first,replace_str);
     }
@@ -229,15 +262,7 @@ void WriteMesh::write_mesh( const Mesh& mesh, const URI& file, const std::vector
   // change the path in the filepath
 
   filepath.path( file_str );
-
-  // get the correct writer based on the extension
-
-  Handle< MeshWriter > writer = m_extensions_to_writers[extension][0];
-  writer->options().set("fields",fields);
-  writer->options().set("mesh",mesh.handle<Mesh>());
-  writer->options().set("file", filepath);
-
-  writer->execute();
+  return filepath;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
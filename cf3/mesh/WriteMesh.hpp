@@ -16,6 +16,7 @@
 #include "mesh/LibMesh.hpp"
 
 namespace cf3 {
+namespace common { class PropertyList; }
 namespace mesh {
   class Mesh;
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,6 +61,12 @@ public: // functions
   /// writes all the fields on the mesh
   void write_mesh( const Mesh&, const common::URI& file);
 
+  /// Path of the file to write, with the ${name} wildcards replaced by the values in the given metadata
+  common::URI resolve_file_path( const common::PropertyList& metadata, const common::URI& file ) const;
+
+  /// Writer for the extension of the given file
+  Handle<MeshWriter> writer_for( const common::URI& file );
+
   virtual void execute();
 
 protected: // helper functions
@@ -75,6 +82,11 @@ private: // data
   common::URI m_file;
   std::vector<common::URI> m_fields;
 
+  /// Option values the current writers were built for
+  Handle<Mesh> m_writers_mesh;
+  common::URI m_writers_file;
+  std::vector<common::URI> m_writers_fields;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
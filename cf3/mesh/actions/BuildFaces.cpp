@@ -7,7 +7,7 @@
 #include <set>
 
 #include <boost/foreach.hpp>
-#include <boost/functional/hash.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include "common/Log.hpp"
 #include "common/Builder.hpp"
@@ -32,7 +32,7 @@
 #include "mesh/MeshElements.hpp"
 #include "mesh/FaceCellConnectivity.hpp"
 #include "mesh/NodeElementConnectivity.hpp"
-#include "mesh/Node2FaceCellConnectivity.hpp"
+#include "mesh/FaceMatcher.hpp"
 #include "mesh/Cells.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Connectivity.hpp"
@@ -50,20 +50,57 @@ namespace actions {
   using namespace common;
   using namespace math::Functions;
 
-struct FaceCompare
+namespace detail
 {
-  bool operator()(const Face2Cell& face1, const Face2Cell& face2) const
+  /// Inner faces of a region, indexed on their nodes
+  class InnerFaceIndex
   {
-    std::size_t seed1=0;
-    std::size_t seed2=0;
-
-    boost::hash_combine(seed1,face1.comp->uri().string());
-    boost::hash_combine(seed2,face2.comp->uri().string());
-    boost::hash_combine(seed1,face1.idx);
-    boost::hash_combine(seed2,face2.idx);
-    return seed1 < seed2;
-  }
-};
+  public:
+    InnerFaceIndex(Region& region) : m_max_nb_nodes(1)
+    {
+      std::vector<Uint> nodes;
+      std::vector<Uint> offsets(1, 0);
+      boost_foreach(FaceCellConnectivity& f2c, find_components_recursively_with_tag<FaceCellConnectivity>(region,mesh::Tags::inner_faces()))
+      {
+        for (Uint idx=0; idx<f2c.size(); ++idx)
+        {
+          Face2Cell face(f2c,idx);
+          const std::vector<Uint> face_nodes = face.nodes();
+          nodes.insert(nodes.end(), face_nodes.begin(), face_nodes.end());
+          offsets.push_back(nodes.size());
+          m_max_nb_nodes = std::max(m_max_nb_nodes, static_cast<Uint>(face_nodes.size()));
+          m_faces.push_back(face);
+        }
+      }
+
+      m_matcher.reset(new FaceMatcher(m_max_nb_nodes, m_faces.size()));
+      const Uint nb_faces = m_faces.size();
+      for (Uint f=0; f!=nb_faces; ++f)
+        m_matcher->find_or_insert(&nodes[offsets[f]], offsets[f+1]-offsets[f], f);
+    }
+
+    /// Inner face with the given nodes, in any order. Failing an exact match,
+    /// this is the first inner face containing all the given nodes, as when only the vertices of a face are given
+    /// @return false if there is no such face
+    bool find(const std::vector<Uint>& nodes, Face2Cell& face) const
+    {
+      if (nodes.empty() || nodes.size() > m_max_nb_nodes)
+        return false;
+      Uint f = m_matcher->find(&nodes[0], nodes.size());
+      if (f == FaceMatcher::not_found)
+        f = m_matcher->find_containing(&nodes[0], nodes.size());
+      if (f == FaceMatcher::not_found)
+        return false;
+      face = m_faces[f];
+      return true;
+    }
+
+  private:
+    Uint m_max_nb_nodes;
+    std::vector<Face2Cell> m_faces;
+    boost::scoped_ptr<FaceMatcher> m_matcher;
+  };
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -443,18 +480,14 @@ boost::shared_ptr< FaceCellConnectivity > BuildFaces::match_faces(Region& region
   std::map<FaceCellConnectivity*,boost::shared_ptr<common::List<bool>::Buffer> >  buf_bdry;
   std::map<FaceCellConnectivity*,boost::shared_ptr<ElementConnectivity::Buffer> > buf_f2c;
 
-  // Build a node to face connectivity matching faces2
-  boost::shared_ptr<Node2FaceCellConnectivity> node2faces2_ptr = allocate_component<Node2FaceCellConnectivity>("node2faces");
-  Node2FaceCellConnectivity& node2faces2 = *node2faces2_ptr;
   boost_foreach(FaceCellConnectivity& faces2, find_components_recursively_with_tag<FaceCellConnectivity>(region2,mesh::Tags::inner_faces()))
   {
     buf_fnb [&faces2] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(faces2.face_number().create_buffer()));
     buf_bdry[&faces2] = boost::shared_ptr<common::List<bool>::Buffer> ( new common::List<bool>::Buffer(faces2.is_bdry_face().create_buffer()));
     buf_f2c [&faces2] = boost::shared_ptr<ElementConnectivity::Buffer> ( new ElementConnectivity::Buffer(faces2.connectivity().create_buffer()));
-    node2faces2.add_used(faces2); // it is assumed this is only face types
   }
-  node2faces2.set_nodes(mesh.geometry_fields());
-  node2faces2.build_connectivity();
+  // Index the faces of region2 on their nodes
+  const detail::InnerFaceIndex faces2_index(region2);
 
   Uint f1(0);
   Uint faces1_idx(0);
@@ -476,54 +509,29 @@ boost::shared_ptr< FaceCellConnectivity > BuildFaces::match_faces(Region& region
     {
       Face2Cell face1(faces1,idx);
       face_nodes = face1.nodes();
-      const Uint nb_nodes_per_face = face_nodes.size();
-
-      std::map<Face2Cell,Uint,FaceCompare> found_faces;
-      std::map<Face2Cell,Uint,FaceCompare>::iterator not_found = found_faces.end();
 
-      bool match_found = false;
-      boost_foreach(const Uint face_node, face_nodes)
+      Face2Cell face2;
+      if (faces2_index.find(face_nodes,face2))
       {
-        boost_foreach(const Face2Cell face2, node2faces2.connectivity()[face_node])
-        {
-          std::map<Face2Cell,Uint,FaceCompare>::iterator it = found_faces.find(face2);
-          if ( it == not_found)
-          {
-            found_faces[face2]=1;
-          }
-          else
-          {
-            Uint& nb_faces = it->second;
-            ++nb_faces;
-            if (nb_faces == nb_nodes_per_face)
-            {
-              match_found = true;
-              elems[LEFT]  = face1.cells()[0];
-              elems[RIGHT] = face2.cells()[0];
-              face_nb[LEFT] = face1.face_nb_in_cells()[0];
-              face_nb[RIGHT] = face2.face_nb_in_cells()[0];
-//              CFdebug << PERank << "match found: " << elems[LEFT] << " <--> " << elems[RIGHT] << CFendl;
-
-              // Remove matches from the 2 connectivity tables and add to the interface
-              i2c.add_row(elems);
-              fnb.add_row(face_nb);
-//              fnb.add_row(buf_fnb[face1.comp]->get_row(face1.idx));
-              bdry.add_row(false);
-
-              buf_f2c [face1.comp]->rm_row(face1.idx);
-              buf_f2c [face2.comp]->rm_row(face2.idx);
-              buf_fnb [face1.comp]->rm_row(face1.idx);
-              buf_fnb [face2.comp]->rm_row(face2.idx);
-              buf_bdry[face1.comp]->rm_row(face1.idx);
-              buf_bdry[face2.comp]->rm_row(face2.idx);
-
-              ++nb_matches;
-              break;
-            }
-          }
-        }
-        if (match_found)
-          break;
+        elems[LEFT]  = face1.cells()[0];
+        elems[RIGHT] = face2.cells()[0];
+        face_nb[LEFT] = face1.face_nb_in_cells()[0];
+        face_nb[RIGHT] = face2.face_nb_in_cells()[0];
+//        CFdebug << PERank << "match found: " << elems[LEFT] << " <--> " << elems[RIGHT] << CFendl;
+
+        // Remove matches from the 2 connectivity tables and add to the interface
+        i2c.add_row(elems);
+        fnb.add_row(face_nb);
+        bdry.add_row(false);
+
+        buf_f2c [face1.comp]->rm_row(face1.idx);
+        buf_f2c [face2.comp]->rm_row(face2.idx);
+        buf_fnb [face1.comp]->rm_row(face1.idx);
+        buf_fnb [face2.comp]->rm_row(face2.idx);
+        buf_bdry[face1.comp]->rm_row(face1.idx);
+        buf_bdry[face2.comp]->rm_row(face2.idx);
+
+        ++nb_matches;
       }
       ++f1;
     }
@@ -545,18 +553,14 @@ void BuildFaces::match_boundary(Region& bdry_region, Region& inner_region)
   std::map<FaceCellConnectivity*,boost::shared_ptr<common::List<bool>::Buffer> >   buf_inner_face_is_bdry;
   std::map<FaceCellConnectivity*,boost::shared_ptr<ElementConnectivity::Buffer> >  buf_inner_face_connectivity;
 
-  // Build a node to face connectivity matching faces2
-  boost::shared_ptr<Node2FaceCellConnectivity> nodes_to_inner_faces_ptr = allocate_component<Node2FaceCellConnectivity>("node2faces");
-  Node2FaceCellConnectivity& nodes_to_inner_faces = *nodes_to_inner_faces_ptr;
   boost_foreach(FaceCellConnectivity& f2c, find_components_recursively_with_tag<FaceCellConnectivity>(inner_region,mesh::Tags::inner_faces()))
   {
     buf_inner_face_nb          [&f2c] = boost::shared_ptr<common::Table<Uint>::Buffer> ( new common::Table<Uint>::Buffer(f2c.face_number().create_buffer()));
     buf_inner_face_is_bdry     [&f2c] = boost::shared_ptr<common::List<bool>::Buffer>  ( new common::List<bool>::Buffer(f2c.is_bdry_face().create_buffer()));
     buf_inner_face_connectivity[&f2c] = boost::shared_ptr<ElementConnectivity::Buffer> ( new ElementConnectivity::Buffer(f2c.connectivity().create_buffer()));
-    nodes_to_inner_faces.add_used(f2c);
   }
-  nodes_to_inner_faces.set_nodes(mesh.geometry_fields());
-  nodes_to_inner_faces.build_connectivity();
+  // Index the inner faces on their nodes
+  const detail::InnerFaceIndex inner_faces_index(inner_region);
 
   boost_foreach(Elements& bdry_faces, find_components<Elements>(bdry_region))
   {
@@ -584,133 +588,30 @@ void BuildFaces::match_boundary(Region& bdry_region, Region& inner_region)
     // the bdry_face_connectivity table
     std::vector<Entity> elems(1);
 
-    // initialize a counter for see if matches are found.
-    // A match is found if every node of a boundary face is also found in an inner_face
+    // A match is found if an inner face has all the nodes of the boundary face
     Uint nb_matches(0);
+    std::vector<Uint> bdry_face_nodes;
+    Face2Cell inner_face;
     for (Uint idx=0; idx<bdry_faces.size(); ++idx)
     {
       Entity bdry_entity(bdry_faces,idx);
-      Connectivity::ConstRow bdry_face_nodes = bdry_entity.get_nodes();
-      const Uint nb_nodes_per_face = bdry_face_nodes.size();
-
-      std::map<Face2Cell,Uint,FaceCompare> found_faces;
-      std::map<Face2Cell,Uint,FaceCompare>::iterator not_found = found_faces.end();
-
-      //      CFdebug << "    searching for match for " << bdry_entity << "  ( ";
-      //      boost_foreach(const Uint bdry_face_node, bdry_face_nodes)
-      //          CFdebug << bdry_face_node << " " ;
-      //      CFdebug << ")"<< CFendl;
-      bool match_found = false;
-      boost_foreach(const Uint bdry_face_node, bdry_face_nodes)
+      Connectivity::ConstRow bdry_face_row = bdry_entity.get_nodes();
+      bdry_face_nodes.assign(bdry_face_row.begin(), bdry_face_row.end());
+
+      if (inner_faces_index.find(bdry_face_nodes,inner_face))
       {
-        //        CFdebug << "         node = " << bdry_face_node << CFendl;
-        boost_foreach( Face2Cell& inner_face, nodes_to_inner_faces.connectivity()[bdry_face_node])
-        {
-          //          CFdebug << "           check inner_face["<<inner_face.idx<<"]  ( ";
-          //          boost_foreach(const Uint face_node, inner_face.nodes())
-          //              CFdebug << face_node << " ";
-          //          CFdebug << " )"<<CFendl;
-          std::map<Face2Cell,Uint,FaceCompare>::iterator it = found_faces.find(inner_face);
-          if ( it == not_found)
-          {
-            found_faces[inner_face]=1;
-
-            it = found_faces.find(inner_face);
-            //            CFdebug << "               bump " << it->first.comp->uri().path() << "  " << it->first.idx << CFendl;
-
-            if (nb_nodes_per_face == 1)
-            {
-              match_found = true;
-              elems[0] = inner_face.cells()[0];
-
-              //              CFdebug << PERank << "match found: " << inner_face.comp->uri().string()<<"["<<inner_face.idx<<"]" << " <--> " << elems[0] << CFendl;
-
-              // Remove matches from the inner_faces_connectivity tables and add to the boundary
-              bdry_face_connectivity.set_row(bdry_entity.idx,elems);
-              bdry_face_nb[bdry_entity.idx][0] = inner_face.face_nb_in_cells()[0];
-              bdry_face_is_bdry[bdry_entity.idx] = true;
-
-              buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
-
-              ++nb_matches;
-              break;
-            }
-          }
-          else
-          {
-            Uint& nb_faces = it->second;
-            ++nb_faces;
-            //            CFdebug << "               bump " << it->first.comp->uri().path() << "  " << it->first.idx << CFendl;
-
-            if (nb_faces == nb_nodes_per_face)
-            {
-
-              match_found = true;
-              elems[0] = inner_face.cells()[0];
-
-//              CFdebug << PERank << "match found: " << inner_face.comp->uri().string()<<"["<<inner_face.idx<<"]" << " <--> " << elems[0] << CFendl;
-
-              // Remove matches from the inner_faces_connectivity tables and add to the boundary
-              bdry_face_connectivity.set_row(bdry_entity.idx,elems);
-              bdry_face_nb[bdry_entity.idx][0] = inner_face.face_nb_in_cells()[0];
-              bdry_face_is_bdry[bdry_entity.idx] = true;
-
-              buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
-              buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
-
-              ++nb_matches;
-              break;
-
-
-
-
-//              match_found = true;
-//              Handle< FaceCellConnectivity > inner_faces_to_cells;
-//              Uint inner_face_idx;
-//              Uint inner_faces_comp_idx;
-//              boost::tie(inner_faces_comp_idx,inner_face_idx) = nodes_to_inner_faces.face_cell_connectivity().location_idx(unified_inner_face_idx);
-//              inner_faces_to_cells = Handle<FaceCellConnectivity>(unified_inner_faces_to_cells->components()[inner_faces_comp_idx]);
-//              elems[0] = inner_faces_to_cells->connectivity()[inner_face_idx][0];
-
-//              // ----------- debug -----------
-//              //Handle< Component > inner_cell_comp;
-//              //Uint inner_cell_idx;
-//              //boost::tie(inner_cell_comp,inner_cell_idx) = inner_faces_to_cells->lookup().location(inner_faces_to_cells->connectivity()[inner_face_idx][0]);
-//              //CFdebug << PERank << "match found: " << bdry_faces.parent().name() << "/" << bdry_faces.name() << "["<<local_bdry_face_idx<<"] <--> " << inner_cell_comp->parent().name()<<"/"<<inner_cell_comp->name()<<"["<<inner_cell_idx<<"]" << CFendl;
-//              // -----------------------------
-
-//               // RealMatrix cell_coordinates = inner_cell_comp->as_type<Elements>().get_coordinates(inner_cell_idx);
-//               // RealVector face_coordinates = bdry_faces.get_coordinates(local_bdry_face_idx).row(0);
-//               // bool match_found_double_check = false;
-//               // for (Uint i=0; i<cell_coordinates.rows(); ++i)
-//               // {
-//               //   if (cell_coordinates.row(i) == face_coordinates.transpose())
-//               //   {
-//               //     match_found_double_check = true;
-//               //     break;
-//               //   }
-//               // }
-//               // cf3_assert(match_found_double_check);
-
-//              // Remove matches from the 2 connectivity tables and add to the interface
-//              bdry_face_connectivity.set_row(local_bdry_face_idx,elems);
-//              bdry_face_nb[local_bdry_face_idx] = buf_vec_inner_face_nb[inner_faces_comp_idx]->get_row(inner_face_idx);
-//              bdry_face_is_bdry[local_bdry_face_idx] = true;
-
-//              buf_vec_inner_face_connectivity[inner_faces_comp_idx]->rm_row(inner_face_idx);
-//              buf_vec_inner_face_nb[inner_faces_comp_idx]->rm_row(inner_face_idx);
-//              buf_vec_inner_face_is_bdry[inner_faces_comp_idx]->rm_row(inner_face_idx);
-
-//              ++nb_matches;
-//              break;
-            }
-          }
-        }
-        if (match_found)
-          break;
+        elems[0] = inner_face.cells()[0];
+
+        // Remove matches from the inner_faces_connectivity tables and add to the boundary
+        bdry_face_connectivity.set_row(bdry_entity.idx,elems);
+        bdry_face_nb[bdry_entity.idx][0] = inner_face.face_nb_in_cells()[0];
+        bdry_face_is_bdry[bdry_entity.idx] = true;
+
+        buf_inner_face_connectivity[inner_face.comp]->rm_row(inner_face.idx);
+        buf_inner_face_nb[inner_face.comp]->rm_row(inner_face.idx);
+        buf_inner_face_is_bdry[inner_face.comp]->rm_row(inner_face.idx);
+
+        ++nb_matches;
       }
     }
   }
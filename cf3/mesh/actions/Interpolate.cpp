@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <map>
+
 #include "common/Builder.hpp"
 #include "common/OptionComponent.hpp"
 #include "common/OptionList.hpp"
@@ -178,14 +180,26 @@ void Interpolate::interpolate(const Field& source, const common::Table<Real>& co
   RealVector coord(dimension); coord.setZero();
   const Uint target_dim = coordinates.row_size();
 
+  // Coordinates found on this rank are grouped per element, so that each element is
+  // only gathered and set up once for the inversion of its mapping
+  typedef std::map< std::pair<const Entities*,Uint>, std::vector<Uint> > PointsPerElement;
+  PointsPerElement points_per_element;
+
+  RealMatrix local_coords(coordinates.size(),target_dim);
   for(Uint i=0; i<coordinates.size(); ++i)
   {
     for (Uint d=0; d<target_dim; ++d)
-      coord[d] = coordinates[i][d];
-    if( m_octtree->find_element(coord,element) )
+      local_coords(i,d) = coordinates[i][d];
+  }
+  std::vector<Entity> elements;
+  std::vector<bool> found;
+  m_octtree->find_elements(local_coords,elements,found);
+
+  for(Uint i=0; i<coordinates.size(); ++i)
+  {
+    if( found[i] )
     {
-      interpolate_coordinate( coord, *element.comp, element.idx, target[i] );
-//      std::cout<< PERank << "interpolate for coord (" << coord.transpose() << ") in " << element_component->uri().path() << "["<<element_idx<<"] ... done" << std::endl;
+      points_per_element[std::make_pair(elements[i].comp,elements[i].idx)].push_back(i);
     }
     else
     {
@@ -196,6 +210,11 @@ void Interpolate::interpolate(const Field& source, const common::Table<Real>& co
     }
   }
 
+  boost_foreach(const PointsPerElement::value_type& points, points_per_element)
+  {
+    interpolate_coordinates( coordinates, points.second, *points.first.first, points.first.second, target );
+  }
+
   std::vector<Real> send_coords(target_dim*missing_cells.size());
   std::vector<Real> recv_coords;
 
@@ -347,6 +366,51 @@ void Interpolate::interpolate_coordinate(const RealVector& target_coord, const E
 
 //////////////////////////////////////////////////////////////////////////////
 
+void Interpolate::interpolate_coordinates(const common::Table<Real>& coordinates, const std::vector<Uint>& rows, const Entities& element_component, const Uint element_idx, common::Table<Real>& target)
+{
+  cf3_assert(is_null(m_source) == false);
+  const Field& source = *m_source;
+  const Space& source_space = source.space(element_component);
+  const ShapeFunction& sf = source_space.shape_function();
+  const ElementType& element_type = element_component.element_type();
+
+  RealMatrix source_geom_nodes(element_type.nb_nodes(),element_type.dimension());
+  element_component.geometry_space().put_coordinates(source_geom_nodes,element_idx);
+
+  const Uint dim = std::min(element_type.dimension(),coordinates.row_size());
+  RealMatrix target_coords(rows.size(),element_type.dimension());
+  target_coords.setZero();
+  for(Uint r=0; r<rows.size(); ++r)
+  {
+    for(Uint d=0; d<dim; ++d)
+      target_coords(r,d) = coordinates[rows[r]][d];
+  }
+
+  RealMatrix local_coords;
+  element_type.compute_mapped_coordinates(target_coords,source_geom_nodes,local_coords);
+
+  RealVector local_coord(sf.dimensionality());
+  RealRowVector sf_value(sf.nb_nodes());
+  Connectivity::ConstRow source_indexes = source_space.connectivity()[element_idx];
+  for(Uint r=0; r<rows.size(); ++r)
+  {
+    local_coord = local_coords.row(r).transpose();
+    sf.compute_value(local_coord,sf_value);
+
+    common::Table<Real>::Row target_row = target[rows[r]];
+    for(Uint v=0; v<target_row.size(); ++v)
+    {
+      target_row[v]=0.;
+      for(Uint i=0; i<source_indexes.size(); ++i)
+      {
+        target_row[v] += source[source_indexes[i]][v] * sf_value[i];
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Interpolate::signal_interpolate ( common::SignalArgs& node )
 {
   common::XML::SignalOptions options( node );
@@ -69,6 +69,9 @@ private:
 
   void interpolate_coordinate(const RealVector& target_coord, const Entities& element_component, const Uint element_idx, Field::Row target_row);
 
+  /// Interpolate at the given rows of coordinates, which are all located in the same source element
+  void interpolate_coordinates(const common::Table<Real>& coordinates, const std::vector<Uint>& rows, const Entities& element_component, const Uint element_idx, common::Table<Real>& target);
+
 
 }; // end Interpolate
 
@@ -0,0 +1,613 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionArray.hpp"
+#include "common/OptionComponent.hpp"
+#include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/actions/WallDistance.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshTriangulator.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Space.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+  using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Number of Reals used to store a simplex: 3 points with 3 coordinates
+  const Uint simplex_stride = 9;
+
+  /// Marks points without a known nearest wall simplex
+  const Uint no_face = std::numeric_limits<Uint>::max();
+
+  /// Squared distance between a point and a simplex of nb_points points (a point, a segment or a triangle)
+  /// Points are given with 3 coordinates.
+  Real squared_distance(const Real* p, const Real* s, const Uint nb_points)
+  {
+    RealVector3 x(p[0], p[1], p[2]);
+    RealVector3 a(s[0], s[1], s[2]);
+    if(nb_points == 1)
+      return (x - a).squaredNorm();
+
+    RealVector3 b(s[3], s[4], s[5]);
+    if(nb_points == 2)
+    {
+      const RealVector3 ab = b - a;
+      const Real len2 = ab.squaredNorm();
+      const Real t = len2 > 0. ? std::max(0., std::min(1., (x - a).dot(ab) / len2)) : 0.;
+      return (x - a - t*ab).squaredNorm();
+    }
+
+    // Closest point on a triangle, following the Voronoi regions of its vertices and edges
+    RealVector3 c(s[6], s[7], s[8]);
+    const RealVector3 ab = b - a;
+    const RealVector3 ac = c - a;
+    const RealVector3 ap = x - a;
+    const Real d1 = ab.dot(ap);
+    const Real d2 = ac.dot(ap);
+    if(d1 <= 0. && d2 <= 0.)
+      return ap.squaredNorm();
+
+    const RealVector3 bp = x - b;
+    const Real d3 = ab.dot(bp);
+    const Real d4 = ac.dot(bp);
+    if(d3 >= 0. && d4 <= d3)
+      return bp.squaredNorm();
+
+    const Real vc = d1*d4 - d3*d2;
+    if(vc <= 0. && d1 >= 0. && d3 <= 0.)
+      return (ap - d1 / (d1 - d3) * ab).squaredNorm();
+
+    const RealVector3 cp = x - c;
+    const Real d5 = ab.dot(cp);
+    const Real d6 = ac.dot(cp);
+    if(d6 >= 0. && d5 <= d6)
+      return cp.squaredNorm();
+
+    const Real vb = d5*d2 - d1*d6;
+    if(vb <= 0. && d2 >= 0. && d6 <= 0.)
+      return (ap - d2 / (d2 - d6) * ac).squaredNorm();
+
+    const Real va = d3*d6 - d5*d4;
+    if(va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.)
+      return (bp - (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b)).squaredNorm();
+
+    const Real denom = 1. / (va + vb + vc);
+    return (ap - (vb*denom) * ab - (vc*denom) * ac).squaredNorm();
+  }
+
+  /// Bounding volume hierarchy over the wall simplices
+  class WallBVH
+  {
+  public:
+    WallBVH(const std::vector<Real>& simplices, const Uint nb_points) :
+      m_simplices(simplices),
+      m_nb_points(nb_points)
+    {
+      const Uint nb_simplices = simplices.size() / simplex_stride;
+      m_order.resize(nb_simplices);
+      m_centroids.resize(3*nb_simplices);
+      for(Uint i = 0; i != nb_simplices; ++i)
+      {
+        m_order[i] = i;
+        for(Uint d = 0; d != 3; ++d)
+        {
+          Real sum = 0.;
+          for(Uint n = 0; n != nb_points; ++n)
+            sum += simplices[i*simplex_stride + 3*n + d];
+          m_centroids[3*i + d] = sum / static_cast<Real>(nb_points);
+        }
+      }
+
+      if(nb_simplices != 0)
+      {
+        m_nodes.reserve(2*nb_simplices / leaf_size + 1);
+        build(0, nb_simplices);
+      }
+    }
+
+    /// Squared distance to the nearest simplex, which is stored in closest
+    /// @param best Known upper bound for the squared distance, e.g. the distance to a nearby simplex
+    Real nearest(const Real* p, Uint& closest, Real best) const
+    {
+      if(m_nodes.empty())
+        return best;
+
+      std::vector<Uint>& stack = m_stack;
+      stack.clear();
+      stack.push_back(0);
+      while(!stack.empty())
+      {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+        if(box_distance(node, p) >= best)
+          continue;
+
+        if(node.left == 0)
+        {
+          for(Uint i = node.begin; i != node.end; ++i)
+          {
+            const Real d = squared_distance(p, &m_simplices[m_order[i]*simplex_stride], m_nb_points);
+            if(d < best)
+            {
+              best = d;
+              closest = m_order[i];
+            }
+          }
+          continue;
+        }
+
+        // Visit the nearest child first
+        const Real dl = box_distance(m_nodes[node.left], p);
+        const Real dr = box_distance(m_nodes[node.right], p);
+        if(dl < dr)
+        {
+          stack.push_back(node.right);
+          stack.push_back(node.left);
+        }
+        else
+        {
+          stack.push_back(node.left);
+          stack.push_back(node.right);
+        }
+      }
+
+      return best;
+    }
+
+  private:
+    static const Uint leaf_size = 4;
+
+    struct Node
+    {
+      Real lo[3];
+      Real hi[3];
+      Uint begin, end;
+      Uint left, right; ///< Children, left == 0 for leaves
+    };
+
+    /// Orders simplices by the coordinate of their centroid along an axis
+    struct CentroidLess
+    {
+      CentroidLess(const std::vector<Real>& centroids, const Uint axis) : m_centroids(centroids), m_axis(axis) {}
+      bool operator()(const Uint a, const Uint b) const
+      {
+        return m_centroids[3*a + m_axis] < m_centroids[3*b + m_axis];
+      }
+      const std::vector<Real>& m_centroids;
+      const Uint m_axis;
+    };
+
+    Uint build(const Uint begin, const Uint end)
+    {
+      const Uint node_idx = m_nodes.size();
+      m_nodes.push_back(Node());
+      Node node;
+      node.begin = begin;
+      node.end = end;
+      node.left = 0;
+      node.right = 0;
+      Real clo[3], chi[3];
+      for(Uint d = 0; d != 3; ++d)
+      {
+        node.lo[d] = clo[d] = std::numeric_limits<Real>::max();
+        node.hi[d] = chi[d] = -std::numeric_limits<Real>::max();
+      }
+      for(Uint i = begin; i != end; ++i)
+      {
+        const Uint s = m_order[i];
+        for(Uint d = 0; d != 3; ++d)
+        {
+          for(Uint n = 0; n != m_nb_points; ++n)
+          {
+            const Real x = m_simplices[s*simplex_stride + 3*n + d];
+            node.lo[d] = std::min(node.lo[d], x);
+            node.hi[d] = std::max(node.hi[d], x);
+          }
+          clo[d] = std::min(clo[d], m_centroids[3*s + d]);
+          chi[d] = std::max(chi[d], m_centroids[3*s + d]);
+        }
+      }
+
+      if(end - begin > leaf_size)
+      {
+        // Split at the median along the axis with the largest spread of centroids
+        Uint axis = 0;
+        for(Uint d = 1; d != 3; ++d)
+          if(chi[d] - clo[d] > chi[axis] - clo[axis])
+            axis = d;
+        const Uint middle = begin + (end - begin) / 2;
+        std::nth_element(m_order.begin() + begin, m_order.begin() + middle, m_order.begin() + end, CentroidLess(m_centroids, axis));
+        node.left = build(begin, middle);
+        node.right = build(middle, end);
+      }
+
+      m_nodes[node_idx] = node;
+      return node_idx;
+    }
+
+    static Real box_distance(const Node& node, const Real* p)
+    {
+      Real result = 0.;
+      for(Uint d = 0; d != 3; ++d)
+      {
+        const Real delta = p[d] < node.lo[d] ? node.lo[d] - p[d] : (p[d] > node.hi[d] ? p[d] - node.hi[d] : 0.);
+        result += delta*delta;
+      }
+      return result;
+    }
+
+    const std::vector<Real>& m_simplices;
+    const Uint m_nb_points;
+    std::vector<Uint> m_order;
+    std::vector<Real> m_centroids;
+    std::vector<Node> m_nodes;
+    mutable std::vector<Uint> m_stack;
+  };
+
+  /// Append the simplices making up the face to the list, padded to 3D
+  void add_face_simplices(const Connectivity::ConstRow& face_nodes, const GeoShape::Type shape, const Field& coords, std::vector<Real>& simplices)
+  {
+    static const Uint point_nodes[1][3] = {{0, 0, 0}};
+    static const Uint line_nodes[1][3] = {{0, 1, 0}};
+    static const Uint triag_nodes[1][3] = {{0, 1, 2}};
+
+    const Uint (*local_nodes)[3] = 0;
+    Uint nb_simplices = 1;
+    switch(shape)
+    {
+      case GeoShape::POINT: local_nodes = point_nodes; break;
+      case GeoShape::LINE:  local_nodes = line_nodes; break;
+      case GeoShape::TRIAG: local_nodes = triag_nodes; break;
+      case GeoShape::QUAD:  local_nodes = MeshTriangulator::quad_triangles; nb_simplices = 2; break;
+      default:
+        throw common::NotSupported(FromHere(), "Wall faces of shape " + GeoShape::Convert::instance().to_str(shape) + " are not supported");
+    }
+
+    const Uint dim = coords.row_size();
+    for(Uint s = 0; s != nb_simplices; ++s)
+    {
+      for(Uint n = 0; n != 3; ++n)
+      {
+        const Field::ConstRow x = coords[face_nodes[local_nodes[s][n]]];
+        for(Uint d = 0; d != 3; ++d)
+          simplices.push_back(d < dim ? x[d] : 0.);
+      }
+    }
+  }
+
+  /// Copy a field row to a 3D point
+  inline void to_point(const Field::ConstRow& row, Real* p)
+  {
+    const Uint dim = row.size();
+    for(Uint d = 0; d != 3; ++d)
+      p[d] = d < dim ? row[d] : 0.;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < WallDistance, MeshTransformer, mesh::actions::LibActions> WallDistance_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+WallDistance::WallDistance( const std::string& name )
+: MeshTransformer(name),
+  m_revision(0),
+  m_coordinates_hash(0),
+  m_outdated(true)
+{
+  properties()["brief"] = std::string("Compute the distance to the nearest wall");
+  properties()["description"] = std::string("Stores the distance from each point of a dictionary to the nearest face of the wall regions in a scalar field");
+
+  options().add("regions", std::vector<URI>())
+      .pretty_name("Regions")
+      .description("Boundary regions that make up the wall")
+      .attach_trigger(boost::bind(&WallDistance::trigger_reset, this))
+      .mark_basic();
+
+  options().add("dictionary", m_dictionary)
+      .pretty_name("Dictionary")
+      .description("Dictionary holding the points where the distance is computed. Defaults to the geometry dictionary.")
+      .link_to(&m_dictionary)
+      .attach_trigger(boost::bind(&WallDistance::trigger_reset, this));
+
+  options().add("field_name", std::string("wall_distance"))
+      .pretty_name("Field Name")
+      .description("Name and tag of the field that holds the result")
+      .attach_trigger(boost::bind(&WallDistance::trigger_reset, this));
+
+  options().add("variable_name", std::string("WallDistance"))
+      .pretty_name("Variable Name")
+      .description("Name of the variable in the result field, if the field needs to be created")
+      .attach_trigger(boost::bind(&WallDistance::trigger_reset, this));
+
+  options().add("method", std::string("exact"))
+      .pretty_name("Method")
+      .description("exact: query the nearest wall face for every point. "
+                   "sweeping: query only the points next to the wall and on partition boundaries, and propagate the nearest wall face to the other points.")
+      .attach_trigger(boost::bind(&WallDistance::trigger_reset, this));
+
+  options().add("max_sweeps", 20u)
+      .pretty_name("Maximum Sweeps")
+      .description("Maximum number of sweep iterations in the sweeping method")
+      .attach_trigger(boost::bind(&WallDistance::trigger_reset, this));
+
+  options().option("mesh").attach_trigger(boost::bind(&WallDistance::trigger_reset, this));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void WallDistance::trigger_reset()
+{
+  m_outdated = true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+Handle<Field const> WallDistance::field() const
+{
+  return m_field;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void WallDistance::execute()
+{
+  if(is_null(m_mesh))
+    throw SetupError(FromHere(), "option [mesh] was not set in ["+uri().path()+"]");
+
+  Mesh& mesh = *m_mesh;
+  Dictionary& dict = is_null(m_dictionary) ? mesh.geometry_fields() : *m_dictionary;
+  const std::string method = options().value<std::string>("method");
+  if(method != "exact" && method != "sweeping")
+    throw BadValue(FromHere(), "Unknown wall distance method " + method + " in " + uri().string() + ", must be exact or sweeping");
+
+  const Uint dim = mesh.dimension();
+  const Field& geometry_coords = mesh.geometry_fields().coordinates();
+
+  // Wall faces on this rank, split in simplices. Nodes of the wall are marked for the sweeping method.
+  std::vector<Real> local_simplices;
+  std::vector<bool> is_wall_node(geometry_coords.size(), false);
+  boost_foreach(const URI& region_uri, options().value< std::vector<URI> >("regions"))
+  {
+    Handle<Region> region(access_component(region_uri));
+    if(is_null(region))
+      throw SetupError(FromHere(), "Wall region " + region_uri.string() + " for " + uri().string() + " does not exist");
+
+    boost_foreach(const Entities& faces, find_components_recursively<Entities>(*region))
+    {
+      const ElementType& etype = faces.element_type();
+      if(etype.dimensionality() + 1 != dim)
+        continue;
+
+      const Connectivity& connectivity = faces.geometry_space().connectivity();
+      const Uint nb_faces = faces.size();
+      for(Uint f = 0; f != nb_faces; ++f)
+      {
+        const Connectivity::ConstRow face_nodes = connectivity[f];
+        boost_foreach(const Uint node, face_nodes)
+          is_wall_node[node] = true;
+        if(!faces.is_ghost(f))
+          detail::add_face_simplices(face_nodes, etype.shape(), geometry_coords, local_simplices);
+      }
+    }
+  }
+
+  // Share the wall with all ranks
+  std::vector<Real> simplices;
+  if(PE::Comm::instance().is_active())
+  {
+    std::vector< std::vector<Real> > recv_simplices(PE::Comm::instance().size());
+    PE::Comm::instance().all_gather(local_simplices, recv_simplices);
+    boost_foreach(const std::vector<Real>& rank_simplices, recv_simplices)
+      simplices.insert(simplices.end(), rank_simplices.begin(), rank_simplices.end());
+  }
+  else
+  {
+    simplices.swap(local_simplices);
+  }
+
+  if(simplices.empty())
+    throw SetupError(FromHere(), "No wall faces found for " + uri().string());
+
+  const Field& coords = dict.coordinates();
+  const std::size_t coordinates_hash = boost::hash_range(coords.array().data(), coords.array().data() + coords.array().num_elements());
+
+  // Reuse the previous result if nothing changed, including the position of the wall and of the points
+  if(!m_outdated && is_not_null(m_field) && &m_field->dict() == &dict && m_computed_mesh == m_mesh && dict.revision() == m_revision
+     && coordinates_hash == m_coordinates_hash && simplices == m_wall_simplices)
+    return;
+
+  const std::string field_name = options().value<std::string>("field_name");
+  m_field = Handle<Field>(dict.get_child(field_name));
+  if(is_null(m_field))
+  {
+    m_field = dict.create_field(field_name, options().value<std::string>("variable_name") + "[scalar]").handle<Field>();
+    m_field->add_tag(field_name);
+  }
+  if(m_field->row_size() != 1)
+    throw SetupError(FromHere(), "Wall distance field " + m_field->uri().string() + " is not a scalar field");
+  Field& distance = *m_field;
+
+  const Uint nb_points = dim;
+  const detail::WallBVH bvh(simplices, nb_points);
+
+  const Uint nb_nodes = dict.size();
+  std::vector<Uint> closest(nb_nodes, detail::no_face);
+  Real p[3];
+
+  if(method == "exact")
+  {
+    Uint previous = 0;
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      detail::to_point(coords[i], p);
+      // The wall face nearest to the previous point gives a good first bound
+      Uint nearest = previous;
+      const Real bound = detail::squared_distance(p, &simplices[previous*detail::simplex_stride], nb_points);
+      const Real d2 = bvh.nearest(p, nearest, bound);
+      distance[i][0] = std::sqrt(d2);
+      previous = nearest;
+    }
+  }
+  else
+  {
+    // Point adjacency through the volume elements of the dictionary
+    std::vector< std::vector<Uint> > neighbours(nb_nodes);
+    std::vector<bool> is_seed(nb_nodes, false);
+    boost_foreach(const Handle<Space>& space, dict.spaces())
+    {
+      const Entities& entities = space->support();
+      if(entities.element_type().dimensionality() != dim)
+        continue;
+
+      const Connectivity& geometry_connectivity = entities.geometry_space().connectivity();
+      const Connectivity& connectivity = space->connectivity();
+      const Uint nb_elems = connectivity.size();
+      for(Uint e = 0; e != nb_elems; ++e)
+      {
+        const Connectivity::ConstRow row = connectivity[e];
+
+        // Points of cells touching the wall get an exact distance
+        bool at_wall = false;
+        boost_foreach(const Uint node, geometry_connectivity[e])
+          at_wall = at_wall || is_wall_node[node];
+
+        boost_foreach(const Uint a, row)
+        {
+          is_seed[a] = is_seed[a] || at_wall;
+          boost_foreach(const Uint b, row)
+            if(a != b)
+              neighbours[a].push_back(b);
+        }
+      }
+    }
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      std::sort(neighbours[i].begin(), neighbours[i].end());
+      neighbours[i].erase(std::unique(neighbours[i].begin(), neighbours[i].end()), neighbours[i].end());
+      // Ghost points carry the information from the other ranks
+      if(dict.is_ghost(i))
+        is_seed[i] = true;
+    }
+
+    std::vector<Real> d2(nb_nodes, std::numeric_limits<Real>::max());
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      if(!is_seed[i])
+        continue;
+      detail::to_point(coords[i], p);
+      d2[i] = bvh.nearest(p, closest[i], std::numeric_limits<Real>::max());
+    }
+
+    // Sweep orderings along the diagonals of the coordinate system, each traversed in both directions
+    const Uint nb_orderings = 1u << (dim - 1);
+    std::vector< std::vector<Uint> > orderings(nb_orderings);
+    std::vector< std::pair<Real, Uint> > keys(nb_nodes);
+    for(Uint o = 0; o != nb_orderings; ++o)
+    {
+      for(Uint i = 0; i != nb_nodes; ++i)
+      {
+        const Field::ConstRow x = coords[i];
+        Real key = x[0];
+        for(Uint d = 1; d != dim; ++d)
+          key += (o & (1u << (d-1))) ? -x[d] : x[d];
+        keys[i] = std::make_pair(key, i);
+      }
+      std::sort(keys.begin(), keys.end());
+      orderings[o].resize(nb_nodes);
+      for(Uint i = 0; i != nb_nodes; ++i)
+        orderings[o][i] = keys[i].second;
+    }
+
+    const Uint max_sweeps = options().value<Uint>("max_sweeps");
+    bool changed = true;
+    for(Uint sweep = 0; sweep != max_sweeps && changed; ++sweep)
+    {
+      changed = false;
+      for(Uint o = 0; o != 2*nb_orderings; ++o)
+      {
+        const std::vector<Uint>& ordering = orderings[o/2];
+        for(Uint k = 0; k != nb_nodes; ++k)
+        {
+          const Uint i = o % 2 == 0 ? ordering[k] : ordering[nb_nodes - 1 - k];
+          if(is_seed[i])
+            continue;
+          detail::to_point(coords[i], p);
+          boost_foreach(const Uint j, neighbours[i])
+          {
+            const Uint face = closest[j];
+            if(face == closest[i] || face == detail::no_face)
+              continue;
+            const Real candidate = detail::squared_distance(p, &simplices[face*detail::simplex_stride], nb_points);
+            if(candidate < d2[i])
+            {
+              d2[i] = candidate;
+              closest[i] = face;
+              changed = true;
+            }
+          }
+        }
+      }
+    }
+
+    // Points that no sweep reached, because they are cut off from the seeds or the sweeps stopped too early, get an exact distance
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      if(closest[i] != detail::no_face)
+        continue;
+      detail::to_point(coords[i], p);
+      d2[i] = bvh.nearest(p, closest[i], std::numeric_limits<Real>::max());
+    }
+
+    for(Uint i = 0; i != nb_nodes; ++i)
+      distance[i][0] = std::sqrt(d2[i]);
+  }
+
+  m_revision = dict.revision();
+  m_computed_mesh = m_mesh;
+  m_coordinates_hash = coordinates_hash;
+  m_wall_simplices.swap(simplices);
+  m_outdated = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+
+} // actions
+} // mesh
+} // cf3
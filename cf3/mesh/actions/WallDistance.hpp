@@ -0,0 +1,87 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_WallDistance_hpp
+#define cf3_mesh_actions_WallDistance_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshTransformer.hpp"
+
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+  class Dictionary;
+  class Field;
+namespace actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Computes the distance from each point of a dictionary to the nearest wall face.
+/// The wall faces of all ranks are gathered on every rank and, in the "exact" method,
+/// stored in a bounding volume hierarchy that is queried for every point. The "sweeping"
+/// method only computes exact distances for the points of the cells next to the wall and
+/// propagates the nearest wall face to the other points by sweeping over the mesh in
+/// alternating directions, which is cheaper for very large meshes.
+///
+/// The result is kept in a scalar field, which is only recomputed when the mesh, the dictionary,
+/// the options or the position of the wall or of the points change.
+class mesh_actions_API WallDistance : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  WallDistance( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "WallDistance"; }
+
+  virtual void execute();
+
+  /// The field holding the wall distance, null before the first execution
+  Handle<Field const> field() const;
+
+private: // functions
+
+  /// Force recomputation at the next execute
+  void trigger_reset();
+
+private: // data
+
+  Handle<Dictionary> m_dictionary;
+
+  Handle<Field> m_field;
+
+  /// Revision of the dictionary when the field was computed
+  Uint m_revision;
+
+  /// Mesh the field was computed for
+  Handle<Mesh> m_computed_mesh;
+
+  /// Hash of the point coordinates the field was computed for
+  std::size_t m_coordinates_hash;
+
+  /// Wall simplices the field was computed for, gathered from all ranks
+  std::vector<Real> m_wall_simplices;
+
+  /// True if the field needs to be computed regardless of the revision
+  bool m_outdated;
+
+}; // end WallDistance
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_WallDistance_hpp
@@ -0,0 +1,221 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <map>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/tokenizer.hpp>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Table.hpp"
+#include "common/List.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/cf3mesh/Reader.hpp"
+#include "mesh/cf3mesh/Shared.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/MergedParallelDistribution.hpp"
+#include "mesh/ParallelDistribution.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+
+namespace cf3 {
+namespace mesh {
+namespace cf3mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < cf3mesh::Reader, MeshReader, LibCF3Mesh> aCF3MeshReader_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+Reader::Reader( const std::string& name )
+: MeshReader(name)
+{
+  options().add("part", PE::Comm::instance().rank() )
+      .description("Number of the part of the mesh to read. (e.g. rank of processor)")
+      .pretty_name("Part");
+
+  options().add("nb_parts", PE::Comm::instance().size() )
+      .description("Total number of parts. (e.g. number of processors)")
+      .pretty_name("nb_parts");
+
+  properties()["brief"] = std::string("cf3mesh file reader component");
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Reader::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cf3mesh");
+  return extensions;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
+{
+  boost::filesystem::path fp (file.path());
+  if( !boost::filesystem::exists(fp) )
+  {
+     throw boost::filesystem::filesystem_error( fp.string() + " does not exist", boost::system::error_code() );
+  }
+
+  CFinfo << "Opening file " << fp.string() << CFendl;
+
+  // Pages of the mapped file are only loaded when they are accessed, so only the
+  // header and the rows of this part are actually read from disk
+  boost::iostreams::mapped_file_source mapped_file(fp.string());
+  const char* data = mapped_file.data();
+
+  Shared::Header header;
+  Shared::read_header(data, mapped_file.size(), header);
+  if(header.nb_nodes == 0 || header.nb_elements == 0)
+    throw FileFormatError(FromHere(), fp.string() + " contains no nodes or no elements");
+
+  const Uint part = options().value<Uint>("part");
+
+  Handle<MergedParallelDistribution> hash = create_component<MergedParallelDistribution>("hash");
+  std::vector<Uint> num_obj(2);
+  num_obj[NODES] = header.nb_nodes;
+  num_obj[ELEMS] = header.nb_elements;
+  hash->options().set("nb_parts",options().value<Uint>("nb_parts"));
+  hash->options().set("nb_obj",num_obj);
+
+  const ParallelDistribution& node_hash = hash->subhash(NODES);
+  const ParallelDistribution& elem_hash = hash->subhash(ELEMS);
+  const Uint nodes_begin = node_hash.start_idx_in_part(part);
+  const Uint nodes_end = node_hash.end_idx_in_part(part);
+  const Uint elems_begin = elem_hash.start_idx_in_part(part);
+  const Uint elems_end = elem_hash.end_idx_in_part(part);
+
+  // Find the nodes of the owned elements that are owned by another part
+  std::map<Uint,Uint> ghost_nodes;
+  boost_foreach(const Shared::Block& block, header.blocks)
+  {
+    const Uint begin = std::max(block.first_element, elems_begin);
+    const Uint end = std::min(block.first_element + block.nb_elements, elems_end);
+    const Uint* connectivity = reinterpret_cast<const Uint*>(data + block.offset);
+    for(Uint elem = begin; elem < end; ++elem)
+    {
+      const Uint* row = connectivity + static_cast<std::size_t>(elem - block.first_element)*block.nb_nodes;
+      for(Uint n = 0; n != block.nb_nodes; ++n)
+      {
+        if(row[n] >= header.nb_nodes)
+          throw FileFormatError(FromHere(), "Element " + to_str(elem) + " in " + fp.string() + " refers to non-existing node " + to_str(row[n]));
+        if(row[n] < nodes_begin || row[n] >= nodes_end)
+          ghost_nodes.insert(std::make_pair(row[n], 0u));
+      }
+    }
+  }
+
+  // Owned nodes come first, followed by the ghost nodes in global order
+  mesh.initialize_nodes(0, header.dimension);
+  Dictionary& nodes = mesh.geometry_fields();
+  const Uint nb_owned_nodes = nodes_end - nodes_begin;
+  nodes.resize(nb_owned_nodes + ghost_nodes.size());
+
+  const Real* coordinates = reinterpret_cast<const Real*>(data + header.coordinates_offset);
+  for(Uint node = nodes_begin; node != nodes_end; ++node)
+  {
+    const Uint loc = node - nodes_begin;
+    std::copy(coordinates + static_cast<std::size_t>(node)*header.dimension, coordinates + static_cast<std::size_t>(node+1)*header.dimension, nodes.coordinates()[loc].begin());
+    nodes.rank()[loc] = part;
+    nodes.glb_idx()[loc] = node;
+  }
+
+  Uint loc = nb_owned_nodes;
+  for(std::map<Uint,Uint>::iterator ghost = ghost_nodes.begin(); ghost != ghost_nodes.end(); ++ghost, ++loc)
+  {
+    const Uint node = ghost->first;
+    ghost->second = loc;
+    std::copy(coordinates + static_cast<std::size_t>(node)*header.dimension, coordinates + static_cast<std::size_t>(node+1)*header.dimension, nodes.coordinates()[loc].begin());
+    nodes.rank()[loc] = node_hash.part_of_obj(node);
+    nodes.glb_idx()[loc] = node;
+  }
+
+  // Every part creates all regions and element types, even if it owns none of their elements
+  boost_foreach(const Shared::Block& block, header.blocks)
+  {
+    const std::size_t separator = block.path.rfind('/');
+    const std::string region_path = separator == std::string::npos ? std::string() : block.path.substr(0, separator);
+    const std::string entities_name = separator == std::string::npos ? block.path : block.path.substr(separator+1);
+
+    Handle<Region> region = create_region(mesh.topology(), region_path);
+    Handle<Entities> entities(region->create_component(entities_name, block.entities_type));
+    if(is_null(entities))
+      throw FileFormatError(FromHere(), block.entities_type + " is not an Entities type");
+    entities->initialize(block.element_type, nodes);
+
+    Connectivity& elem_table = entities->geometry_space().connectivity();
+    if(elem_table.row_size() != block.nb_nodes)
+      throw FileFormatError(FromHere(), "Block " + block.path + " in " + fp.string() + " has " + to_str(block.nb_nodes) + " nodes per element, while " + block.element_type + " has " + to_str(elem_table.row_size()));
+
+    const Uint begin = std::max(block.first_element, elems_begin);
+    const Uint end = std::max(begin, std::min(block.first_element + block.nb_elements, elems_end));
+    elem_table.resize(end - begin);
+    entities->rank().resize(end - begin);
+    entities->glb_idx().resize(end - begin);
+
+    const Uint* connectivity = reinterpret_cast<const Uint*>(data + block.offset);
+    for(Uint elem = begin; elem < end; ++elem)
+    {
+      const Uint row_idx = elem - begin;
+      const Uint* row = connectivity + static_cast<std::size_t>(elem - block.first_element)*block.nb_nodes;
+      Connectivity::Row element_nodes = elem_table[row_idx];
+      for(Uint n = 0; n != block.nb_nodes; ++n)
+      {
+        element_nodes[n] = (row[n] >= nodes_begin && row[n] < nodes_end) ? row[n] - nodes_begin : ghost_nodes[row[n]];
+      }
+      entities->rank()[row_idx] = part;
+      entities->glb_idx()[row_idx] = elem;
+    }
+  }
+
+  remove_component(*hash);
+  mapped_file.close();
+
+  mesh.raise_mesh_loaded();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Handle< Region > Reader::create_region(Region& topology, std::string const& relative_path)
+{
+  typedef boost::tokenizer<boost::char_separator<char> > Tokenizer;
+  boost::char_separator<char> sep("/");
+  Tokenizer tokens(relative_path, sep);
+
+  Handle< Region > region = topology.handle<Region>();
+  for (Tokenizer::iterator tok_iter = tokens.begin(); tok_iter != tokens.end(); ++tok_iter)
+  {
+    std::string name = *tok_iter;
+    Handle< Component > new_region = region->get_child(name);
+    if (is_null(new_region))  region->create_component<Region>(name);
+    region = Handle<Region>(region->get_child(name));
+  }
+  return region;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // cf3mesh
+} // mesh
+} // cf3
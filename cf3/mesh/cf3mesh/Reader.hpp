@@ -0,0 +1,65 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_cf3mesh_Reader_hpp
+#define cf3_mesh_cf3mesh_Reader_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshReader.hpp"
+
+#include "mesh/cf3mesh/LibCF3Mesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+class Region;
+
+namespace cf3mesh {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Reads a mesh in the binary cf3mesh format, as written by cf3mesh::Writer.
+/// The file is memory-mapped, and every process only touches the rows assigned to its part:
+/// a contiguous range of elements and a contiguous range of nodes, following the same
+/// distribution as the gmsh and neu readers. Nodes of the owned elements that belong to
+/// another part are added as ghost nodes. Since no process reads the complete file, the
+/// time to load a mesh does not grow with the number of processes.
+/// @see Shared for the layout of the file
+class cf3mesh_API Reader : public MeshReader
+{
+public: // functions
+  /// constructor
+  Reader( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Reader"; }
+
+  virtual std::string get_format() { return "cf3mesh"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // functions
+
+  virtual void do_read_mesh_into(const common::URI& fp, Mesh& mesh);
+
+  Handle<Region> create_region(Region& topology, const std::string& relative_path);
+
+  enum HashType { NODES=0, ELEMS=1 };
+
+}; // end Reader
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // cf3mesh
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_cf3mesh_Reader_hpp
@@ -0,0 +1,190 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cstring>
+#include <ostream>
+
+#include "common/BasicExceptions.hpp"
+#include "common/StringConversion.hpp"
+
+#include "mesh/cf3mesh/Shared.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+
+namespace cf3 {
+namespace mesh {
+namespace cf3mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Size of the fixed part of the header: magic, 5 counters and the coordinates offset
+  const boost::uint64_t fixed_header_size = 8u + 5u*sizeof(boost::uint32_t) + sizeof(boost::uint64_t);
+
+  /// Size of a block description without the characters of its strings: 3 string lengths, 3 counters and the offset
+  const boost::uint64_t fixed_block_size = 6u*sizeof(boost::uint32_t) + sizeof(boost::uint64_t);
+
+  template<typename T>
+  void write(std::ostream& file, const T& value)
+  {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void write(std::ostream& file, const std::string& value)
+  {
+    write(file, static_cast<boost::uint32_t>(value.size()));
+    file.write(value.data(), value.size());
+  }
+
+  /// Sequential access to the header, with bounds checking
+  class HeaderParser
+  {
+  public:
+    HeaderParser(const char* data, const boost::uint64_t size) : m_data(data), m_size(size), m_position(0) {}
+
+    template<typename T>
+    void read(T& value)
+    {
+      check_available(sizeof(T));
+      std::memcpy(&value, m_data + m_position, sizeof(T));
+      m_position += sizeof(T);
+    }
+
+    void read(std::string& value)
+    {
+      boost::uint32_t size;
+      read(size);
+      check_available(size);
+      value.assign(m_data + m_position, size);
+      m_position += size;
+    }
+
+    void read(char* values, const Uint nb_values)
+    {
+      check_available(nb_values);
+      std::memcpy(values, m_data + m_position, nb_values);
+      m_position += nb_values;
+    }
+
+  private:
+    void check_available(const boost::uint64_t nb_bytes) const
+    {
+      if(m_position + nb_bytes > m_size)
+        throw FileFormatError(FromHere(), "Unexpected end of cf3mesh header");
+    }
+
+    const char* m_data;
+    const boost::uint64_t m_size;
+    boost::uint64_t m_position;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+boost::uint64_t Shared::header_size(const Header& header)
+{
+  boost::uint64_t size = detail::fixed_header_size;
+  for(Uint i = 0; i != header.blocks.size(); ++i)
+  {
+    const Block& block = header.blocks[i];
+    size += detail::fixed_block_size + block.path.size() + block.entities_type.size() + block.element_type.size();
+  }
+  return section_size(size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Shared::write_header(std::ostream& file, const Header& header)
+{
+  file.write(magic(), 8);
+  detail::write(file, static_cast<boost::uint32_t>(version()));
+  detail::write(file, static_cast<boost::uint32_t>(header.dimension));
+  detail::write(file, static_cast<boost::uint32_t>(header.nb_nodes));
+  detail::write(file, static_cast<boost::uint32_t>(header.nb_elements));
+  detail::write(file, static_cast<boost::uint32_t>(header.blocks.size()));
+  detail::write(file, header.coordinates_offset);
+
+  boost::uint64_t written = detail::fixed_header_size;
+  for(Uint i = 0; i != header.blocks.size(); ++i)
+  {
+    const Block& block = header.blocks[i];
+    detail::write(file, block.path);
+    detail::write(file, block.entities_type);
+    detail::write(file, block.element_type);
+    detail::write(file, static_cast<boost::uint32_t>(block.nb_nodes));
+    detail::write(file, static_cast<boost::uint32_t>(block.nb_elements));
+    detail::write(file, static_cast<boost::uint32_t>(block.first_element));
+    detail::write(file, block.offset);
+    written += detail::fixed_block_size + block.path.size() + block.entities_type.size() + block.element_type.size();
+  }
+
+  const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  file.write(padding, header_size(header) - written);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Shared::read_header(const char* data, const boost::uint64_t size, Header& header)
+{
+  detail::HeaderParser parser(data, size);
+
+  char file_magic[8];
+  boost::uint32_t file_version, dimension, nb_nodes, nb_elements, nb_blocks;
+  parser.read(file_magic, 8);
+  if(std::string(file_magic, 8) != magic())
+    throw FileFormatError(FromHere(), "Not a cf3mesh file");
+  parser.read(file_version);
+  if(file_version != version())
+    throw FileFormatError(FromHere(), "cf3mesh format version " + to_str(file_version) + " is not supported, expected version " + to_str(version()));
+
+  parser.read(dimension);
+  parser.read(nb_nodes);
+  parser.read(nb_elements);
+  parser.read(nb_blocks);
+  parser.read(header.coordinates_offset);
+  header.dimension = dimension;
+  header.nb_nodes = nb_nodes;
+  header.nb_elements = nb_elements;
+
+  if(header.coordinates_offset + static_cast<boost::uint64_t>(nb_nodes)*dimension*sizeof(Real) > size)
+    throw FileFormatError(FromHere(), "cf3mesh coordinates extend beyond the end of the file");
+
+  header.blocks.resize(nb_blocks);
+  Uint nb_counted_elements = 0;
+  for(Uint i = 0; i != nb_blocks; ++i)
+  {
+    Block& block = header.blocks[i];
+    boost::uint32_t block_nb_nodes, block_nb_elements, first_element;
+    parser.read(block.path);
+    parser.read(block.entities_type);
+    parser.read(block.element_type);
+    parser.read(block_nb_nodes);
+    parser.read(block_nb_elements);
+    parser.read(first_element);
+    parser.read(block.offset);
+    block.nb_nodes = block_nb_nodes;
+    block.nb_elements = block_nb_elements;
+    block.first_element = first_element;
+
+    if(block.first_element != nb_counted_elements)
+      throw FileFormatError(FromHere(), "cf3mesh block " + block.path + " does not continue the global element numbering");
+    if(block.offset + static_cast<boost::uint64_t>(block.nb_elements)*block.nb_nodes*sizeof(Uint) > size)
+      throw FileFormatError(FromHere(), "cf3mesh block " + block.path + " extends beyond the end of the file");
+    nb_counted_elements += block.nb_elements;
+  }
+
+  if(nb_counted_elements != header.nb_elements)
+    throw FileFormatError(FromHere(), "cf3mesh blocks contain " + to_str(nb_counted_elements) + " elements, while the header announces " + to_str(header.nb_elements));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // cf3mesh
+} // mesh
+} // cf3
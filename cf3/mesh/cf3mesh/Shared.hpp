@@ -0,0 +1,106 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_cf3mesh_Shared_hpp
+#define cf3_mesh_cf3mesh_Shared_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "common/CF.hpp"
+
+#include "mesh/cf3mesh/LibCF3Mesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace cf3mesh {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Layout of a cf3mesh file, shared by the reader and the writer.
+///
+/// The file starts with a header that describes where everything is stored:
+/// - 8 bytes magic string "CF3MESH1"
+/// - format version, dimension, total number of nodes, total number of elements
+///   and number of element blocks (5 x 32 bit unsigned)
+/// - offset of the coordinates in bytes (64 bit unsigned)
+/// - for every element block: the path of the Entities relative to the topology, the builder
+///   names of the Entities and of the element type (each as a 32 bit length followed by the characters),
+///   the number of nodes per element, the number of elements, the global index of the first element
+///   (3 x 32 bit unsigned) and the offset of its connectivity in bytes (64 bit unsigned)
+///
+/// The header is followed by the coordinates of all nodes (nb_nodes x dimension Real), and the
+/// connectivity of every block (nb_elements x nb_nodes 32 bit unsigned global node indices).
+/// Every data section starts at a multiple of 8 bytes. Elements are numbered globally in
+/// the order of the blocks, so boundary patches are simply blocks of lower-dimensional elements.
+///
+/// All data is stored in the native byte order. Because every section has a known position
+/// and fixed-size rows, a reader can access only the rows it needs.
+class cf3mesh_API Shared
+{
+public:
+
+  /// Gets the Class name
+  static std::string type_name() { return "Shared"; }
+
+  /// Magic string at the start of every cf3mesh file
+  static const char* magic() { return "CF3MESH1"; }
+
+  /// Version of the format, incremented when the layout changes
+  static Uint version() { return 1u; }
+
+  /// Description of the elements of one Entities component
+  struct Block
+  {
+    std::string path;           ///< Path of the Entities, relative to the topology
+    std::string entities_type;  ///< Builder name of the Entities, e.g. cf3.mesh.Cells
+    std::string element_type;   ///< Builder name of the element type
+    Uint nb_nodes;              ///< Number of nodes per element
+    Uint nb_elements;           ///< Number of elements in this block
+    Uint first_element;         ///< Global index of the first element of this block
+    boost::uint64_t offset;     ///< Position of the connectivity in the file
+  };
+
+  /// Contents of the header
+  struct Header
+  {
+    Uint dimension;
+    Uint nb_nodes;
+    Uint nb_elements;
+    boost::uint64_t coordinates_offset;
+    std::vector<Block> blocks;
+  };
+
+  /// Size in bytes of the header, rounded up to a multiple of 8
+  static boost::uint64_t header_size(const Header& header);
+
+  /// Size in bytes of a data section, rounded up to a multiple of 8
+  static boost::uint64_t section_size(const boost::uint64_t nb_bytes) { return (nb_bytes + 7u) / 8u * 8u; }
+
+  /// Write the header, including the padding up to header_size()
+  static void write_header(std::ostream& file, const Header& header);
+
+  /// Parse the header at the start of the given data, and check that all sections fit in it
+  /// @throws common::FileFormatError if the data is not a valid cf3mesh file
+  static void read_header(const char* data, const boost::uint64_t size, Header& header);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // cf3mesh
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_cf3mesh_Shared_hpp
@@ -0,0 +1,132 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/Table.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/cf3mesh/Writer.hpp"
+#include "mesh/cf3mesh/Shared.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+
+namespace cf3 {
+namespace mesh {
+namespace cf3mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < cf3mesh::Writer, MeshWriter, LibCF3Mesh> aCF3MeshWriter_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+Writer::Writer( const std::string& name )
+: MeshWriter(name)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Writer::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cf3mesh");
+  return extensions;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write()
+{
+  if(PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    throw NotSupported(FromHere(), "The cf3mesh format stores an unpartitioned mesh and can only be written in serial");
+
+  const Mesh& mesh = *m_mesh;
+  const Dictionary& geometry = mesh.geometry_fields();
+  const std::string topology_path = mesh.topology().uri().path();
+
+  Shared::Header header;
+  header.dimension = mesh.dimension();
+  header.nb_nodes = geometry.size();
+  header.nb_elements = 0;
+
+  std::vector<const Connectivity*> connectivities;
+  boost_foreach(const Handle<Entities const>& entities, m_filtered_entities)
+  {
+    const Connectivity& connectivity = entities->geometry_space().connectivity();
+
+    Shared::Block block;
+    block.path = entities->uri().path().substr(topology_path.size()+1);
+    block.entities_type = entities->derived_type_name();
+    block.element_type = entities->element_type().derived_type_name();
+    block.nb_nodes = connectivity.row_size();
+    block.nb_elements = connectivity.size();
+    block.first_element = header.nb_elements;
+    header.blocks.push_back(block);
+    connectivities.push_back(&connectivity);
+
+    header.nb_elements += block.nb_elements;
+  }
+
+  // Position every section now that the size of the header is known
+  header.coordinates_offset = Shared::header_size(header);
+  boost::uint64_t offset = header.coordinates_offset + Shared::section_size(static_cast<boost::uint64_t>(header.nb_nodes)*header.dimension*sizeof(Real));
+  boost_foreach(Shared::Block& block, header.blocks)
+  {
+    block.offset = offset;
+    offset += Shared::section_size(static_cast<boost::uint64_t>(block.nb_elements)*block.nb_nodes*sizeof(Uint));
+  }
+
+  boost::filesystem::fstream file;
+  boost::filesystem::path path (m_file_path.path());
+  file.open(path,std::ios_base::out | std::ios_base::binary);
+  if (!file) // didn't open so throw exception
+  {
+     throw boost::filesystem::filesystem_error( path.string() + " failed to open",
+                                                boost::system::error_code() );
+  }
+
+  CFinfo << "Writing cf3mesh file " << path.string() << CFendl;
+
+  const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+  Shared::write_header(file, header);
+
+  const common::Table<Real>& coordinates = geometry.coordinates();
+  const boost::uint64_t coordinates_size = static_cast<boost::uint64_t>(header.nb_nodes)*header.dimension*sizeof(Real);
+  if(coordinates_size != 0)
+    file.write(reinterpret_cast<const char*>(coordinates.array().data()), coordinates_size);
+  file.write(padding, Shared::section_size(coordinates_size) - coordinates_size);
+
+  for(Uint i = 0; i != connectivities.size(); ++i)
+  {
+    const boost::uint64_t connectivity_size = static_cast<boost::uint64_t>(header.blocks[i].nb_elements)*header.blocks[i].nb_nodes*sizeof(Uint);
+    if(connectivity_size != 0)
+      file.write(reinterpret_cast<const char*>(connectivities[i]->array().data()), connectivity_size);
+    file.write(padding, Shared::section_size(connectivity_size) - connectivity_size);
+  }
+
+  file.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // cf3mesh
+} // mesh
+} // cf3
@@ -0,0 +1,58 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_cf3mesh_Writer_hpp
+#define cf3_mesh_cf3mesh_Writer_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshWriter.hpp"
+
+#include "mesh/cf3mesh/LibCF3Mesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace cf3mesh {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Writes the coordinates, the regions and the connectivity of every element type of a mesh
+/// in the binary cf3mesh format.
+/// The format holds a single, unpartitioned mesh, so this writer only runs in serial. It is
+/// meant to convert meshes once, e.g. using
+/// @code coolfluid-mesh-transformer --input mesh.msh --output mesh.cf3mesh @endcode
+/// after which cf3mesh::Reader can load the mesh on any number of processes.
+/// Fields are not written.
+/// @see Shared for the layout of the file
+class cf3mesh_API Writer : public MeshWriter
+{
+public: // functions
+
+  /// constructor
+  Writer( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Writer"; }
+
+  virtual void write();
+
+  virtual std::string get_format() { return "cf3mesh"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+}; // end Writer
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // cf3mesh
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_cf3mesh_Writer_hpp
@@ -0,0 +1,75 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_LibCheckpoint_hpp
+#define cf3_LibCheckpoint_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common/Library.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Define the macro checkpoint_API
+/// @note build system defines COOLFLUID_MESH_CHECKPOINT_EXPORTS when compiling checkpoint files
+#ifdef COOLFLUID_MESH_CHECKPOINT_EXPORTS
+#   define checkpoint_API      CF3_EXPORT_API
+#   define checkpoint_TEMPLATE
+#else
+#   define checkpoint_API      CF3_IMPORT_API
+#   define checkpoint_TEMPLATE CF3_TEMPLATE_EXTERN
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+/// @brief Library for binary checkpoint/restart files of a partitioned mesh
+namespace checkpoint {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Class defines the checkpoint mesh format operations
+class checkpoint_API LibCheckpoint :
+    public common::Library
+{
+public:
+
+  /// Constructor
+  LibCheckpoint ( const std::string& name) : common::Library(name) {   }
+
+  /// @return string of the library namespace
+  static std::string library_namespace() { return "cf3.mesh.checkpoint"; }
+
+  /// Static function that returns the library name.
+  /// Must be implemented for Library registration
+  /// @return name of the library
+  static std::string library_name() { return "checkpoint"; }
+
+  /// Static function that returns the description of the library.
+  /// Must be implemented for Library registration
+  /// @return description of the library
+
+  static std::string library_description()
+  {
+    return "This library implements binary checkpoint/restart files of a partitioned mesh.";
+  }
+
+  /// Gets the Class name
+  static std::string type_name() { return "LibCheckpoint"; }
+
+}; // end LibCheckpoint
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // checkpoint
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_LibCheckpoint_hpp
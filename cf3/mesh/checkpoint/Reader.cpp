@@ -0,0 +1,348 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Table.hpp"
+#include "common/List.hpp"
+
+#include "mesh/checkpoint/Reader.hpp"
+#include "mesh/checkpoint/Shared.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshMetadata.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementConnectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+
+namespace cf3 {
+namespace mesh {
+namespace checkpoint {
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < checkpoint::Reader, MeshReader, LibCheckpoint> aCheckpointReader_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  template<typename T>
+  void read_table(ReadBuffer& in, common::Table<T>& table)
+  {
+    Uint size, row_size;
+    in >> size >> row_size;
+    table.set_row_size(row_size);
+    table.resize(size);
+    in.read(table.array().data(), size*row_size);
+  }
+
+  template<typename T>
+  void read_list(ReadBuffer& in, common::List<T>& list)
+  {
+    Uint size;
+    in >> size;
+    list.resize(size);
+    in.read(list.array().data(), size);
+  }
+
+  void add_tags(Component& component, const std::vector<std::string>& tags)
+  {
+    boost_foreach(const std::string& tag, tags)
+    {
+      component.add_tag(tag);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Reader::Reader( const std::string& name )
+: MeshReader(name)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Reader::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cf3chk");
+  return extensions;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
+{
+  if(mesh.dimension() != 0 || mesh.topology().count_children() != 0)
+    throw SetupError(FromHere(), "Checkpoint " + file.path() + " can only be read into an empty mesh, but " + mesh.uri().string() + " is not empty");
+
+  CFinfo << "Reading checkpoint " << file.path() << CFendl;
+
+  std::vector<char> block;
+  Shared::read_file(file, block);
+  ReadBuffer in(block);
+
+  read_metadata(mesh, in);
+
+  Uint dimension, nb_nodes;
+  in >> dimension >> nb_nodes;
+  mesh.initialize_nodes(nb_nodes, dimension);
+
+  m_entities.clear();
+  read_region(mesh.topology(), mesh.geometry_fields(), in);
+
+  Uint nb_dictionaries;
+  in >> nb_dictionaries;
+  for(Uint i = 0; i != nb_dictionaries; ++i)
+  {
+    read_dictionary(mesh, i == 0, in);
+  }
+
+  boost_foreach(const Handle<Entities>& entities, m_entities)
+  {
+    read_element_connectivities(*entities, in);
+  }
+
+  if(!in.eof())
+    throw FileFormatError(FromHere(), "Checkpoint " + file.path() + " contains more data than expected");
+
+  m_entities.clear();
+
+  // Only the cheap lookup structures are rebuilt, the spaces and their numbering are taken from the file
+  mesh.update_structures();
+  boost_foreach(const Handle<Dictionary>& dict, mesh.dictionaries())
+  {
+    dict->rebuild_map_glb_to_loc();
+    dict->rebuild_node_to_element_connectivity();
+  }
+  mesh.update_statistics();
+
+  mesh.raise_mesh_loaded();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_metadata(Mesh& mesh, ReadBuffer& in)
+{
+  MeshMetadata& metadata = mesh.metadata();
+
+  Uint nb_properties;
+  in >> nb_properties;
+  for(Uint i = 0; i != nb_properties; ++i)
+  {
+    std::string name;
+    Uint type;
+    in >> name >> type;
+    switch(type)
+    {
+      case Shared::REAL:          { Real value; in >> value; metadata[name] = value; break; }
+      case Shared::UINT:          { Uint value; in >> value; metadata[name] = value; break; }
+      case Shared::INT:           { int value; in >> value; metadata[name] = value; break; }
+      case Shared::BOOL:          { bool value; in >> value; metadata[name] = value; break; }
+      case Shared::STRING:        { std::string value; in >> value; metadata[name] = value; break; }
+      case Shared::REAL_VECTOR:   { std::vector<Real> value; in >> value; metadata[name] = value; break; }
+      case Shared::UINT_VECTOR:   { std::vector<Uint> value; in >> value; metadata[name] = value; break; }
+      case Shared::STRING_VECTOR: { std::vector<std::string> value; in >> value; metadata[name] = value; break; }
+      default:
+        throw FileFormatError(FromHere(), "Unknown type for metadata " + name);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_region(Region& region, Dictionary& geometry, ReadBuffer& in)
+{
+  Uint nb_children;
+  in >> nb_children;
+  for(Uint i = 0; i != nb_children; ++i)
+  {
+    std::string name, builder_name;
+    std::vector<std::string> tags;
+    Uint kind;
+    in >> name >> builder_name >> tags >> kind;
+
+    if(kind == Shared::REGION)
+    {
+      Handle<Region> child(region.create_component(name, builder_name));
+      if(is_null(child))
+        throw FileFormatError(FromHere(), builder_name + " is not a Region");
+      detail::add_tags(*child, tags);
+      read_region(*child, geometry, in);
+      continue;
+    }
+
+    if(kind != Shared::ENTITIES)
+      throw FileFormatError(FromHere(), "Unknown component kind for " + name);
+
+    std::string element_type;
+    in >> element_type;
+
+    Handle<Entities> entities(region.create_component(name, builder_name));
+    if(is_null(entities))
+      throw FileFormatError(FromHere(), builder_name + " is not an Entities type");
+    detail::add_tags(*entities, tags);
+    entities->initialize(element_type, geometry);
+
+    detail::read_list(in, entities->glb_idx());
+    detail::read_list(in, entities->rank());
+
+    Connectivity& connectivity = entities->geometry_space().connectivity();
+    const Uint nb_nodes = connectivity.row_size();
+    detail::read_table(in, connectivity);
+    if(connectivity.row_size() != nb_nodes || connectivity.size() != entities->glb_idx().size() || entities->rank().size() != entities->glb_idx().size())
+      throw FileFormatError(FromHere(), "Inconsistent sizes for " + entities->uri().string());
+
+    m_entities.push_back(entities);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_dictionary(Mesh& mesh, const bool is_geometry, ReadBuffer& in)
+{
+  Handle<Dictionary> dict;
+  if(is_geometry)
+  {
+    dict = mesh.geometry_fields().handle<Dictionary>();
+  }
+  else
+  {
+    std::string name, builder_name;
+    std::vector<std::string> tags;
+    in >> name >> builder_name >> tags;
+    dict = Handle<Dictionary>(mesh.create_component(name, builder_name));
+    if(is_null(dict))
+      throw FileFormatError(FromHere(), builder_name + " is not a Dictionary");
+    detail::add_tags(*dict, tags);
+
+    Uint nb_spaces;
+    in >> nb_spaces;
+    for(Uint i = 0; i != nb_spaces; ++i)
+    {
+      Uint entities_idx;
+      std::string shape_function;
+      in >> entities_idx >> shape_function;
+      if(entities_idx >= m_entities.size())
+        throw FileFormatError(FromHere(), "Invalid entities index for a space of " + name);
+
+      Space& space = m_entities[entities_idx]->create_space(shape_function, *dict);
+      const Uint nb_nodes = space.connectivity().row_size();
+      detail::read_table(in, space.connectivity());
+      if(space.connectivity().row_size() != nb_nodes || space.connectivity().size() != m_entities[entities_idx]->size())
+        throw FileFormatError(FromHere(), "Inconsistent sizes for " + space.uri().string());
+    }
+  }
+
+  detail::read_list(in, dict->glb_idx());
+  detail::read_list(in, dict->rank());
+  if(dict->rank().size() != dict->glb_idx().size())
+    throw FileFormatError(FromHere(), "Inconsistent sizes for " + dict->uri().string());
+  dict->resize(dict->glb_idx().size());
+
+  Uint nb_fields;
+  in >> nb_fields;
+  for(Uint i = 0; i != nb_fields; ++i)
+  {
+    std::string name, description;
+    std::vector<std::string> tags;
+    in >> name >> description >> tags;
+
+    Handle<Field> field(dict->get_child(name));
+    if(is_null(field))
+      field = dict->create_field(name, description).handle<Field>();
+    detail::add_tags(*field, tags);
+
+    const Uint row_size = field->row_size();
+    detail::read_table(in, *field);
+    if(field->row_size() != row_size || field->size() != dict->size())
+      throw FileFormatError(FromHere(), "Inconsistent sizes for " + field->uri().string());
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_element_connectivities(Entities& entities, ReadBuffer& in)
+{
+  bool has_f2c;
+  in >> has_f2c;
+  if(has_f2c)
+  {
+    std::string name;
+    std::vector<Uint> used;
+    in >> name >> used;
+
+    Handle<FaceCellConnectivity> f2c = entities.create_component<FaceCellConnectivity>(name);
+    boost_foreach(const Uint used_idx, used)
+    {
+      if(used_idx >= m_entities.size())
+        throw FileFormatError(FromHere(), "Invalid entities index in " + f2c->uri().string());
+      f2c->add_used(*m_entities[used_idx]);
+    }
+    read_entity_table(f2c->connectivity(), in);
+    detail::read_table(in, f2c->face_number());
+    detail::read_list(in, f2c->is_bdry_face());
+    entities.connectivity_face2cell() = f2c;
+  }
+
+  bool has_c2f;
+  in >> has_c2f;
+  if(has_c2f)
+  {
+    std::string name;
+    in >> name;
+    Handle<ElementConnectivity> c2f = entities.create_component<ElementConnectivity>(name);
+    read_entity_table(*c2f, in);
+    entities.connectivity_cell2face() = c2f;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_entity_table(common::Table<Entity>& table, ReadBuffer& in)
+{
+  Uint size, row_size;
+  in >> size >> row_size;
+  table.set_row_size(row_size);
+  table.resize(size);
+  for(Uint i = 0; i != size; ++i)
+  {
+    for(Uint j = 0; j != row_size; ++j)
+    {
+      Uint entities_idx;
+      Entity& entity = table[i][j];
+      in >> entities_idx >> entity.idx;
+      if(entities_idx == Shared::no_entities())
+      {
+        entity.comp = 0;
+      }
+      else
+      {
+        if(entities_idx >= m_entities.size())
+          throw FileFormatError(FromHere(), "Invalid entities index in " + table.uri().string());
+        entity.comp = m_entities[entities_idx].get();
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // checkpoint
+} // mesh
+} // cf3
@@ -0,0 +1,80 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_checkpoint_Reader_hpp
+#define cf3_mesh_checkpoint_Reader_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "common/Table.hpp"
+
+#include "mesh/MeshReader.hpp"
+#include "mesh/Entities.hpp"
+
+#include "mesh/checkpoint/LibCheckpoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+class Dictionary;
+class Region;
+
+namespace checkpoint {
+
+class ReadBuffer;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Reads a checkpoint written by checkpoint::Writer back into an empty mesh.
+/// Every rank reads only its own part of the file, which contains the mesh exactly as it was
+/// partitioned and numbered when written, so no partitioning, global numbering or face building
+/// is needed after reading. The number of ranks must be the same as when writing.
+/// @see Shared for the layout of the file
+class checkpoint_API Reader : public MeshReader
+{
+public: // functions
+  /// constructor
+  Reader( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Reader"; }
+
+  virtual std::string get_format() { return "checkpoint"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // functions
+
+  virtual void do_read_mesh_into(const common::URI& fp, Mesh& mesh);
+
+  void read_metadata(Mesh& mesh, ReadBuffer& in);
+
+  void read_region(Region& region, Dictionary& geometry, ReadBuffer& in);
+
+  void read_dictionary(Mesh& mesh, const bool is_geometry, ReadBuffer& in);
+
+  void read_element_connectivities(Entities& entities, ReadBuffer& in);
+
+  void read_entity_table(common::Table<Entity>& table, ReadBuffer& in);
+
+private: // data
+
+  /// Entities in the order they were written
+  std::vector< Handle<Entities> > m_entities;
+
+}; // end Reader
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // checkpoint
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_checkpoint_Reader_hpp
@@ -0,0 +1,194 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/checkpoint/Shared.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+
+namespace cf3 {
+namespace mesh {
+namespace checkpoint {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Largest number of bytes passed to a single MPI-IO call, to stay within the range of an int count
+  const boost::uint64_t max_chunk_size = 1u << 30;
+
+  /// Number of chunks needed to transfer the given number of bytes
+  Uint nb_chunks(const boost::uint64_t nb_bytes)
+  {
+    return static_cast<Uint>((nb_bytes + max_chunk_size - 1) / max_chunk_size);
+  }
+
+  /// Parse the fixed part of the header, returning the number of ranks that wrote the file
+  Uint check_header(const std::vector<char>& header, const std::string& filename)
+  {
+    ReadBuffer buffer(header);
+    char magic[8];
+    boost::uint32_t version, nb_ranks;
+    buffer.read(magic, 8);
+    buffer >> version >> nb_ranks;
+    if(std::string(magic, 8) != Shared::magic())
+      throw FileFormatError(FromHere(), filename + " is not a checkpoint file");
+    if(version != Shared::version())
+      throw FileFormatError(FromHere(), filename + " has checkpoint format version " + to_str(version) + ", expected version " + to_str(Shared::version()));
+    return nb_ranks;
+  }
+
+  /// Throw if the file was written by a different number of ranks
+  void check_nb_ranks(const Uint file_nb_ranks, const Uint nb_ranks, const std::string& filename)
+  {
+    if(file_nb_ranks != nb_ranks)
+      throw FileFormatError(FromHere(), filename + " was written by " + to_str(file_nb_ranks) + " ranks, but is read by " + to_str(nb_ranks) + " ranks. Checkpoints can only be restarted on the same number of ranks.");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Shared::write_file(const URI& file, const std::vector<char>& block)
+{
+  const bool parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  const Uint nb_ranks = parallel ? PE::Comm::instance().size() : 1u;
+  const Uint rank = parallel ? PE::Comm::instance().rank() : 0u;
+  const std::string filename = file.path();
+
+  // Gather the block sizes to build the index
+  const boost::uint64_t block_size = block.size();
+  std::vector<boost::uint64_t> block_sizes(1, block_size);
+  if(parallel)
+    PE::Comm::instance().all_gather(block_size, block_sizes);
+
+  WriteBuffer header;
+  header.write(magic(), 8);
+  header << static_cast<boost::uint32_t>(version()) << static_cast<boost::uint32_t>(nb_ranks);
+  boost::uint64_t offset = header_size() + nb_ranks*index_entry_size();
+  boost::uint64_t my_offset = offset;
+  for(Uint r = 0; r != nb_ranks; ++r)
+  {
+    if(r == rank)
+      my_offset = offset;
+    header << offset << block_sizes[r];
+    offset += block_sizes[r];
+  }
+
+  if(!parallel)
+  {
+    boost::filesystem::fstream stream(boost::filesystem::path(filename), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if(!stream)
+      throw boost::filesystem::filesystem_error(filename + " failed to open", boost::system::error_code());
+    stream.write(&header.data()[0], header.data().size());
+    if(!block.empty())
+      stream.write(&block[0], block.size());
+    if(!stream)
+      throw FileFormatError(FromHere(), "Error writing checkpoint " + filename);
+    return;
+  }
+
+  CF3_TRACE_SCOPE("MPI_File_write_at_all", TraceRecorder::MPI);
+
+  MPI_File fh;
+  MPI_CHECK_RESULT(MPI_File_open, (PE::Comm::instance().communicator(), const_cast<char*>(filename.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh));
+  MPI_CHECK_RESULT(MPI_File_set_size, (fh, 0));
+
+  if(rank == 0)
+    MPI_CHECK_RESULT(MPI_File_write_at, (fh, 0, const_cast<char*>(&header.data()[0]), static_cast<int>(header.data().size()), MPI_BYTE, MPI_STATUS_IGNORE));
+
+  // Collective writes must be called the same number of times on every rank
+  Uint my_nb_chunks = detail::nb_chunks(block_size);
+  Uint nb_chunks = 0;
+  PE::Comm::instance().all_reduce(PE::max(), &my_nb_chunks, 1, &nb_chunks);
+  for(Uint chunk = 0; chunk != nb_chunks; ++chunk)
+  {
+    const boost::uint64_t begin = std::min(block_size, chunk*detail::max_chunk_size);
+    const boost::uint64_t end = std::min(block_size, begin + detail::max_chunk_size);
+    char* data = block.empty() ? 0 : const_cast<char*>(&block[0]) + begin;
+    MPI_CHECK_RESULT(MPI_File_write_at_all, (fh, static_cast<MPI_Offset>(my_offset + begin), data, static_cast<int>(end - begin), MPI_BYTE, MPI_STATUS_IGNORE));
+  }
+
+  MPI_CHECK_RESULT(MPI_File_close, (&fh));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Shared::read_file(const URI& file, std::vector<char>& block)
+{
+  const bool parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  const Uint nb_ranks = parallel ? PE::Comm::instance().size() : 1u;
+  const Uint rank = parallel ? PE::Comm::instance().rank() : 0u;
+  const std::string filename = file.path();
+
+  if( !boost::filesystem::exists(boost::filesystem::path(filename)) )
+    throw boost::filesystem::filesystem_error( filename + " does not exist", boost::system::error_code() );
+
+  std::vector<char> header(header_size());
+  std::vector<char> index_entry(index_entry_size());
+  boost::uint64_t offset, size;
+
+  if(!parallel)
+  {
+    boost::filesystem::fstream stream(boost::filesystem::path(filename), std::ios_base::in | std::ios_base::binary);
+    if(!stream)
+      throw boost::filesystem::filesystem_error(filename + " failed to open", boost::system::error_code());
+    stream.read(&header[0], header.size());
+    if(!stream)
+      throw FileFormatError(FromHere(), filename + " is not a checkpoint file");
+    detail::check_nb_ranks(detail::check_header(header, filename), nb_ranks, filename);
+    stream.read(&index_entry[0], index_entry.size());
+    ReadBuffer(index_entry) >> offset >> size;
+    block.resize(size);
+    stream.seekg(offset);
+    if(size != 0)
+      stream.read(&block[0], size);
+    if(!stream)
+      throw FileFormatError(FromHere(), "Unexpected end of checkpoint " + filename);
+    return;
+  }
+
+  CF3_TRACE_SCOPE("MPI_File_read_at_all", TraceRecorder::MPI);
+
+  MPI_File fh;
+  MPI_CHECK_RESULT(MPI_File_open, (PE::Comm::instance().communicator(), const_cast<char*>(filename.c_str()), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh));
+
+  // Every rank reads the fixed header and only its own index entry
+  MPI_CHECK_RESULT(MPI_File_read_at_all, (fh, 0, &header[0], static_cast<int>(header.size()), MPI_BYTE, MPI_STATUS_IGNORE));
+  const Uint file_nb_ranks = detail::check_header(header, filename);
+  if(file_nb_ranks != nb_ranks)
+  {
+    MPI_File_close(&fh);
+    detail::check_nb_ranks(file_nb_ranks, nb_ranks, filename);
+  }
+  MPI_CHECK_RESULT(MPI_File_read_at_all, (fh, static_cast<MPI_Offset>(header_size() + rank*index_entry_size()), &index_entry[0], static_cast<int>(index_entry.size()), MPI_BYTE, MPI_STATUS_IGNORE));
+  ReadBuffer(index_entry) >> offset >> size;
+
+  block.resize(size);
+  Uint my_nb_chunks = detail::nb_chunks(size);
+  Uint nb_chunks = 0;
+  PE::Comm::instance().all_reduce(PE::max(), &my_nb_chunks, 1, &nb_chunks);
+  for(Uint chunk = 0; chunk != nb_chunks; ++chunk)
+  {
+    const boost::uint64_t begin = std::min(size, chunk*detail::max_chunk_size);
+    const boost::uint64_t end = std::min(size, begin + detail::max_chunk_size);
+    char* data = block.empty() ? 0 : &block[0] + begin;
+    MPI_CHECK_RESULT(MPI_File_read_at_all, (fh, static_cast<MPI_Offset>(offset + begin), data, static_cast<int>(end - begin), MPI_BYTE, MPI_STATUS_IGNORE));
+  }
+
+  MPI_CHECK_RESULT(MPI_File_close, (&fh));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // checkpoint
+} // mesh
+} // cf3
@@ -0,0 +1,212 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_checkpoint_Shared_hpp
+#define cf3_mesh_checkpoint_Shared_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/URI.hpp"
+
+#include "mesh/checkpoint/LibCheckpoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace checkpoint {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Layout of a checkpoint file, shared by the reader and the writer.
+///
+/// A checkpoint file contains one binary block per rank, preceded by an index:
+/// - 8 bytes magic string "CF3CHKPT"
+/// - format version (32 bit unsigned)
+/// - number of ranks that wrote the file (32 bit unsigned)
+/// - for every rank: offset and size of its block in bytes (2 x 64 bit unsigned)
+/// - the blocks, in rank order
+///
+/// The block of a rank holds the mesh metadata, the topology tree with for each Entities
+/// the element type, glb_idx, rank and geometry connectivity, every Dictionary with its
+/// glb_idx, rank, space connectivities and fields, and the face-cell and cell-face
+/// connectivities created by BuildFaces.
+///
+/// All data is stored in the native byte order. Every rank reads back only the
+/// block that it wrote, so a checkpoint can only be read with the number of ranks
+/// that wrote it.
+class checkpoint_API Shared
+{
+public:
+
+  /// Gets the Class name
+  static std::string type_name() { return "Shared"; }
+
+  /// Magic string at the start of every checkpoint file
+  static const char* magic() { return "CF3CHKPT"; }
+
+  /// Version of the format, incremented when the block layout changes
+  static Uint version() { return 1u; }
+
+  /// Size in bytes of the header, without the index
+  static Uint header_size() { return 8u + 2u*sizeof(boost::uint32_t); }
+
+  /// Size in bytes of one index entry
+  static Uint index_entry_size() { return 2u*sizeof(boost::uint64_t); }
+
+  /// Kind of component stored in the topology tree
+  enum ComponentKind { REGION = 0, ENTITIES = 1 };
+
+  /// Types of mesh metadata that can be stored
+  enum PropertyType { REAL = 0, UINT = 1, INT = 2, BOOL = 3, STRING = 4, REAL_VECTOR = 5, UINT_VECTOR = 6, STRING_VECTOR = 7 };
+
+  /// Marks an entity reference that points to no entities
+  static Uint no_entities() { return static_cast<Uint>(-1); }
+
+  /// Write the block of this rank to a checkpoint file. Collective when running in parallel:
+  /// the blocks of all ranks are written to the same file using MPI-IO.
+  static void write_file(const common::URI& file, const std::vector<char>& block);
+
+  /// Read the block that was written by this rank from a checkpoint file.
+  /// Collective when running in parallel.
+  /// @throws common::FileFormatError if the file is not a checkpoint, or was written by a different number of ranks
+  static void read_file(const common::URI& file, std::vector<char>& block);
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Appends plain data to a growing byte array
+class checkpoint_API WriteBuffer
+{
+public:
+
+  /// Append a plain old data value
+  template<typename T>
+  WriteBuffer& operator<<(const T& value)
+  {
+    write(&value, 1);
+    return *this;
+  }
+
+  /// Append a string, prefixed with its length
+  WriteBuffer& operator<<(const std::string& value)
+  {
+    *this << static_cast<Uint>(value.size());
+    write(value.data(), value.size());
+    return *this;
+  }
+
+  /// Append a vector, prefixed with its length
+  template<typename T>
+  WriteBuffer& operator<<(const std::vector<T>& values)
+  {
+    *this << static_cast<Uint>(values.size());
+    for(Uint i = 0; i != values.size(); ++i)
+      *this << values[i];
+    return *this;
+  }
+
+  /// Append an array of plain old data values
+  template<typename T>
+  void write(const T* values, const Uint nb_values)
+  {
+    if(nb_values == 0)
+      return;
+    const char* bytes = reinterpret_cast<const char*>(values);
+    m_data.insert(m_data.end(), bytes, bytes + nb_values*sizeof(T));
+  }
+
+  /// The data written so far
+  const std::vector<char>& data() const { return m_data; }
+
+private:
+  std::vector<char> m_data;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Extracts plain data, in the order it was written by a WriteBuffer
+class checkpoint_API ReadBuffer
+{
+public:
+
+  ReadBuffer(const std::vector<char>& data) : m_data(data), m_position(0)
+  {
+  }
+
+  /// Extract a plain old data value
+  template<typename T>
+  ReadBuffer& operator>>(T& value)
+  {
+    read(&value, 1);
+    return *this;
+  }
+
+  /// Extract a string
+  ReadBuffer& operator>>(std::string& value)
+  {
+    Uint size;
+    *this >> size;
+    check_available(size);
+    value.assign(&m_data[m_position], size);
+    m_position += size;
+    return *this;
+  }
+
+  /// Extract a vector
+  template<typename T>
+  ReadBuffer& operator>>(std::vector<T>& values)
+  {
+    Uint size;
+    *this >> size;
+    values.resize(size);
+    for(Uint i = 0; i != size; ++i)
+      *this >> values[i];
+    return *this;
+  }
+
+  /// Extract an array of plain old data values
+  template<typename T>
+  void read(T* values, const Uint nb_values)
+  {
+    if(nb_values == 0)
+      return;
+    const std::size_t nb_bytes = nb_values*sizeof(T);
+    check_available(nb_bytes);
+    std::memcpy(values, &m_data[m_position], nb_bytes);
+    m_position += nb_bytes;
+  }
+
+  /// True if all data was extracted
+  bool eof() const { return m_position == m_data.size(); }
+
+private:
+  void check_available(const std::size_t nb_bytes) const
+  {
+    if(m_position + nb_bytes > m_data.size())
+      throw common::FileFormatError(FromHere(), "Unexpected end of checkpoint data");
+  }
+
+  const std::vector<char>& m_data;
+  std::size_t m_position;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // checkpoint
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_checkpoint_Shared_hpp
@@ -0,0 +1,299 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <typeinfo>
+
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Link.hpp"
+#include "common/Log.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Table.hpp"
+#include "common/List.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/checkpoint/Writer.hpp"
+#include "mesh/checkpoint/Shared.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshMetadata.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/ShapeFunction.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementConnectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+
+namespace cf3 {
+namespace mesh {
+namespace checkpoint {
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < checkpoint::Writer, MeshWriter, LibCheckpoint> aCheckpointWriter_Builder;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  template<typename T>
+  void write_table(WriteBuffer& out, const common::Table<T>& table)
+  {
+    out << table.size() << table.row_size();
+    out.write(table.array().data(), table.size()*table.row_size());
+  }
+
+  template<typename T>
+  void write_list(WriteBuffer& out, const common::List<T>& list)
+  {
+    out << list.size();
+    out.write(list.array().data(), list.size());
+  }
+
+  /// Entity references are stored as the index of the Entities in the written order and the element index
+  void write_entity_table(WriteBuffer& out, const common::Table<Entity>& table, const std::map<const Entities*, Uint>& entities_idx)
+  {
+    out << table.size() << table.row_size();
+    for(Uint i = 0; i != table.size(); ++i)
+    {
+      for(Uint j = 0; j != table.row_size(); ++j)
+      {
+        const Entity& entity = table[i][j];
+        std::map<const Entities*, Uint>::const_iterator found = entities_idx.find(entity.comp);
+        out << (found == entities_idx.end() ? Shared::no_entities() : found->second) << entity.idx;
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Writer::Writer( const std::string& name )
+: MeshWriter(name)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> Writer::get_extensions()
+{
+  std::vector<std::string> extensions;
+  extensions.push_back(".cf3chk");
+  return extensions;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write()
+{
+  const Mesh& mesh = *m_mesh;
+  const Dictionary& geometry = mesh.geometry_fields();
+
+  m_entities.clear();
+  m_entities_idx.clear();
+
+  WriteBuffer out;
+
+  write_metadata(out);
+
+  out << mesh.dimension() << geometry.size();
+
+  write_region(mesh.topology(), out);
+
+  // Dictionaries, starting with the geometry
+  std::vector<const Dictionary*> dictionaries(1, &geometry);
+  boost_foreach(const Handle<Dictionary>& dict, mesh.dictionaries())
+  {
+    if(dict.get() != &geometry)
+      dictionaries.push_back(dict.get());
+  }
+  out << static_cast<Uint>(dictionaries.size());
+  boost_foreach(const Dictionary* dict, dictionaries)
+  {
+    write_dictionary(*dict, out);
+  }
+
+  boost_foreach(const Entities* entities, m_entities)
+  {
+    write_element_connectivities(*entities, out);
+  }
+
+  CFinfo << "Writing checkpoint " << m_file_path.path() << CFendl;
+  Shared::write_file(m_file_path, out.data());
+
+  m_entities.clear();
+  m_entities_idx.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_metadata(WriteBuffer& out)
+{
+  const PropertyList& properties = metadata();
+
+  std::vector<std::string> names;
+  std::vector<Uint> types;
+  for(PropertyList::const_iterator it = properties.begin(); it != properties.end(); ++it)
+  {
+    const std::type_info& type = it->second.type();
+    if(type == typeid(Real))                            types.push_back(Shared::REAL);
+    else if(type == typeid(Uint))                       types.push_back(Shared::UINT);
+    else if(type == typeid(int))                        types.push_back(Shared::INT);
+    else if(type == typeid(bool))                       types.push_back(Shared::BOOL);
+    else if(type == typeid(std::string))                types.push_back(Shared::STRING);
+    else if(type == typeid(std::vector<Real>))          types.push_back(Shared::REAL_VECTOR);
+    else if(type == typeid(std::vector<Uint>))          types.push_back(Shared::UINT_VECTOR);
+    else if(type == typeid(std::vector<std::string>))   types.push_back(Shared::STRING_VECTOR);
+    else
+    {
+      CFwarn << "Metadata " << it->first << " of mesh " << m_mesh->uri().string() << " has an unsupported type and is not written to the checkpoint" << CFendl;
+      continue;
+    }
+    names.push_back(it->first);
+  }
+
+  out << static_cast<Uint>(names.size());
+  for(Uint i = 0; i != names.size(); ++i)
+  {
+    const boost::any& value = properties[names[i]];
+    out << names[i] << types[i];
+    switch(types[i])
+    {
+      case Shared::REAL:          out << boost::any_cast<Real>(value); break;
+      case Shared::UINT:          out << boost::any_cast<Uint>(value); break;
+      case Shared::INT:           out << boost::any_cast<int>(value); break;
+      case Shared::BOOL:          out << boost::any_cast<bool>(value); break;
+      case Shared::STRING:        out << boost::any_cast<std::string>(value); break;
+      case Shared::REAL_VECTOR:   out << boost::any_cast< std::vector<Real> >(value); break;
+      case Shared::UINT_VECTOR:   out << boost::any_cast< std::vector<Uint> >(value); break;
+      case Shared::STRING_VECTOR: out << boost::any_cast< std::vector<std::string> >(value); break;
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_region(const Region& region, WriteBuffer& out)
+{
+  std::vector<const Component*> children;
+  boost_foreach(const Component& child, region)
+  {
+    if(is_not_null(dynamic_cast<const Region*>(&child)) || is_not_null(dynamic_cast<const Entities*>(&child)))
+      children.push_back(&child);
+  }
+
+  out << static_cast<Uint>(children.size());
+  boost_foreach(const Component* child, children)
+  {
+    out << child->name() << child->derived_type_name() << child->get_tags();
+
+    if(const Region* child_region = dynamic_cast<const Region*>(child))
+    {
+      out << static_cast<Uint>(Shared::REGION);
+      write_region(*child_region, out);
+      continue;
+    }
+
+    const Entities& entities = dynamic_cast<const Entities&>(*child);
+    m_entities_idx[&entities] = m_entities.size();
+    m_entities.push_back(&entities);
+
+    out << static_cast<Uint>(Shared::ENTITIES) << entities.element_type().derived_type_name();
+    detail::write_list(out, entities.glb_idx());
+    detail::write_list(out, entities.rank());
+    detail::write_table(out, entities.geometry_space().connectivity());
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_dictionary(const Dictionary& dict, WriteBuffer& out)
+{
+  const bool is_geometry = (&dict == &m_mesh->geometry_fields());
+  if(!is_geometry)
+  {
+    out << dict.name() << dict.derived_type_name() << dict.get_tags();
+
+    // Spaces of the geometry dictionary are stored with the entities
+    std::vector<const Space*> spaces;
+    boost_foreach(const Handle<Space>& space, dict.spaces())
+    {
+      if(m_entities_idx.count(&space->support()))
+        spaces.push_back(space.get());
+    }
+    out << static_cast<Uint>(spaces.size());
+    boost_foreach(const Space* space, spaces)
+    {
+      out << m_entities_idx[&space->support()] << space->shape_function().derived_type_name();
+      detail::write_table(out, space->connectivity());
+    }
+  }
+
+  detail::write_list(out, dict.glb_idx());
+  detail::write_list(out, dict.rank());
+  write_fields(dict, out);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_fields(const Dictionary& dict, WriteBuffer& out)
+{
+  out << static_cast<Uint>(dict.fields().size());
+  boost_foreach(const Handle<Field>& field, dict.fields())
+  {
+    out << field->name() << field->descriptor().description() << field->get_tags();
+    detail::write_table(out, *field);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_element_connectivities(const Entities& entities, WriteBuffer& out)
+{
+  // Face to cell connectivity, only if it is owned by the entities as done by BuildFaces
+  const Handle<FaceCellConnectivity>& f2c = entities.connectivity_face2cell();
+  const bool has_f2c = is_not_null(f2c) && f2c->parent().get() == &entities;
+  out << has_f2c;
+  if(has_f2c)
+  {
+    std::vector<Uint> used;
+    boost_foreach(const Link& link, find_components<Link>(*f2c->get_child("used_components")))
+    {
+      Handle<Entities const> used_entities(link.follow());
+      if(is_not_null(used_entities) && m_entities_idx.count(used_entities.get()))
+        used.push_back(m_entities_idx[used_entities.get()]);
+    }
+    out << f2c->name() << used;
+    detail::write_entity_table(out, f2c->connectivity(), m_entities_idx);
+    detail::write_table(out, f2c->face_number());
+    detail::write_list(out, f2c->is_bdry_face());
+  }
+
+  // Cell to face connectivity
+  const Handle<ElementConnectivity>& c2f = entities.connectivity_cell2face();
+  const bool has_c2f = is_not_null(c2f) && c2f->parent().get() == &entities;
+  out << has_c2f;
+  if(has_c2f)
+  {
+    out << c2f->name();
+    detail::write_entity_table(out, *c2f, m_entities_idx);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // checkpoint
+} // mesh
+} // cf3
@@ -0,0 +1,81 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_checkpoint_Writer_hpp
+#define cf3_mesh_checkpoint_Writer_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "mesh/MeshWriter.hpp"
+
+#include "mesh/checkpoint/LibCheckpoint.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+  class Dictionary;
+namespace checkpoint {
+
+  class WriteBuffer;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Writes a binary checkpoint of a partitioned mesh, to be read back by checkpoint::Reader
+/// on the same number of ranks.
+/// Unlike the visualization writers, the complete state of the mesh is always written:
+/// all regions, all dictionaries with all their fields, the global numbering, and the
+/// connectivities built by BuildFaces. The "fields" and region filter options are ignored.
+/// @see Shared for the layout of the file
+class checkpoint_API Writer : public MeshWriter
+{
+public: // functions
+
+  /// constructor
+  Writer( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Writer"; }
+
+  virtual void write();
+
+  virtual std::string get_format() { return "checkpoint"; }
+
+  virtual std::vector<std::string> get_extensions();
+
+private: // functions
+
+  void write_metadata(WriteBuffer& out);
+
+  void write_region(const Region& region, WriteBuffer& out);
+
+  void write_dictionary(const Dictionary& dict, WriteBuffer& out);
+
+  void write_fields(const Dictionary& dict, WriteBuffer& out);
+
+  void write_element_connectivities(const Entities& entities, WriteBuffer& out);
+
+private: // data
+
+  /// Entities in the order they are written, with their index
+  std::map<const Entities*, Uint> m_entities_idx;
+
+  /// Entities in the order they are written
+  std::vector<const Entities*> m_entities;
+
+}; // end Writer
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // checkpoint
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_checkpoint_Writer_hpp
@@ -324,8 +324,8 @@ void Writer::write_elem_nodal_data(std::fstream& file)
     const Field& field = *field_h;
     if(field.discontinuous())
     {
-      const Real field_time = m_mesh->metadata().properties().value<Real>("time");
-      const Uint field_iter = m_mesh->metadata().properties().value<Uint>("iter");
+      const Real field_time = metadata().value<Real>("time");
+      const Uint field_iter = metadata().value<Uint>("iter");
       const std::string field_name = field.name();
       Uint nb_elements = 0;
       boost_foreach(const Handle<Entities const>& elements_handle, m_filtered_entities )
@@ -490,8 +490,8 @@ void Writer::write_nodal_data(std::fstream& file)
     {
       cf3_assert(is_null(field_h) == false);
       const Field& field = *field_h;
-      const Real field_time = m_mesh->metadata().properties().value<Real>("time");
-      const Uint field_iter = m_mesh->metadata().properties().value<Uint>("iter");
+      const Real field_time = metadata().value<Real>("time");
+      const Uint field_iter = metadata().value<Uint>("iter");
       const std::string field_name = field.name();
       Uint nb_elements = 0;
       std::vector< Handle<Entities const> > filtered_used_entities_by_field;
@@ -27,6 +27,7 @@
 #include "mesh/Connectivity.hpp"
 #include "mesh/Functions.hpp"
 #include "mesh/MeshMetadata.hpp"
+#include "mesh/OutputAggregation.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -50,6 +51,9 @@ Writer::Writer( const std::string& name )
 
   options().add("cell_centred",true)
     .description("True if discontinuous fields are to be plotted as cell-centred fields");
+
+  options().add("aggregation_ratio",1u)
+    .description("Number of ranks whose zones are collected and written to a single file by the first rank of the group");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -65,6 +69,13 @@ std::vector<std::string> Writer::get_extensions()
 
 void Writer::write()
 {
+  const OutputAggregation aggregation(options().value<Uint>("aggregation_ratio"));
+  if (aggregation.ratio() > 1 && PE::Comm::instance().size() > 1)
+  {
+    write_aggregated(aggregation);
+    return;
+  }
+
   // if the file is present open it
   boost::filesystem::fstream file;
   boost::filesystem::path path(m_file_path.path());
@@ -81,15 +92,50 @@ void Writer::write()
   }
 
 
-  write_file(file);
+  write_file(file, true);
 
   file.close();
 
 }
+
 /////////////////////////////////////////////////////////////////////////////
 
-void Writer::write_file(std::fstream& file)
+void Writer::write_aggregated(const OutputAggregation& aggregation)
 {
+  // Every rank formats its zones, the aggregator adds the header in front of its own zones
+  std::stringstream zones;
+  write_file(zones, aggregation.is_aggregator());
+
+  std::vector<std::string> group_zones;
+  aggregation.gather(zones.str(), group_zones);
+
+  if (!aggregation.is_aggregator())
+    return;
+
+  boost::filesystem::fstream file;
+  boost::filesystem::path path(m_file_path.path());
+  path = path.parent_path() / boost::filesystem::path(boost::filesystem::basename(path) + "_G" + to_str(aggregation.group()) + boost::filesystem::extension(path));
+  file.open(path,std::ios_base::out);
+  if (!file) // didn't open so throw exception
+  {
+     throw boost::filesystem::filesystem_error( path.string() + " failed to open",
+                                                boost::system::error_code() );
+  }
+
+  boost_foreach(const std::string& rank_zones, group_zones)
+  {
+    file << rank_zones;
+  }
+
+  file.close();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_file(std::ostream& out, const bool include_header)
+{
+  // The header is always built, because the variable numbering is needed for the zones
+  std::stringstream file;
   file << "TITLE      = COOLFluiD Mesh Data" << "\n";
   file << "VARIABLES  = ";
 
@@ -131,7 +177,16 @@ void Writer::write_file(std::fstream& file)
   }
   file << "\n";
 
+  if (include_header)
+    out << file.str();
+
+  write_zones(out, dimension, cell_centered_var_ids);
+}
 
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_zones(std::ostream& file, const Uint dimension, const std::vector<Uint>& cell_centered_var_ids)
+{
   // loop over the element types
   // and create a zone in the tecplot file for each element type
 //  std::map<Handle<Component const>,Uint> zone_id;
@@ -189,9 +244,9 @@ void Writer::write_file(std::fstream& file)
     // one zone per element type per cpu
     // therefore the title is dependent on those parameters
     file << "ZONE "
-         << "  T=\"ITER"<<m_mesh->metadata().properties().value<Uint>("iter") << ":" << zone_name << "\""
+         << "  T=\"ITER"<<metadata().value<Uint>("iter") << ":" << zone_name << "\""
          << ", STRANDID="<<zone_idx
-         << ", SOLUTIONTIME="<<m_mesh->metadata().properties().value<Real>("time")
+         << ", SOLUTIONTIME="<<metadata().value<Real>("time")
          << ", N=" << used_nodes.size()
          << ", E=" << nb_elems
          << ", DATAPACKING=BLOCK"
@@ -19,6 +19,7 @@
 namespace cf3 {
 namespace mesh {
   class ElementType;
+  class OutputAggregation;
 namespace tecplot {
 
 //////////////////////////////////////////////////////////////////////////////
@@ -48,7 +49,11 @@ public: // functions
 
 private: // functions
 
-  void write_file(std::fstream& file);
+  void write_file(std::ostream& file, const bool include_header);
+
+  void write_zones(std::ostream& file, const Uint dimension, const std::vector<Uint>& cell_centered_var_ids);
+
+  void write_aggregated(const OutputAggregation& aggregation);
 
   std::string zone_type(const ElementType& etype) const;
 
@@ -9,6 +9,8 @@
 #include "common/Core.hpp"
 #include "common/Environment.hpp"
 #include "common/Group.hpp"
+#include "common/TraceRecorder.hpp"
+#include "common/URI.hpp"
 #include "common/PE/Comm.hpp"
 
 #include "python/CoreWrapper.hpp"
@@ -63,6 +65,18 @@ struct CoreWrapper
     return common::PE::Comm::instance().size();
   }
 
+  static void start_tracing(const Uint capacity)
+  {
+    common::TraceRecorder::instance().enable(capacity);
+  }
+  static void stop_tracing()
+  {
+    common::TraceRecorder::instance().disable();
+  }
+  static void write_trace(const std::string& filename)
+  {
+    common::TraceRecorder::instance().write_chrome_trace(common::URI(filename));
+  }
   static void terminate()
   {
     common::Core::instance().terminate();
@@ -85,7 +99,13 @@ void def_core()
     .def("proc", CoreWrapper::proc)
     .staticmethod("proc")
     .def("nb_procs", CoreWrapper::nb_procs)
-    .staticmethod("nb_procs");
+    .staticmethod("nb_procs")
+    .def("start_tracing", CoreWrapper::start_tracing, "Start recording an execution timeline of actions and MPI calls, keeping at most the given number of events")
+    .staticmethod("start_tracing")
+    .def("stop_tracing", CoreWrapper::stop_tracing, "Stop recording the execution timeline")
+    .staticmethod("stop_tracing")
+    .def("write_trace", CoreWrapper::write_trace, "Write the recorded timeline of all ranks to the given file, in Chrome trace (JSON) format")
+    .staticmethod("write_trace");
 }
 
 
@@ -0,0 +1,112 @@
+# Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+#
+# This software is distributed under the terms of the
+# GNU Lesser General Public License version 3 (LGPLv3).
+# See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+"""Reader for the binary history files written by cf3.solver.History with the option binary.
+
+  columns = historyreader.read('history.cfh')
+  pylab.plot(columns['iter'], columns['residual'])
+
+or, to convert a file to tab separated values:
+
+  python historyreader.py history.cfh history.tsv
+"""
+
+import struct
+import sys
+
+import numpy
+
+try:
+  from collections import OrderedDict
+except ImportError: # python < 2.7
+  OrderedDict = dict
+
+def read(filename):
+  """Return a dict with a NumPy array per column, in the order of the file.
+  Columns that were added later on are zero for the earlier entries.
+  A file that was cut off while writing, e.g. by a killed run, is read up to the last complete row."""
+  f = open(filename, 'rb')
+  data = f.read()
+  f.close()
+
+  if data[0:8] != b'CF3HIST1':
+    raise ValueError(filename + ' is not a binary history file')
+  order = '<' if struct.unpack('<I', data[8:12])[0] == 1 else '>'
+  real = numpy.dtype(order + 'f8')
+
+  names = []
+  blocks = [] # (column names, rows per column)
+  pos = 12
+  while pos + 8 <= len(data):
+    tag = data[pos:pos+4]
+    count = struct.unpack(order + 'I', data[pos+4:pos+8])[0]
+    pos += 8
+    if tag == b'SCHM':
+      schema = []
+      for i in range(count):
+        if pos + 4 > len(data):
+          break
+        length = struct.unpack(order + 'I', data[pos:pos+4])[0]
+        if pos + 4 + length > len(data):
+          break
+        schema.append(data[pos+4:pos+4+length].decode('ascii'))
+        pos += 4 + length
+      if len(schema) != count:
+        break # truncated schema, no data can follow
+      names = schema
+    elif tag == b'DATA':
+      nb_columns = len(names)
+      size = count * nb_columns * real.itemsize
+      if pos + size > len(data):
+        # Truncated final block. The columns are stored one after the other,
+        # so only the rows that reached the last column are complete.
+        nb_values = (len(data) - pos) // real.itemsize
+        nb_rows = max(0, min(count, nb_values - (nb_columns - 1) * count))
+        available = numpy.frombuffer(data[pos:pos + nb_values * real.itemsize], dtype=real)
+        if nb_rows > 0:
+          values = numpy.array([available[i*count:i*count + nb_rows] for i in range(nb_columns)])
+          blocks.append((names, values))
+        break
+      values = numpy.frombuffer(data[pos:pos+size], dtype=real).reshape(nb_columns, count)
+      blocks.append((names, values))
+      pos += size
+    else:
+      raise ValueError('unknown block in ' + filename)
+
+  nb_rows = sum(values.shape[1] for block_names, values in blocks)
+  columns = {}
+  column_order = []
+  for block_names, values in blocks:
+    for name in block_names:
+      if name not in columns:
+        columns[name] = numpy.zeros(nb_rows)
+        column_order.append(name)
+
+  row = 0
+  for block_names, values in blocks:
+    for i, name in enumerate(block_names):
+      columns[name][row:row+values.shape[1]] = values[i]
+    row += values.shape[1]
+
+  result = OrderedDict()
+  for name in column_order:
+    result[name] = columns[name]
+  return result
+
+def to_tsv(filename, tsv_filename):
+  """Convert a binary history file to the tab separated values format of cf3.solver.History"""
+  columns = read(filename)
+  out = open(tsv_filename, 'w')
+  out.write('#' + ''.join('\t%16s' % name for name in columns.keys()) + '\n')
+  for values in zip(*columns.values()):
+    out.write(''.join('\t%16.9e' % value for value in values) + '\n')
+  out.close()
+
+if __name__ == '__main__':
+  if len(sys.argv) != 3:
+    print('usage: python historyreader.py history_file tsv_file')
+    sys.exit(1)
+  to_tsv(sys.argv[1], sys.argv[2])
@@ -4,14 +4,18 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
 #include <iomanip>
 
+#include <boost/cstdint.hpp>
+
 #include "common/BoostFilesystem.hpp"
 #include "common/PropertyList.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
 #include "common/Builder.hpp"
 #include "common/Signal.hpp"
+#include "common/Foreach.hpp"
 
 
 #include "solver/History.hpp"
@@ -25,6 +29,18 @@ common::ComponentBuilder < History , Component, LibSolver > History_Builder;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace detail
+{
+  /// Write a count in the binary log file
+  void write_count(std::ostream& out, const Uint count)
+  {
+    const boost::uint32_t value = count;
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 History::History ( const std::string& name ) :
   Component(name)
 {
@@ -44,6 +60,16 @@ History::History ( const std::string& name ) :
   options().add("file",URI("history.tsv"))
       .description("Log file for history").mark_basic();
 
+  options().add("binary",false)
+      .pretty_name("Binary")
+      .description("Write the log file in the append-only binary columnar format instead of tab separated values");
+
+  options().add("buffer_rows",16u)
+      .pretty_name("Buffer Rows")
+      .description("Number of entries that are collected before they are appended to a binary log file");
+
+  m_pending_row_size = 0;
+
   regist_signal ( "write" )
       .description( "Write history" )
       .pretty_name("Write" )
@@ -57,6 +83,7 @@ History::~History()
 {
   if (m_file)
   {
+    flush();
     m_file.close();
   }
 }
@@ -125,7 +152,11 @@ void History::save_entry()
 
   if (m_logging)
   {
-    if (PE::Comm::instance().rank() == 0)
+    if (PE::Comm::instance().rank() == 0 && options().value<bool>("binary"))
+    {
+      log_binary_entry(this_entry.data(), resized);
+    }
+    else if (PE::Comm::instance().rank() == 0)
     {
       if (resized)
         m_file.close();
@@ -152,6 +183,9 @@ void History::flush()
 {
   if(is_not_null(m_buffer))
     m_buffer->flush();
+
+  if (m_file && !m_pending_rows.empty())
+    write_binary_rows();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -197,10 +231,10 @@ void History::signal_write(common::SignalArgs& args)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void History::open_file(boost::filesystem::fstream& file, const common::URI& file_uri)
+void History::open_file(boost::filesystem::fstream& file, const common::URI& file_uri, const std::ios_base::openmode mode)
 {
   boost::filesystem::path path (file_uri.path());
-  file.open(path,std::ios_base::out);
+  file.open(path,mode);
   if (!file) // didn't open so throw exception
   {
     throw boost::filesystem::filesystem_error( path.string() + " failed to open",
@@ -216,22 +250,103 @@ std::string History::file_header() const
   std::stringstream ss;
 
   ss << "#";
+  boost_foreach(const std::string& column, column_names())
+  {
+    ss << "\t" << std::setw(16) << column;
+  }
+  ss << "\n";
+  return ss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::string> History::column_names() const
+{
+  std::vector<std::string> names;
+  names.reserve(m_variables->size());
   for (Uint var_idx=0; var_idx<m_variables->nb_vars(); ++var_idx)
   {
     const Uint var_length = m_variables->var_length(var_idx);
     if (var_length == 1)
     {
-      ss << "\t" << std::setw(16) << m_variables->user_variable_name(var_idx);
+      names.push_back(m_variables->user_variable_name(var_idx));
     }
     else
     {
       for (Uint i=0; i<var_length; ++i)
-        ss << "\t" << std::setw(16) << m_variables->user_variable_name(var_idx)<<"["<<i<<"]";
+        names.push_back(m_variables->user_variable_name(var_idx)+"["+to_str(i)+"]");
     }
+  }
+  return names;
+}
 
+////////////////////////////////////////////////////////////////////////////////
+
+void History::log_binary_entry(const std::vector<Real>& entry, const bool resized)
+{
+  if (!m_file)
+  {
+    // New file, starting with all entries so far, e.g. after restoring from a checkpoint
+    open_file(m_file,options().value<URI>("file"),std::ios_base::out | std::ios_base::binary);
+    m_file.write("CF3HIST1",8);
+    detail::write_count(m_file,1u);
+
+    flush();
+    write_binary_schema();
+    m_pending_rows.assign(m_table->array().data(), m_table->array().data() + m_table->array().num_elements());
+    write_binary_rows();
+    return;
   }
-  ss << "\n";
-  return ss.str();
+
+  if (resized)
+  {
+    // Entries before the new variables keep the old columns
+    write_binary_rows();
+    write_binary_schema();
+  }
+
+  m_pending_rows.insert(m_pending_rows.end(), entry.begin(), entry.end());
+  if (m_pending_rows.size() >= options().value<Uint>("buffer_rows") * m_pending_row_size)
+    write_binary_rows();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void History::write_binary_schema()
+{
+  const std::vector<std::string> names = column_names();
+  m_file.write("SCHM",4);
+  detail::write_count(m_file,names.size());
+  boost_foreach(const std::string& name, names)
+  {
+    detail::write_count(m_file,name.size());
+    m_file.write(name.data(),name.size());
+  }
+  m_pending_row_size = names.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void History::write_binary_rows()
+{
+  if (m_pending_rows.empty() || m_pending_row_size == 0)
+    return;
+
+  cf3_assert(m_pending_rows.size() % m_pending_row_size == 0);
+  const Uint nb_rows = m_pending_rows.size() / m_pending_row_size;
+  m_file.write("DATA",4);
+  detail::write_count(m_file,nb_rows);
+
+  // Column-major, so that readers can map every column directly
+  std::vector<Real> column(nb_rows);
+  for (Uint col=0; col<m_pending_row_size; ++col)
+  {
+    for (Uint row=0; row<nb_rows; ++row)
+      column[row] = m_pending_rows[row*m_pending_row_size + col];
+    m_file.write(reinterpret_cast<const char*>(&column[0]), nb_rows*sizeof(Real));
+  }
+  m_file.flush();
+  m_pending_rows.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -265,6 +380,58 @@ HistoryEntry History::entry() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+std::vector<std::string> History::variable_names() const
+{
+  std::vector<std::string> names;
+  names.reserve(m_variables->nb_vars());
+  for (Uint var_idx=0; var_idx<m_variables->nb_vars(); ++var_idx)
+  {
+    names.push_back(m_variables->user_variable_name(var_idx));
+  }
+  return names;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void History::restore(const Uint dimension, const std::vector<std::string>& variables, const std::vector<Real>& data)
+{
+  if (m_variables->nb_vars() != 0)
+    throw common::SetupError(FromHere(), "History "+uri().string()+" can only be restored before any variable is set");
+
+  if (variables.empty())
+    return;
+
+  if (data.size() % variables.size() != 0)
+    throw common::BadValue(FromHere(), "History data for "+uri().string()+" does not match the number of variables");
+
+  options().set("dimension",dimension);
+  m_variables->options().set("dimension",std::max(dimension,1u));
+  boost_foreach(const std::string& var_name, variables)
+  {
+    m_variables->push_back(var_name,math::VariablesDescriptor::Dimensionalities::SCALAR);
+  }
+  m_table_needs_resize = true;
+  resize_if_necessary();
+
+  // Rows are added in one go, the log file gets rewritten completely at the next entry
+  std::vector<Real> row(variables.size());
+  const Uint nb_rows = data.size() / variables.size();
+  for (Uint i=0; i<nb_rows; ++i)
+  {
+    std::copy(data.begin()+i*row.size(), data.begin()+(i+1)*row.size(), row.begin());
+    m_buffer->add_row(row);
+  }
+  flush();
+
+  // The current entry starts from the last saved values
+  for (Uint var_idx=0; var_idx<variables.size(); ++var_idx)
+  {
+    properties()[variables[var_idx]] = nb_rows == 0 ? 0. : row[var_idx];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 HistoryEntry::HistoryEntry(const History& history)
   : m_history(history)
 {
@@ -39,6 +39,19 @@ class HistoryEntry;
 /// The history file to be rewritten, including the new variables, putting zero's
 /// for the non-existent past entries.
 ///
+/// With the option "binary", the log file is written in an append-only binary
+/// columnar format instead, which is never rewritten:
+/// - a header: the 8 characters "CF3HIST1", followed by the 32-bit unsigned integer 1
+///   in the byte order of the writing machine
+/// - a schema block whenever the variables change: the characters "SCHM", the number
+///   of columns, and for every column the length of its name followed by the name
+/// - data blocks, each with the rows of "buffer_rows" entries: the characters "DATA",
+///   the number of rows, and then the values of every column for all rows (column-major,
+///   64-bit floating point). A data block uses the columns of the last schema before it.
+///
+/// All counts are 32-bit unsigned integers. The python module historyreader reads these
+/// files into NumPy arrays, and converts them to tsv.
+///
 /// Example:\n
 /// @code
 /// boost::shared_ptr<History> history = allocate_component<History>("history");
@@ -114,16 +127,40 @@ public:
   Handle<math::VariablesDescriptor const> variables() const;
 
 
-  /// @brief Flush the buffer in the table
+  /// @brief Flush the buffer in the table, and append the pending entries to a binary log file
   void flush();
 
   /// @brief make a Entry object that can be written to any output stream
   HistoryEntry entry() const;
 
+  /// @brief Names of the stored variables, in the order of the table columns
+  std::vector<std::string> variable_names() const;
+
+  /// @brief Restore a history that was saved before, e.g. when restarting from a checkpoint
+  /// @param dimension  value of the "dimension" option when the history was saved
+  /// @param variables  names of the variables, in the order of the table columns
+  /// @param data       the table rows, one after the other
+  /// @pre No variables were set yet in this history
+  void restore(const Uint dimension, const std::vector<std::string>& variables, const std::vector<Real>& data);
+
 private: // functions
 
   /// @brief open a file with given URI
-  static void open_file(boost::filesystem::fstream& file, const common::URI& file_uri);
+  static void open_file(boost::filesystem::fstream& file, const common::URI& file_uri, const std::ios_base::openmode mode = std::ios_base::out);
+
+  /// @brief Log an entry in the binary log file
+  /// @param entry  values of the entry, which is already added to the buffer
+  /// @param resized  true if the entry added variables
+  void log_binary_entry(const std::vector<Real>& entry, const bool resized);
+
+  /// @brief Append the entries that are not in the binary log file yet
+  void write_binary_rows();
+
+  /// @brief Append a schema block with the current variables to the binary log file
+  void write_binary_schema();
+
+  /// @brief Names of the columns of the table, with vector variables expanded
+  std::vector<std::string> column_names() const;
 
   /// @brief resize table and rebuild buffer if needed
   bool resize_if_necessary();
@@ -152,6 +189,12 @@ private: // data
   /// If so, the table needs to be resized.
   bool m_table_needs_resize;
 
+  /// Entries that are not in the binary log file yet, row after row
+  std::vector<Real> m_pending_rows;
+
+  /// Number of columns of the entries in m_pending_rows
+  Uint m_pending_row_size;
+
 }; // History
 
 ////////////////////////////////////////////////////////////////////////////////
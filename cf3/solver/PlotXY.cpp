@@ -10,6 +10,8 @@
 
 #include "common/Builder.hpp"
 #include "common/Signal.hpp"
+#include "common/OptionT.hpp"
+#include "common/XML/SignalOptions.hpp"
 #include "common/XML/MultiArray.hpp"
 #include "common/Table.hpp"
 
@@ -40,6 +42,7 @@ PlotXY::PlotXY(const std::string& name) :
 {
   regist_signal( "convergence_history" )
     .connect( boost::bind( &PlotXY::convergence_history, this, _1 ) )
+    .signature( boost::bind( &PlotXY::signature_convergence_history, this, _1 ) )
     .description("Lists convergence history")
     .pretty_name("Get history");
 
@@ -63,6 +66,10 @@ void PlotXY::convergence_history( SignalArgs & args )
 {
   if( is_not_null(m_data.get()) )
   {
+    SignalOptions request_options( args );
+    const Uint first_row = request_options.check("first_row") ? request_options.value<Uint>("first_row") : 0u;
+    const bool compress = request_options.check("compress") ? request_options.value<bool>("compress") : true;
+
     SignalFrame reply = args.create_reply( uri() );
     SignalFrame& options = reply.map( Protocol::Tags::key_options() );
 //    std::vector<Real> data(8000);
@@ -70,7 +77,11 @@ void PlotXY::convergence_history( SignalArgs & args )
     std::vector<std::string> labels =
         list_of<std::string>("x")("y")("z")("u")("v")("w")("p")("t");
 
-    add_multi_array_in(options.main_map, "Table", m_data->array(), ";", labels);
+    // a requester that is ahead of the table (e.g. after a restart) gets everything again
+    const Uint reply_first_row = first_row <= table.size() ? first_row : 0u;
+
+    options.set_option("first_row", class_name<Uint>(), to_str(reply_first_row));
+    add_binary_multi_array_in(options.main_map, "Table", m_data->array(), labels, compress, reply_first_row);
 
 //    for(Uint row = 0 ; row < 1000 ; ++row)
 //    {
@@ -88,6 +99,18 @@ void PlotXY::convergence_history( SignalArgs & args )
 
 /////////////////////////////////////////////////////////////////////////////////////
 
+void PlotXY::signature_convergence_history( SignalArgs & args )
+{
+  SignalOptions options( args );
+
+  options.add("first_row", 0u)
+      .description("Index of the first row to send. The rows before it are already known by the requester.");
+  options.add("compress", true)
+      .description("Compress the rows with zlib");
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+
 void PlotXY::set_data(const URI &uri)
 {
   m_data = Handle< Table<Real> >(access_component(uri));
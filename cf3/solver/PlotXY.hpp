@@ -41,8 +41,14 @@ public:
 
     void set_data (const common::URI & uri);
 
+    /// Replies with the rows of the table, as a binary multi-array named "Table".
+    /// Only the rows from option "first_row" on are sent, so that a requester
+    /// that already has the beginning of the history only receives the new rows.
+    /// The reply also gives the "first_row" it starts from.
     void convergence_history( common::SignalArgs & args );
 
+    void signature_convergence_history( common::SignalArgs & args );
+
   private: // data
 
     std::vector<Real> m_x_axis;
@@ -0,0 +1,92 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <limits>
+
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
+#include "common/List.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+
+#include "ExtractBoundary.hpp"
+
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < ExtractBoundary, common::Action, LibActions > ExtractBoundary_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractBoundary::ExtractBoundary ( const std::string& name ) : PeriodicExtract(name)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractBoundary::~ExtractBoundary()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExtractBoundary::extract(std::vector<NodeSource>& nodes, ConnectivityMapT& connectivity)
+{
+  if(regions().empty())
+    throw SetupError(FromHere(), "No regions to extract were set for " + uri().string());
+
+  // Index of each used geometry node in the extract
+  const Uint unused = std::numeric_limits<Uint>::max();
+  std::vector<Uint> node_map(mesh().geometry_fields().size(), unused);
+
+  boost_foreach(const Handle<Region>& region, regions())
+  {
+    boost_foreach(const Entities& entities, find_components_recursively<Entities>(*region))
+    {
+      std::vector<Uint>& result = connectivity[entities.element_type().derived_type_name()];
+      const Connectivity& entities_connectivity = entities.geometry_space().connectivity();
+      const Uint nb_elements = entities.size();
+      const Uint nb_element_nodes = entities_connectivity.row_size();
+      for(Uint e = 0; e != nb_elements; ++e)
+      {
+        if(entities.is_ghost(e))
+          continue;
+
+        const Connectivity::ConstRow row = entities_connectivity[e];
+        for(Uint i = 0; i != nb_element_nodes; ++i)
+        {
+          Uint& node = node_map[row[i]];
+          if(node == unused)
+          {
+            node = nodes.size();
+            nodes.push_back(NodeSource(row[i], row[i], 0.));
+          }
+          result.push_back(node);
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
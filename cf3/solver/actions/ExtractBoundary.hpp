@@ -0,0 +1,45 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_ExtractBoundary_hpp
+#define cf3_solver_actions_ExtractBoundary_hpp
+
+#include "solver/actions/PeriodicExtract.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+/// Extracts the elements of the regions of this action, typically boundary patches, together with the
+/// nodal fields on them. Unlike mesh::actions::Extract, the solution mesh is left untouched.
+class solver_actions_API ExtractBoundary : public PeriodicExtract {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  ExtractBoundary ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ExtractBoundary();
+
+  /// Get the class name
+  static std::string type_name () { return "ExtractBoundary"; }
+
+private: // functions
+
+  virtual void extract(std::vector<NodeSource>& nodes, ConnectivityMapT& connectivity);
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_ExtractBoundary_hpp
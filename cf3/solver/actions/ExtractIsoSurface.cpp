@@ -0,0 +1,81 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/OptionURI.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+
+#include "ExtractIsoSurface.hpp"
+
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < ExtractIsoSurface, common::Action, LibActions > ExtractIsoSurface_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractIsoSurface::ExtractIsoSurface ( const std::string& name ) : ExtractLevelSet(name)
+{
+  options().add("field", URI())
+      .supported_protocol(URI::Scheme::CPATH)
+      .pretty_name("Field")
+      .description("Field of the geometry dictionary to extract the iso-surface from")
+      .mark_basic();
+
+  options().add("component", 0u)
+      .pretty_name("Component")
+      .description("Column of the field that is compared with the iso-value")
+      .mark_basic();
+
+  options().add("value", 0.)
+      .pretty_name("Value")
+      .description("Iso-value")
+      .mark_basic();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractIsoSurface::~ExtractIsoSurface()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExtractIsoSurface::compute_level_set(std::vector<Real>& values)
+{
+  const URI field_uri = options().value<URI>("field");
+  Handle<Field const> field(access_component_checked(field_uri));
+  if(is_null(field) || &field->dict() != &mesh().geometry_fields())
+    throw SetupError(FromHere(), "Field " + field_uri.string() + " for " + uri().string() + " is not a field of the geometry dictionary");
+
+  const Uint component = options().value<Uint>("component");
+  if(component >= field->row_size())
+    throw SetupError(FromHere(), "Component " + to_str(component) + " of " + uri().string() + " is out of range for field " + field_uri.string());
+
+  const Real value = options().value<Real>("value");
+  const Uint nb_nodes = field->size();
+  values.resize(nb_nodes);
+  for(Uint i = 0; i != nb_nodes; ++i)
+    values[i] = (*field)[i][component] - value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
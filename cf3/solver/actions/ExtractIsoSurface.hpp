@@ -0,0 +1,44 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_ExtractIsoSurface_hpp
+#define cf3_solver_actions_ExtractIsoSurface_hpp
+
+#include "solver/actions/ExtractLevelSet.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+/// Extracts the surface (a line in 2D) where one component of a field of the geometry dictionary equals a given value
+class solver_actions_API ExtractIsoSurface : public ExtractLevelSet {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  ExtractIsoSurface ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ExtractIsoSurface();
+
+  /// Get the class name
+  static std::string type_name () { return "ExtractIsoSurface"; }
+
+private: // functions
+
+  virtual void compute_level_set(std::vector<Real>& values);
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_ExtractIsoSurface_hpp
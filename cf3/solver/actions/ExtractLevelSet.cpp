@@ -0,0 +1,221 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
+#include "common/List.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshTriangulator.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+
+#include "ExtractLevelSet.hpp"
+
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Cuts simplices along the zero level set, merging the crossing points on shared edges
+  template<typename NodeSourceT>
+  class LevelSetCutter
+  {
+  public:
+    LevelSetCutter(const std::vector<Real>& level_set, std::vector<NodeSourceT>& nodes, std::vector<Uint>& connectivity) :
+      m_level_set(level_set),
+      m_nodes(nodes),
+      m_connectivity(connectivity)
+    {
+    }
+
+    /// Add the segment where the triangle with the given nodes crosses the level set
+    void cut_triangle(const Uint* v)
+    {
+      const Uint nb_inside = inside(v[0]) + inside(v[1]) + inside(v[2]);
+      if(nb_inside == 0 || nb_inside == 3)
+        return;
+
+      // The vertex on its own side of the surface
+      const Uint lone = inside(v[0]) != inside(v[1]) ? (inside(v[0]) != inside(v[2]) ? 0 : 1) : 2;
+      m_connectivity.push_back(edge_node(v[lone], v[(lone+1)%3]));
+      m_connectivity.push_back(edge_node(v[lone], v[(lone+2)%3]));
+    }
+
+    /// Add the triangles where the tetrahedron with the given nodes crosses the level set
+    void cut_tetra(const Uint* v)
+    {
+      Uint in[4], out[4];
+      Uint nb_in = 0, nb_out = 0;
+      for(Uint i = 0; i != 4; ++i)
+      {
+        if(inside(v[i]))
+          in[nb_in++] = v[i];
+        else
+          out[nb_out++] = v[i];
+      }
+
+      if(nb_in == 1 || nb_in == 3)
+      {
+        const Uint lone = nb_in == 1 ? in[0] : out[0];
+        const Uint* others = nb_in == 1 ? out : in;
+        for(Uint i = 0; i != 3; ++i)
+          m_connectivity.push_back(edge_node(lone, others[i]));
+      }
+      else if(nb_in == 2)
+      {
+        // The section is a quadrilateral, split in two triangles
+        const Uint n0 = edge_node(in[0], out[0]);
+        const Uint n1 = edge_node(in[0], out[1]);
+        const Uint n2 = edge_node(in[1], out[1]);
+        const Uint n3 = edge_node(in[1], out[0]);
+        m_connectivity.push_back(n0); m_connectivity.push_back(n1); m_connectivity.push_back(n2);
+        m_connectivity.push_back(n2); m_connectivity.push_back(n3); m_connectivity.push_back(n0);
+      }
+    }
+
+  private:
+    Uint inside(const Uint node) const
+    {
+      return m_level_set[node] < 0. ? 1u : 0u;
+    }
+
+    /// Index of the crossing point on the edge between a and b, which lie on different sides
+    Uint edge_node(const Uint a, const Uint b)
+    {
+      const std::pair<Uint, Uint> edge(std::min(a, b), std::max(a, b));
+      std::map<std::pair<Uint, Uint>, Uint>::const_iterator it = m_edge_nodes.find(edge);
+      if(it != m_edge_nodes.end())
+        return it->second;
+
+      const Uint result = m_nodes.size();
+      m_nodes.push_back(NodeSourceT(a, b, m_level_set[a] / (m_level_set[a] - m_level_set[b])));
+      m_edge_nodes[edge] = result;
+      return result;
+    }
+
+    const std::vector<Real>& m_level_set;
+    std::vector<NodeSourceT>& m_nodes;
+    std::vector<Uint>& m_connectivity;
+    std::map<std::pair<Uint, Uint>, Uint> m_edge_nodes;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractLevelSet::ExtractLevelSet ( const std::string& name ) : PeriodicExtract(name)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractLevelSet::~ExtractLevelSet()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExtractLevelSet::extract(std::vector<NodeSource>& nodes, ConnectivityMapT& connectivity)
+{
+  std::vector<Real> level_set;
+  compute_level_set(level_set);
+  cf3_assert(level_set.size() == mesh().geometry_fields().size());
+
+  const Uint dim = mesh().dimension();
+  if(dim != 2 && dim != 3)
+    throw SetupError(FromHere(), uri().string() + " can only extract level sets from 2D or 3D meshes");
+
+  std::vector<Uint>& result = connectivity[dim == 3 ? "cf3.mesh.LagrangeP1.Triag3D" : "cf3.mesh.LagrangeP1.Line2D"];
+  detail::LevelSetCutter<NodeSource> cutter(level_set, nodes, result);
+
+  std::vector< Handle<Region> > cut_regions(regions().begin(), regions().end());
+  if(cut_regions.empty())
+    cut_regions.push_back(mesh().topology().handle<Region>());
+
+  std::vector<Uint> simplices;
+  Uint simplex_nodes[4];
+  boost_foreach(const Handle<Region>& region, cut_regions)
+  {
+    boost_foreach(const Cells& cells, find_components_recursively<Cells>(*region))
+    {
+      const ElementType& etype = cells.element_type();
+      if(etype.order() != 1 || etype.dimensionality() != dim)
+        continue;
+
+      // Local node indices of the simplices that make up each cell
+      simplices.clear();
+      switch(etype.shape())
+      {
+        case GeoShape::TRIAG:
+          for(Uint i = 0; i != 3; ++i) simplices.push_back(i);
+          break;
+        case GeoShape::QUAD:
+          simplices.assign(&MeshTriangulator::quad_triangles[0][0], &MeshTriangulator::quad_triangles[0][0] + 6);
+          break;
+        case GeoShape::TETRA:
+          for(Uint i = 0; i != 4; ++i) simplices.push_back(i);
+          break;
+        case GeoShape::HEXA:
+          simplices.assign(&MeshTriangulator::hexa_tetrahedra[0][0], &MeshTriangulator::hexa_tetrahedra[0][0] + 20);
+          break;
+        default:
+          continue;
+      }
+
+      const Uint simplex_size = dim + 1;
+      const Uint nb_simplices = simplices.size() / simplex_size;
+      const Connectivity& cells_connectivity = cells.geometry_space().connectivity();
+      const Uint nb_cells = cells.size();
+      const Uint nb_cell_nodes = cells_connectivity.row_size();
+      for(Uint e = 0; e != nb_cells; ++e)
+      {
+        if(cells.is_ghost(e))
+          continue;
+
+        const Connectivity::ConstRow row = cells_connectivity[e];
+
+        // Most cells are not crossed by the surface
+        bool has_inside = false, has_outside = false;
+        for(Uint i = 0; i != nb_cell_nodes; ++i)
+        {
+          if(level_set[row[i]] < 0.)
+            has_inside = true;
+          else
+            has_outside = true;
+        }
+        if(!has_inside || !has_outside)
+          continue;
+
+        for(Uint s = 0; s != nb_simplices; ++s)
+        {
+          for(Uint i = 0; i != simplex_size; ++i)
+            simplex_nodes[i] = row[simplices[s*simplex_size + i]];
+
+          if(dim == 3)
+            cutter.cut_tetra(simplex_nodes);
+          else
+            cutter.cut_triangle(simplex_nodes);
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
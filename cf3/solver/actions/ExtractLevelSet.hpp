@@ -0,0 +1,54 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_ExtractLevelSet_hpp
+#define cf3_solver_actions_ExtractLevelSet_hpp
+
+#include "solver/actions/PeriodicExtract.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+/// Extracts the zero level set of a function defined in the geometry nodes.
+///
+/// The cells of the regions of this action (the whole topology by default) are split into
+/// triangles or tetrahedra using the same decomposition as mesh::MeshTriangulator. The linear
+/// shape functions of these simplices give the crossing points on their edges, resulting in
+/// line segments in 2D and triangles in 3D. Crossing points shared by neighbouring simplices are
+/// merged. Only first order triangles, quadrilaterals, tetrahedra and hexahedra are cut,
+/// and ghost cells are skipped so every part of the surface is extracted on one rank.
+class solver_actions_API ExtractLevelSet : public PeriodicExtract {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  ExtractLevelSet ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ExtractLevelSet();
+
+  /// Get the class name
+  static std::string type_name () { return "ExtractLevelSet"; }
+
+private: // functions
+
+  virtual void extract(std::vector<NodeSource>& nodes, ConnectivityMapT& connectivity);
+
+  /// Compute the level set function in all nodes of the geometry dictionary
+  virtual void compute_level_set(std::vector<Real>& values) = 0;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_ExtractLevelSet_hpp
@@ -0,0 +1,277 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <iomanip>
+#include <sstream>
+
+#include <boost/algorithm/string/replace.hpp>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionArray.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Octtree.hpp"
+#include "mesh/ShapeFunction.hpp"
+
+#include "ExtractProbeLine.hpp"
+
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < ExtractProbeLine, common::Action, LibActions > ExtractProbeLine_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractProbeLine::ExtractProbeLine ( const std::string& name ) : solver::Action(name)
+{
+  mark_basic();
+
+  options().add("iterator", m_iterator)
+      .pretty_name("Iterator Component")
+      .description("The component that stores the \'iteration\'")
+      .link_to(&m_iterator);
+
+  options().add( "saverate", 0u )
+      .pretty_name("Save Rate")
+      .description("Interval of iterations between samples");
+
+  options().add( "file", URI() )
+      .pretty_name("File")
+      .description("Path of the tab separated file to write. ${iter} is replaced by the iteration.");
+
+  options().add( "fields", std::vector<URI>() )
+      .pretty_name("Fields")
+      .description("Fields to sample. They must belong to the geometry dictionary. "
+                   "Default is all fields of the geometry dictionary.");
+
+  options().add("start", std::vector<Real>())
+      .pretty_name("Start")
+      .description("First point of the line")
+      .mark_basic();
+
+  options().add("end", std::vector<Real>())
+      .pretty_name("End")
+      .description("Last point of the line")
+      .mark_basic();
+
+  options().add("nb_points", 100u)
+      .pretty_name("Number of Points")
+      .description("Number of equally spaced points on the line, including both ends")
+      .mark_basic();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractProbeLine::~ExtractProbeLine()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExtractProbeLine::execute()
+{
+  if( is_null(m_iterator) )
+    throw SetupError( FromHere(), "The option 'iterator' was not set in the component " + uri().string() );
+
+  const Uint iteration = boost::any_cast<Uint> ( m_iterator->properties().property("iteration") );
+
+  const Uint saverate = options().value<Uint>("saverate");
+
+  if (saverate == 0 || iteration % saverate != 0)
+    return;
+
+  update();
+
+  if(PE::Comm::instance().rank() != 0)
+    return;
+
+  std::stringstream iteration_str;
+  iteration_str << std::setw(4) << std::setfill('0') << iteration;
+  std::string path = options().value<URI>("file").path();
+  boost::algorithm::replace_all(path, "${iter}", iteration_str.str());
+
+  CFinfo << "Writing probe line " << path << CFendl;
+  boost::filesystem::fstream file(path, std::ios_base::out);
+  if (!file)
+    throw FileSystemError(FromHere(), "Could not open file " + path);
+
+  file << "#";
+  boost_foreach(const std::string& column, m_columns)
+    file << "\t" << std::setw(16) << column;
+  file << "\n";
+  for(Uint i = 0; i != m_samples.rows(); ++i)
+  {
+    for(Uint j = 0; j != m_samples.cols(); ++j)
+      file << "\t" << std::scientific << std::setw(16) << m_samples(i, j);
+    file << "\n";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExtractProbeLine::update()
+{
+  const Dictionary& geometry = mesh().geometry_fields();
+  const Uint dim = mesh().dimension();
+
+  // Fields to sample
+  std::vector< Handle<Field const> > fields;
+  boost_foreach(const URI& field_uri, options().value< std::vector<URI> >("fields"))
+  {
+    Handle<Field const> field(access_component_checked(field_uri));
+    if(is_null(field) || &field->dict() != &geometry)
+      throw SetupError(FromHere(), "Field " + field_uri.string() + " for " + uri().string() + " is not a field of the geometry dictionary");
+    fields.push_back(field);
+  }
+  if(options().value< std::vector<URI> >("fields").empty())
+  {
+    boost_foreach(const Field& field, find_components<Field>(geometry))
+    {
+      if(&field != &geometry.coordinates())
+        fields.push_back(field.handle<Field const>());
+    }
+  }
+
+  const std::vector<Real> start = options().value< std::vector<Real> >("start");
+  const std::vector<Real> end = options().value< std::vector<Real> >("end");
+  const Uint nb_points = options().value<Uint>("nb_points");
+  if(start.size() != dim || end.size() != dim)
+    throw SetupError(FromHere(), "Options start and end of " + uri().string() + " must have " + to_str(dim) + " components");
+  if(nb_points < 2)
+    throw SetupError(FromHere(), "Option nb_points of " + uri().string() + " must be at least 2");
+
+  // Columns: distance along the line, coordinates, field values
+  const char* coordinate_names[] = { "x", "y", "z" };
+  m_columns.assign(1, "s");
+  for(Uint d = 0; d != dim; ++d)
+    m_columns.push_back(coordinate_names[d]);
+  boost_foreach(const Handle<Field const>& field, fields)
+  {
+    for(Uint var_idx = 0; var_idx != field->nb_vars(); ++var_idx)
+    {
+      const Uint var_length = field->var_length(var_idx);
+      if(var_length == 1)
+        m_columns.push_back(field->var_name(var_idx));
+      else
+        for(Uint i = 0; i != var_length; ++i)
+          m_columns.push_back(field->var_name(var_idx) + "[" + to_str(i) + "]");
+    }
+  }
+  const Uint nb_columns = m_columns.size();
+
+  Real length = 0.;
+  RealMatrix points(nb_points, dim);
+  for(Uint d = 0; d != dim; ++d)
+    length += (end[d] - start[d]) * (end[d] - start[d]);
+  length = std::sqrt(length);
+  for(Uint i = 0; i != nb_points; ++i)
+  {
+    const Real t = static_cast<Real>(i) / static_cast<Real>(nb_points - 1);
+    for(Uint d = 0; d != dim; ++d)
+      points(i, d) = start[d] + t * (end[d] - start[d]);
+  }
+
+  // Locate the points in the cells of this rank. The search structure is rebuilt every time, so moving meshes are handled.
+  if(is_not_null(get_child("octtree")))
+    remove_component("octtree");
+  Octtree& octtree = *create_component<Octtree>("octtree");
+  octtree.options().set("mesh", mesh().handle<Mesh>());
+  std::vector<Entity> elements;
+  std::vector<bool> found;
+  octtree.find_elements(points, elements, found);
+
+  // Points on partition boundaries are found on several ranks: the lowest of these ranks samples them
+  PE::Comm& comm = PE::Comm::instance();
+  const Uint rank = comm.rank();
+  const Uint nb_ranks = comm.is_active() ? comm.size() : 1;
+  std::vector<Uint> owner(nb_points, nb_ranks);
+  for(Uint i = 0; i != nb_points; ++i)
+  {
+    if(found[i])
+      owner[i] = rank;
+  }
+  if(comm.is_active())
+    comm.all_reduce(PE::min(), &owner[0], nb_points, &owner[0]);
+
+  std::vector<Real> values(nb_points * nb_columns, 0.);
+  RealVector point(dim);
+  for(Uint i = 0; i != nb_points; ++i)
+  {
+    if(owner[i] != rank)
+      continue;
+
+    const Entity& element = elements[i];
+    const ElementType& etype = element.element_type();
+    point = points.row(i).transpose();
+    const RealVector sf_values = etype.shape_function().value(etype.mapped_coordinate(point, element.get_coordinates()));
+    const Connectivity::ConstRow nodes = element.get_nodes();
+
+    Real* row = &values[i * nb_columns];
+    row[0] = static_cast<Real>(i) / static_cast<Real>(nb_points - 1) * length;
+    for(Uint d = 0; d != dim; ++d)
+      row[1 + d] = point[d];
+
+    Uint column = 1 + dim;
+    boost_foreach(const Handle<Field const>& field, fields)
+    {
+      const Uint row_size = field->row_size();
+      for(Uint n = 0; n != sf_values.size(); ++n)
+      {
+        const Field::ConstRow field_row = (*field)[nodes[n]];
+        for(Uint j = 0; j != row_size; ++j)
+          row[column + j] += sf_values[n] * field_row[j];
+      }
+      column += row_size;
+    }
+  }
+
+  // Only the owner has non-zero values for a point
+  if(comm.is_active())
+    comm.all_reduce(PE::plus(), &values[0], values.size(), &values[0]);
+
+  Uint nb_samples = 0;
+  for(Uint i = 0; i != nb_points; ++i)
+  {
+    if(owner[i] != nb_ranks)
+      ++nb_samples;
+  }
+  m_samples.resize(nb_samples, nb_columns);
+  Uint sample = 0;
+  for(Uint i = 0; i != nb_points; ++i)
+  {
+    if(owner[i] == nb_ranks)
+      continue;
+    for(Uint j = 0; j != nb_columns; ++j)
+      m_samples(sample, j) = values[i * nb_columns + j];
+    ++sample;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
@@ -0,0 +1,66 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_ExtractProbeLine_hpp
+#define cf3_solver_actions_ExtractProbeLine_hpp
+
+#include "math/MatrixTypes.hpp"
+
+#include "solver/actions/LibActions.hpp"
+#include "solver/Action.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+/// Samples fields of the geometry dictionary at equally spaced points on a segment every "saverate"
+/// iterations, for line plots. Each rank locates the points in its own cells and interpolates with the
+/// shape functions of the cell. The samples are combined on rank 0, which writes them as a tab separated table
+/// with the distance along the line, the coordinates and the field values. Points outside of the mesh are left out.
+class solver_actions_API ExtractProbeLine : public solver::Action {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  ExtractProbeLine ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ExtractProbeLine();
+
+  /// Get the class name
+  static std::string type_name () { return "ExtractProbeLine"; }
+
+  /// Sample and write the line if the iteration is a multiple of the save rate
+  virtual void execute ();
+
+  /// Sample the fields for the current solution, without writing them. Collective.
+  void update();
+
+  /// Column names of the samples
+  const std::vector<std::string>& columns() const { return m_columns; }
+
+  /// Samples of the last update, one row per point inside the mesh, with the columns given by columns()
+  const RealMatrix& samples() const { return m_samples; }
+
+private: // data
+
+  Handle<Component> m_iterator;  ///< component that holds the iteration
+
+  std::vector<std::string> m_columns; ///< column names
+
+  RealMatrix m_samples; ///< samples of the last update
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_ExtractProbeLine_hpp
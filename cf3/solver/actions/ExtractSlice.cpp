@@ -0,0 +1,78 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+#include "common/OptionArray.hpp"
+#include "common/OptionList.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+
+#include "ExtractSlice.hpp"
+
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < ExtractSlice, common::Action, LibActions > ExtractSlice_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractSlice::ExtractSlice ( const std::string& name ) : ExtractLevelSet(name)
+{
+  options().add("origin", std::vector<Real>())
+      .pretty_name("Origin")
+      .description("A point in the slice plane")
+      .mark_basic();
+
+  options().add("normal", std::vector<Real>())
+      .pretty_name("Normal")
+      .description("Normal vector of the slice plane")
+      .mark_basic();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ExtractSlice::~ExtractSlice()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExtractSlice::compute_level_set(std::vector<Real>& values)
+{
+  const std::vector<Real> origin = options().value< std::vector<Real> >("origin");
+  const std::vector<Real> normal = options().value< std::vector<Real> >("normal");
+  const Uint dim = mesh().dimension();
+  if(origin.size() != dim || normal.size() != dim)
+    throw SetupError(FromHere(), "Options origin and normal of " + uri().string() + " must have " + to_str(dim) + " components");
+
+  // Signed distance to the plane, scaled with the length of the normal
+  const Field& coordinates = mesh().geometry_fields().coordinates();
+  const Uint nb_nodes = coordinates.size();
+  values.resize(nb_nodes);
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Field::ConstRow x = coordinates[i];
+    Real distance = 0.;
+    for(Uint d = 0; d != dim; ++d)
+      distance += (x[d] - origin[d]) * normal[d];
+    values[i] = distance;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
@@ -0,0 +1,44 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_ExtractSlice_hpp
+#define cf3_solver_actions_ExtractSlice_hpp
+
+#include "solver/actions/ExtractLevelSet.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+/// Extracts the intersection of the mesh with a plane (a line in 2D), given by a point and a normal
+class solver_actions_API ExtractSlice : public ExtractLevelSet {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  ExtractSlice ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ExtractSlice();
+
+  /// Get the class name
+  static std::string type_name () { return "ExtractSlice"; }
+
+private: // functions
+
+  virtual void compute_level_set(std::vector<Real>& values);
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_ExtractSlice_hpp
@@ -0,0 +1,244 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <numeric>
+
+#include "common/OptionArray.hpp"
+#include "common/OptionT.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Foreach.hpp"
+#include "common/FindComponents.hpp"
+#include "common/List.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/WriteMesh.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshMetadata.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+
+#include "PeriodicExtract.hpp"
+
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Number of items on the ranks before this one
+  Uint global_offset(const Uint local_size)
+  {
+    if(!PE::Comm::instance().is_active())
+      return 0;
+
+    std::vector<Uint> sizes;
+    PE::Comm::instance().all_gather(local_size, sizes);
+    return std::accumulate(sizes.begin(), sizes.begin() + PE::Comm::instance().rank(), 0u);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+PeriodicExtract::PeriodicExtract ( const std::string& name ) : solver::Action(name),
+  m_writer( *create_static_component<WriteMesh>("MeshWriter") )
+{
+  mark_basic();
+
+  options().add("iterator", m_iterator)
+      .pretty_name("Iterator Component")
+      .description("The component that stores the \'iteration\'")
+      .link_to(&m_iterator);
+
+  options().add( "saverate", 0u )
+      .pretty_name("Save Rate")
+      .description("Interval of iterations between extracts");
+
+  options().add( "file", URI() )
+      .pretty_name("File")
+      .description("Path where to write the extract. The extension selects the mesh writer.");
+
+  options().add( "fields", std::vector<URI>() )
+      .pretty_name("Fields")
+      .description("Fields to interpolate onto the extract. They must belong to the geometry dictionary. "
+                   "Default is all fields of the geometry dictionary.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+PeriodicExtract::~PeriodicExtract()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void PeriodicExtract::execute()
+{
+  if( is_null(m_iterator) )
+    throw SetupError( FromHere(), "The option 'iterator' was not set in the component " + uri().string() );
+
+  const Uint iteration = boost::any_cast<Uint> ( m_iterator->properties().property("iteration") );
+
+  const Uint saverate = options().value<Uint>("saverate");
+
+  if (saverate == 0 || iteration % saverate != 0)
+    return;
+
+  update();
+
+  std::vector<URI> fields;
+  boost_foreach(const Field& field, find_components<Field>(m_extracted->geometry_fields()))
+  {
+    if(&field != &m_extracted->geometry_fields().coordinates())
+      fields.push_back(field.uri());
+  }
+
+  m_writer.write_mesh(*m_extracted, options().value<URI>("file"), fields);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void PeriodicExtract::update()
+{
+  const Dictionary& geometry = mesh().geometry_fields();
+
+  // Fields to transfer
+  std::vector< Handle<Field const> > fields;
+  boost_foreach(const URI& field_uri, options().value< std::vector<URI> >("fields"))
+  {
+    Handle<Field const> field(access_component_checked(field_uri));
+    if(is_null(field) || &field->dict() != &geometry)
+      throw SetupError(FromHere(), "Field " + field_uri.string() + " for " + uri().string() + " is not a field of the geometry dictionary");
+    fields.push_back(field);
+  }
+  if(options().value< std::vector<URI> >("fields").empty())
+  {
+    boost_foreach(const Field& field, find_components<Field>(geometry))
+    {
+      if(&field != &geometry.coordinates())
+        fields.push_back(field.handle<Field const>());
+    }
+  }
+
+  std::vector<NodeSource> nodes;
+  ConnectivityMapT connectivity;
+  extract(nodes, connectivity);
+
+  if(is_not_null(m_extracted))
+    remove_component(*m_extracted);
+  m_extracted = create_component<Mesh>("extract");
+  Mesh& extracted = *m_extracted;
+
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_nodes = nodes.size();
+
+  // Nodes, positioned with the same interpolation as the fields
+  extracted.initialize_nodes(nb_nodes, mesh().dimension());
+  Dictionary& extracted_nodes = extracted.geometry_fields();
+  const Uint node_offset = detail::global_offset(nb_nodes);
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    extracted_nodes.rank()[i] = rank;
+    extracted_nodes.glb_idx()[i] = node_offset + i;
+  }
+
+  std::vector< std::pair<const Field*, Field*> > transfers;
+  transfers.push_back(std::make_pair(&geometry.coordinates(), &extracted_nodes.coordinates()));
+  boost_foreach(const Handle<Field const>& field, fields)
+  {
+    transfers.push_back(std::make_pair(field.get(), &extracted_nodes.create_field(field->name(), field->descriptor().description())));
+  }
+
+  for(Uint t = 0; t != transfers.size(); ++t)
+  {
+    const Field& source = *transfers[t].first;
+    Field& target = *transfers[t].second;
+    const Uint row_size = source.row_size();
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      const NodeSource& node = nodes[i];
+      const Field::ConstRow first = source[node.first];
+      const Field::ConstRow second = source[node.second];
+      Field::Row row = target[i];
+      for(Uint j = 0; j != row_size; ++j)
+        row[j] = (1. - node.weight) * first[j] + node.weight * second[j];
+    }
+  }
+
+  // Elements
+  Region& region = extracted.topology().create_region("extract");
+  std::vector< Handle<Cells> > extracted_elements;
+  for(ConnectivityMapT::const_iterator it = connectivity.begin(); it != connectivity.end(); ++it)
+  {
+    const std::string& element_type = it->first;
+    Handle<Cells> cells = region.create_component<Cells>(element_type.substr(element_type.rfind('.') + 1));
+    cells->initialize(element_type, extracted_nodes);
+
+    Connectivity& cells_connectivity = cells->geometry_space().connectivity();
+    const Uint row_size = cells_connectivity.row_size();
+    const Uint nb_cells = it->second.size() / row_size;
+    cells->resize(nb_cells);
+    for(Uint i = 0; i != nb_cells; ++i)
+    {
+      Connectivity::Row row = cells_connectivity[i];
+      for(Uint j = 0; j != row_size; ++j)
+        row[j] = it->second[i*row_size + j];
+    }
+    extracted_elements.push_back(cells);
+  }
+
+  Uint nb_elements = 0;
+  boost_foreach(const Handle<Cells>& cells, extracted_elements)
+    nb_elements += cells->size();
+
+  Uint element_offset = detail::global_offset(nb_elements);
+  boost_foreach(const Handle<Cells>& cells, extracted_elements)
+  {
+    cells->rank().resize(cells->size());
+    cells->glb_idx().resize(cells->size());
+    for(Uint i = 0; i != cells->size(); ++i)
+    {
+      cells->rank()[i] = rank;
+      cells->glb_idx()[i] = element_offset++;
+    }
+  }
+
+  // File name patterns such as ${iter} refer to the solution
+  const MeshMetadata& metadata = mesh().metadata();
+  if(metadata.check("time"))
+    extracted.metadata()["time"] = metadata.properties().value<Real>("time");
+  if(metadata.check("iter"))
+    extracted.metadata()["iter"] = metadata.properties().value<Uint>("iter");
+
+  // No mesh_loaded event: the extract is not a mesh to solve on
+  extracted.update_structures();
+  extracted.update_statistics();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Handle<Mesh const> PeriodicExtract::extracted() const
+{
+  return m_extracted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
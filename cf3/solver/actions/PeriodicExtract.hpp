@@ -0,0 +1,86 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_PeriodicExtract_hpp
+#define cf3_solver_actions_PeriodicExtract_hpp
+
+#include <map>
+
+#include "solver/actions/LibActions.hpp"
+#include "solver/Action.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh   { class Field; class Mesh; class WriteMesh; }
+namespace solver {
+namespace actions {
+
+/// Base class for in-situ extracts: every "saverate" iterations a small mesh is built
+/// from the solution mesh on each rank, the selected fields are interpolated onto it and
+/// the result is written with the mesh writer matching the extension of "file".
+///
+/// Only fields of the geometry dictionary are transferred. The extracted mesh is rebuilt
+/// at every output step and kept as the child "extract", so it can also be inspected
+/// by other actions. Writing is collective, since the writers are.
+class solver_actions_API PeriodicExtract : public solver::Action {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  PeriodicExtract ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~PeriodicExtract();
+
+  /// Get the class name
+  static std::string type_name () { return "PeriodicExtract"; }
+
+  /// Build and write the extract if the iteration is a multiple of the save rate
+  virtual void execute ();
+
+  /// Build the extract for the current solution, without writing it
+  void update();
+
+  /// The mesh built by the last update, null before the first one
+  Handle<mesh::Mesh const> extracted() const;
+
+protected: // types
+
+  /// An extracted node lies on the segment between two nodes of the solution mesh
+  struct NodeSource
+  {
+    NodeSource(const Uint a, const Uint b, const Real w) : first(a), second(b), weight(w) {}
+    Uint first;
+    Uint second;
+    Real weight; ///< Relative position between first (0) and second (1)
+  };
+
+  /// Connectivity of the extracted elements per element type builder name, stored row by row
+  typedef std::map< std::string, std::vector<Uint> > ConnectivityMapT;
+
+private: // functions
+
+  /// Compute the nodes and elements of the extract on this rank
+  virtual void extract(std::vector<NodeSource>& nodes, ConnectivityMapT& connectivity) = 0;
+
+private: // data
+
+  Handle<Component> m_iterator;  ///< component that holds the iteration
+
+  mesh::WriteMesh& m_writer; ///< mesh writer
+
+  Handle<mesh::Mesh> m_extracted; ///< result of the last update
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_PeriodicExtract_hpp
@@ -4,15 +4,32 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <deque>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/condition_variable.hpp>
+
 #include "common/Builder.hpp"
 #include "common/OptionT.hpp"
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 #include "common/Foreach.hpp"
 #include "common/FindComponents.hpp"
+#include "common/Group.hpp"
+#include "common/Log.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "math/VariablesDescriptor.hpp"
 
 #include "mesh/WriteMesh.hpp"
+#include "mesh/MeshWriter.hpp"
+#include "mesh/MeshMetadata.hpp"
+#include "mesh/Region.hpp"
 #include "mesh/Mesh.hpp"
+#include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
 
 #include "PeriodicWriteMesh.hpp"
@@ -31,6 +48,165 @@ common::ComponentBuilder < PeriodicWriteMesh, common::Action, LibActions > Perio
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+/// Staging buffers and I/O thread for the asynchronous output
+class PeriodicWriteMesh::Implementation
+{
+public:
+  /// Copies of the fields and metadata of one snapshot, and everything else the I/O thread needs to write them.
+  /// All of it is looked up on the main thread, so the I/O thread never resolves a path in the component tree.
+  struct Buffer
+  {
+    Handle<Group> staging;
+    Handle<Mesh const> mesh;
+    Handle<MeshWriter> writer;
+    URI filepath;                                   ///< File to write, with the wildcards already replaced
+    PropertyList metadata;                          ///< Copy of the mesh metadata at the time of the snapshot
+    std::vector< Handle<Field const> > fields;      ///< Staged copies of the fields
+    std::vector< Handle<Region const> > regions;
+    bool busy;
+  };
+
+  Implementation() :
+    m_next_buffer(0),
+    m_warned(false),
+    m_comm(MPI_COMM_NULL),
+    m_stop(false)
+  {
+    m_buffers[0].busy = false;
+    m_buffers[1].busy = false;
+  }
+
+  ~Implementation()
+  {
+    stop();
+  }
+
+  /// Create the communicator of the I/O thread, so collective operations of the writers never match those
+  /// of the solver. Collective over all ranks, and called by all of them at their first asynchronous snapshot,
+  /// before they decide whether that snapshot is written in the background.
+  void setup_communicator()
+  {
+    if(m_comm == MPI_COMM_NULL && PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+      MPI_CHECK_RESULT(MPI_Comm_dup, (PE::Comm::instance().communicator(), &m_comm));
+  }
+
+  /// Pass a filled buffer to the I/O thread, starting it if needed
+  void submit(const Uint buffer_idx)
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if(m_thread.get_id() == boost::thread::id())
+      m_thread = boost::thread(&Implementation::run, this);
+    m_buffers[buffer_idx].busy = true;
+    m_queue.push_back(buffer_idx);
+    m_condition.notify_all();
+  }
+
+  /// Wait until the given buffer may be filled again
+  void wait_for(const Uint buffer_idx)
+  {
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    while(m_buffers[buffer_idx].busy)
+      m_condition.wait(lock);
+    rethrow_error();
+  }
+
+  /// Wait until both buffers are written
+  void wait_all()
+  {
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    while(m_buffers[0].busy || m_buffers[1].busy)
+      m_condition.wait(lock);
+    rethrow_error();
+  }
+
+  /// Finish all pending output and stop the I/O thread
+  void stop()
+  {
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_stop = true;
+      m_condition.notify_all();
+    }
+    if(m_thread.joinable())
+      m_thread.join();
+
+    if(m_comm != MPI_COMM_NULL)
+    {
+      int finalized;
+      MPI_Finalized(&finalized);
+      if(!finalized)
+        MPI_Comm_free(&m_comm);
+      m_comm = MPI_COMM_NULL;
+    }
+  }
+
+  Buffer m_buffers[2];
+  Uint m_next_buffer;
+  bool m_warned;
+
+private:
+  /// Body of the I/O thread: write the queued buffers in order
+  void run()
+  {
+    if(m_comm != MPI_COMM_NULL)
+      PE::Comm::instance().set_thread_communicator(m_comm);
+
+    while(true)
+    {
+      Uint buffer_idx;
+      {
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        while(m_queue.empty() && !m_stop)
+          m_condition.wait(lock);
+        if(m_queue.empty())
+          break;
+        buffer_idx = m_queue.front();
+      }
+
+      const Buffer& buffer = m_buffers[buffer_idx];
+      std::string error;
+      try
+      {
+        buffer.writer->write_snapshot(*buffer.mesh, buffer.filepath, buffer.fields, buffer.regions, buffer.metadata);
+      }
+      catch(std::exception& e)
+      {
+        error = "Background output of " + buffer.filepath.string() + " failed: " + e.what();
+      }
+
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      if(!error.empty() && m_error.empty())
+        m_error = error;
+      m_queue.pop_front();
+      m_buffers[buffer_idx].busy = false;
+      m_condition.notify_all();
+    }
+
+    if(m_comm != MPI_COMM_NULL)
+      PE::Comm::instance().set_thread_communicator(MPI_COMM_NULL);
+  }
+
+  /// Report an error of the I/O thread in the calling thread. Called with the mutex locked.
+  void rethrow_error()
+  {
+    if(m_error.empty())
+      return;
+    const std::string error = m_error;
+    m_error.clear();
+    throw FileSystemError(FromHere(), error);
+  }
+
+  PE::Communicator m_comm;
+  boost::thread m_thread;
+  boost::mutex m_mutex;
+  boost::condition_variable m_condition;
+  std::deque<Uint> m_queue;
+  bool m_stop;
+  std::string m_error;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 PeriodicWriteMesh::PeriodicWriteMesh ( const std::string& name ) : solver::Action(name),
   m_writer( *create_static_component<WriteMesh>("MeshWriter") )
 {
@@ -48,8 +224,37 @@ PeriodicWriteMesh::PeriodicWriteMesh ( const std::string& name ) : solver::Actio
   options().add( "filepath", URI() )
       .pretty_name("File Path")
       .description("Path where to save the mesh");
+
+  options().add( "asynchronous", false )
+      .pretty_name("Asynchronous")
+      .description("Write the mesh in a background thread, from a copy of the fields");
+
+  options().add( "staging_memory", 1024u )
+      .pretty_name("Staging Memory")
+      .description("Maximum memory in MiB for the two copies of the fields used by asynchronous output. "
+                   "Larger snapshots are written synchronously.");
+
+  m_implementation.reset(new Implementation());
+
+  // The staging groups exist from the start, so taking a snapshot only changes the children of an idle buffer
+  m_implementation->m_buffers[0].staging = create_static_component<Group>("staging_0");
+  m_implementation->m_buffers[1].staging = create_static_component<Group>("staging_1");
+
+  // Changing these options rebuilds the writers, which must not happen while one of them writes in the background
+  m_writer.options().option("mesh").attach_trigger( boost::bind( &PeriodicWriteMesh::flush, this ) );
+  m_writer.options().option("file").attach_trigger( boost::bind( &PeriodicWriteMesh::flush, this ) );
+  m_writer.options().option("fields").attach_trigger( boost::bind( &PeriodicWriteMesh::flush, this ) );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////
+
+PeriodicWriteMesh::~PeriodicWriteMesh()
+{
+  // Output that is still pending is completed by the I/O thread before it stops
+  m_implementation->stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
 
 void PeriodicWriteMesh::execute()
 {
@@ -74,6 +279,23 @@ void PeriodicWriteMesh::execute()
       state_fields.push_back(field.uri());
     }
 
+    if(options().value<bool>("asynchronous"))
+    {
+      if(asynchronous_supported())
+      {
+        if(write_asynchronous(filepath, state_fields))
+          return;
+      }
+      else if(!m_implementation->m_warned)
+      {
+        CFwarn << uri().string() << ": MPI does not provide MPI_THREAD_MULTIPLE, the mesh is written synchronously" << CFendl;
+        m_implementation->m_warned = true;
+      }
+
+      // Keep the files in order with the ones written in the background
+      flush();
+    }
+
     m_writer.write_mesh( mesh(), filepath, state_fields );
 
 
@@ -81,6 +303,88 @@ void PeriodicWriteMesh::execute()
 
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void PeriodicWriteMesh::flush()
+{
+  m_implementation->wait_all();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PeriodicWriteMesh::asynchronous_supported() const
+{
+  if(!PE::Comm::instance().is_active() || PE::Comm::instance().size() == 1)
+    return true;
+
+  int provided;
+  MPI_CHECK_RESULT(MPI_Query_thread, (&provided));
+  return provided == MPI_THREAD_MULTIPLE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PeriodicWriteMesh::write_asynchronous(const URI& filepath, const std::vector<URI>& fields)
+{
+  Implementation& impl = *m_implementation;
+  impl.setup_communicator();
+
+  std::vector< Handle<Field const> > source_fields;
+  Real nb_bytes = 0.;
+  boost_foreach(const URI& field_uri, fields)
+  {
+    source_fields.push_back(Handle<Field const>(access_component_checked(field_uri)));
+    nb_bytes += static_cast<Real>(source_fields.back()->size()) * source_fields.back()->row_size() * sizeof(Real);
+  }
+
+  // All ranks must agree, since the writers communicate on the communicator of the I/O thread
+  int fits = 2. * nb_bytes <= options().value<Uint>("staging_memory") * 1048576.;
+  if(PE::Comm::instance().is_active())
+    PE::Comm::instance().all_reduce(PE::logical_and(), &fits, 1, &fits);
+  if(!fits)
+    return false;
+
+  const Uint buffer_idx = impl.m_next_buffer;
+  Implementation::Buffer& buffer = impl.m_buffers[buffer_idx];
+
+  // Only waits if the snapshot before the previous one is still being written
+  impl.wait_for(buffer_idx);
+
+  // Resolve the file name and the writer now: the metadata may have moved on by the time the I/O thread writes
+  buffer.mesh = mesh().handle<Mesh const>();
+  buffer.metadata = mesh().metadata().properties();
+  buffer.filepath = m_writer.resolve_file_path(buffer.metadata, filepath);
+  buffer.writer = m_writer.writer_for(buffer.filepath);
+  buffer.regions = buffer.writer->selected_regions(mesh());
+
+  // Copy the field values, grouped per dictionary since field names are only unique within a dictionary
+  buffer.fields.clear();
+  boost_foreach(const Handle<Field const>& field, source_fields)
+  {
+    Handle<Component> dict_group = buffer.staging->get_child(field->dict().name());
+    if(is_null(dict_group))
+      dict_group = buffer.staging->create_component<Group>(field->dict().name());
+
+    Handle<Field> staged(dict_group->get_child(field->name()));
+    if(is_null(staged) || staged->descriptor().description() != field->descriptor().description())
+    {
+      if(is_not_null(staged))
+        dict_group->remove_component(*staged);
+      staged = dict_group->create_component<Field>(field->name());
+      staged->set_dict(field->dict());
+      staged->create_descriptor(field->descriptor().description(), mesh().dimension());
+    }
+    staged->resize(field->size());
+    std::copy(field->array().data(), field->array().data() + field->array().num_elements(), staged->array().data());
+
+    buffer.fields.push_back(staged->handle<Field const>());
+  }
+
+  impl.submit(buffer_idx);
+  impl.m_next_buffer = 1 - buffer_idx;
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 } // actions
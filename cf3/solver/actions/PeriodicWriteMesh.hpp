@@ -7,6 +7,8 @@
 #ifndef cf3_solver_actions_PeriodicWriteMesh_hpp
 #define cf3_solver_actions_PeriodicWriteMesh_hpp
 
+#include <boost/scoped_ptr.hpp>
+
 #include "solver/actions/LibActions.hpp"
 #include "solver/Action.hpp"
 
@@ -17,6 +19,15 @@ namespace mesh   { class Field; class Mesh; class WriteMesh; }
 namespace solver {
 namespace actions {
 
+/// Writes the mesh with all its fields every "saverate" iterations.
+///
+/// When the option "asynchronous" is set, the field values and the mesh metadata are copied into one of
+/// two staging buffers, the file name is resolved, and a background I/O thread formats and writes the file
+/// while the solver continues. The solver only waits when both buffers are still busy at the next snapshot,
+/// or when the component is destroyed. The mesh topology and coordinates are not copied, so they must not
+/// change while a snapshot is written in the background. In parallel, the I/O thread communicates on its own
+/// duplicate of the world communicator, and MPI must provide MPI_THREAD_MULTIPLE, otherwise the output is
+/// written synchronously.
 class solver_actions_API PeriodicWriteMesh : public solver::Action {
 
 public: // functions
@@ -24,8 +35,8 @@ public: // functions
   /// @param name of the component
   PeriodicWriteMesh ( const std::string& name );
 
-  /// Virtual destructor
-  virtual ~PeriodicWriteMesh() {}
+  /// Virtual destructor, waits for the background output to finish
+  virtual ~PeriodicWriteMesh();
 
   /// Get the class name
   static std::string type_name () { return "PeriodicWriteMesh"; }
@@ -33,12 +44,27 @@ public: // functions
   /// execute the action
   virtual void execute ();
 
+  /// Wait until all snapshots that are written in the background are complete
+  void flush();
+
+private: // functions
+
+  /// Copy the fields into a staging buffer and hand it to the I/O thread
+  /// @return false if the snapshot does not fit in the memory budget
+  bool write_asynchronous(const common::URI& filepath, const std::vector<common::URI>& fields);
+
+  /// True if the output may be written from a background thread
+  bool asynchronous_supported() const;
+
 private: // data
 
   Handle<Component> m_iterator;  ///< component that holds the iteration
 
   mesh::WriteMesh& m_writer; ///< mesh writer
 
+  class Implementation;
+  boost::scoped_ptr<Implementation> m_implementation;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
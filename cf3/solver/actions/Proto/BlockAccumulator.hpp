@@ -15,6 +15,8 @@
 
 #include "math/MatrixTypes.hpp"
 
+#include "mesh/Elements.hpp"
+
 #include "math/LSS/System.hpp"
 #include "math/LSS/BlockAccumulator.hpp"
 #include "math/LSS/Matrix.hpp"
@@ -65,15 +67,15 @@ struct MatrixAssignOpsCases
 };
 
 /// Translate tag to operator
-inline void do_assign_op_matrix(boost::proto::tag::assign, math::LSS::Matrix& lss_matrix, const math::LSS::BlockAccumulator& block_accumulator)
+inline void do_assign_op_matrix(boost::proto::tag::assign, math::LSS::Matrix& lss_matrix, const math::LSS::BlockAccumulator& block_accumulator, const mesh::Elements&, const Uint)
 {
   lss_matrix.set_values(block_accumulator);
 }
 
-/// Translate tag to operator
-inline void do_assign_op_matrix(boost::proto::tag::plus_assign, math::LSS::Matrix& lss_matrix, const math::LSS::BlockAccumulator& block_accumulator)
+/// Translate tag to operator. Adding goes through the per-element scatter maps of the matrix, if it has them
+inline void do_assign_op_matrix(boost::proto::tag::plus_assign, math::LSS::Matrix& lss_matrix, const math::LSS::BlockAccumulator& block_accumulator, const mesh::Elements& elements, const Uint element_idx)
 {
-  lss_matrix.add_values(block_accumulator);
+  lss_matrix.add_element_values(block_accumulator, elements, element_idx);
 }
 
 /// Translate tag to operator
@@ -125,7 +127,7 @@ struct BlockAssignmentOp<SystemMatrixTag, OpTagT>
         block_accumulator.mat(block_row, block_col) = rhs(row, col);
       }
     }
-    do_assign_op_matrix(OpTagT(), lss.matrix(), block_accumulator);
+    do_assign_op_matrix(OpTagT(), lss.matrix(), block_accumulator, data.elements(), data.element_idx());
   }
 };
 
@@ -934,6 +934,18 @@ public:
     return m_support;
   }
 
+  /// The elements that are looped over
+  const mesh::Elements& elements() const
+  {
+    return m_elements;
+  }
+
+  /// Index of the current element
+  Uint element_idx() const
+  {
+    return m_element_idx;
+  }
+
   /// Retrieve the element matrix at index i
   ElementMatrixT& element_matrix(const int i)
   {
@@ -12,6 +12,7 @@
 #include "BlockAccumulator.hpp"
 #include "ElementIntegration.hpp"
 #include "ElementMatrix.hpp"
+#include "ElementMatrixCache.hpp"
 #include "ElementTransforms.hpp"
 #include "GaussPoints.hpp"
 #include "IndexLooping.hpp"
@@ -73,11 +74,15 @@ struct StreamOutputIndexed : StreamOutput< ElementMathIndexed<I, J> >
 {
 };
 
+struct ElementGrammar;
+
 struct SingleExprElementGrammar :
   boost::proto::or_
   <
     // Assignment to system matrix
     BlockAccumulation<ElementMath>,
+    // Element matrices computed only once
+    CacheElementMatrixGrammar<ElementGrammar>,
     boost::proto::when
     <
       ElementMath,
@@ -0,0 +1,198 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_Proto_ElementMatrixCache_hpp
+#define cf3_solver_actions_Proto_ElementMatrixCache_hpp
+
+#include <map>
+#include <vector>
+
+#include <boost/mpl/range_c.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/proto/core.hpp>
+#include <boost/proto/context/callable.hpp>
+#include <boost/proto/context/null.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "common/Handle.hpp"
+
+#include "mesh/Elements.hpp"
+
+#include "ElementMatrix.hpp"
+
+/// @file
+/// Storage of element matrices that do not change between executions of an expression
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+namespace Proto {
+
+/// Stores a copy of an element matrix for each element, so time-invariant element matrices
+/// (mass matrices, constant-coefficient diffusion, ...) are only integrated once.
+/// Copies of an ElementMatrixCache share the same storage, so it can be stored by value in an expression.
+/// The stored matrices are discarded automatically when the number of elements changes or the elements
+/// are deleted. Expressions set on a ProtoAction also invalidate their caches when the value of
+/// a ConfigurableConstant or PhysicsConstant changes. Call invalidate() after moving the mesh nodes.
+class ElementMatrixCache
+{
+public:
+  ElementMatrixCache() : m_storage(new StorageT())
+  {
+  }
+
+  /// Discard all stored element matrices
+  void invalidate() const
+  {
+    m_storage->clear();
+  }
+
+  /// Get the storage for the matrix of the given element
+  /// @param elements The elements that are looped over
+  /// @param element_idx Index of the element
+  /// @param matrix_size Number of coefficients in the element matrix
+  /// @param is_stored Set to true if the returned storage contains a previously stored matrix
+  /// @return Pointer to the first of matrix_size coefficients for the element
+  Real* element_storage(const mesh::Elements& elements, const Uint element_idx, const Uint matrix_size, bool& is_stored) const
+  {
+    Entry& entry = (*m_storage)[&elements];
+    const Uint nb_elements = elements.size();
+    if(entry.elements.get() != &elements || entry.matrix_size != matrix_size || entry.is_stored.size() != nb_elements)
+    {
+      entry.elements = elements.handle<mesh::Elements const>();
+      entry.matrix_size = matrix_size;
+      entry.is_stored.assign(nb_elements, false);
+      entry.values.resize(nb_elements * matrix_size);
+    }
+
+    cf3_assert(element_idx < nb_elements);
+    is_stored = entry.is_stored[element_idx];
+    entry.is_stored[element_idx] = true;
+    return &entry.values[element_idx * matrix_size];
+  }
+
+private:
+  /// Stored matrices for one Elements component
+  struct Entry
+  {
+    Entry() : matrix_size(0) {}
+
+    /// Elements the matrices belong to, becomes null if the elements are deleted
+    Handle<mesh::Elements const> elements;
+    /// Size of each matrix
+    Uint matrix_size;
+    /// True if the matrix for an element was stored
+    std::vector<bool> is_stored;
+    /// The matrix coefficients, one matrix after the other
+    std::vector<Real> values;
+  };
+
+  typedef std::map<const mesh::Elements*, Entry> StorageT;
+  boost::shared_ptr<StorageT> m_storage;
+};
+
+/// Primitive transform that evaluates the expressions that compute an element matrix only once for each element,
+/// and restores the stored element matrix on further evaluations
+template<typename GrammarT>
+struct CacheElementMatrix :
+  boost::proto::transform< CacheElementMatrix<GrammarT> >
+{
+  template<typename ExprT, typename StateT, typename DataT>
+  struct impl : boost::proto::transform_impl<ExprT, StateT, DataT>
+  {
+    typedef void result_type;
+
+    struct evaluate_expr
+    {
+      evaluate_expr(typename impl::expr_param expr, typename impl::state_param state, typename impl::data_param data) :
+        m_expr(expr),
+        m_state(state),
+        m_data(data)
+      {
+      }
+
+      template<typename I>
+      void operator()(const I&) const
+      {
+        GrammarT()(boost::proto::child_c<I::value>(m_expr), m_state, m_data);
+      }
+
+      typename impl::expr_param m_expr;
+      typename impl::state_param m_state;
+      typename impl::data_param m_data;
+    };
+
+    typedef typename boost::remove_reference<DataT>::type::ElementMatrixT ElementMatrixT;
+
+    void operator()(typename impl::expr_param expr, typename impl::state_param state, typename impl::data_param data) const
+    {
+      const ElementMatrixCache& cache = boost::proto::value(boost::proto::child_c<1>(expr));
+      ElementMatrixT& matrix = data.element_matrix(boost::proto::value(boost::proto::child_c<2>(expr)));
+
+      bool is_stored = false;
+      Real* stored_matrix = cache.element_storage(data.support().m_elements, data.support().m_element_idx, matrix.size(), is_stored);
+      Eigen::Map<ElementMatrixT> stored_map(stored_matrix);
+      if(is_stored)
+      {
+        matrix = stored_map;
+        return;
+      }
+
+      boost::mpl::for_each< boost::mpl::range_c<int, 3, boost::proto::arity_of<ExprT>::value> >
+      (
+        evaluate_expr(expr, state, data)
+      );
+
+      stored_map = matrix;
+    }
+  };
+};
+
+/// Tags a terminal that triggers element matrix caching
+struct CacheElementMatrixTag {};
+
+/// Use cache_element_matrix(cache, _A, expr1, expr2, ..., exprN) to evaluate expr1 to exprN only on the first
+/// execution for each element, storing the resulting element matrix _A in the ElementMatrixCache cache.
+/// On later executions, _A is set to the stored value instead. The expressions must compute all of _A,
+/// and may depend only on the geometry and on constants, e.g.:
+/// cache_element_matrix(mass_cache, _T, _T = _0, element_quadrature(_T(u) += transpose(N(u))*N(u)))
+static boost::proto::terminal< CacheElementMatrixTag >::type cache_element_matrix = {};
+
+/// Matches and evaluates cached element matrix computations, where the sub-expressions match GrammarT
+template<typename GrammarT>
+struct CacheElementMatrixGrammar :
+  boost::proto::when
+  <
+    boost::proto::function
+    <
+      boost::proto::terminal<CacheElementMatrixTag>,
+      boost::proto::terminal<ElementMatrixCache>,
+      ElementMatrixTerm,
+      boost::proto::vararg<boost::proto::_>
+    >,
+    CacheElementMatrix<GrammarT>
+  >
+{
+};
+
+/// Context to invalidate all element matrix caches in an expression
+struct InvalidateElementMatrixCaches
+  : boost::proto::callable_context< InvalidateElementMatrixCaches, boost::proto::null_context >
+{
+  typedef void result_type;
+
+  void operator()(boost::proto::tag::terminal, const ElementMatrixCache& cache)
+  {
+    cache.invalidate();
+  }
+};
+
+} // namespace Proto
+} // namespace actions
+} // namespace solver
+} // namespace cf3
+
+#endif // cf3_solver_actions_Proto_ElementMatrixCache_hpp
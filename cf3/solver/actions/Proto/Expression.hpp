@@ -32,6 +32,7 @@
 #include "ConfigurableConstant.hpp"
 #include "ElementLooper.hpp"
 #include "ElementMatrix.hpp"
+#include "ElementMatrixCache.hpp"
 #include "NodeLooper.hpp"
 #include "NodeGrammar.hpp"
 #include "PhysicsConstant.hpp"
@@ -144,11 +145,33 @@ public:
     boost::fusion::for_each(m_variables, AppendTags(tags));
   }
 
+protected:
+  /// Discard the element matrices stored using cache_element_matrix if the value of a constant changed since the last call
+  void check_element_matrix_caches()
+  {
+    std::vector<Real> constant_values;
+    for(ConstantStorage::ScalarsT::const_iterator it = m_constant_values.m_scalars.begin(); it != m_constant_values.m_scalars.end(); ++it)
+      constant_values.push_back(it->second);
+    for(ConstantStorage::VectorsT::const_iterator it = m_constant_values.m_vectors.begin(); it != m_constant_values.m_vectors.end(); ++it)
+      constant_values.insert(constant_values.end(), it->second.data(), it->second.data() + it->second.size());
+    for(PhysicsConstantStorage::ScalarsT::const_iterator it = m_physics_values.m_scalars.begin(); it != m_physics_values.m_scalars.end(); ++it)
+      constant_values.push_back(it->second);
+
+    if(constant_values != m_cached_constant_values)
+    {
+      InvalidateElementMatrixCaches ctx;
+      boost::proto::eval(m_expr, ctx);
+      m_cached_constant_values.swap(constant_values);
+    }
+  }
+
 private:
   /// Values for configurable constants
   ConstantStorage m_constant_values;
   /// Values for physics constants
   PhysicsConstantStorage m_physics_values;
+  /// Values of all constants when the element matrix caches were last checked
+  std::vector<Real> m_cached_constant_values;
 protected:
 
   /// Store a copy of the expression
@@ -252,6 +275,8 @@ public:
 
   void loop(mesh::Region& region)
   {
+    BaseT::check_element_matrix_caches();
+
     // Traverse all Elements under the region and evaluate the expression
     BOOST_FOREACH(mesh::Elements& elements, common::find_components_recursively<mesh::Elements>(region) )
     {
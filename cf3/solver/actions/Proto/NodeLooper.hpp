@@ -7,7 +7,7 @@
 #ifndef cf3_solver_actions_Proto_NodeLooper_hpp
 #define cf3_solver_actions_Proto_NodeLooper_hpp
 
-#include "mesh/Functions.hpp"
+#include "mesh/Dictionary.hpp"
 
 #include "FieldSync.hpp"
 #include "NodeData.hpp"
@@ -140,14 +140,8 @@ private:
   {
     NodeGrammar grammar;
 
-    // Build a list of used entities
-    std::vector< Handle<mesh::Entities const> > used_entities;
-    BOOST_FOREACH(const mesh::Entities& entities, common::find_components_recursively<mesh::Entities>(m_region))
-    {
-      used_entities.push_back(entities.handle<mesh::Entities>());
-    }
-
-    boost::shared_ptr< common::List<Uint> > used_nodes_ptr = mesh::build_used_nodes_list(used_entities, dict, true);
+    // The used nodes are cached by the dictionary, so repeated loops over the same region (e.g. boundary conditions) don't rebuild them
+    const boost::shared_ptr< common::List<Uint> const > used_nodes_ptr = dict.used_nodes(m_region);
 
     const common::List<Uint>& nodes = *used_nodes_ptr;
     const Uint nb_nodes = nodes.size();
@@ -33,6 +33,8 @@ namespace solver {
 namespace actions {
 namespace Proto {
 
+class ElementMatrixCache;
+
 /// Helper to get the data type for the given variable
 template<typename VarT, typename DataT>
 struct VarDataType
@@ -294,6 +296,7 @@ struct DeepCopy : //boost::proto::functional::deep_copy
         boost::proto::terminal<const Real&>,
         boost::proto::terminal<const Uint&>,
         boost::proto::terminal<const int&>,
+        boost::proto::terminal<ElementMatrixCache>,
         FieldTypes
       >,
       boost::proto::_make_terminal(boost::proto::_byval(boost::proto::_value))
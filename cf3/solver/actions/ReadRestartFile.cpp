@@ -0,0 +1,129 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionComponent.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/LoadMesh.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshMetadata.hpp"
+
+#include "solver/History.hpp"
+#include "solver/Tags.hpp"
+#include "solver/Time.hpp"
+
+#include "ReadRestartFile.hpp"
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < ReadRestartFile, common::Action, LibActions > ReadRestartFile_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+ReadRestartFile::ReadRestartFile ( const std::string& name ) : solver::Action(name),
+  m_loader( *create_static_component<LoadMesh>("MeshLoader") )
+{
+  mark_basic();
+
+  options().add( "file", URI("restart.cf3chk") )
+      .pretty_name("File")
+      .description("Checkpoint file to read, as written by WriteRestartFile")
+      .mark_basic();
+
+  options().add(solver::Tags::time(), m_time)
+      .pretty_name("Time")
+      .description("Time component to restore from the checkpoint")
+      .link_to(&m_time);
+
+  options().add("history", m_history)
+      .pretty_name("History")
+      .description("History component to restore from the checkpoint")
+      .link_to(&m_history);
+}
+
+void ReadRestartFile::execute()
+{
+  m_loader.load_mesh_into(options().value<URI>("file"), mesh());
+
+  const MeshMetadata& metadata = mesh().metadata();
+
+  if(is_not_null(m_time) && metadata.check("time_step"))
+  {
+    m_time->options().set("time_step", boost::any_cast<Real>(metadata["time_step"]));
+    m_time->options().set("iteration", boost::any_cast<Uint>(metadata["iter"]));
+    m_time->options().set("current_time", boost::any_cast<Real>(metadata["time"]));
+  }
+
+  if(is_not_null(m_history))
+    restore_history();
+}
+
+void ReadRestartFile::restore_history()
+{
+  const MeshMetadata& metadata = mesh().metadata();
+
+  // Only the block of rank 0 has the history
+  Uint dimension = 0;
+  std::vector<std::string> variables;
+  std::vector<Real> data;
+  if(metadata.check("history_variables"))
+  {
+    dimension = boost::any_cast<Uint>(metadata["history_dimension"]);
+    variables = boost::any_cast< std::vector<std::string> >(metadata["history_variables"]);
+    data = boost::any_cast< std::vector<Real> >(metadata["history_data"]);
+  }
+
+  PE::Comm& comm = PE::Comm::instance();
+  if(comm.is_active() && comm.size() > 1)
+  {
+    // The variable names are sent as one string, each name followed by a null character
+    std::string names;
+    boost_foreach(const std::string& variable, variables)
+    {
+      names += variable;
+      names.push_back('\0');
+    }
+
+    Uint sizes[3] = { dimension, names.size(), data.size() };
+    comm.broadcast(sizes, 3, sizes, 0);
+    dimension = sizes[0];
+    names.resize(sizes[1]);
+    data.resize(sizes[2]);
+    if(!names.empty())
+      comm.broadcast(&names[0], names.size(), &names[0], 0);
+    if(!data.empty())
+      comm.broadcast(&data[0], data.size(), &data[0], 0);
+
+    variables.clear();
+    for(std::size_t begin = 0; begin != names.size(); )
+    {
+      const std::size_t end = names.find('\0', begin);
+      variables.push_back(names.substr(begin, end - begin));
+      begin = end + 1;
+    }
+  }
+
+  if(!variables.empty())
+    m_history->restore(dimension, variables, data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
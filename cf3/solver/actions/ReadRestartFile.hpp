@@ -0,0 +1,62 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_ReadRestartFile_hpp
+#define cf3_solver_actions_ReadRestartFile_hpp
+
+#include "solver/actions/LibActions.hpp"
+#include "solver/Action.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh   { class LoadMesh; }
+namespace solver {
+  class Time;
+  class History;
+namespace actions {
+
+/// Read a checkpoint written by WriteRestartFile into the (empty) configured mesh, and restore
+/// the time and history if they are configured. The history is read by rank 0 and sent to the other ranks.
+/// The checkpoint must be read by the same number of ranks that wrote it. The mesh comes back
+/// partitioned, numbered and with its faces built, so these steps must be skipped after restarting.
+class solver_actions_API ReadRestartFile : public solver::Action {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  ReadRestartFile ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ReadRestartFile() {}
+
+  /// Get the class name
+  static std::string type_name () { return "ReadRestartFile"; }
+
+  /// execute the action
+  virtual void execute ();
+
+private: // functions
+
+  /// Restore the history from the checkpoint. Collective when running in parallel.
+  void restore_history();
+
+private: // data
+
+  Handle<Time> m_time;       ///< time to restore, optional
+  Handle<History> m_history; ///< history to restore, optional
+
+  mesh::LoadMesh& m_loader;  ///< mesh loader
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_ReadRestartFile_hpp
@@ -0,0 +1,87 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+#include "common/OptionComponent.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Table.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/WriteMesh.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshMetadata.hpp"
+
+#include "solver/History.hpp"
+#include "solver/Tags.hpp"
+#include "solver/Time.hpp"
+
+#include "WriteRestartFile.hpp"
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < WriteRestartFile, common::Action, LibActions > WriteRestartFile_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+WriteRestartFile::WriteRestartFile ( const std::string& name ) : solver::Action(name),
+  m_writer( *create_static_component<WriteMesh>("MeshWriter") )
+{
+  mark_basic();
+
+  options().add( "file", URI("restart.cf3chk") )
+      .pretty_name("File")
+      .description("Checkpoint file to write, should have the .cf3chk extension")
+      .mark_basic();
+
+  options().add(solver::Tags::time(), m_time)
+      .pretty_name("Time")
+      .description("Time component to store in the checkpoint")
+      .link_to(&m_time);
+
+  options().add("history", m_history)
+      .pretty_name("History")
+      .description("History component to store in the checkpoint")
+      .link_to(&m_history);
+}
+
+void WriteRestartFile::execute()
+{
+  MeshMetadata& metadata = mesh().metadata();
+
+  if(is_not_null(m_time))
+  {
+    metadata["time"] = m_time->current_time();
+    metadata["iter"] = m_time->iter();
+    metadata["time_step"] = m_time->dt();
+  }
+
+  // the history is the same on all ranks, only rank 0 stores it
+  if(is_not_null(m_history) && PE::Comm::instance().rank() == 0)
+  {
+    const Table<Real>& table = *m_history->table();
+    std::vector<Real> data(table.array().data(), table.array().data() + table.size()*table.row_size());
+    metadata["history_dimension"] = m_history->options().value<Uint>("dimension");
+    metadata["history_variables"] = m_history->variable_names();
+    metadata["history_data"] = data;
+  }
+
+  m_writer.write_mesh(mesh(), options().value<URI>("file"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
@@ -0,0 +1,57 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_WriteRestartFile_hpp
+#define cf3_solver_actions_WriteRestartFile_hpp
+
+#include "solver/actions/LibActions.hpp"
+#include "solver/Action.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh   { class WriteMesh; }
+namespace solver {
+  class Time;
+  class History;
+namespace actions {
+
+/// Write a checkpoint of the mesh, all its fields and the solver state, to restart from using ReadRestartFile.
+/// The time and history are stored in the mesh metadata, and the mesh is written using the
+/// cf3.mesh.checkpoint format, with one block per rank in a single file. The history is the same
+/// on all ranks, so it is only stored in the block of rank 0.
+class solver_actions_API WriteRestartFile : public solver::Action {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  WriteRestartFile ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~WriteRestartFile() {}
+
+  /// Get the class name
+  static std::string type_name () { return "WriteRestartFile"; }
+
+  /// execute the action
+  virtual void execute ();
+
+private: // data
+
+  Handle<Time> m_time;       ///< time to store, optional
+  Handle<History> m_history; ///< history to store, optional
+
+  mesh::WriteMesh& m_writer; ///< mesh writer
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // solver
+} // cf3
+
+#endif // cf3_solver_actions_WriteRestartFile_hpp
@@ -86,7 +86,8 @@ CNode::CNode( const std::string & name, const QString & component_type, Type typ
     m_component_type( component_type ),
     m_type( type ),
     m_listing_content( false ),
-    m_is_root( false )
+    m_is_root( false ),
+    m_children_pending( false )
 {
   m_content_listed = is_local_component();
   m_mutex = new QMutex();
@@ -637,6 +638,8 @@ boost::shared_ptr< CNode > CNode::create_from_xml_recursive( XmlNode & node,
   if(mode_attr != nullptr && std::strcmp(mode_attr->value(), "basic") == 0)
     root_node->mark_basic();
 
+  root_node->set_children_pending( node.content->first_attribute("expandable") != nullptr );
+
   if( !uuid.is_nil() )
     root_node->properties().set( "uuid", uuid );
   else
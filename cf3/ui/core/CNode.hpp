@@ -194,6 +194,27 @@ namespace core {
       return m_is_root;
     }
 
+    /// Indicates whether the children of this node still have to be listed.
+    /// This is the case for nodes at the maximum depth of a tree listing.
+    /// @return Returns @c true if the server has children that were not listed.
+    bool children_pending() const
+    {
+      return m_children_pending;
+    }
+
+    /// Sets whether the children of this node still have to be listed.
+    void set_children_pending( bool pending )
+    {
+      m_children_pending = pending;
+    }
+
+    /// Marks the options and properties of this node as outdated, so that
+    /// they are listed again the next time they are accessed.
+    void invalidate_content()
+    {
+      m_content_listed = is_local_component();
+    }
+
     /// Sets node properties
     /// @param node Node containing the options
     void set_properties( const common::SignalArgs & node );
@@ -375,6 +396,9 @@ namespace core {
     /// If @c true, this component is a NRoot object.
     bool m_is_root;
 
+    /// @c true if the children of this node were not listed yet.
+    bool m_children_pending;
+
   private: // data
 
     /// Component type name.
@@ -10,6 +10,9 @@
 
 #include "common/Signal.hpp"
 #include "common/FindComponents.hpp"
+#include "common/TreeJournal.hpp"
+
+#include "common/XML/SignalOptions.hpp"
 
 #include "ui/core/TreeThread.hpp"
 #include "ui/core/NetworkQueue.hpp"
@@ -36,7 +39,9 @@ namespace core {
 NTree::NTree(Handle< NRoot > rootNode)
   : CNode(CLIENT_TREE, "NTree", CNode::DEBUG_NODE),
     m_advanced_mode(false),
-    m_debug_mode_enabled(false)
+    m_debug_mode_enabled(false),
+    m_tree_version(0),
+    m_listing_depth(0)
 {
 
   m_root_node = new TreeNode(rootNode, nullptr, 0);
@@ -596,10 +601,10 @@ void NTree::list_tree_reply(SignalArgs & args)
 
   try
   {
-    Handle< NRoot > tree_root = m_root_node->node()->castTo<NRoot>();
-    boost::shared_ptr< CNode > root_node = CNode::create_from_xml(args.main_map.content.content->first_node());
-    ComponentIterator<CNode> it = component_begin<CNode>(*root_node->root());
-    ComponentIterator<CNode> root_end = component_end<CNode>(*root_node->root());
+    XmlNode changes_node( args.main_map.content.content->first_node("changes") );
+    XmlNode tree_node( args.main_map.content.content->first_node("node") );
+    Handle< CNode > target = node_by_path( URI(args.node.attribute_value("sender")) );
+    const bool is_subtree = is_not_null(target) && target.get() != m_root_node->node().get();
     URI currentIndexPath;
 
     if(m_current_index.isValid())
@@ -607,45 +612,34 @@ void NTree::list_tree_reply(SignalArgs & args)
       currentIndexPath = index_to_tree_node(m_current_index)->node()->uri();
     }
 
-    //
-    // rename the root
-    //
-    tree_root->rename(root_node->name());
-    tree_root->rename(root_node->name());
-
-    //
-    // remove old nodes
-    //
-    ComponentIterator<CNode> itRem = component_begin<CNode>(*tree_root);
-    ComponentIterator<CNode> tree_root_end = component_end<CNode>(*tree_root);
-
-    QList<std::string> list_to_remove;
-    QList<std::string>::iterator itList;
-
-    for( ; itRem != tree_root_end ; itRem++)
+    if( changes_node.is_valid() )
     {
-      if(!itRem->is_local_component() && !itRem->is_root() )
-        list_to_remove << itRem->name();
+      // only what changed since the last update
+      apply_tree_changes(changes_node);
     }
-
-    itList = list_to_remove.begin();
-
-    for( ; itList != list_to_remove.end() ; itList++)
+    else if( is_subtree )
     {
-      tree_root->access_component_checked(*itList)->handle<CNode>()->about_to_be_removed();
-      tree_root->remove_component(*itList);
+      // a subtree that was not listed yet
+      if( tree_node.is_valid() )
+        replace_children(target, tree_node);
     }
+    else if( tree_node.is_valid() )
+    {
+      Handle< NRoot > tree_root = m_root_node->node()->castTo<NRoot>();
 
-    //
-    // add the new nodes
-    //
+      //
+      // rename the root
+      //
+      tree_root->rename(tree_node.attribute_value("name"));
+
+      //
+      // replace the nodes
+      //
+      replace_children(tree_root, tree_node);
+    }
 
-    std::vector<std::string> names_to_add;
-    names_to_add.reserve(root_node->count_children());
-    for( ; it != root_end ; it++)
-      names_to_add.push_back(it.get()->name());
-    BOOST_FOREACH(const std::string& name, names_to_add)
-      tree_root->add_component( root_node->remove_component(name) );
+    if( args.main_map.check_entry("version") && !is_subtree )
+      m_tree_version = args.main_map.get_value<Uint>("version");
 
     // child count may have changed, ask the root TreeNode to update its internal data
     m_root_node->update_child_list();
@@ -661,6 +655,10 @@ void NTree::list_tree_reply(SignalArgs & args)
   {
     NLog::global()->add_exception(xe.what());
   }
+  catch(Exception & e)
+  {
+    NLog::global()->add_exception(e.what());
+  }
 
   // tell the view to update the whole thing
   endResetModel();
@@ -673,6 +671,123 @@ void NTree::list_tree_reply(SignalArgs & args)
 
 ////////////////////////////////////////////////////////////////////////////
 
+void NTree::replace_children(Handle< CNode > parent, const XmlNode & tree_node)
+{
+  boost::shared_ptr< CNode > root_node = CNode::create_from_xml(tree_node);
+  ComponentIterator<CNode> it = component_begin<CNode>(*root_node->root());
+  ComponentIterator<CNode> root_end = component_end<CNode>(*root_node->root());
+
+  //
+  // remove old nodes
+  //
+  ComponentIterator<CNode> itRem = component_begin<CNode>(*parent);
+  ComponentIterator<CNode> parent_end = component_end<CNode>(*parent);
+
+  QList<std::string> list_to_remove;
+  QList<std::string>::iterator itList;
+
+  for( ; itRem != parent_end ; itRem++)
+  {
+    if(!itRem->is_local_component() && !itRem->is_root() )
+      list_to_remove << itRem->name();
+  }
+
+  itList = list_to_remove.begin();
+
+  for( ; itList != list_to_remove.end() ; itList++)
+  {
+    parent->access_component_checked(*itList)->handle<CNode>()->about_to_be_removed();
+    parent->remove_component(*itList);
+  }
+
+  //
+  // add the new nodes
+  //
+
+  std::vector<std::string> names_to_add;
+  names_to_add.reserve(root_node->count_children());
+  for( ; it != root_end ; it++)
+    names_to_add.push_back(it.get()->name());
+  BOOST_FOREACH(const std::string& name, names_to_add)
+    parent->add_component( root_node->remove_component(name) );
+
+  parent->set_children_pending( root_node->children_pending() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void NTree::apply_tree_changes(const XmlNode & changes_node)
+{
+  rapidxml::xml_node<>* change = changes_node.content->first_node("change");
+
+  for( ; is_not_null(change) ; change = change->next_sibling("change") )
+  {
+    XmlNode change_node(change);
+    XmlNode tree_node( change->first_node("node") );
+    const TreeJournal::ChangeType type = TreeJournal::type_from_str( change_node.attribute_value("type") );
+    const URI path( change_node.attribute_value("path") );
+    const std::string name = path.name();
+    Handle< CNode > node = node_by_path(path);
+    Handle< CNode > parent = node_by_path(path.base_path());
+
+    switch(type)
+    {
+      case TreeJournal::ADDED:
+        // nodes below a subtree that was not listed are listed with it
+        if( is_null(parent) || parent->children_pending() || !tree_node.is_valid() )
+          break;
+
+        if( is_not_null(node) )
+        {
+          node->about_to_be_removed();
+          parent->remove_component(name);
+        }
+
+        {
+          boost::shared_ptr< CNode > added = CNode::create_from_xml(tree_node);
+          if( is_not_null(added) )
+          {
+            // the server gives its current name, the path follows the later changes
+            added->rename(name);
+            parent->add_node(added);
+            added->setup_finished();
+          }
+        }
+        break;
+
+      case TreeJournal::REMOVED:
+        if( is_not_null(node) && is_not_null(parent) && !node->is_local_component() )
+        {
+          node->about_to_be_removed();
+          parent->remove_component(name);
+        }
+        break;
+
+      case TreeJournal::RENAMED:
+        if( is_not_null(node) )
+          node->rename( change_node.attribute_value("name") );
+        break;
+
+      case TreeJournal::MODIFIED:
+        if( is_not_null(node) )
+        {
+          if( tree_node.is_valid() )
+          {
+            if( tree_node.attribute_value("mode") == "basic" )
+              node->mark_basic();
+            else
+              node->remove_tag("basic");
+          }
+
+          node->invalidate_content();
+        }
+        break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void NTree::clear_tree()
 {
   beginResetModel();
@@ -703,6 +818,9 @@ void NTree::clear_tree()
     emit endRemoveRows();
   }
 
+  // the next update lists the complete tree
+  m_tree_version = 0;
+
   endResetModel();
 }
 
@@ -741,10 +859,55 @@ void NTree::content_listed(Handle< Component > node)
 
 void NTree::update_tree()
 {
-  SignalFrame frame("list_tree", CLIENT_TREE_PATH, SERVER_ROOT_PATH);
+  SignalOptions options;
+
+  options.add("version", m_tree_version);
+  options.add("depth", m_listing_depth);
+
+  SignalFrame frame = options.create_frame("list_tree", CLIENT_TREE_PATH, SERVER_ROOT_PATH);
   NetworkQueue::global()->send( frame );
 }
 
+////////////////////////////////////////////////////////////////////////////
+
+void NTree::set_listing_depth(Uint depth)
+{
+  m_listing_depth = depth;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool NTree::canFetchMore(const QModelIndex & parent) const
+{
+  if(!parent.isValid())
+    return false;
+
+  Handle< CNode > node = index_to_node(parent);
+  return is_not_null(node) && node->children_pending();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void NTree::fetchMore(const QModelIndex & parent)
+{
+  if(!parent.isValid())
+    return;
+
+  Handle< CNode > node = index_to_node(parent);
+
+  if(is_null(node) || !node->children_pending())
+    return;
+
+  // the reply comes from the node and replaces its children
+  SignalOptions options;
+
+  options.add("depth", m_listing_depth == 0 ? 0u : 2u);
+
+  SignalFrame frame = options.create_frame("list_tree", CLIENT_TREE_PATH, node->uri());
+
+  NetworkQueue::global()->send( frame, NetworkQueue::IMMEDIATE );
+}
+
 /*============================================================================
 
                              PRIVATE METHODS
@@ -229,6 +229,15 @@ namespace core {
     /// @return Always returns 1.
     virtual int columnCount(const QModelIndex & parent = QModelIndex()) const;
 
+    /// @brief Implementation of @c QAbstractItemModel::canFetchMore().
+    /// @return Returns @c true if the children of the node were not listed
+    /// yet.
+    virtual bool canFetchMore(const QModelIndex & parent) const;
+
+    /// @brief Implementation of @c QAbstractItemModel::fetchMore().
+    /// Requests the listing of the children of the node.
+    virtual void fetchMore(const QModelIndex & parent);
+
     /// @brief Gives header titles.
 
     /// Overrides @c QAbstractItemModel::headerData().
@@ -258,6 +267,14 @@ namespace core {
     /// returns @c false.
     bool is_debug_mode_enabled() const;
 
+    /// @brief Sets the number of levels requested by a tree listing.
+
+    /// Deeper nodes are listed when they are expanded in a view. Other parts
+    /// of the client only find the nodes that were listed.
+    /// @param depth Number of levels. If 0 (the default), the whole tree is
+    /// listed.
+    void set_listing_depth(Uint depth);
+
     /// @brief Updates the children row counts, starting from the root.
     /// @note This method emits a @c layoutChanged() signal, causing the
     /// view(s) to be completely updated. Calling this method too often might
@@ -361,6 +378,22 @@ namespace core {
     /// @brief Mutex to control concurrent access.
     QMutex * m_mutex;
 
+    /// @brief Version of the server tree the client tree corresponds to.
+    /// If 0, the complete tree is listed on the next update.
+    Uint m_tree_version;
+
+    /// @brief Number of levels requested by a tree listing, 0 for all.
+    Uint m_listing_depth;
+
+    /// @brief Applies the changes listed by the server since the last update.
+    /// @param changes_node The "changes" node of the reply.
+    void apply_tree_changes(const common::XML::XmlNode & changes_node);
+
+    /// @brief Replaces the server children of a node.
+    /// @param parent The node to update.
+    /// @param tree_node XML node of the server component with its children.
+    void replace_children(Handle< CNode > parent, const common::XML::XmlNode & tree_node);
+
     /// @brief Converts an index to a tree node
 
     /// @param index Node index to convert
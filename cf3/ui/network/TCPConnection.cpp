@@ -4,11 +4,13 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <cstring> // for std::memchr()
 #include <iomanip> // for std::setw()
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include "common/BasicExceptions.hpp"
 #include "common/StringConversion.hpp"
 
 #include "common/XML/SignalFrame.hpp"
@@ -40,7 +42,8 @@ TCPConnection::Ptr TCPConnection::create( asio::io_service & ios )
 TCPConnection::TCPConnection( asio::io_service & io_service )
   : m_socket(io_service),
     m_incoming_data(nullptr),
-    m_incoming_data_size(0)
+    m_incoming_data_size(0),
+    m_max_frame_size(DEFAULT_MAX_FRAME_SIZE)
 {
 
 }
@@ -63,18 +66,32 @@ void TCPConnection::prepare_write_buffers( SignalArgs & args,
   // prepare the outgoing data: flush to XML and convert to string
   args.flush_maps();
 
-  XML::to_string( *args.xml_doc.get(), m_outgoing_data );
+  XML::to_string( *args.xml_doc.get(), m_outgoing_data, m_outgoing_attachments );
+
+  // the attachments follow the XML text in the same frame, after a null character
+  std::size_t frame_size = m_outgoing_data.length();
+  if( !m_outgoing_attachments.empty() )
+  {
+    m_outgoing_data.push_back( '\0' );
+    frame_size = m_outgoing_data.length() + m_outgoing_attachments.length();
+  }
 
   // create the header on HEADER_LENGTH characters
   std::ostringstream header_stream;
 
-  header_stream << std::setw(HEADER_LENGTH) << m_outgoing_data.length();
+  header_stream << std::setw(HEADER_LENGTH) << frame_size;
 
   m_outgoing_header = header_stream.str();
 
+  if( m_outgoing_header.length() != HEADER_LENGTH )
+    throw BadValue( FromHere(), "Frame of " + to_str( Uint(frame_size) ) + " bytes is too large to be sent." );
+
   // write header and data to buffers and then on the socket
   buffers.push_back( asio::buffer(m_outgoing_header) );
   buffers.push_back( asio::buffer(m_outgoing_data) );
+
+  if( !m_outgoing_attachments.empty() )
+    buffers.push_back( asio::buffer(m_outgoing_attachments) );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -89,6 +106,15 @@ void TCPConnection::process_header( boost::system::error_code & error )
     boost::algorithm::trim( header_str );
     m_incoming_data_size = boost::lexical_cast<cf3::Uint> ( header_str );
 
+    // the size comes from the remote entity, check it before allocating anything
+    if( m_incoming_data_size > m_max_frame_size )
+    {
+      const Uint frame_size = m_incoming_data_size;
+      m_incoming_data_size = 0;
+      throw BadValue( FromHere(), "Frame of " + to_str( frame_size ) + " bytes exceeds the maximum of "
+                      + to_str( m_max_frame_size ) + " bytes." );
+    }
+
     // destroy old buffer and allocate the new one
     delete[] m_incoming_data;
     m_incoming_data = new char[m_incoming_data_size];
@@ -122,9 +148,17 @@ void TCPConnection::parse_frame_data( SignalFrame & args, boost::system::error_c
 {
   try
   {
-    std::string frame( m_incoming_data, m_incoming_data_size );
+    // the XML text ends at the null character before the attachments, if any
+    const char * separator = static_cast<const char *>( std::memchr( m_incoming_data, '\0', m_incoming_data_size ) );
+    const std::size_t text_size = is_null(separator) ? m_incoming_data_size : separator - m_incoming_data;
+    const std::size_t attachments_length = is_null(separator) ? 0 : m_incoming_data_size - text_size - 1;
+
+    std::string frame( m_incoming_data, text_size );
 
     args = SignalFrame( cf3::common::XML::parse_string( frame ) );
+
+    // the attachment sizes given by the XML are checked against the rest of the frame
+    read_attachments( *args.xml_doc.get(), m_incoming_data + m_incoming_data_size - attachments_length, attachments_length );
   }
 
   catch ( cf3::common::Exception & cfe )
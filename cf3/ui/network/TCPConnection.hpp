@@ -57,6 +57,15 @@ class ErrorHandler;
 /// safeguard to check that all data has arrived and allocate the correct buffer
 /// for the reading process. @n@n
 
+/// Binary node values (see
+/// @link cf3::common::XML::Protocol::Tags::attr_encoding() @c attr_encoding @endlink)
+/// are not written in the XML text. They follow it as attachments in the same
+/// frame, after a null character, and the frame size in the header includes
+/// them. The sizes given by the XML are checked against the received frame
+/// before the values are put back into their nodes, and frames larger than
+/// @c #max_frame_size() are rejected before any memory is allocated for them.
+/// Large arrays are thus transferred without conversion to text. @n@n
+
 /// This class can be used in both client and server applications. However, an
 /// additional step is needed on the server-side: open a network connection and
 /// start accepting new clients connections. @n@n
@@ -230,6 +239,13 @@ public:
   /// @param handler Error handler to set. Can be expired.
   void set_error_handler ( boost::weak_ptr<ErrorHandler> handler );
 
+  /// Sets the size of the largest frame accepted from the remote entity.
+  /// @param size Maximum number of bytes of a frame, attachments included.
+  void set_max_frame_size ( Uint size ) { m_max_frame_size = size; }
+
+  /// @return Returns the size of the largest frame accepted from the remote entity.
+  Uint max_frame_size () const { return m_max_frame_size; }
+
 private: // functions
 
   /// @brief Function called when a frame header has been read, successfully or not.
@@ -313,6 +329,7 @@ private: // functions
   void process_header ( boost::system::error_code & error );
 
   /// @brief Parses frame data from string to XML.
+  /// The attachments that follow the XML text are put back into their nodes.
   /// @param args Object where the parsed XML will be written.
   void parse_frame_data ( common::XML::SignalFrame & args,
                           boost::system::error_code & error);
@@ -332,8 +349,11 @@ private: // data
   /// Buffer for outgoing header
   std::string m_outgoing_header;
 
-  /// Nameless enum for header length
-  enum { HEADER_LENGTH = 8 };
+  /// Buffer for outgoing attachments
+  std::string m_outgoing_attachments;
+
+  /// Nameless enum for header length and the default maximum frame size (64 MiB)
+  enum { HEADER_LENGTH = 8, DEFAULT_MAX_FRAME_SIZE = 67108864 };
 
   /// Buffer the receiving header.
   char m_incoming_header[HEADER_LENGTH];
@@ -346,6 +366,9 @@ private: // data
   /// @c m_incoming_data_size.
   char * m_incoming_data;
 
+  /// Largest frame accepted from the remote entity.
+  Uint m_max_frame_size;
+
   /// Weak pointer to the error handler.
   boost::weak_ptr<ErrorHandler> m_error_handler;
 
@@ -10,6 +10,7 @@
 #include "common/Log.hpp"
 #include "common/Group.hpp"
 #include "common/Core.hpp"
+#include "common/TreeJournal.hpp"
 #include "common/PE/Manager.hpp"
 #include "common/XML/Protocol.hpp"
 
@@ -47,6 +48,8 @@ ServerRoot::ServerRoot()
   m_pe_manager->signal("signal_to_forward")
       ->connect( boost::bind(&ServerRoot::signal_to_forward, this, _1) );
 
+  // clients may now ask for the tree changes since their last listing
+  TreeJournal::instance().set_enabled(true);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,375 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cmath>
+#include <limits>
+
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Foreach.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "math/Checks.hpp"
+#include "math/MatrixTypes.hpp"
+
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+
+#include "RDM/RDSolver.hpp"
+#include "RDM/IterativeSolver.hpp"
+#include "RDM/BoundaryConditions.hpp"
+#include "RDM/DomainDiscretization.hpp"
+#include "RDM/NewtonKrylov.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::math::Checks;
+
+namespace cf3 {
+namespace RDM {
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < NewtonKrylov, common::Action, LibRDM > NewtonKrylov_Builder;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+NewtonKrylov::NewtonKrylov ( const std::string& name ) :
+  cf3::solver::Action(name),
+  m_state_norm(0.),
+  m_initial_residual_norm(0.)
+{
+  mark_basic();
+
+  options().add( "cfl", 1.0 )
+      .pretty_name("CFL")
+      .description("Courant-Fredrichs-Levy number for the pseudo time step at the first iteration");
+
+  options().add( "cfl_max", 1e6 )
+      .pretty_name("Maximum CFL")
+      .description("Upper limit for the CFL number");
+
+  options().add( "ser_exponent", 1.0 )
+      .pretty_name("SER Exponent")
+      .description("Exponent of the residual ratio in the switched evolution relaxation of the CFL number");
+
+  options().add( "krylov_dimension", 30u )
+      .pretty_name("Krylov Dimension")
+      .description("Number of GMRES iterations before a restart");
+
+  options().add( "max_krylov_iterations", 100u )
+      .pretty_name("Maximum Krylov Iterations")
+      .description("Maximum total number of GMRES iterations for each Newton step");
+
+  options().add( "krylov_tolerance", 1e-2 )
+      .pretty_name("Krylov Tolerance")
+      .description("Reduction of the linear residual at which GMRES stops");
+
+  options().add( "fd_epsilon", std::sqrt(std::numeric_limits<Real>::epsilon()) )
+      .pretty_name("Finite Difference Epsilon")
+      .description("Relative perturbation for the finite difference Jacobian-vector products");
+
+  properties().add( "cfl", 1.0 );
+  properties().add( "krylov_iterations", 0u );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void NewtonKrylov::execute()
+{
+  RDSolver& mysolver = *solver().handle< RDSolver >();
+
+  if (is_null(m_solution))
+    m_solution = follow_link(mysolver.fields().get_child( RDM::Tags::solution() ))->handle<Field>();
+  if (is_null(m_wave_speed))
+    m_wave_speed = follow_link(mysolver.fields().get_child( RDM::Tags::wave_speed() ))->handle<Field>();
+  if (is_null(m_residual))
+    m_residual = follow_link(mysolver.fields().get_child( RDM::Tags::residual() ))->handle<Field>();
+
+  Field& solution     = *m_solution;
+  Field& wave_speed   = *m_wave_speed;
+  Field& residual     = *m_residual;
+
+  const Uint nbdofs = solution.size();
+  const Uint nbvars = solution.row_size();
+  const Uint n = nbdofs*nbvars;
+
+  // Store the current state. The residual and wave speed are overwritten during the Krylov iterations
+  // and must be restored at the end.
+
+  m_state.resize(n);
+  m_state_residual.resize(n);
+  m_active.resize(n);
+  std::vector<Real> saved_residual(n);
+  std::vector<Real> saved_wave_speed(nbdofs);
+
+  for ( Uint i=0; i< nbdofs; ++i )
+  {
+    saved_wave_speed[i] = wave_speed[i][0];
+    const bool active = !solution.is_ghost(i) && is_not_zero(wave_speed[i][0]);
+    for ( Uint j=0; j< nbvars; ++j )
+    {
+      const Uint k = i*nbvars+j;
+      m_state[k] = solution[i][j];
+      saved_residual[k] = residual[i][j];
+      m_active[k] = active;
+      m_state_residual[k] = active ? residual[i][j] : 0.;
+    }
+  }
+
+  const Real residual_norm = std::sqrt(dot(m_state_residual, m_state_residual));
+  if ( is_zero(residual_norm) )
+    return;
+
+  m_state_norm = std::sqrt(dot(m_state, m_state));
+
+  // Switched evolution relaxation of the CFL number
+
+  const Uint iter = mysolver.iterative_solver().properties().value<Uint>("iteration");
+  if ( iter <= 1 || is_zero(m_initial_residual_norm) )
+    m_initial_residual_norm = residual_norm;
+
+  const Real cfl = std::min( options().value<Real>("cfl_max"),
+                             options().value<Real>("cfl") * std::pow( m_initial_residual_norm / residual_norm, options().value<Real>("ser_exponent") ) );
+  properties().property("cfl") = cfl;
+
+  m_time_term.resize(n);
+  m_preconditioner.resize(n);
+  for ( Uint i=0; i< nbdofs; ++i )
+  {
+    for ( Uint j=0; j< nbvars; ++j )
+    {
+      const Uint k = i*nbvars+j;
+      m_time_term[k] = saved_wave_speed[i] / cfl;
+      m_preconditioner[k] = m_active[k] ? 1. / (saved_wave_speed[i] + m_time_term[k]) : 0.;
+    }
+  }
+
+  // Solve the Newton system
+
+  std::vector<Real> rhs(n);
+  for ( Uint k=0; k < n; ++k )
+    rhs[k] = -m_state_residual[k];
+
+  std::vector<Real> update(n, 0.);
+  const Uint nb_krylov_iters = gmres(rhs, update);
+  properties().property("krylov_iterations") = nb_krylov_iters;
+
+  CFinfo << "NewtonKrylov: CFL " << cfl << ", " << nb_krylov_iters << " GMRES iterations" << CFendl;
+
+  // Apply the update and restore the residual and wave speed of the current iteration
+
+  for ( Uint i=0; i< nbdofs; ++i )
+  {
+    wave_speed[i][0] = saved_wave_speed[i];
+    for ( Uint j=0; j< nbvars; ++j )
+    {
+      const Uint k = i*nbvars+j;
+      solution[i][j] = m_state[k] + update[k];
+      residual[i][j] = saved_residual[k];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void NewtonKrylov::compute_residual()
+{
+  RDSolver& mysolver = *solver().handle< RDSolver >();
+
+  m_solution->synchronize();
+
+  mysolver.iterative_solver().pre_actions().execute();
+  mysolver.domain_discretization().execute();
+  mysolver.boundary_conditions().execute();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void NewtonKrylov::apply_operator(const std::vector<Real>& v, std::vector<Real>& Av)
+{
+  const Uint n = v.size();
+  Av.resize(n);
+
+  const Real v_norm = std::sqrt(dot(v, v));
+  if ( is_zero(v_norm) )
+  {
+    std::fill(Av.begin(), Av.end(), 0.);
+    return;
+  }
+
+  const Real eps = options().value<Real>("fd_epsilon") * (1. + m_state_norm) / v_norm;
+
+  Field& solution = *m_solution;
+  Field& residual = *m_residual;
+  const Uint nbdofs = solution.size();
+  const Uint nbvars = solution.row_size();
+
+  for ( Uint i=0; i< nbdofs; ++i )
+    for ( Uint j=0; j< nbvars; ++j )
+      solution[i][j] = m_state[i*nbvars+j] + eps * v[i*nbvars+j];
+
+  compute_residual();
+
+  for ( Uint i=0; i< nbdofs; ++i )
+  {
+    for ( Uint j=0; j< nbvars; ++j )
+    {
+      const Uint k = i*nbvars+j;
+      Av[k] = m_active[k] ? (residual[i][j] - m_state_residual[k]) / eps + m_time_term[k] * v[k] : 0.;
+    }
+  }
+
+  // leave the solution in its original state
+  for ( Uint i=0; i< nbdofs; ++i )
+    for ( Uint j=0; j< nbvars; ++j )
+      solution[i][j] = m_state[i*nbvars+j];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void NewtonKrylov::apply_preconditioner(const std::vector<Real>& v, std::vector<Real>& Pv)
+{
+  const Uint n = v.size();
+  Pv.resize(n);
+  for ( Uint k=0; k < n; ++k )
+    Pv[k] = m_preconditioner[k] * v[k];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real NewtonKrylov::dot(const std::vector<Real>& a, const std::vector<Real>& b) const
+{
+  const Uint n = a.size();
+  Real local_result = 0.;
+  for ( Uint k=0; k < n; ++k )
+    if ( m_active[k] )
+      local_result += a[k]*b[k];
+
+  if ( common::PE::Comm::instance().is_active() )
+  {
+    Real result = 0.;
+    common::PE::Comm::instance().all_reduce(common::PE::plus(), &local_result, 1, &result);
+    return result;
+  }
+
+  return local_result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint NewtonKrylov::gmres(const std::vector<Real>& rhs, std::vector<Real>& x)
+{
+  const Uint n = rhs.size();
+  const Uint m = options().value<Uint>("krylov_dimension");
+  const Uint max_iters = options().value<Uint>("max_krylov_iterations");
+  const Real rhs_norm = std::sqrt(dot(rhs, rhs));
+  const Real tolerance = options().value<Real>("krylov_tolerance") * rhs_norm;
+
+  std::vector< std::vector<Real> > basis(m+1, std::vector<Real>(n));
+  RealMatrix hessenberg(m+1, m);
+  RealVector cs(m), sn(m), g(m+1);
+  std::vector<Real> w(n), z(n);
+
+  Uint total_iters = 0;
+  while ( total_iters < max_iters )
+  {
+    // r = rhs - A x
+    apply_operator(x, w);
+    for ( Uint k=0; k < n; ++k )
+      basis[0][k] = rhs[k] - w[k];
+
+    const Real beta = std::sqrt(dot(basis[0], basis[0]));
+    if ( beta <= tolerance || is_zero(beta) )
+      break;
+
+    for ( Uint k=0; k < n; ++k )
+      basis[0][k] /= beta;
+
+    hessenberg.setZero();
+    g.setZero();
+    g[0] = beta;
+
+    Uint j = 0;
+    for ( ; j < m && total_iters < max_iters; ++j, ++total_iters )
+    {
+      // w = A M^-1 v_j
+      apply_preconditioner(basis[j], z);
+      apply_operator(z, w);
+
+      // modified Gram-Schmidt
+      for ( Uint i=0; i <= j; ++i )
+      {
+        hessenberg(i,j) = dot(w, basis[i]);
+        for ( Uint k=0; k < n; ++k )
+          w[k] -= hessenberg(i,j) * basis[i][k];
+      }
+      hessenberg(j+1,j) = std::sqrt(dot(w, w));
+      if ( is_not_zero(hessenberg(j+1,j)) )
+        for ( Uint k=0; k < n; ++k )
+          basis[j+1][k] = w[k] / hessenberg(j+1,j);
+
+      // apply the previous Givens rotations to the new column
+      for ( Uint i=0; i < j; ++i )
+      {
+        const Real tmp = cs[i]*hessenberg(i,j) + sn[i]*hessenberg(i+1,j);
+        hessenberg(i+1,j) = -sn[i]*hessenberg(i,j) + cs[i]*hessenberg(i+1,j);
+        hessenberg(i,j) = tmp;
+      }
+
+      // compute and apply the new rotation
+      const Real denom = std::sqrt(hessenberg(j,j)*hessenberg(j,j) + hessenberg(j+1,j)*hessenberg(j+1,j));
+      cs[j] = hessenberg(j,j) / denom;
+      sn[j] = hessenberg(j+1,j) / denom;
+      hessenberg(j,j) = denom;
+      hessenberg(j+1,j) = 0.;
+      g[j+1] = -sn[j]*g[j];
+      g[j] = cs[j]*g[j];
+
+      if ( std::abs(g[j+1]) <= tolerance )
+      {
+        ++j;
+        ++total_iters;
+        break;
+      }
+    }
+
+    // solve the upper triangular system and update x = x + M^-1 V y
+    RealVector y(j);
+    for ( int i = static_cast<int>(j)-1; i >= 0; --i )
+    {
+      y[i] = g[i];
+      for ( Uint l = i+1; l < j; ++l )
+        y[i] -= hessenberg(i,l) * y[l];
+      y[i] /= hessenberg(i,i);
+    }
+
+    std::fill(w.begin(), w.end(), 0.);
+    for ( Uint i=0; i < j; ++i )
+      for ( Uint k=0; k < n; ++k )
+        w[k] += y[i] * basis[i][k];
+    apply_preconditioner(w, z);
+    for ( Uint k=0; k < n; ++k )
+      x[k] += z[k];
+
+    if ( j == 0 || std::abs(g[j]) <= tolerance )
+      break;
+  }
+
+  return total_iters;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
+
+///////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,95 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RDM_NewtonKrylov_hpp
+#define cf3_RDM_NewtonKrylov_hpp
+
+#include "solver/Action.hpp"
+
+#include "RDM/LibRDM.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh { class Field; }
+namespace RDM {
+
+/// Implicit update for steady problems, using a Jacobian-free Newton-Krylov method.
+/// Each call solves the pseudo-transient Newton system
+///   ( V/dtau + dR/du ) du = -R
+/// with restarted GMRES. The Jacobian-vector products are approximated by finite differences
+/// of the residual computed by the DomainDiscretization and BoundaryConditions of the solver,
+/// so no Jacobian matrix is ever assembled. The local pseudo time step V/dtau = wave_speed/CFL
+/// is the same as in FwdEuler, and the system is right-preconditioned with the approximate
+/// diagonal of the first order Jacobian, wave_speed*(1 + 1/CFL).
+/// The CFL number is ramped up using switched evolution relaxation (SER):
+///   CFL = min( cfl_max, cfl * (|R_0|/|R|)^ser_exponent )
+class RDM_API NewtonKrylov : public cf3::solver::Action {
+
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  NewtonKrylov ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~NewtonKrylov() {}
+
+  /// Get the class name
+  static std::string type_name () { return "NewtonKrylov"; }
+
+  /// execute the action
+  virtual void execute ();
+
+private: // functions
+
+  /// Recompute the residual for the state currently stored in the solution field
+  void compute_residual();
+
+  /// Compute Av = (V/dtau + dR/du) v, using a finite difference for the Jacobian
+  void apply_operator(const std::vector<Real>& v, std::vector<Real>& Av);
+
+  /// Apply the inverse of the preconditioner
+  void apply_preconditioner(const std::vector<Real>& v, std::vector<Real>& Pv);
+
+  /// Solve the Newton system using restarted GMRES with right preconditioning
+  /// @returns the number of Krylov iterations
+  Uint gmres(const std::vector<Real>& rhs, std::vector<Real>& x);
+
+  /// Dot product over the locally owned entries, summed over all processes
+  Real dot(const std::vector<Real>& a, const std::vector<Real>& b) const;
+
+private: // data
+
+  /// solution field pointer
+  Handle<mesh::Field> m_solution;
+  /// residual field pointer
+  Handle<mesh::Field> m_residual;
+  /// wave_speed field pointer
+  Handle<mesh::Field> m_wave_speed;
+
+  /// State around which the residual is linearized
+  std::vector<Real> m_state;
+  /// Residual at m_state, with inactive entries set to zero
+  std::vector<Real> m_state_residual;
+  /// Diagonal pseudo-time term V/dtau
+  std::vector<Real> m_time_term;
+  /// Diagonal preconditioner
+  std::vector<Real> m_preconditioner;
+  /// False for ghost entries and for entries without wave speed, which are not updated
+  std::vector<bool> m_active;
+  /// Norm of the state, used to scale the finite difference step
+  Real m_state_norm;
+  /// Norm of the residual at the first iteration, used for the CFL ramping
+  Real m_initial_residual_norm;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
+
+#endif // cf3_RDM_NewtonKrylov_hpp
@@ -10,6 +10,7 @@
 #include "common/Builder.hpp"
 #include "common/OptionT.hpp"
 #include "common/Log.hpp"
+#include "common/ActionDirector.hpp"
 
 #include "common/XML/SignalOptions.hpp"
 
@@ -58,7 +59,7 @@ SteadyExplicit::SteadyExplicit ( const std::string& name  ) :
 
   regist_signal( "create_model" )
     .connect( boost::bind( &SteadyExplicit::signal_create_model, this, _1 ) )
-    .description("Creates a model for solving steady problms with RD using explicit iterations")
+    .description("Creates a model for solving steady problems with RD using explicit iterations")
     .pretty_name("Create Model");
 
   signal("create_component")->hidden(true);
@@ -106,9 +107,9 @@ Model& SteadyExplicit::create_model( const std::string& model_name, const std::s
                                                               ( RDM::Tags::wave_speed() );
   reset->options().set("FieldTags", reset_tags);
 
-  // (4c) setup iterative solver explicit time stepping  - forward euler
+  // (4c) setup iterative solver update
 
-  solver->iterative_solver().update().create_component<FwdEuler>("Step");
+  create_update( solver->iterative_solver().update() );
 
   // (4d) setup solver fields
   solver->prepare_mesh().create_component<SetupMultipleSolutions>("SetupFields");
@@ -125,6 +126,13 @@ Model& SteadyExplicit::create_model( const std::string& model_name, const std::s
 }
 
 
+void SteadyExplicit::create_update( common::ActionDirector& update )
+{
+  // explicit time stepping  - forward euler
+  update.create_component<FwdEuler>("Step");
+}
+
+
 void SteadyExplicit::signal_create_model ( common::SignalArgs& node )
 {
   SignalOptions options( node );
@@ -15,6 +15,7 @@
 
 namespace cf3 {
 
+ namespace common { class ActionDirector; }
  namespace solver { class Model; }
 
 namespace RDM {
@@ -57,6 +58,11 @@ public: // functions
 
   //@} END SIGNALS
 
+protected: // functions
+
+  /// Create the action that updates the solution in each iteration, forward Euler time stepping by default
+  virtual void create_update( common::ActionDirector& update );
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
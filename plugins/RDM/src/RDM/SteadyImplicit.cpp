@@ -0,0 +1,43 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/ActionDirector.hpp"
+#include "common/Builder.hpp"
+#include "common/Signal.hpp"
+
+#include "RDM/NewtonKrylov.hpp"
+
+#include "SteadyImplicit.hpp"
+
+namespace cf3 {
+namespace RDM {
+
+using namespace cf3::common;
+
+common::ComponentBuilder < SteadyImplicit, cf3::solver::Wizard, LibRDM > SteadyImplicit_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+SteadyImplicit::SteadyImplicit ( const std::string& name  ) :
+  SteadyExplicit ( name )
+{
+  signal("create_model")->description("Creates a model for solving steady problems with RD using implicit Newton-Krylov iterations");
+}
+
+
+SteadyImplicit::~SteadyImplicit() {}
+
+
+void SteadyImplicit::create_update( common::ActionDirector& update )
+{
+  // implicit update - Jacobian-free Newton-Krylov
+  update.create_component<NewtonKrylov>("Step");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
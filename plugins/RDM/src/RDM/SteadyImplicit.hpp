@@ -0,0 +1,49 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_RDM_SteadyImplicit_hpp
+#define cf3_RDM_SteadyImplicit_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RDM/SteadyExplicit.hpp"
+
+namespace cf3 {
+namespace RDM {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Wizard to setup a steady simulation, solved with implicit Newton-Krylov iterations
+/// instead of the explicit time stepping of SteadyExplicit
+class RDM_API SteadyImplicit : public SteadyExplicit {
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  SteadyImplicit ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~SteadyImplicit();
+
+  /// Get the class name
+  static std::string type_name () { return "SteadyImplicit"; }
+
+protected: // functions
+
+  /// Create the Jacobian-free Newton-Krylov update
+  virtual void create_update( common::ActionDirector& update );
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // RDM
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_RDM_SteadyImplicit_hpp
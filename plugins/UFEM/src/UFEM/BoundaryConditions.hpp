@@ -33,6 +33,9 @@ public: // functions
   /// Get the class name
   static std::string type_name () { return "BoundaryConditions"; }
 
+  /// Run the boundary conditions. The symmetric dirichlet conditions are collected and applied to the linear system at once.
+  virtual void execute();
+
   /// Create constant dirichlet BC
   /// @param region_name Name of the boundary region. Must be unique in the problem region
   /// @param variable_name Name of the variable for which to set the BC
@@ -104,6 +104,9 @@ void HeatConductionSteady::trigger()
   FieldVariable<4, ScalarField> temperature2_hc("TemperatureHistoryHC2", "temperature_history_hc");
   FieldVariable<5, ScalarField> temperature3_hc("TemperatureHistoryHC3", "temperature_history_hc");
 
+  // The diffusion matrix only depends on the geometry and the conductivity, so it is integrated only once
+  ElementMatrixCache diffusion_cache;
+
   if(use_specializations)
   {
     boost::proto::terminal< RestrictToElementTypeTag< boost::mpl::vector5<LagrangeP1::Line1D, LagrangeP1::Tetra3D, LagrangeP1::Quad2D, LagrangeP1::Hexa3D, LagrangeP2::Line1D> > >::type generic_elements;
@@ -114,10 +117,14 @@ void HeatConductionSteady::trigger()
       group
       (
         generic_elements(
-          _A = _0,
-          element_quadrature
+          cache_element_matrix
           (
-            _A(T) += lambda_s * transpose(nabla(T)) * nabla(T)
+            diffusion_cache, _A,
+            _A = _0,
+            element_quadrature
+            (
+              _A(T) += lambda_s * transpose(nabla(T)) * nabla(T)
+            )
           )
         ),
         specialized_elements(heat_specialized(T, k, _A(T))),
@@ -133,10 +140,14 @@ void HeatConductionSteady::trigger()
       boost::mpl::vector6<LagrangeP1::Line1D, LagrangeP1::Triag2D, LagrangeP1::Tetra3D, LagrangeP1::Quad2D, LagrangeP1::Hexa3D, LagrangeP2::Line1D>(),
       group
       (
-        _A = _0,
-        element_quadrature
+        cache_element_matrix
         (
-          _A(T) += lambda_s * transpose(nabla(T)) * nabla(T)
+          diffusion_cache, _A,
+          _A = _0,
+          element_quadrature
+          (
+            _A(T) += lambda_s * transpose(nabla(T)) * nabla(T)
+          )
         ),
         system_matrix +=  _A,
         system_rhs += -_A * _x + integral<2>(transpose(N(T))*N(q)*jacobian_determinant) * nodal_values(q)
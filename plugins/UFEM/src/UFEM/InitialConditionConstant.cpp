@@ -130,16 +130,10 @@ void InitialConditionConstant::execute()
   {
     CFdebug << "  Action " << name() << ": running over region " << region->uri().path() << CFendl;
     
-    // Build a list of used entities
     mesh::Mesh& mesh = common::find_parent_component<mesh::Mesh>(*region);
-    std::vector< Handle<mesh::Entities const> > used_entities;
-    BOOST_FOREACH(const mesh::Entities& entities, common::find_components_recursively<mesh::Entities>(*region))
-    {
-      used_entities.push_back(entities.handle<mesh::Entities>());
-    }
-    boost::shared_ptr< common::List<Uint> > used_nodes_ptr = mesh::build_used_nodes_list(used_entities, mesh.geometry_fields(), true);
+    const boost::shared_ptr< common::List<Uint> const > used_nodes_ptr = mesh.geometry_fields().used_nodes(*region);
 
-    common::List<Uint>& nodes = *used_nodes_ptr;
+    const common::List<Uint>& nodes = *used_nodes_ptr;
     
     Field& field = find_field(*region, field_tag);
     BOOST_FOREACH(const Uint node, nodes.array())
@@ -8,10 +8,16 @@
 #include <boost/bind.hpp>
 
 #include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
 #include "common/Log.hpp"
 #include "common/Option.hpp"
 #include "common/OptionList.hpp"
 
+#include "math/Consts.hpp"
+#include "math/LSS/SolveLSS.hpp"
+#include "math/LSS/System.hpp"
+
 #include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
 
@@ -28,17 +34,52 @@ using namespace common;
 common::ComponentBuilder < LSSActionUnsteady, common::ActionDirector, LibUFEM > LSSActionUnsteady_Builder;
 
 LSSActionUnsteady::LSSActionUnsteady(const std::string& name) :
-  LSSAction(name)
+  LSSAction(name),
+  m_history_step(math::Consts::uint_max()),
+  m_step_iterations(0)
 {
   options().add(solver::Tags::time(), m_time)
     .pretty_name("Time")
     .description("Component that keeps track of time for this simulation")
     .attach_trigger(boost::bind(&LSSActionUnsteady::trigger_time, this))
     .link_to(&m_time);
+
+  options().add("history", m_history)
+    .pretty_name("History")
+    .description("History component used to log the number of linear solver iterations")
+    .link_to(&m_history);
 }
 
-LSSActionUnsteady::~LSSActionUnsteady()
+void LSSActionUnsteady::execute()
 {
+  if(is_not_null(m_time))
+  {
+    boost_foreach(math::LSS::SolveLSS& solve, find_components_recursively<math::LSS::SolveLSS>(*this))
+      solve.options().set("step", m_time->iter());
+  }
+
+  LSSAction::execute();
+
+  if(is_not_null(m_history))
+  {
+    if(is_null(m_time))
+      throw SetupError(FromHere(), "Time is not set for " + uri().string() + ", which is needed to log in history " + m_history->uri().string());
+
+    const Uint step = m_time->iter();
+    if(step != m_history_step)
+    {
+      m_history_step = step;
+      m_step_iterations = 0;
+    }
+
+    const Handle<math::LSS::System> lss = options().value< Handle<math::LSS::System> >("lss");
+    m_step_iterations += lss->solution_strategy()->iterations();
+
+    m_history->set("iteration", static_cast<Real>(step));
+    m_history->set("time", m_time->current_time());
+    m_history->set(name() + "_iterations", static_cast<Real>(m_step_iterations));
+    m_history->save_entry();
+  }
 }
 
 Real& LSSActionUnsteady::dt()
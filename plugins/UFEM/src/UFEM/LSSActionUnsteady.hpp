@@ -7,6 +7,7 @@
 #ifndef cf3_UFEM_LSSActionUnsteady_hpp
 #define cf3_UFEM_LSSActionUnsteady_hpp
 
+#include "solver/History.hpp"
 #include "solver/Time.hpp"
 
 #include "LibUFEM.hpp"
@@ -21,6 +22,10 @@ namespace UFEM {
 /// * Physical model
 /// * Mesh used
 /// * Region to loop over
+/// The time step is passed on to the SolveLSS actions, so they can extrapolate their initial guess per time step.
+/// If a History is set, a row with the number of linear solver iterations is saved in it after every solve.
+/// The "iteration" column holds the time step, and when a step has several solves, the iterations are summed
+/// over the solves of the step so far, so the last row of a step has the total for the step.
 class UFEM_API LSSActionUnsteady : public LSSAction
 {
 public: // functions
@@ -29,11 +34,11 @@ public: // functions
   /// @param name of the component
   LSSActionUnsteady ( const std::string& name );
 
-  virtual ~LSSActionUnsteady();
-
   /// Get the class name
   static std::string type_name () { return "LSSActionUnsteady"; }
 
+  virtual void execute();
+
   /// Reference to the timestep
   Real& dt();
 
@@ -48,7 +53,13 @@ private:
   void trigger_timestep();
 
   Handle<solver::Time> m_time;
+  Handle<solver::History> m_history;
   Real m_dt, m_invdt;
+
+  /// Step of the iterations in m_step_iterations
+  Uint m_history_step;
+  /// Number of linear solver iterations summed over the solves in m_history_step
+  Uint m_step_iterations;
 };
 
 } // UFEM
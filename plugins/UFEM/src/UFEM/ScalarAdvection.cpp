@@ -89,6 +89,9 @@ void ScalarAdvection::trigger_scalar_name()
 
   ConfigurableConstant<Real> relaxation_factor_scalar("relaxation_factor_scalar", "factor for relaxation in case of coupling", 1.);
 
+  // The diffusion matrix only depends on the geometry and the physical constants, so it is integrated only once
+  ElementMatrixCache diffusion_cache;
+
   // Set the proto expression that handles the assembly
   Handle<ProtoAction>(get_child("Assembly"))->set_expression(
     elements_expression
@@ -98,14 +101,23 @@ void ScalarAdvection::trigger_scalar_name()
      group
      (
        _A = _0, _T = _0,
+      cache_element_matrix
+      (
+        diffusion_cache, _M,
+        _M = _0,
+        element_quadrature
+        (
+          _M(Phi,Phi) += transpose(nabla(Phi)) * nabla(Phi) * lambda_f/(boost::proto::lit(rho)*cp)
+        )
+      ),
       UFEM::compute_tau(u_adv, nu_eff, lit(tau_su)),
       element_quadrature
       (
-       _A(Phi) += transpose(N(Phi)) * u_adv * nabla(Phi) + tau_su * transpose(u_adv*nabla(Phi)) * u_adv * nabla(Phi) + transpose(nabla(Phi)) * nabla(Phi) * lambda_f/(boost::proto::lit(rho)*cp) ,
+       _A(Phi) += transpose(N(Phi)) * u_adv * nabla(Phi) + tau_su * transpose(u_adv*nabla(Phi)) * u_adv * nabla(Phi),
        _T(Phi,Phi) +=  transpose(N(Phi) + tau_su * u_adv * nabla(Phi)) * N(Phi)
       ),
-      system_matrix += invdt() * _T + 1.0 * _A,
-      system_rhs += -_A * _x
+      system_matrix += invdt() * _T + 1.0 * _A + _M,
+      system_rhs += -_A * _x - _M * _x
      )
     )
   );
@@ -130,6 +130,12 @@ bc.add_constant_bc(region_name = 'bottom2', variable_name = 'TurbulentViscosity'
 bc.add_constant_bc(region_name = 'bottom3', variable_name = 'TurbulentViscosity').options().set('value',  NU_in)
 bc.add_constant_bc(region_name = 'top', variable_name = 'TurbulentViscosity').options().set('value', NU_in)
 
+# Distance to the flat plate, used by Spalart-Allmaras
+wall_distance = domain.create_component('WallDistance', 'cf3.mesh.actions.WallDistance')
+wall_distance.mesh = mesh
+wall_distance.regions = [mesh.access_component('topology/bottom1').uri(), mesh.access_component('topology/bottom2').uri()]
+wall_distance.execute()
+
 # Time setup
 time = model.create_time()
 time.time_step = 0.01
@@ -26,7 +26,7 @@ def make_square(x_segs, y_segs):
   return blocks
 
 class TestCase:
-  def __init__(self, modelname, segments, use_spec):
+  def __init__(self, modelname, segments, use_spec, matrix_builder = 'cf3.math.LSS.TrilinosFEVbrMatrix', nb_steps = 1, scatter_maps = True):
     if len(sys.argv) == 2:
       self.nb_procs = int(sys.argv[1])
     else:
@@ -52,6 +52,9 @@ class TestCase:
     self.ns_solver.options().set('use_specializations', use_spec)
     self.ns_solver.options().set('disabled_actions', ['SolveLSS'])
     self.use_spec = use_spec
+    self.matrix_builder = matrix_builder
+    self.nb_steps = nb_steps
+    self.scatter_maps = scatter_maps
 
   def grow_overlap(self):
     if self.nb_procs > 1:
@@ -106,19 +109,28 @@ class TestCase:
   def setup_lss(self):
     self.grow_overlap()
     self.ns_solver.options().set('regions', [self.mesh.access_component('topology').uri()])
-    self.ns_solver.create_lss('cf3.math.LSS.TrilinosFEVbrMatrix')
+    lss = self.ns_solver.create_lss(self.matrix_builder)
+    if not self.scatter_maps:
+      lss.get_child('Matrix').options().set('use_scatter_maps', False)
 
   def run(self):
     time = self.model.create_time()
     time.options().set('time_step', 1.)
-    time.options().set('end_time', 1.)
+    time.options().set('end_time', float(self.nb_steps))
     self.model.simulate()
     self.ns_solver.store_timings()
     try:
       assembly_name = 'Assembly'
-      print '<DartMeasurement name=\"' + self.model.name() + ' time\" type=\"numeric/double\">' + str(self.ns_solver.get_child(assembly_name).properties()['timer_mean']) + '</DartMeasurement>'
+      props = self.ns_solver.get_child(assembly_name).properties()
+      print '<DartMeasurement name=\"' + self.model.name() + ' time\" type=\"numeric/double\">' + str(props['timer_mean']) + '</DartMeasurement>'
+      if self.nb_steps > 1:
+        # The slowest step is the first one, the fastest one shows the steady state
+        print '<DartMeasurement name=\"' + self.model.name() + ' max time\" type=\"numeric/double\">' + str(props['timer_maximum']) + '</DartMeasurement>'
+        print '<DartMeasurement name=\"' + self.model.name() + ' min time\" type=\"numeric/double\">' + str(props['timer_minimum']) + '</DartMeasurement>'
+      return props['timer_minimum']
     except:
       print 'Could not find timing info'
+      return None
 
 # Some shortcuts
 root = cf.Core.root()
@@ -166,4 +178,23 @@ test_case.model.delete_component()
 test_case = TestCase('TetrasSpecialized', [80, 50, 50], True)
 test_case.cube_mesh_tetras()
 test_case.run()
-test_case.model.delete_component()
\ No newline at end of file
+test_case.model.delete_component()
+
+# The CRS matrix adds element matrices through per-element scatter maps, computed during the first step.
+# Compare the fastest step with the FEVbr matrix and with the CRS matrix searching its rows at every step
+# (the assembly before the scatter maps), and report the ratios
+def compare_steps(name, segments, use_spec, make_mesh):
+  timings = {}
+  for (suffix, builder, scatter_maps) in [('Vbr', 'cf3.math.LSS.TrilinosFEVbrMatrix', True), ('CrsSearch', 'cf3.math.LSS.TrilinosCrsMatrix', False), ('Crs', 'cf3.math.LSS.TrilinosCrsMatrix', True)]:
+    test_case = TestCase(name + suffix + 'Steps', list(segments), use_spec, builder, 5, scatter_maps)
+    make_mesh(test_case)
+    timings[suffix] = test_case.run()
+    test_case.model.delete_component()
+  if timings['Crs'] is None or timings['Crs'] <= 0.:
+    return
+  for reference in ['Vbr', 'CrsSearch']:
+    if timings[reference] is not None:
+      print '<DartMeasurement name=\"' + name + ' ' + reference + '/Crs speedup\" type=\"numeric/double\">' + str(timings[reference] / timings['Crs']) + '</DartMeasurement>'
+
+compare_steps('QuadsGeneric', [500,400], False, TestCase.square_mesh_quads)
+compare_steps('TetrasSpecialized', [80, 50, 50], True, TestCase.cube_mesh_tetras)
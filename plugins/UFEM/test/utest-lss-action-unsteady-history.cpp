@@ -0,0 +1,137 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the iteration history of UFEM::LSSActionUnsteady"
+
+#include <boost/assign/std/vector.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Builder.hpp"
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+#include "common/Table.hpp"
+
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "common/PE/CommWrapper.hpp"
+
+#include "math/LSS/LibLSS.hpp"
+#include "math/LSS/SolutionStrategy.hpp"
+#include "math/LSS/SolveLSS.hpp"
+#include "math/LSS/System.hpp"
+
+#include "solver/History.hpp"
+#include "solver/Time.hpp"
+
+#include "UFEM/LSSActionUnsteady.hpp"
+
+using namespace boost::assign;
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::math;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Solution strategy that doesn't solve anything, but reports a given number of iterations
+class CountingStrategy : public LSS::SolutionStrategy
+{
+public:
+  CountingStrategy(const std::string& name) : LSS::SolutionStrategy(name), nb_iterations(0)
+  {
+  }
+
+  static std::string type_name () { return "CountingStrategy"; }
+
+  virtual void set_matrix(const Handle<LSS::Matrix>& matrix) {}
+  virtual void set_rhs(const Handle<LSS::Vector>& rhs) {}
+  virtual void set_solution(const Handle<LSS::Vector>& solution) {}
+  virtual void solve() {}
+  virtual Real compute_residual() { return 0.; }
+  virtual Uint iterations() const { return nb_iterations; }
+
+  /// Number of iterations reported for the next solve
+  Uint nb_iterations;
+};
+
+ComponentBuilder < CountingStrategy, LSS::SolutionStrategy, LSS::LibLSS > CountingStrategy_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( LSSActionUnsteadyHistorySuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( RowPerSolve )
+{
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+
+  Component& root = Core::instance().root();
+
+  // Linear system without a backend, as in utest-lss-solvelss
+  Handle<LSS::System> lss = root.create_component<LSS::System>("LSS");
+  PE::CommPattern& cp = *root.create_component<PE::CommPattern>("commpattern");
+  std::vector<Uint> gid, conn, startidx, rnk;
+  gid += 0,1,2,3;
+  rnk += 0,0,0,0;
+  conn += 0,1,1,2,2,3,3,0;
+  startidx += 0,2,4,6,8;
+  cp.insert("gid",gid,1,false);
+  cp.setup(cp.get_child("gid")->handle<PE::CommWrapper>(),rnk);
+  lss->options().set("matrix_builder", std::string("cf3.math.LSS.EmptyLSSMatrix"));
+  lss->options().set("solution_strategy", std::string("cf3.math.LSS.CountingStrategy"));
+  lss->create(cp, 1u, conn, startidx);
+  CountingStrategy& strategy = dynamic_cast<CountingStrategy&>(*lss->solution_strategy());
+
+  Handle<solver::Time> time = root.create_component<solver::Time>("Time");
+  Handle<solver::History> history = root.create_component<solver::History>("History");
+  history->options().set("dimension", 1u);
+  history->options().set("logging", false);
+
+  UFEM::LSSActionUnsteady& action = *root.create_component<UFEM::LSSActionUnsteady>("action");
+  LSS::SolveLSS& solve = *action.create_component<LSS::SolveLSS>("SolveLSS");
+  action.options().set("lss", lss);
+  action.options().set("time", time);
+  action.options().set("history", history);
+
+  // Step 0 has a single solve
+  strategy.nb_iterations = 3;
+  action.execute();
+  BOOST_CHECK_EQUAL(solve.options().value<Uint>("step"), 0u);
+  BOOST_CHECK_EQUAL(history->table()->size(), 1u);
+
+  // Step 1 has two solves, each saved right away with the sum over the step so far
+  time->iter() = 1;
+  time->current_time() = 0.5;
+  strategy.nb_iterations = 2;
+  action.execute();
+  BOOST_CHECK_EQUAL(solve.options().value<Uint>("step"), 1u);
+  BOOST_CHECK_EQUAL(history->table()->size(), 2u);
+  strategy.nb_iterations = 4;
+  action.execute();
+
+  // Columns in the order they were set: iteration, time, action_iterations
+  const Table<Real>& table = *history->table();
+  BOOST_REQUIRE_EQUAL(table.size(), 3u);
+  BOOST_REQUIRE_EQUAL(table.row_size(), 3u);
+
+  BOOST_CHECK_EQUAL(table[0][0], 0.);
+  BOOST_CHECK_EQUAL(table[0][2], 3.);
+
+  BOOST_CHECK_EQUAL(table[1][0], 1.);
+  BOOST_CHECK_EQUAL(table[1][1], 0.5);
+  BOOST_CHECK_EQUAL(table[1][2], 2.);
+
+  BOOST_CHECK_EQUAL(table[2][0], 1.);
+  BOOST_CHECK_EQUAL(table[2][2], 6.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
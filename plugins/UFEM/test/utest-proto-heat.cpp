@@ -17,12 +17,16 @@
 
 #include "common/Core.hpp"
 #include "common/Environment.hpp"
+#include "common/Log.hpp"
+#include "common/Timer.hpp"
 
+#include "math/LSS/SolutionStrategy.hpp"
 #include "math/LSS/System.hpp"
 
 #include "mesh/Domain.hpp"
 
 #include "mesh/LagrangeP1/Line1D.hpp"
+#include "mesh/LagrangeP1/Quad2D.hpp"
 #include "solver/Model.hpp"
 
 #include "math/LSS/SolveLSS.hpp"
@@ -62,6 +66,73 @@ check_close(const Real a, const Real b, const Real threshold)
 
 static boost::proto::terminal< void(*)(Real, Real, Real) >::type const _check_close = {&check_close};
 
+/// Solve steady heat conduction on a square of quadrilaterals with the given solution strategy,
+/// checking the result against the linear analytical solution. Returns the norm of the final linear system
+/// residual, and the wall clock time of the simulation in elapsed.
+Real solve_heat_2d(Component& root, const std::string& name, const std::string& solution_strategy, Real& elapsed)
+{
+  const Real length = 5.;
+  const Uint nb_segments = 64;
+
+  Model& model = *root.create_component<Model>(name);
+  Domain& domain = model.create_domain("Domain");
+  UFEM::Solver& solver = *model.create_component<UFEM::Solver>("Solver");
+
+  Handle<UFEM::LSSAction> lss_action(solver.add_direct_solver("cf3.UFEM.LSSAction"));
+
+  FieldVariable<0, ScalarField> temperature("Temperature", UFEM::Tags::solution());
+
+  boost::mpl::vector1<mesh::LagrangeP1::Quad2D> allowed_elements;
+
+  boost::shared_ptr<UFEM::BoundaryConditions> bc = allocate_component<UFEM::BoundaryConditions>("BoundaryConditions");
+
+  *lss_action
+    << create_proto_action
+    (
+      "Assembly",
+      elements_expression
+      (
+        allowed_elements,
+        group
+        (
+          _A = _0,
+          element_quadrature( _A(temperature) += transpose(nabla(temperature)) * nabla(temperature) ),
+          lss_action->system_matrix += _A
+        )
+      )
+    )
+    << bc
+    << allocate_component<math::LSS::SolveLSS>("SolveLSS")
+    << create_proto_action("Increment", nodes_expression(temperature += lss_action->solution(temperature)))
+    << create_proto_action("CheckResult", nodes_expression(_check_close(temperature, 10. + 25.*(coordinates(0,0) / length), 1e-6)));
+
+  model.create_physics("cf3.UFEM.NavierStokesPhysics");
+
+  boost::shared_ptr<MeshGenerator> create_square = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","create_square");
+  create_square->options().set("mesh",domain.uri()/"Mesh");
+  create_square->options().set("lengths",std::vector<Real>(DIM_2D, length));
+  create_square->options().set("nb_cells",std::vector<Uint>(DIM_2D, nb_segments));
+  Mesh& mesh = create_square->generate();
+
+  lss_action->options().set("regions", std::vector<URI>(1, mesh.topology().uri()));
+
+  // The mixed precision strategy needs a CRS matrix, so both runs use the same matrix type
+  math::LSS::System& lss = lss_action->create_lss("cf3.math.LSS.TrilinosCrsMatrix", solution_strategy);
+
+  bc->add_constant_bc("left", "Temperature", 10.);
+  bc->add_constant_bc("right", "Temperature", 35.);
+
+  Timer timer;
+  model.simulate();
+  elapsed = timer.elapsed();
+
+  const Real residual = lss.solution_strategy()->compute_residual();
+  CFinfo << solution_strategy << ": residual " << residual << ", simulation time " << elapsed << " s" << CFendl;
+
+  root.remove_component(model);
+  return residual;
+}
+
 struct ProtoHeatFixture
 {
   ProtoHeatFixture() :
@@ -148,6 +219,21 @@ BOOST_AUTO_TEST_CASE( Heat1DComponent )
   model.simulate();
 }
 
+BOOST_AUTO_TEST_CASE( Heat2DMixedPrecision )
+{
+  Core::instance().environment().options().set("log_level", 3u);
+
+  Real double_time, mixed_time;
+  const Real double_residual = solve_heat_2d(root, "DoubleModel", "cf3.math.LSS.TrilinosStratimikosStrategy", double_time);
+  const Real mixed_residual = solve_heat_2d(root, "MixedModel", "cf3.math.LSS.MixedPrecisionStrategy", mixed_time);
+
+  // Both runs reproduce the analytical solution (checked in solve_heat_2d), and the single precision
+  // preconditioner must not leave a larger residual than the double precision solve
+  BOOST_CHECK_LT(mixed_residual, 10.*double_residual + 1e-10);
+
+  CFinfo << "Mixed precision / double precision simulation time: " << mixed_time / double_time << CFendl;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,13 +4,23 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <cmath>
+
+#include <boost/bind.hpp>
+
 #include "common/Builder.hpp"
 #include "common/OptionList.hpp"
 #include "common/PE/Comm.hpp"
 
+#include "common/PropertyList.hpp"
+#include "common/Foreach.hpp"
+
 #include "mesh/Field.hpp"
 #include "mesh/FieldManager.hpp"
 #include "mesh/Mesh.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
 
 #include "solver/Time.hpp"
 #include "solver/Model.hpp"
@@ -38,7 +48,8 @@ common::ComponentBuilder < ComputeUpdateCoefficient, common::Action, LibSDM > Co
 
 ComputeUpdateCoefficient::ComputeUpdateCoefficient ( const std::string& name ) :
   solver::Action(name),
-  m_tolerance(1e-12)
+  m_tolerance(1e-12),
+  m_initial_residual_norm(0.)
 {
   mark_basic();
   // options
@@ -54,6 +65,34 @@ ComputeUpdateCoefficient::ComputeUpdateCoefficient ( const std::string& name ) :
     .mark_basic()
     .add_tag("cfl");
 
+  options().add("cell_time_step", false)
+    .description("For local time stepping, use the smallest time step of the solution points in a cell for the whole cell")
+    .pretty_name("Cell Time Step")
+    .mark_basic();
+
+  options().add("adaptive_cfl", false)
+    .description("For local time stepping, increase the CFL number as the residual drops:\n"
+                 "  cfl * (|R_0|/|R|)^cfl_exponent, limited by cfl_max")
+    .pretty_name("Adaptive CFL")
+    .mark_basic()
+    .attach_trigger(boost::bind(&ComputeUpdateCoefficient::reset_initial_residual_norm, this));
+
+  options().add("cfl_max", 100.)
+    .description("Maximum CFL number reached with adaptive_cfl")
+    .pretty_name("Maximum CFL");
+
+  options().add("cfl_exponent", 1.)
+    .description("Exponent of the residual drop in the CFL number with adaptive_cfl")
+    .pretty_name("CFL Exponent");
+
+  options().add(sdm::Tags::residual(), m_residual)
+    .description("Residual, used for the adaptive CFL number")
+    .pretty_name("Residual")
+    .link_to(&m_residual)
+    .attach_trigger(boost::bind(&ComputeUpdateCoefficient::reset_initial_residual_norm, this));
+
+  properties().add("cfl", 1.);
+
   options().add(sdm::Tags::update_coeff(), m_update_coeff)
     .description("Update coefficient to multiply with residual")
     .pretty_name("Update Coefficient")
@@ -137,6 +176,8 @@ void ComputeUpdateCoefficient::execute()
   {
     if (is_not_null(m_time))  m_time->dt() = 0.;
 
+    cfl = local_cfl(cfl);
+
     // Calculate the update_coefficient = CFL/wave_speed
     RealVector ws(wave_speed.row_size());
     for (Uint i=0; i<wave_speed.size(); ++i)
@@ -144,7 +185,70 @@ void ComputeUpdateCoefficient::execute()
       if (wave_speed[i][0] > 0)
         update_coeff[i][0] = cfl/wave_speed[i][0];
     }
+
+    // Use the most restrictive update coefficient of each cell for all its solution points
+    if (options().value<bool>("cell_time_step"))
+    {
+      boost_foreach(const Handle<Entities>& elements, update_coeff.entities_range())
+      {
+        if ( is_null(elements->handle<Cells>()) ) continue;
+        const Connectivity& connectivity = update_coeff.space(*elements).connectivity();
+        for (Uint elem=0; elem<elements->size(); ++elem)
+        {
+          Real cell_coeff = real_max();
+          boost_foreach(const Uint pt, connectivity[elem])
+            cell_coeff = std::min(cell_coeff, update_coeff[pt][0]);
+          boost_foreach(const Uint pt, connectivity[elem])
+            update_coeff[pt][0] = cell_coeff;
+        }
+      }
+    }
   }
+  properties()["cfl"] = cfl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Real ComputeUpdateCoefficient::local_cfl(const Real& cfl)
+{
+  if ( ! options().value<bool>("adaptive_cfl") )
+    return cfl;
+
+  if( is_null( m_residual ) )
+  {
+    m_residual = Handle<Field>( follow_link( solver().field_manager().get_child( sdm::Tags::residual() ) ) );
+    options().set( sdm::Tags::residual(), m_residual );
+  }
+
+  // Switched evolution relaxation (SER), based on the L2 norm of the residual
+  const Field& residual = *m_residual;
+  Real local_norm = 0.;
+  for (Uint i=0; i<residual.size(); ++i)
+  {
+    if (residual.is_ghost(i)) continue;
+    for (Uint var=0; var<residual.row_size(); ++var)
+      local_norm += residual[i][var]*residual[i][var];
+  }
+  Real norm = local_norm;
+  if (PE::Comm::instance().is_active())
+    PE::Comm::instance().all_reduce(PE::plus(), &local_norm, 1, &norm);
+  norm = std::sqrt(norm);
+
+  // The reference norm is taken again when the iterations are restarted
+  if (m_initial_residual_norm == 0. || (is_not_null(m_time) && m_time->iter() == 0))
+    m_initial_residual_norm = norm;
+  if (norm == 0.)
+    return options().value<Real>("cfl_max");
+
+  const Real ser_cfl = cfl * std::pow(m_initial_residual_norm/norm, options().value<Real>("cfl_exponent"));
+  return std::max(cfl, std::min(options().value<Real>("cfl_max"), ser_cfl));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ComputeUpdateCoefficient::reset_initial_residual_norm()
+{
+  m_initial_residual_norm = 0.;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
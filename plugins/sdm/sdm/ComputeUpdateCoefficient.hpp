@@ -44,13 +44,24 @@ private: // helper functions
 
   Real limit_end_time(const Real& time, const Real& end_time);
   void link_fields();
+
+  /// CFL number for local time stepping, increased as the residual drops if adaptive_cfl is on
+  Real local_cfl(const Real& cfl);
+
+  /// Take the reference residual norm of the adaptive CFL again at the next execution
+  void reset_initial_residual_norm();
+
 private: // data
 
   Handle<mesh::Field> m_update_coeff;
   Handle<mesh::Field> m_wave_speed;
+  Handle<mesh::Field> m_residual;
   Handle<solver::Time> m_time;
 
   Real m_tolerance;
+
+  /// Residual norm at the first iteration with adaptive CFL
+  Real m_initial_residual_norm;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
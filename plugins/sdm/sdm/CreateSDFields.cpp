@@ -71,7 +71,7 @@ void CreateSDFields::execute()
 //  mesh().check_sanity();
   const Uint solution_order = solver().options().option(sdm::Tags::solution_order()).value<Uint>();
 
-  std::string solution_space_name = "solution_space";
+  const std::string solution_space_name = solver().options().value<std::string>(sdm::Tags::solution_space());
 //  std::string boundary_space_name = "boundary_space";
 
   if ( is_not_null (find_component_ptr_recursively_with_tag<Dictionary>(mesh(),solution_space_name)))
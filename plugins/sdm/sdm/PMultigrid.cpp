@@ -0,0 +1,467 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <cmath>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/ActionDirector.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Group.hpp"
+#include "common/Link.hpp"
+
+#include "math/Consts.hpp"
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/Field.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/FieldManager.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Connectivity.hpp"
+
+#include "physics/PhysModel.hpp"
+
+#include "solver/Time.hpp"
+
+#include "sdm/PMultigrid.hpp"
+#include "sdm/SDSolver.hpp"
+#include "sdm/Tags.hpp"
+#include "sdm/Term.hpp"
+#include "sdm/BC.hpp"
+#include "sdm/LagrangeLocally1D.hpp"
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+
+namespace cf3 {
+namespace sdm {
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < PMultigrid, common::Action, LibSDM > PMultigrid_Builder;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+/// Adds the FAS forcing term to the residual of a coarse level
+class AddForcing : public common::Action
+{
+public:
+  AddForcing(const std::string& name) : common::Action(name) {}
+  static std::string type_name() { return "AddForcing"; }
+
+  virtual void execute()
+  {
+    Field& R = *residual;
+    const Field& f = *forcing;
+    for (Uint i=0; i<R.size(); ++i)
+    {
+      for (Uint var=0; var<R.row_size(); ++var)
+      {
+        R[i][var] += f[i][var];
+      }
+    }
+  }
+
+  Handle<Field> residual;
+  Handle<Field> forcing;
+};
+
+/// Copy the options holding plain values (numbers, strings and arrays of those) from one component
+/// to another that has options with the same name. Options that already have the same value are
+/// not set, and the copy is done twice because options with triggers may modify other options.
+void copy_value_options(const Component& from, Component& to)
+{
+  for (Uint pass=0; pass<2; ++pass)
+  {
+    for (OptionList::const_iterator it=from.options().begin(); it!=from.options().end(); ++it)
+    {
+      const Option& option = *it->second;
+      if ( !to.options().check(option.name()) )
+        continue;
+
+      std::string type = option.type();
+      if (boost::starts_with(type,"array["))
+        type = type.substr(6,type.size()-7);
+      if (type != "real" && type != "integer" && type != "unsigned" && type != "bool" && type != "string")
+        continue;
+
+      if (to.options().option(option.name()).value_str() != option.value_str())
+        to.options().set(option.name(),option.value());
+    }
+  }
+}
+
+/// Index of a coordinate in a list of 1D points
+Uint index_1d(const Real coord, const RealVector& pts)
+{
+  for (Uint k=0; k<pts.size(); ++k)
+  {
+    if (std::abs(pts[k]-coord) < 1e-10)
+      return k;
+  }
+  throw common::ValueNotFound(FromHere(),"Coordinate "+to_str(coord)+" is not a 1D solution point");
+}
+
+} // detail
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+PMultigrid::PMultigrid ( const std::string& name ) :
+  IterativeSolver(name),
+  m_cycle_index(1)
+{
+  options().add("smoother", std::string("cf3.sdm.ExplicitRungeKuttaLowStorage2"))
+      .description("Iterative solver used to smooth every level")
+      .pretty_name("Smoother")
+      .attach_trigger( boost::bind( &PMultigrid::config_smoother, this ) )
+      .mark_basic();
+
+  options().add("cycle", std::string("V"))
+      .description("Multigrid cycle: V or W")
+      .pretty_name("Cycle")
+      .attach_trigger( boost::bind( &PMultigrid::config_cycle, this ) )
+      .mark_basic();
+
+  options().add("pre_smoothing", 1u)
+      .description("Number of smoothing iterations before going to a coarser level")
+      .pretty_name("Pre-smoothing")
+      .mark_basic();
+
+  options().add("post_smoothing", 1u)
+      .description("Number of smoothing iterations after the correction from a coarser level")
+      .pretty_name("Post-smoothing")
+      .mark_basic();
+
+  options().add("coarse_smoothing", 2u)
+      .description("Number of smoothing iterations on the coarsest level")
+      .pretty_name("Coarse smoothing")
+      .mark_basic();
+
+  options().add("coarsest_order", 1u)
+      .description("Solution order of the coarsest level (1 is a piecewise constant solution)")
+      .pretty_name("Coarsest order")
+      .mark_basic();
+
+  config_smoother();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void PMultigrid::config_smoother()
+{
+  if ( is_not_null(m_smoother) )
+  {
+    remove_component(*m_smoother);
+  }
+  m_smoother = create_component("Smoother",options().value<std::string>("smoother"))->handle<IterativeSolver>();
+  if ( is_null(m_smoother) )
+    throw SetupError(FromHere(), "Smoother "+options().value<std::string>("smoother")+" is not an sdm IterativeSolver");
+
+  m_smoother->pre_update().add_link(pre_update());
+  m_smoother->post_update().add_link(post_update());
+  if ( is_not_null(m_solver) )
+    m_smoother->configure_option_recursively(sdm::Tags::solver(), m_solver);
+
+  // coarse levels have to be created again with the new smoother
+  m_levels.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void PMultigrid::config_cycle()
+{
+  const std::string cycle = options().value<std::string>("cycle");
+  if (cycle == "V")
+    m_cycle_index = 1;
+  else if (cycle == "W")
+    m_cycle_index = 2;
+  else
+    throw BadValue(FromHere(), "Multigrid cycle must be V or W, not "+cycle);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void PMultigrid::setup_levels()
+{
+  SDSolver& fine = *solver().handle<SDSolver>();
+  const Uint fine_order = fine.options().value<Uint>(sdm::Tags::solution_order());
+  const Uint coarsest_order = options().value<Uint>("coarsest_order");
+  if (coarsest_order == 0 || coarsest_order > fine_order)
+    throw BadValue(FromHere(), "coarsest_order must be between 1 and the solution order "+to_str(fine_order));
+
+  m_levels.assign(1+fine_order-coarsest_order, Level());
+  m_levels[0].solver   = fine.handle<SDSolver>();
+  m_levels[0].smoother = m_smoother;
+  m_levels[0].solution = m_solution;
+  m_levels[0].residual = m_residual;
+
+  if (m_levels.size() == 1)
+    return;
+
+  // The coarse solvers are kept out of the fine solver, to avoid that its configuration is propagated to them
+  Component& parent = *fine.parent();
+  const std::string group_name = fine.name()+"_PMultigrid";
+  if ( is_not_null(parent.get_child(group_name)) )
+    parent.remove_component(group_name);
+  m_coarse_solvers = parent.create_component<Group>(group_name);
+
+  for (Uint l=1; l<m_levels.size(); ++l)
+  {
+    const Uint order = fine_order - l;
+    Level& level = m_levels[l];
+    Level& finer = m_levels[l-1];
+
+    SDSolver& coarse = *m_coarse_solvers->create_component<SDSolver>("P"+to_str(order-1));
+    coarse.options().set(sdm::Tags::physical_model(), physical_model().handle<physics::PhysModel>());
+    coarse.options().set(sdm::Tags::solution_vars(), fine.options().value<std::string>(sdm::Tags::solution_vars()));
+    coarse.options().set(sdm::Tags::solution_order(), order);
+    coarse.options().set(sdm::Tags::solution_space(), std::string(sdm::Tags::solution_space())+"_P"+to_str(order-1));
+    coarse.options().set("iterative_solver", options().value<std::string>("smoother"));
+    coarse.options().set(sdm::Tags::mesh(), fine.mesh().handle<Mesh>());
+    coarse.options().set(sdm::Tags::regions(), fine.options().value< std::vector<URI> >(sdm::Tags::regions()));
+
+    // The faces and connectivities were already built for the fine solver
+    coarse.prepare_mesh().remove_component("build_inner_faces");
+    coarse.prepare_mesh().execute();
+
+    boost_foreach(Term& term, find_components<Term>(*fine.domain_discretization().get_child("Terms")))
+    {
+      Term& coarse_term = coarse.domain_discretization().create_term(term.derived_type_name(), term.name(),
+                                                                      term.options().value< std::vector<URI> >(sdm::Tags::regions()));
+      detail::copy_value_options(term, coarse_term);
+    }
+    boost_foreach(BC& bc, find_components<BC>(*fine.boundary_conditions().get_child("BCs")))
+    {
+      BC& coarse_bc = coarse.boundary_conditions().create_boundary_condition(bc.derived_type_name(), bc.name(),
+                                                                             bc.options().value< std::vector<URI> >(sdm::Tags::regions()));
+      detail::copy_value_options(bc, coarse_bc);
+    }
+    detail::copy_value_options(*m_smoother, coarse.iterative_solver());
+
+    level.solver   = coarse.handle<SDSolver>();
+    level.smoother = coarse.iterative_solver().handle<IterativeSolver>();
+    level.solution = follow_link( coarse.field_manager().get_child(sdm::Tags::solution()) )->handle<Field>();
+    level.residual = follow_link( coarse.field_manager().get_child(sdm::Tags::residual()) )->handle<Field>();
+
+    Dictionary& solution_space = level.solution->dict();
+    level.initial_solution = solution_space.create_field("fas_initial_solution", level.solution->descriptor().description()).handle<Field>();
+    level.initial_solution->descriptor().prefix_variable_names("initial_");
+    level.forcing = solution_space.create_field("fas_forcing", level.solution->descriptor().description()).handle<Field>();
+    level.forcing->descriptor().prefix_variable_names("forcing_");
+
+    // The forcing term is added after the domain discretization computed the residual
+    Handle<detail::AddForcing> add_forcing = level.smoother->pre_update().create_component<detail::AddForcing>("AddForcing");
+    add_forcing->residual = level.residual;
+    add_forcing->forcing = level.forcing;
+
+    boost_foreach(const Handle<Entities>& elements, level.solution->entities_range())
+    {
+      if ( is_null(elements->handle<Cells>()) ) continue;
+      const Uint shape = elements->element_type().shape();
+      if (level.restriction.count(shape)) continue;
+
+      const ShapeFunction& coarse_sf = *level.solution->space(*elements).shape_function().handle<ShapeFunction>();
+      const ShapeFunction& fine_sf   = *finer.solution->space(*elements).shape_function().handle<ShapeFunction>();
+      level.restriction[shape]  = transfer_operator(fine_sf, coarse_sf);
+      level.prolongation[shape] = transfer_operator(coarse_sf, fine_sf);
+    }
+
+    CFinfo << "Created p-multigrid level " << l << " with solution order " << order << CFendl;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+RealMatrix PMultigrid::transfer_operator(const ShapeFunction& from, const ShapeFunction& to)
+{
+  if (from.shape() != GeoShape::LINE && from.shape() != GeoShape::QUAD && from.shape() != GeoShape::HEXA)
+    throw NotSupported(FromHere(), "p-multigrid is only implemented for tensor-product elements, not for "+from.derived_type_name());
+
+  const Locally_1d from_1d(from.order());
+  const Locally_1d to_1d(to.order());
+
+  // Lagrange polynomials through the 1D "from" points, evaluated in the 1D "to" points
+  RealMatrix operator_1d(to_1d.nb_sol_pts, from_1d.nb_sol_pts);
+  for (Uint i=0; i<to_1d.nb_sol_pts; ++i)
+  {
+    for (Uint j=0; j<from_1d.nb_sol_pts; ++j)
+    {
+      operator_1d(i,j) = Lagrange::coeff(to_1d.sol_pts[i], from_1d.sol_pts, j);
+    }
+  }
+
+  // Tensor product of the 1D operator, looking up the 1D index of every solution point in each direction
+  RealMatrix element_operator(to.nb_sol_pts(), from.nb_sol_pts());
+  for (Uint i=0; i<to.nb_sol_pts(); ++i)
+  {
+    for (Uint j=0; j<from.nb_sol_pts(); ++j)
+    {
+      element_operator(i,j) = 1.;
+      for (Uint d=0; d<from.dimensionality(); ++d)
+      {
+        element_operator(i,j) *= operator_1d( detail::index_1d(to.sol_pts()(i,d), to_1d.sol_pts),
+                                              detail::index_1d(from.sol_pts()(j,d), from_1d.sol_pts) );
+      }
+    }
+  }
+  return element_operator;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void PMultigrid::transfer(const std::map<Uint,RealMatrix>& operators, const Field& from, Field& to, const bool add)
+{
+  const Uint nb_vars = from.row_size();
+  RealMatrix from_values;
+  RealMatrix to_values;
+  boost_foreach(const Handle<Entities>& elements_handle, to.entities_range())
+  {
+    const Entities& elements = *elements_handle;
+    if ( is_null(elements.handle<Cells>()) ) continue;
+
+    const RealMatrix& element_operator = operators.find(elements.element_type().shape())->second;
+    const Connectivity& from_connectivity = from.space(elements).connectivity();
+    const Connectivity& to_connectivity = to.space(elements).connectivity();
+    from_values.resize(element_operator.cols(), nb_vars);
+    to_values.resize(element_operator.rows(), nb_vars);
+
+    for (Uint e=0; e<elements.size(); ++e)
+    {
+      for (Uint j=0; j<element_operator.cols(); ++j)
+      {
+        for (Uint var=0; var<nb_vars; ++var)
+          from_values(j,var) = from[from_connectivity[e][j]][var];
+      }
+
+      to_values.noalias() = element_operator*from_values;
+
+      for (Uint i=0; i<element_operator.rows(); ++i)
+      {
+        const Uint pt = to_connectivity[e][i];
+        for (Uint var=0; var<nb_vars; ++var)
+        {
+          if (add)
+            to[pt][var] += to_values(i,var);
+          else
+            to[pt][var] = to_values(i,var);
+        }
+      }
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void PMultigrid::smooth(const Uint level, const Uint nb_iterations)
+{
+  for (Uint iter=0; iter<nb_iterations; ++iter)
+    m_levels[level].smoother->execute();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void PMultigrid::cycle(const Uint l)
+{
+  Level& level = m_levels[l];
+
+  if (l+1 == m_levels.size())
+  {
+    smooth(l, options().value<Uint>("coarse_smoothing"));
+    return;
+  }
+
+  smooth(l, options().value<Uint>("pre_smoothing"));
+
+  Level& coarse = m_levels[l+1];
+  Field& u_c  = *coarse.solution;
+  Field& u0_c = *coarse.initial_solution;
+  Field& R_c  = *coarse.residual;
+  Field& f_c  = *coarse.forcing;
+
+  // Residual of this level, including its forcing term
+  level.smoother->pre_update().execute();
+
+  // Restrict the solution, and compute the coarse residual without forcing
+  transfer(coarse.restriction, *level.solution, u_c);
+  coarse.smoother->post_update().execute();
+  u0_c = u_c;
+  f_c = 0.;
+  coarse.smoother->pre_update().execute();
+
+  // f_c = I(R + f) - R_c(I u)
+  transfer(coarse.restriction, *level.residual, f_c);
+  for (Uint i=0; i<f_c.size(); ++i)
+  {
+    for (Uint var=0; var<f_c.row_size(); ++var)
+      f_c[i][var] -= R_c[i][var];
+  }
+
+  for (Uint visit=0; visit<m_cycle_index; ++visit)
+    cycle(l+1);
+
+  // Prolongate the coarse correction u_c - u0_c
+  for (Uint i=0; i<u0_c.size(); ++i)
+  {
+    for (Uint var=0; var<u0_c.row_size(); ++var)
+      u0_c[i][var] = u_c[i][var] - u0_c[i][var];
+  }
+  transfer(coarse.prolongation, u0_c, *level.solution, true);
+  level.smoother->post_update().execute();
+  level.solution->synchronize();
+
+  smooth(l, options().value<Uint>("post_smoothing"));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void PMultigrid::execute()
+{
+  configure_option_recursively( "iterator", handle<Component>() );
+
+  link_fields();
+
+  if (is_null(m_time))        throw SetupError(FromHere(), "Time was not set");
+
+  Component& fine_update_coeff = *solver().handle<SDSolver>()->actions().get_child("compute_update_coefficient");
+  if (fine_update_coeff.options().value<bool>("time_accurate"))
+    throw SetupError(FromHere(), "p-multigrid only accelerates convergence to steady state, set TimeStepping.time_accurate to false");
+
+  if (m_levels.empty())
+    setup_levels();
+
+  // The coarse levels use the same local time stepping as the finest level.
+  // The forcing term makes the coarse residual vanish, so it cannot drive an adaptive CFL number.
+  for (Uint l=1; l<m_levels.size(); ++l)
+  {
+    Component& update_coeff = *m_levels[l].solver->actions().get_child("compute_update_coefficient");
+    detail::copy_value_options(fine_update_coeff, update_coeff);
+    update_coeff.options().set("adaptive_cfl", false);
+    update_coeff.options().set(sdm::Tags::time(), m_time);
+    m_levels[l].smoother->options().set(sdm::Tags::time(), m_time);
+  }
+
+  properties().property("iteration") = 1u;
+
+  cycle(0);
+
+  raise_iteration_done();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // sdm
+} // cf3
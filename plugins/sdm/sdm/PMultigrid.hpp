@@ -0,0 +1,123 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_sdm_PMultigrid_hpp
+#define cf3_sdm_PMultigrid_hpp
+
+#include "math/MatrixTypes.hpp"
+
+#include "sdm/IterativeSolver.hpp"
+
+namespace cf3 {
+namespace common { class Group; }
+namespace sdm {
+
+class SDSolver;
+class ShapeFunction;
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+/// p-multigrid acceleration for steady state computations, using the Full Approximation Scheme (FAS)
+///
+/// The levels all use the same mesh, and differ only in the solution order:
+/// the finest level is the solver this iterative solver belongs to, and every coarser level
+/// is an SDSolver of one order less, down to the "coarsest_order".
+/// The coarse solvers are created on first execution, copying the terms and boundary conditions
+/// of the fine solver. They are placed in a group next to the fine solver, so they are not
+/// reconfigured by the fine solver and not executed by the model.
+///
+/// Every level is smoothed by an iterative solver of type "smoother" (one of the explicit Runge-Kutta
+/// schemes). Solution and residual are restricted by interpolating the fine polynomial in the coarse
+/// solution points, and the coarse correction is prolongated by interpolating the coarse polynomial
+/// in the fine solution points. The element transfer operators are built once per element shape
+/// from the 1D Lagrange polynomials of both orders.
+/// On a coarse level H, the smoother solves @f$ R_H(u_H) + f_H = 0 @f$, with the forcing term
+/// @f[ f_H = I_h^H ( R_h(u_h) + f_h ) - R_H(I_h^H u_h) @f]
+/// The recursion is visited once (V-cycle) or twice (W-cycle) per level.
+/// @note Only for local time stepping (TimeStepping.time_accurate = false)
+class sdm_API PMultigrid : public IterativeSolver {
+
+public: // functions
+
+  /// Contructor
+  /// @param name of the component
+  PMultigrid ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~PMultigrid() {}
+
+  /// Get the class name
+  static std::string type_name () { return "PMultigrid"; }
+
+  /// execute one multigrid cycle
+  virtual void execute ();
+
+  /// @return the smoother of the finest level
+  IterativeSolver& smoother() { return *m_smoother; }
+
+private: // functions
+
+  /// Triggered when the smoother option is configured
+  void config_smoother();
+
+  /// Triggered when the cycle option is configured
+  void config_cycle();
+
+  /// Create the coarse solvers and the transfer operators
+  void setup_levels();
+
+  /// Perform a multigrid cycle starting at the given level
+  void cycle(const Uint level);
+
+  /// Apply the smoother of the given level a number of times
+  void smooth(const Uint level, const Uint nb_iterations);
+
+  /// Interpolate the values of a field on one level to another level, for all cells.
+  /// @param [in]  operators  transfer operator per element shape
+  /// @param [in]  from       field on the source level
+  /// @param [out] to         field on the target level
+  /// @param [in]  add        add to the values of the target field instead of overwriting them
+  void transfer(const std::map<Uint,RealMatrix>& operators, const mesh::Field& from, mesh::Field& to, const bool add = false);
+
+  /// Build the operator interpolating the polynomial defined in the solution points of one
+  /// shape function to the solution points of another
+  static RealMatrix transfer_operator(const ShapeFunction& from, const ShapeFunction& to);
+
+private: // data
+
+  /// Data of one multigrid level
+  struct Level
+  {
+    Handle<SDSolver>        solver;            ///< solver of this level
+    Handle<IterativeSolver> smoother;          ///< smoother of this level
+    Handle<mesh::Field>     solution;          ///< solution of this level
+    Handle<mesh::Field>     residual;          ///< residual of this level
+    Handle<mesh::Field>     initial_solution;  ///< restricted solution, before smoothing on this level
+    Handle<mesh::Field>     forcing;           ///< FAS forcing term, added to the residual
+    std::map<Uint,RealMatrix> restriction;     ///< per element shape, from the next finer level to this level
+    std::map<Uint,RealMatrix> prolongation;    ///< per element shape, from this level to the next finer level
+  };
+
+  /// Smoother of the finest level
+  Handle<IterativeSolver> m_smoother;
+
+  /// Group containing the coarse solvers
+  Handle<common::Group> m_coarse_solvers;
+
+  /// Levels, ordered from fine to coarse
+  std::vector<Level> m_levels;
+
+  /// Number of recursive visits of the next coarser level (1 = V-cycle, 2 = W-cycle)
+  Uint m_cycle_index;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+
+} // sdm
+} // cf3
+
+#endif // cf3_sdm_PMultigrid_hpp
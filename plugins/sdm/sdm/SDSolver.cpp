@@ -75,6 +75,10 @@ SDSolver::SDSolver ( const std::string& name  ) :
       .description("Setting this will create the appropriate spaces in the mesh")
       .mark_basic();
 
+  options().add( sdm::Tags::solution_space(), std::string(sdm::Tags::solution_space()) )
+      .pretty_name("Solution Space")
+      .description("Name of the dictionary holding the solution fields. Solvers sharing a mesh need different names");
+
   options().add(sdm::Tags::mesh(), m_mesh)
       .description("Mesh the Discretization Method will be applied to")
       .pretty_name("Mesh")
@@ -154,7 +158,7 @@ void SDSolver::execute()
   m_boundary_conditions->execute();
   // Start time stepping
   m_time_stepping->execute();
-  Component& solution_space = *mesh().get_child("solution_space");
+  Component& solution_space = *mesh().get_child(options().value<std::string>(sdm::Tags::solution_space()));
   boost_foreach(mesh::Field& field,  find_components_recursively<Field>(solution_space))
     field.synchronize();
 }
@@ -300,7 +304,7 @@ void SDSolver::signal_add_probe(common::SignalArgs& args)
   XML::SignalOptions sig_opts(args);
 
   Handle<Probe> probe = time_stepping().post_actions().create_component<Probe>(sig_opts.value<std::string>("name"));
-  probe->options().set("dict",mesh().access_component("solution_space"));
+  probe->options().set("dict",mesh().access_component(options().value<std::string>(sdm::Tags::solution_space())));
   probe->options().set("coordinate",sig_opts.array<Real>("coordinate"));
   std::vector<std::string> functions = sig_opts.array<std::string>("functions");
   boost_foreach(const std::string& function, functions)
@@ -0,0 +1,249 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <map>
+
+#include "common/Foreach.hpp"
+#include "common/Builder.hpp"
+#include "common/OptionList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "math/Defs.hpp"
+#include "math/VariablesDescriptor.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/FieldManager.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementConnectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+
+#include "solver/Solver.hpp"
+
+#include "sdm/SmoothResidual.hpp"
+#include "sdm/Tags.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+namespace cf3 {
+namespace sdm {
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < SmoothResidual, common::Action, LibSDM > SmoothResidual_Builder;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+SmoothResidual::SmoothResidual ( const std::string& name ) :
+  solver::Action(name)
+{
+  mark_basic();
+
+  // options
+
+  options().add("smoothing_coefficient", 0.5)
+     .description("Smoothing coefficient epsilon. Typically the CFL number can be increased by a factor\n"
+                  "sqrt(1+4*epsilon) in 1D.")
+     .pretty_name("Smoothing Coefficient")
+     .mark_basic();
+
+  options().add("nb_iterations", 2u)
+     .description("Number of Jacobi iterations to solve the smoothing system")
+     .pretty_name("Number of Iterations")
+     .mark_basic();
+
+  options().add(sdm::Tags::residual(), m_residual)
+     .description("Residual to smooth")
+     .pretty_name("Residual")
+     .link_to(&m_residual);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SmoothResidual::execute()
+{
+  link_fields();
+
+  if (m_point_offsets.empty())
+    build_cell_graph();
+
+  Field& residual = *m_residual;
+  const Real eps = options().value<Real>("smoothing_coefficient");
+  const Uint nb_iterations = options().value<Uint>("nb_iterations");
+  const Uint nb_vars = residual.row_size();
+  const Uint nb_cells = m_point_offsets.size()-1;
+
+  // Cell averages of the residual, only computed on the owned cells
+  std::vector<Real> average(nb_cells*nb_vars,0.);
+  for (Uint c=0; c<nb_cells; ++c)
+  {
+    const Uint begin = m_point_offsets[c];
+    const Uint end   = m_point_offsets[c+1];
+    if (m_ghost_cells[c] || begin == end) continue;
+    for (Uint p=begin; p<end; ++p)
+      for (Uint var=0; var<nb_vars; ++var)
+        average[c*nb_vars+var] += residual[m_points[p]][var];
+    for (Uint var=0; var<nb_vars; ++var)
+      average[c*nb_vars+var] /= static_cast<Real>(end-begin);
+  }
+  synchronize_cells(average);
+
+  // Jacobi iterations for (1 + eps*nb_neighbours) smoothed_c - eps * sum(smoothed_n) = average_c
+  std::vector<Real> smoothed(average);
+  std::vector<Real> previous(average.size());
+  for (Uint iter=0; iter<nb_iterations; ++iter)
+  {
+    previous.swap(smoothed);
+    for (Uint c=0; c<nb_cells; ++c)
+    {
+      if (m_ghost_cells[c])
+        continue;
+      const Uint begin = m_neighbour_offsets[c];
+      const Uint end   = m_neighbour_offsets[c+1];
+      const Real diag  = 1. + eps*static_cast<Real>(end-begin);
+      for (Uint var=0; var<nb_vars; ++var)
+      {
+        Real sum = 0.;
+        for (Uint n=begin; n<end; ++n)
+          sum += previous[m_neighbours[n]*nb_vars+var];
+        smoothed[c*nb_vars+var] = (average[c*nb_vars+var] + eps*sum)/diag;
+      }
+    }
+    synchronize_cells(smoothed);
+  }
+
+  // Replace the cell averages by the smoothed averages. Ghost cells are left untouched.
+  for (Uint c=0; c<nb_cells; ++c)
+  {
+    if (m_ghost_cells[c])
+      continue;
+    for (Uint p=m_point_offsets[c]; p<m_point_offsets[c+1]; ++p)
+      for (Uint var=0; var<nb_vars; ++var)
+        residual[m_points[p]][var] += smoothed[c*nb_vars+var] - average[c*nb_vars+var];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SmoothResidual::synchronize_cells(std::vector<Real>& cell_values)
+{
+  if ( ! PE::Comm::instance().is_active() || PE::Comm::instance().size() == 1 )
+    return;
+
+  Field& transfer = *m_cell_values;
+  const Uint nb_vars = transfer.row_size();
+  const Uint nb_cells = m_point_offsets.size()-1;
+  for (Uint c=0; c<nb_cells; ++c)
+  {
+    if (m_ghost_cells[c]) continue;
+    for (Uint p=m_point_offsets[c]; p<m_point_offsets[c+1]; ++p)
+      for (Uint var=0; var<nb_vars; ++var)
+        transfer[m_points[p]][var] = cell_values[c*nb_vars+var];
+  }
+
+  transfer.synchronize();
+
+  for (Uint c=0; c<nb_cells; ++c)
+  {
+    if (!m_ghost_cells[c] || m_point_offsets[c] == m_point_offsets[c+1]) continue;
+    const Uint pt = m_points[m_point_offsets[c]];
+    for (Uint var=0; var<nb_vars; ++var)
+      cell_values[c*nb_vars+var] = transfer[pt][var];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SmoothResidual::build_cell_graph()
+{
+  const Field& residual = *m_residual;
+
+  // Number all cells contiguously
+  std::map<const Entities*,Uint> cell_offset;
+  Uint nb_cells = 0;
+  boost_foreach(const Handle<Entities>& elements, residual.entities_range())
+  {
+    if ( is_null(elements->handle<Cells>()) ) continue;
+    cell_offset[elements.get()] = nb_cells;
+    nb_cells += elements->size();
+  }
+
+  m_point_offsets.assign(1,0u);
+  m_neighbour_offsets.assign(1,0u);
+  m_points.clear();
+  m_neighbours.clear();
+  m_ghost_cells.clear();
+  m_point_offsets.reserve(nb_cells+1);
+  m_neighbour_offsets.reserve(nb_cells+1);
+  m_ghost_cells.reserve(nb_cells);
+
+  boost_foreach(const Handle<Entities>& elements, residual.entities_range())
+  {
+    if ( is_null(elements->handle<Cells>()) ) continue;
+    const Connectivity& connectivity = residual.space(*elements).connectivity();
+    const Handle<ElementConnectivity>& cell2face = elements->connectivity_cell2face();
+    for (Uint elem=0; elem<elements->size(); ++elem)
+    {
+      boost_foreach(const Uint pt, connectivity[elem])
+        m_points.push_back(pt);
+
+      // The values of ghost cells are received from their owner, so only owned cells need their neighbours
+      const bool ghost = residual.is_ghost(connectivity[elem][0]);
+      m_ghost_cells.push_back(ghost);
+      if ( ! ghost && is_not_null(cell2face) )
+      {
+        boost_foreach(const Entity& face, (*cell2face)[elem])
+        {
+          if ( is_null(face.comp) ) continue;
+          const FaceCellConnectivity& face2cell = *face.comp->connectivity_face2cell();
+          if ( face2cell.is_bdry_face()[face.idx] ) continue;
+          const Entity& left  = face2cell.connectivity()[face.idx][LEFT];
+          const Entity& right = face2cell.connectivity()[face.idx][RIGHT];
+          const Entity& neighbour = (left.comp == elements.get() && left.idx == elem) ? right : left;
+          std::map<const Entities*,Uint>::const_iterator it = cell_offset.find(neighbour.comp);
+          if ( it == cell_offset.end() ) continue;
+          m_neighbours.push_back(it->second + neighbour.idx);
+        }
+      }
+      m_point_offsets.push_back(m_points.size());
+      m_neighbour_offsets.push_back(m_neighbours.size());
+    }
+  }
+
+  // Field to exchange the cell values between CPUs
+  Dictionary& dict = m_residual->dict();
+  m_cell_values = Handle<Field>(dict.get_child("smoothed_residual_average"));
+  if ( is_null(m_cell_values) )
+  {
+    m_cell_values = dict.create_field("smoothed_residual_average", residual.descriptor().description()).handle<Field>();
+    if ( PE::Comm::instance().is_active() )
+      m_cell_values->parallelize();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SmoothResidual::link_fields()
+{
+  if( is_null( m_residual ) )
+  {
+    m_residual = Handle<Field>( follow_link( solver().field_manager()
+        .get_child( sdm::Tags::residual() ) ) );
+    options().set( sdm::Tags::residual(), m_residual->uri() );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
+} // sdm
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,79 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_sdm_SmoothResidual_hpp
+#define cf3_sdm_SmoothResidual_hpp
+
+#include "solver/Action.hpp"
+#include "sdm/LibSDM.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh   { class Field; }
+namespace sdm {
+
+/// Implicit residual smoothing, to allow larger CFL numbers for steady computations.
+///
+/// The cell averages of the residual @f$ \bar{R} @f$ are smoothed by solving
+/// @f[ \tilde{R}_c - \epsilon \sum_{n \in N(c)} ( \tilde{R}_n - \tilde{R}_c ) = \bar{R}_c @f]
+/// over the graph of cells connected by faces, with a few Jacobi iterations.
+/// The difference between smoothed and original average is added to every solution point of the cell,
+/// so the variation of the residual within a cell is left unchanged.
+/// The cell graph is built once, on the first execution. Ghost cells are part of the graph, and their
+/// values are synchronized after every Jacobi iteration, so the result does not depend on the partitioning.
+/// Add this action to the PreUpdate of the iterative solver, after the domain discretization.
+class sdm_API SmoothResidual : public solver::Action
+{
+public: // functions
+  /// Contructor
+  /// @param name of the component
+  SmoothResidual ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~SmoothResidual() {};
+
+  /// Get the class name
+  static std::string type_name () { return "SmoothResidual"; }
+
+  /// execute the action
+  virtual void execute ();
+
+private: // functions
+
+  void link_fields();
+
+  /// Build the solution points and neighbours of every cell
+  void build_cell_graph();
+
+  /// Copy the values of the owned cells to the ghost cells on other CPUs
+  void synchronize_cells(std::vector<Real>& cell_values);
+
+private: // data
+
+  Handle<mesh::Field> m_residual;
+
+  /// Field used to communicate cell values, with the value of a cell in each of its solution points
+  Handle<mesh::Field> m_cell_values;
+
+  /// Solution points of cell c are m_points[m_point_offsets[c]] to m_points[m_point_offsets[c+1]-1]
+  std::vector<Uint> m_point_offsets;
+  std::vector<Uint> m_points;
+  /// Neighbours of cell c are m_neighbours[m_neighbour_offsets[c]] to m_neighbours[m_neighbour_offsets[c+1]-1]
+  std::vector<Uint> m_neighbour_offsets;
+  std::vector<Uint> m_neighbours;
+  /// True for the cells that are owned by another CPU
+  std::vector<bool> m_ghost_cells;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // sdm
+} // cf3
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_sdm_SmoothResidual_hpp
@@ -16,6 +16,7 @@ const char * Tags::actions()        { return "actions"; }
 const char * Tags::solution_vars()  { return "solution_vars"; }
 const char * Tags::input_vars()     { return "input_vars"; }
 const char * Tags::solution_order() { return "solution_order"; }
+const char * Tags::solution_space() { return "solution_space"; }
 
 const char * Tags::solution()       { return "solution"; }
 const char * Tags::wave_speed()     { return "wave_speed"; }
@@ -24,6 +24,7 @@ struct sdm_API Tags : public solver::Tags
   static const char * solution_vars();
   static const char * input_vars();
   static const char * solution_order();
+  static const char * solution_space();
 
   static const char * solution();
   static const char * wave_speed();
@@ -155,6 +155,9 @@ void TimeStepping::execute()
 
     ActionDirector::execute();
 
+    // the CFL number may have been adapted by the local time stepping
+    cfl = solver().handle<SDSolver>()->actions().get_child("compute_update_coefficient")->properties().value<Real>("cfl");
+
     // advance time & iteration
 
     m_time->current_time() += m_time->dt();
@@ -0,0 +1,106 @@
+import sys
+import coolfluid
+
+# The cf root component
+root = coolfluid.Core.root()
+env =  coolfluid.Core.environment()
+
+### Logging configuration
+env.options().set('assertion_backtrace', True)
+env.options().set('exception_backtrace', True)
+env.options().set('regist_signal_handlers', True)
+env.options().set('exception_log_level', 10)
+env.options().set('log_level', 3)
+env.options().set('exception_outputs', True)
+
+############################
+# Create simulation
+############################
+model   = root.create_component('linear_advection_pmultigrid_2d','cf3.solver.Model');
+solver  = model.create_solver('cf3.sdm.SDSolver')
+physics = model.create_physics('cf3.physics.Scalar.Scalar2D')
+domain  = model.create_domain()
+
+###### Following generates a square mesh
+mesh = domain.create_component('mesh','cf3.mesh.Mesh')
+mesh_generator = domain.create_component("mesh_generator","cf3.mesh.SimpleMeshGenerator")
+mesh_generator.options().set("mesh",mesh.uri())
+mesh_generator.options().set("nb_cells",[10,10])
+mesh_generator.options().set("lengths",[1,1])
+mesh_generator.options().set("offsets",[0,0])
+mesh_generator.execute()
+#####
+
+### Configure solver
+solver.options().set('mesh',mesh)
+solver.options().set('solution_vars','cf3.physics.Scalar.LinearAdv2D')
+solver.options().set('solution_order',3)
+solver.options().set('iterative_solver','cf3.sdm.PMultigrid')
+
+### Configure the p-multigrid cycle, P2 -> P1 -> P0
+multigrid = solver.access_component('TimeStepping/IterativeSolver')
+multigrid.options().set('cycle','V')
+multigrid.options().set('pre_smoothing',1)
+multigrid.options().set('post_smoothing',1)
+multigrid.options().set('coarse_smoothing',2)
+multigrid.access_component('Smoother').options().set('nb_stages',3)
+
+### Configure timestepping, steady state with local time stepping
+solver.access_component('TimeStepping').options().set('time_accurate',False);
+solver.access_component('TimeStepping').options().set('cfl','0.3');
+solver.access_component('TimeStepping').options().set('max_iteration',1);
+
+### Prepare the mesh for Spectral Difference (build faces and fields etc...)
+solver.get_child('PrepareMesh').execute()
+
+### Set the initial condition
+solver.get_child('InitialConditions').create_initial_condition( name = 'init')
+solver.get_child('InitialConditions').get_child('init').options().set("functions",['0'])
+solver.get_child('InitialConditions').execute();
+
+### Create convection term
+convection = solver.get_child('DomainDiscretization').create_term(name = 'convection', type = 'cf3.sdm.scalar.LinearAdvection2D')
+convection.options().set("advection_speed",[1,0.5])
+
+bc_inflow = solver.get_child('BoundaryConditions').create_boundary_condition(name= 'inflow', type = 'cf3.sdm.BCFunction<1,2>',
+regions=[
+mesh.access_component('topology/left').uri(),
+mesh.access_component('topology/bottom').uri()
+])
+bc_inflow.options().set('functions',['sin(2*pi*(y-0.5*x))'])
+
+bc_outflow = solver.get_child('BoundaryConditions').create_boundary_condition(name= 'outflow', type = 'cf3.sdm.BCExtrapolate<1,2>',
+regions=[
+mesh.access_component('topology/right').uri(),
+mesh.access_component('topology/top').uri()
+])
+
+#######################################
+# SIMULATE
+#######################################
+model.simulate()
+initial_norm = solver.access_component('actions/L2norm').properties()['norms'][0]
+
+solver.access_component('TimeStepping').options().set('max_iteration',40);
+model.simulate()
+final_norm = solver.access_component('actions/L2norm').properties()['norms'][0]
+
+print 'residual norm after 1 cycle:', initial_norm, ', after 40 cycles:', final_norm
+if final_norm > 1e-2 * initial_norm:
+  raise Exception('p-multigrid did not converge')
+
+########################
+# OUTPUT
+########################
+
+fields = [
+mesh.access_component("solution_space/solution").uri(),
+]
+
+# gmsh
+######
+gmsh_writer = model.create_component("writer","cf3.mesh.gmsh.Writer")
+gmsh_writer.options().set("mesh",mesh)
+gmsh_writer.options().set("fields",fields)
+gmsh_writer.options().set("file",coolfluid.URI("file:sdm_output_pmultigrid.msh"))
+gmsh_writer.execute()
@@ -10,9 +10,11 @@
 
 #include "common/Builder.hpp"
 #include "common/Signal.hpp"
+#include "common/StringConversion.hpp"
 #include "common/XML/Protocol.hpp"
 #include "common/XML/MultiArray.hpp"
 #include "ui/uicommon/ComponentNames.hpp"
+#include "ui/core/NetworkQueue.hpp"
 #include "ui/core/TreeThread.hpp"
 #include "ui/graphics/TabBuilder.hpp"
 #include "ui/QwtTab/Graph.hpp"
@@ -47,6 +49,11 @@ NPlotXY::NPlotXY(const std::string & name) :
       .description("Lists convergence history")
       .pretty_name("Get history");
 
+  regist_signal( "update_history" )
+      .connect( boost::bind( &NPlotXY::update_history, this, _1 ) )
+      .description("Requests the new rows of the convergence history")
+      .pretty_name("Update history");
+
   regist_signal("show_hide_plot")
       .connect( boost::bind( &NPlotXY::show_hide_plot, this, _1) )
       .description("Shows or hides the plot tab")
@@ -57,7 +64,7 @@ NPlotXY::NPlotXY(const std::string & name) :
       .description("Activates the tab")
       .pretty_name("Switch to tab");
 
-  m_local_signals << "show_hide_plot" << "go_to_tab";
+  m_local_signals << "show_hide_plot" << "go_to_tab" << "update_history";
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -111,8 +118,29 @@ void NPlotXY::convergence_history ( SignalArgs& node )
 
   get_multi_array(options.main_map, "Table", *array, labels);
 
-  int nbRows = array->size();
-  int nbCols = (*array)[0].size();
+  Uint first_row = 0;
+  if( options.main_map.check_entry("first_row") )
+    first_row = options.main_map.get_value<Uint>("first_row");
+
+  // append the new rows if they continue the stored history, replace it otherwise
+  if( first_row == 0 || first_row != m_history.size() || (array->size() != 0 && (*array)[0].size() != m_history[0].size()) )
+  {
+    m_history.resize( boost::extents[array->size()][array->size() != 0 ? (*array)[0].size() : 0] );
+    m_history = *array;
+  }
+  else if( array->size() != 0 )
+  {
+    const Uint nb_known = m_history.size();
+    m_history.resize( boost::extents[nb_known + array->size()][m_history[0].size()] );
+    for(PlotData::index row = 0; row != array->size(); ++row)
+      m_history[nb_known + row] = (*array)[row];
+  }
+
+  if( m_history.size() == 0 )
+    return;
+
+  int nbRows = m_history.size();
+  int nbCols = m_history[0].size();
   std::vector<QString> fct_label(labels.size() + 1);
 
   fct_label[0] = "#";
@@ -137,7 +165,7 @@ void NPlotXY::convergence_history ( SignalArgs& node )
   for(PlotData::index row = 0; row != nbRows; ++row)
   {
     for(PlotData::index col = 0; col != nbCols; ++col)
-      (*plot)[row][col+1] = (*array)[row][col];
+      (*plot)[row][col+1] = m_history[row][col];
   }
 
   TabBuilder::instance()->widget<Graph>(handle<CNode>())->set_xy_data(plot, fct_label);
@@ -145,6 +173,17 @@ void NPlotXY::convergence_history ( SignalArgs& node )
 
 //////////////////////////////////////////////////////////////////////////////
 
+void NPlotXY::update_history ( SignalArgs& node )
+{
+  SignalFrame frame("convergence_history", uri(), uri());
+
+  frame.map( Protocol::Tags::key_options() ).set_option("first_row", common::class_name<Uint>(), to_str(Uint(m_history.size())));
+
+  core::NetworkQueue::global()->send( frame, core::NetworkQueue::IMMEDIATE );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 } // Core
 } // ui
 } // cf3
@@ -45,8 +45,13 @@ public:
 
   virtual QString tool_tip() const;
 
+  /// Stores the rows received from the server and shows them in the plot.
+  /// Rows that continue the stored history are appended to it.
   void convergence_history ( common::SignalArgs& node );
 
+  /// Requests the rows of the history that were not received yet.
+  void update_history ( common::SignalArgs& node );
+
   void show_hide_plot( common::SignalArgs& node );
 
   void go_to_plot( common::SignalArgs& node );
@@ -60,6 +65,11 @@ protected:
 
   virtual void setup_finished();
 
+private:
+
+  /// The rows received so far
+  PlotData m_history;
+
 }; //  XYPlot
 
 ////////////////////////////////////////////////////////////////////////////
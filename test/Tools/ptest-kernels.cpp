@@ -0,0 +1,472 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmarks the computational kernels on generated meshes"
+
+#include <set>
+
+#include <boost/assign/list_of.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/Table.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "common/PE/operations.hpp"
+
+#include "math/MatrixTypes.hpp"
+#include "math/LSS/System.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshTriangulator.hpp"
+#include "mesh/Octtree.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/ShapeFunction.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/LagrangeP1/Hexa3D.hpp"
+
+#include "solver/actions/Proto/ElementLooper.hpp"
+#include "solver/actions/Proto/Expression.hpp"
+#include "solver/actions/Proto/Functions.hpp"
+#include "solver/actions/Proto/Terminals.hpp"
+
+#include "Tools/Testing/BenchmarkReport.hpp"
+#include "Tools/Testing/TimedTestFixture.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver::actions::Proto;
+using namespace cf3::Tools::Testing;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Command line arguments: number of hexahedra in each direction of the 3D mesh,
+/// name of the JSON report and (optionally) the LSS matrix builder
+struct KernelsFixture : TimedTestFixture
+{
+  KernelsFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  Uint nb_segments() const
+  {
+    return m_argc > 1 ? boost::lexical_cast<Uint>(m_argv[1]) : 16u;
+  }
+
+  std::string report_file() const
+  {
+    return m_argc > 2 ? std::string(m_argv[2]) : std::string("ptest-kernels.json");
+  }
+
+  std::string matrix_builder() const
+  {
+    return m_argc > 3 ? std::string(m_argv[3]) : std::string();
+  }
+
+  /// Unit square or cube, split into simplices if requested
+  Mesh& generate(const std::string& name, const Uint dim, const Uint nb_cells, const bool simplices)
+  {
+    Handle<SimpleMeshGenerator> mesh_gen = Core::instance().root().create_component<SimpleMeshGenerator>("generator_" + name);
+    mesh_gen->options().set("mesh",Core::instance().root().uri()/name);
+    mesh_gen->options().set("lengths",std::vector<Real>(dim,1.));
+    mesh_gen->options().set("nb_cells",std::vector<Uint>(dim,nb_cells));
+    Mesh& mesh = mesh_gen->generate();
+    if(simplices)
+      Core::instance().root().create_component<MeshTriangulator>("triangulator_" + name)->transform(mesh);
+    return mesh;
+  }
+
+  static Mesh& mesh(const std::string& name)
+  {
+    return *Core::instance().root().get_child(name)->handle<Mesh>();
+  }
+
+  /// Number of volume elements on this rank
+  static Uint nb_volume_elements(Mesh& mesh)
+  {
+    Uint nb_elems = 0;
+    boost_foreach(const Elements& elements, find_components_recursively_with_filter<Elements>(mesh.topology(), IsElementsVolume()))
+      nb_elems += elements.size();
+    return nb_elems;
+  }
+
+  /// Total size of the files in the given directory, counted on rank 0 only so the sum over the ranks is correct
+  static boost::uint64_t directory_size(const boost::filesystem::path& dir)
+  {
+    if(PE::Comm::instance().rank() != 0)
+      return 0;
+
+    boost::uint64_t nb_bytes = 0;
+    for(boost::filesystem::directory_iterator it(dir); it != boost::filesystem::directory_iterator(); ++it)
+    {
+      if(boost::filesystem::is_regular_file(it->status()))
+        nb_bytes += boost::filesystem::file_size(it->path());
+    }
+    return nb_bytes;
+  }
+
+  void benchmark_writer(const std::string& name, const std::string& filename)
+  {
+    Mesh& box = mesh("box");
+    const boost::filesystem::path dir("ptest-kernels-" + name);
+    if(PE::Comm::instance().rank() == 0)
+    {
+      boost::filesystem::remove_all(dir);
+      boost::filesystem::create_directories(dir);
+    }
+    PE::Comm::instance().barrier();
+
+    const std::vector<URI> fields(1, box.geometry_fields().get_child("sync")->uri());
+    restart_timer();
+    box.write_mesh(URI((dir / filename).string()), fields);
+    PE::Comm::instance().barrier();
+    const Real seconds = elapsed();
+
+    BenchmarkReport::instance().add("writer-" + name, seconds, nb_volume_elements(box), "elements", directory_size(dir));
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( KernelsSuite, KernelsFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(m_argc,m_argv);
+  PE::Comm::instance().init(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( CreateMeshes )
+{
+  const Uint n = nb_segments();
+
+  // The 2D meshes get about as many elements as the 3D ones
+  const Uint n_2d = static_cast<Uint>(std::sqrt(static_cast<Real>(n*n*n)));
+
+  generate("rect", 2, n_2d, false);
+  generate("rect_triag", 2, n_2d, true);
+  generate("box", 3, n, false);
+  generate("box_tetra", 3, n, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Shape function values, gradients and the Jacobian at the centroid of every element
+BOOST_AUTO_TEST_CASE( ShapeFunctions )
+{
+  const std::vector<std::string> meshes = boost::assign::list_of("rect")("rect_triag")("box")("box_tetra");
+  boost_foreach(const std::string& mesh_name, meshes)
+  {
+    boost_foreach(const Elements& elements, find_components_recursively_with_filter<Elements>(mesh(mesh_name).topology(), IsElementsVolume()))
+    {
+      const ElementType& etype = elements.element_type();
+      const ShapeFunction& sf = etype.shape_function();
+      const Space& space = elements.geometry_space();
+      const Uint nb_elems = elements.size();
+
+      const RealVector centroid = sf.local_coordinates().colwise().mean().transpose();
+      RealMatrix nodes;
+      space.allocate_coordinates(nodes);
+      RealRowVector values(sf.nb_nodes());
+      RealMatrix gradient(etype.dimensionality(), sf.nb_nodes());
+      RealMatrix jacobian(etype.dimensionality(), etype.dimension());
+
+      Real det_sum = 0.;
+      restart_timer();
+      for(Uint elem = 0; elem != nb_elems; ++elem)
+      {
+        space.put_coordinates(nodes, elem);
+        sf.compute_value(centroid, values);
+        sf.compute_gradient(centroid, gradient);
+        etype.compute_jacobian(centroid, nodes, jacobian);
+        det_sum += etype.jacobian_determinant(centroid, nodes);
+      }
+      const Real seconds = elapsed();
+
+      BenchmarkReport::instance().add("shape-function-" + etype.derived_type_name(), seconds, nb_elems, "elements",
+                                      static_cast<boost::uint64_t>(nb_elems) * nodes.size() * sizeof(Real));
+
+      // The meshes are affine, so the determinant times the reference volume sums to the domain volume
+      Real volume = det_sum * etype.volume(sf.local_coordinates());
+      if(PE::Comm::instance().is_active())
+      {
+        const Real local_volume = volume;
+        PE::Comm::instance().all_reduce(PE::plus(), &local_volume, 1, &volume);
+      }
+      BOOST_CHECK_CLOSE(volume, 1., 1e-8);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Element Laplacian matrices computed through a Proto expression
+BOOST_AUTO_TEST_CASE( ProtoAssembly )
+{
+  Mesh& box = mesh("box");
+  box.geometry_fields().create_field("T", "T").add_tag("kernels_solution");
+  FieldVariable<0, ScalarField> T("T", "kernels_solution");
+
+  typedef Eigen::Matrix<Real, 8, 8> ElementMatrixT;
+  ElementMatrixT total;
+  total.setZero();
+
+  restart_timer();
+  for_each_element< boost::mpl::vector1<LagrangeP1::Hexa3D> >
+  (
+    box.topology(),
+    group
+    (
+      _A = _0,
+      element_quadrature(_A(T) += transpose(nabla(T))*nabla(T)),
+      boost::proto::lit(total) += _A
+    )
+  );
+  const Real seconds = elapsed();
+
+  BenchmarkReport::instance().add("proto-laplacian-assembly", seconds, nb_volume_elements(box), "elements");
+
+  // The rows of a Laplacian sum to zero
+  for(Uint i = 0; i != 8; ++i)
+    BOOST_CHECK_SMALL(total.row(i).sum(), 1e-8);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Synchronize )
+{
+  Mesh& box = mesh("box");
+  Dictionary& geometry = box.geometry_fields();
+  Field& field = geometry.create_field("sync", "u[vector]");
+  field.parallelize();
+
+  const Uint my_rank = PE::Comm::instance().rank();
+  Uint nb_ghosts = 0;
+  for(Uint i = 0; i != geometry.size(); ++i)
+  {
+    const bool is_ghost = geometry.rank()[i] != my_rank;
+    if(is_ghost)
+      ++nb_ghosts;
+    for(Uint j = 0; j != field.row_size(); ++j)
+      field[i][j] = is_ghost ? -1. : static_cast<Real>(geometry.glb_idx()[i]);
+  }
+
+  const Uint nb_syncs = 10;
+  restart_timer();
+  for(Uint i = 0; i != nb_syncs; ++i)
+    field.synchronize();
+  const Real seconds = elapsed();
+
+  BenchmarkReport::instance().add("commpattern-synchronize", seconds, static_cast<boost::uint64_t>(nb_syncs)*geometry.size(), "nodes",
+                                  static_cast<boost::uint64_t>(nb_syncs)*nb_ghosts*field.row_size()*sizeof(Real));
+
+  for(Uint i = 0; i != geometry.size(); ++i)
+    BOOST_CHECK_EQUAL(field[i][0], static_cast<Real>(geometry.glb_idx()[i]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Assembly and solution of a shifted graph Laplacian with the matrix builder given on the command line
+BOOST_AUTO_TEST_CASE( LinearSystem )
+{
+  if(matrix_builder().empty())
+  {
+    CFinfo << "No matrix builder given, skipping the linear system benchmark" << CFendl;
+    return;
+  }
+
+  Mesh& box = mesh("box");
+  Dictionary& geometry = box.geometry_fields();
+  const Uint nb_nodes = geometry.size();
+  const Elements& elements = find_component_recursively_with_filter<Elements>(box.topology(), IsElementsVolume());
+  const Connectivity& connectivity = elements.geometry_space().connectivity();
+  const Uint nb_elems = elements.size();
+  const Uint nb_elem_nodes = connectivity.row_size();
+
+  // Node graph
+  std::vector< std::set<Uint> > node_neighbours(nb_nodes);
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    for(Uint i = 0; i != nb_elem_nodes; ++i)
+      node_neighbours[connectivity[elem][i]].insert(connectivity[elem].begin(), connectivity[elem].end());
+  }
+  std::vector<Uint> node_connectivity;
+  std::vector<Uint> starting_indices(1, 0);
+  starting_indices.reserve(nb_nodes+1);
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    node_connectivity.insert(node_connectivity.end(), node_neighbours[i].begin(), node_neighbours[i].end());
+    starting_indices.push_back(node_connectivity.size());
+  }
+
+  Handle<math::LSS::System> lss = Core::instance().root().create_component<math::LSS::System>("lss");
+  lss->options().option("matrix_builder").change_value(matrix_builder());
+  lss->create(geometry.comm_pattern(), 1, node_connectivity, starting_indices);
+  lss->reset();
+
+  math::LSS::BlockAccumulator block;
+  block.resize(nb_elem_nodes, 1);
+  block.mat.setConstant(-1.);
+  block.mat.diagonal().setConstant(nb_elem_nodes - 0.9);
+  block.rhs.setConstant(1.);
+  block.sol.setZero();
+
+  restart_timer();
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    block.neighbour_indices(connectivity[elem]);
+    lss->add_values(block);
+  }
+  const Real assembly_seconds = elapsed();
+  BenchmarkReport::instance().add("lss-assembly", assembly_seconds, nb_elems, "elements", static_cast<boost::uint64_t>(nb_elems)*block.mat.size()*sizeof(Real));
+
+  restart_timer();
+  lss->solve();
+  const Real solve_seconds = elapsed();
+  BenchmarkReport::instance().add("lss-solve", solve_seconds, node_connectivity.size(), "nonzeros", static_cast<boost::uint64_t>(node_connectivity.size())*(sizeof(Real)+sizeof(int)));
+
+  Core::instance().root().remove_component(*lss);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Point location of all element centroids
+BOOST_AUTO_TEST_CASE( OcttreeSearch )
+{
+  Mesh& box = mesh("box");
+  const Elements& elements = find_component_recursively_with_filter<Elements>(box.topology(), IsElementsVolume());
+  const Space& space = elements.geometry_space();
+  const Uint nb_elems = elements.size();
+
+  std::vector<RealVector> centroids(nb_elems);
+  RealMatrix nodes;
+  space.allocate_coordinates(nodes);
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    space.put_coordinates(nodes, elem);
+    centroids[elem] = nodes.colwise().mean().transpose();
+  }
+
+  Octtree& octtree = *box.create_component<Octtree>("octtree");
+  octtree.options().set("mesh", box.handle<Mesh>());
+
+  restart_timer();
+  octtree.create_octtree();
+  BenchmarkReport::instance().add("octtree-build", elapsed(), nb_elems, "elements");
+
+  Uint nb_found = 0;
+  Entity element;
+  restart_timer();
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    if(octtree.find_element(centroids[elem], element))
+      ++nb_found;
+  }
+  const Real seconds = elapsed();
+  BenchmarkReport::instance().add("octtree-search", seconds, nb_elems, "queries");
+
+  BOOST_CHECK_EQUAL(nb_found, nb_elems);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Writers )
+{
+  benchmark_writer("gmsh", "box.msh");
+  benchmark_writer("vtkxml", "box.pvtu");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Bulk building of a hexahedral connectivity table, as done by the mesh readers, through buffer chunks and through reserve()
+BOOST_AUTO_TEST_CASE( TableBuffers )
+{
+  const Uint nb_rows = nb_volume_elements(mesh("box"));
+  std::vector<Uint> row(8);
+  for(Uint use_reserve = 0; use_reserve != 2; ++use_reserve)
+  {
+    boost::shared_ptr< Table<Uint> > table = allocate_component< Table<Uint> >("table");
+    table->set_row_size(8);
+
+    restart_timer();
+    {
+      Table<Uint>::Buffer buffer = table->create_buffer();
+      if(use_reserve)
+        buffer.reserve(nb_rows);
+      for(Uint i = 0; i != nb_rows; ++i)
+      {
+        for(Uint j = 0; j != 8; ++j)
+          row[j] = i + j;
+        buffer.add_row(row);
+      }
+    }
+    const Real seconds = elapsed();
+
+    BenchmarkReport::instance().add(use_reserve ? "table-buffer-reserve" : "table-buffer-chunks", seconds, nb_rows, "rows", static_cast<boost::uint64_t>(nb_rows)*8*sizeof(Uint));
+    BOOST_CHECK_EQUAL(table->size(), nb_rows);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Must be last, since the faces are added to the mesh
+BOOST_AUTO_TEST_CASE( FaceConnectivity )
+{
+  Mesh& box = mesh("box");
+  const Uint n = nb_segments();
+
+  restart_timer();
+  Handle<FaceCellConnectivity> f2c = box.create_component<FaceCellConnectivity>("face_cell_connectivity");
+  f2c->setup(box.topology());
+  const Real seconds = elapsed();
+
+  BenchmarkReport::instance().add("face-cell-connectivity", seconds, nb_volume_elements(box), "elements");
+
+  if(PE::Comm::instance().size() == 1)
+    BOOST_CHECK_EQUAL(f2c->size(), 3*n*n*(n+1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  BenchmarkReport::instance().write_json(report_file());
+
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
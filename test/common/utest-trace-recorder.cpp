@@ -0,0 +1,227 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the execution timeline recorder"
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "common/ActionDirector.hpp"
+#include "common/Core.hpp"
+#include "common/TraceRecorder.hpp"
+#include "common/URI.hpp"
+
+#include "common/PE/Comm.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// Action that does some communication
+struct CommunicatingAction : Action
+{
+  CommunicatingAction(const std::string& name) : Action(name) {}
+  static std::string type_name () { return "CommunicatingAction"; }
+  virtual void execute()
+  {
+    const Uint local = 1;
+    Uint global = 0;
+    PE::Comm::instance().all_reduce(PE::plus(), &local, 1, &global);
+    BOOST_CHECK_EQUAL(global, PE::Comm::instance().size());
+  }
+};
+
+/// Record a number of events under the given name
+void record_events(const Uint nb_events, const std::string& name)
+{
+  for(Uint i = 0; i != nb_events; ++i)
+    TraceScope scope(name);
+}
+
+/// Intern new names and record an event for each, so the name table and the ring buffer keep changing
+void intern_and_record(const Uint nb_names)
+{
+  TraceRecorder& recorder = TraceRecorder::instance();
+  for(Uint i = 0; i != nb_names; ++i)
+    recorder.record(recorder.intern("concurrent_" + boost::lexical_cast<std::string>(i)), TraceRecorder::ACTION, 0., 1.);
+}
+
+BOOST_AUTO_TEST_SUITE( TraceRecorderSuite )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+}
+
+BOOST_AUTO_TEST_CASE( RingBuffer )
+{
+  TraceRecorder& recorder = TraceRecorder::instance();
+  recorder.enable(4);
+
+  const Uint name_id = recorder.intern("event");
+  BOOST_CHECK_EQUAL(recorder.intern("event"), name_id);
+  BOOST_CHECK_EQUAL(recorder.name(name_id), "event");
+
+  for(Uint i = 0; i != 6; ++i)
+    recorder.record(name_id, TraceRecorder::ACTION, Real(i), Real(i) + 0.5);
+
+  // Only the last 4 events are kept, oldest first
+  BOOST_CHECK_EQUAL(recorder.nb_events(), 4);
+  for(Uint i = 0; i != 4; ++i)
+  {
+    BOOST_CHECK_EQUAL(recorder.event(i).start, Real(i+2));
+    BOOST_CHECK_EQUAL(recorder.event(i).duration, 0.5);
+  }
+
+  recorder.clear();
+  BOOST_CHECK_EQUAL(recorder.nb_events(), 0);
+  recorder.disable();
+}
+
+BOOST_AUTO_TEST_CASE( Disabled )
+{
+  TraceRecorder& recorder = TraceRecorder::instance();
+  recorder.enable(16);
+  recorder.disable();
+  {
+    TraceScope scope("ignored");
+  }
+  BOOST_CHECK_EQUAL(recorder.nb_events(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( ActionTree )
+{
+  TraceRecorder& recorder = TraceRecorder::instance();
+
+  Component& root = Core::instance().root();
+  Handle<ActionDirector> director = root.create_component<ActionDirector>("director");
+  director->create_component<CommunicatingAction>("action1");
+  director->create_component<CommunicatingAction>("action2");
+
+  recorder.enable(64);
+  director->execute();
+  recorder.disable();
+
+  // Each action is recorded after the MPI call it contains has finished
+  BOOST_CHECK_EQUAL(recorder.nb_events(), 4);
+  BOOST_CHECK_EQUAL(recorder.event(0).category, (Uint)TraceRecorder::MPI);
+  const TraceRecorder::Event last = recorder.event(recorder.nb_events()-1);
+  BOOST_CHECK_EQUAL(recorder.name(last.name), "action2");
+  BOOST_CHECK_EQUAL(last.category, (Uint)TraceRecorder::ACTION);
+  BOOST_CHECK(last.duration >= 0.);
+
+  recorder.write_chrome_trace(URI("utest-trace-recorder.json", URI::Scheme::FILE));
+
+  if(PE::Comm::instance().rank() == 0)
+  {
+    std::ifstream trace_file("utest-trace-recorder.json");
+    std::stringstream trace;
+    trace << trace_file.rdbuf();
+    BOOST_CHECK(trace.str().find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK(trace.str().find("\"name\":\"action1\"") != std::string::npos);
+    BOOST_CHECK(trace.str().find("\"pid\":" + to_str(PE::Comm::instance().size()-1)) != std::string::npos);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( StartTime )
+{
+  TraceRecorder& recorder = TraceRecorder::instance();
+  recorder.enable(16);
+
+  // The enclosing event starts first but is recorded last
+  const Uint inner = recorder.intern("inner");
+  const Uint outer = recorder.intern("outer");
+  recorder.record(inner, TraceRecorder::ACTION, 20., 30.);
+  recorder.record(outer, TraceRecorder::ACTION, 10., 40.);
+  recorder.disable();
+
+  recorder.write_chrome_trace(URI("utest-trace-recorder-start.json", URI::Scheme::FILE));
+
+  if(PE::Comm::instance().rank() == 0)
+  {
+    std::ifstream trace_file("utest-trace-recorder-start.json");
+    std::stringstream trace;
+    trace << trace_file.rdbuf();
+    BOOST_CHECK(trace.str().find("\"name\":\"outer\",\"cat\":\"action\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":0.000,") != std::string::npos);
+    BOOST_CHECK(trace.str().find("\"name\":\"inner\",\"cat\":\"action\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":10.000,") != std::string::npos);
+    BOOST_CHECK(trace.str().find("\"ts\":-") == std::string::npos);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( Threads )
+{
+  TraceRecorder& recorder = TraceRecorder::instance();
+  recorder.enable(1024);
+
+  boost::thread helper(boost::bind(&record_events, 400, "helper"));
+  record_events(400, "main");
+  helper.join();
+  recorder.disable();
+
+  BOOST_CHECK_EQUAL(recorder.nb_events(), 800);
+  Uint nb_helper_events = 0;
+  for(Uint i = 0; i != recorder.nb_events(); ++i)
+  {
+    const TraceRecorder::Event evt = recorder.event(i);
+    if(recorder.name(evt.name) == "helper")
+    {
+      BOOST_CHECK_EQUAL(evt.thread, 1);
+      ++nb_helper_events;
+    }
+    else
+    {
+      BOOST_CHECK_EQUAL(evt.thread, 0);
+    }
+  }
+  BOOST_CHECK_EQUAL(nb_helper_events, 400);
+}
+
+BOOST_AUTO_TEST_CASE( ConcurrentReads )
+{
+  TraceRecorder& recorder = TraceRecorder::instance();
+  recorder.enable(64);
+  const Uint first = recorder.intern("first");
+  recorder.record(first, TraceRecorder::ACTION, 0., 1.);
+
+  // Names and events are read while the helper grows the name table and overwrites the ring buffer
+  boost::thread helper(boost::bind(&intern_and_record, 2000));
+  Uint nb_wrong = 0;
+  for(Uint i = 0; i != 2000; ++i)
+  {
+    if(recorder.name(first) != "first")
+      ++nb_wrong;
+    if(recorder.event(0).duration != 1.)
+      ++nb_wrong;
+  }
+  helper.join();
+  BOOST_CHECK_EQUAL(nb_wrong, 0);
+  BOOST_CHECK_EQUAL(recorder.nb_events(), 64);
+
+  recorder.disable();
+  BOOST_CHECK(!recorder.is_enabled());
+  recorder.disable();
+  BOOST_CHECK(!recorder.is_enabled());
+}
+
+BOOST_AUTO_TEST_CASE( Finalize )
+{
+  PE::Comm::instance().finalize();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,184 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for common::TreeJournal"
+
+#include <boost/test/unit_test.hpp>
+
+#include "rapidxml/rapidxml.hpp"
+
+#include "common/Core.hpp"
+#include "common/Group.hpp"
+#include "common/Link.hpp"
+#include "common/OptionT.hpp"
+#include "common/Signal.hpp"
+#include "common/TreeJournal.hpp"
+
+#include "common/XML/Protocol.hpp"
+#include "common/XML/SignalOptions.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::common::XML;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Lists the tree of the root with the given version and returns the reply
+SignalFrame list_tree(const Uint version, const Uint depth = 0)
+{
+  SignalOptions options;
+  options.add("version", version);
+  options.add("depth", depth);
+  SignalFrame frame = options.create_frame("list_tree", URI("cpath:/"), URI("cpath:/"));
+
+  Core::instance().root().signal_list_tree(frame);
+
+  return frame.get_reply();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( TreeJournalSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Disabled )
+{
+  TreeJournal& journal = TreeJournal::instance();
+  BOOST_CHECK(!journal.is_enabled());
+
+  // nothing is recorded until a UI server enables the journal
+  const Uint start = journal.version();
+  Core::instance().root().create_component<Group>("disabled_test");
+  BOOST_CHECK_EQUAL(journal.version(), start);
+  std::vector<TreeJournal::Change> changes;
+  BOOST_CHECK(!journal.changes_since(start, changes));
+
+  // versions from before enabling are unavailable
+  journal.set_enabled(true);
+  BOOST_CHECK(journal.is_enabled());
+  BOOST_CHECK(!journal.changes_since(start, changes));
+  BOOST_CHECK(journal.changes_since(journal.version(), changes));
+  BOOST_CHECK(changes.empty());
+
+  Core::instance().root().remove_component("disabled_test");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( RecordChanges )
+{
+  TreeJournal& journal = TreeJournal::instance();
+  const Uint start = journal.version();
+
+  // components outside of the tree are not recorded
+  boost::shared_ptr<Group> detached = allocate_component<Group>("detached");
+  detached->create_component<Group>("child");
+  BOOST_CHECK_EQUAL(journal.version(), start);
+
+  Group& group = *Core::instance().root().create_component<Group>("journal_test");
+  group.add_component(detached);
+  group.get_child("detached")->rename("attached");
+  group.remove_component("attached");
+
+  std::vector<TreeJournal::Change> changes;
+  BOOST_CHECK(journal.changes_since(start, changes));
+  BOOST_REQUIRE_EQUAL(changes.size(), 4u);
+  BOOST_CHECK_EQUAL(changes[0].type, TreeJournal::ADDED);
+  BOOST_CHECK_EQUAL(changes[0].path.path(), "/journal_test");
+  BOOST_CHECK_EQUAL(changes[1].type, TreeJournal::ADDED);
+  BOOST_CHECK_EQUAL(changes[2].type, TreeJournal::RENAMED);
+  BOOST_CHECK_EQUAL(changes[2].new_name, "attached");
+  BOOST_CHECK_EQUAL(changes[3].type, TreeJournal::REMOVED);
+  BOOST_CHECK_EQUAL(changes[3].path.path(), "/journal_test/attached");
+  BOOST_CHECK_EQUAL(changes[3].version, journal.version());
+
+  // the detached group was renamed and then removed
+  BOOST_CHECK(TreeJournal::path_after(changes, 1).empty());
+  BOOST_CHECK_EQUAL(TreeJournal::path_after(changes, 0).path(), "/journal_test");
+
+  // versions that are no longer covered by the journal
+  journal.set_capacity(2);
+  BOOST_CHECK(!journal.changes_since(start, changes));
+  BOOST_CHECK(journal.changes_since(journal.version() - 2, changes));
+  BOOST_CHECK(!journal.changes_since(journal.version() + 1, changes));
+  journal.set_capacity(10000);
+
+  Core::instance().root().remove_component("journal_test");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( LinkChanges )
+{
+  TreeJournal& journal = TreeJournal::instance();
+
+  Group& group = *Core::instance().root().create_component<Group>("link_test");
+  Link& link = *group.create_component<Link>("link");
+  const Uint start = journal.version();
+
+  link.link_to(group);
+
+  std::vector<TreeJournal::Change> changes;
+  BOOST_CHECK(journal.changes_since(start, changes));
+  BOOST_REQUIRE_EQUAL(changes.size(), 1u);
+  BOOST_CHECK_EQUAL(changes[0].type, TreeJournal::MODIFIED);
+  BOOST_CHECK_EQUAL(changes[0].path.path(), "/link_test/link");
+
+  Core::instance().root().remove_component("link_test");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ListTreeChanges )
+{
+  // full listing
+  SignalFrame full = list_tree(0);
+  BOOST_CHECK(is_not_null(full.main_map.content.content->first_node("node")));
+  BOOST_CHECK(is_null(full.main_map.content.content->first_node("changes")));
+  const Uint version = full.main_map.get_value<Uint>("version");
+  BOOST_CHECK_EQUAL(version, TreeJournal::instance().version());
+
+  Group& group = *Core::instance().root().create_component<Group>("delta_test");
+  group.create_component<Group>("first");
+  group.create_component<Group>("second")->rename("renamed");
+
+  // only the changes
+  SignalFrame delta = list_tree(version);
+  BOOST_CHECK(is_null(delta.main_map.content.content->first_node("node")));
+  rapidxml::xml_node<>* changes = delta.main_map.content.content->first_node("changes");
+  BOOST_REQUIRE(is_not_null(changes));
+  BOOST_CHECK_EQUAL(delta.main_map.get_value<Uint>("version"), TreeJournal::instance().version());
+
+  Uint nb_changes = 0;
+  for(rapidxml::xml_node<>* change = changes->first_node("change"); is_not_null(change); change = change->next_sibling("change"))
+    ++nb_changes;
+  BOOST_CHECK_EQUAL(nb_changes, 4u);
+
+  // the added group is listed with its current children
+  XmlNode first_change(changes->first_node("change"));
+  BOOST_CHECK_EQUAL(first_change.attribute_value("type"), "added");
+  BOOST_CHECK_EQUAL(first_change.attribute_value("path"), "cpath:/delta_test");
+  rapidxml::xml_node<>* added = first_change.content->first_node("node");
+  BOOST_REQUIRE(is_not_null(added));
+  XmlNode renamed_child(added->last_node("node"));
+  BOOST_CHECK_EQUAL(renamed_child.attribute_value("name"), "renamed");
+
+  // depth limited listing
+  SignalFrame shallow = list_tree(0, 1);
+  XmlNode root_node(shallow.main_map.content.content->first_node("node"));
+  BOOST_CHECK(is_null(root_node.content->first_node("node")));
+  BOOST_CHECK_EQUAL(root_node.attribute_value("expandable"), "true");
+
+  Core::instance().root().remove_component("delta_test");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
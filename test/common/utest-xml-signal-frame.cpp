@@ -11,13 +11,16 @@
 #include <boost/test/unit_test.hpp>
 
 #include "common/Log.hpp"
+#include "common/StringConversion.hpp"
 #include "common/URI.hpp"
 
 #include "common/XML/SignalFrame.hpp"
 #include "common/XML/Protocol.hpp"
 #include "common/XML/XmlDoc.hpp"
 #include "common/XML/FileOperations.hpp"
+#include "common/XML/MultiArray.hpp"
 
+using namespace cf3;
 using namespace cf3::common;
 using namespace cf3::common::XML;
 
@@ -104,6 +107,95 @@ BOOST_AUTO_TEST_CASE ( map )
 
 /////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE ( binary_attachments )
+{
+  URI sender("cpath:/sender");
+  URI receiver("cpath:/receiver");
+  SignalFrame frame ( "theTarget", sender, receiver);
+
+  boost::multi_array<Real, 2> table(boost::extents[4][3]);
+  for(Uint row = 0 ; row < 4 ; ++row)
+    for(Uint col = 0 ; col < 3 ; ++col)
+      table[row][col] = row * 10. + col + 0.125;
+
+  std::vector<std::string> labels;
+  labels.push_back("x");
+  labels.push_back("y");
+  labels.push_back("z");
+
+  add_binary_multi_array_in( frame.main_map, "Full", table, labels, false );
+  add_binary_multi_array_in( frame.main_map, "Tail", table, labels, true, 1 );
+
+  // the binary values are not part of the text
+  std::string text, attachments;
+  frame.flush_maps();
+  to_string( *frame.xml_doc, text, attachments );
+  BOOST_CHECK( !attachments.empty() );
+  BOOST_CHECK_EQUAL( text.find("0.125"), std::string::npos );
+
+  SignalFrame received( parse_string(text) );
+  BOOST_CHECK_EQUAL( attachments_size( *received.xml_doc ), attachments.size() );
+  read_attachments( *received.xml_doc, attachments.data(), attachments.size() );
+
+  boost::multi_array<Real, 2> full, tail;
+  std::vector<std::string> read_labels;
+
+  get_multi_array( received.main_map, "Full", full, read_labels );
+  BOOST_CHECK_EQUAL( read_labels.size(), 3u );
+  BOOST_CHECK_EQUAL( read_labels[2], std::string("z") );
+  BOOST_REQUIRE_EQUAL( full.size(), 4u );
+  BOOST_CHECK( full == table );
+
+  get_multi_array( received.main_map, "Tail", tail, read_labels );
+  BOOST_REQUIRE_EQUAL( tail.size(), 3u );
+  BOOST_REQUIRE_EQUAL( tail[0].size(), 3u );
+  BOOST_CHECK_EQUAL( tail[0][0], 10.125 );
+  BOOST_CHECK_EQUAL( tail[2][2], 32.125 );
+
+  // the original frame still holds its values
+  get_multi_array( frame.main_map, "Full", full, read_labels );
+  BOOST_CHECK( full == table );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE ( forged_attachment_sizes )
+{
+  SignalFrame frame ( "theTarget", URI("cpath:/sender"), URI("cpath:/receiver") );
+
+  boost::multi_array<Real, 2> table(boost::extents[2][1]);
+  table[0][0] = 1.;
+  table[1][0] = 2.;
+  std::vector<std::string> labels(1, "x");
+  add_binary_multi_array_in( frame.main_map, "Table", table, labels, false );
+
+  std::string text, attachments;
+  frame.flush_maps();
+  to_string( *frame.xml_doc, text, attachments );
+
+  const std::string size_attr = std::string(Protocol::Tags::attr_attachment()) + "=\"" + to_str( Uint(attachments.size()) ) + "\"";
+  const std::size_t size_pos = text.find(size_attr);
+  BOOST_REQUIRE( size_pos != std::string::npos );
+
+  // sizes beyond the received bytes are rejected, also when adding them to the offset would overflow
+  const char * forged_sizes[] = { "1000000000", "18446744073709551615" };
+  for( Uint i = 0 ; i < 2 ; ++i )
+  {
+    std::string forged_text = text;
+    forged_text.replace( size_pos, size_attr.size(), std::string(Protocol::Tags::attr_attachment()) + "=\"" + forged_sizes[i] + "\"" );
+
+    SignalFrame received( parse_string(forged_text) );
+    BOOST_CHECK_THROW( read_attachments( *received.xml_doc, attachments.data(), attachments.size() ), XmlError );
+  }
+
+  // so are attachments the document does not refer to
+  SignalFrame received( parse_string(text) );
+  const std::string longer = attachments + "extra";
+  BOOST_CHECK_THROW( read_attachments( *received.xml_doc, longer.data(), longer.size() ), XmlError );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /////////////////////////////////////////////////////////////////////////////
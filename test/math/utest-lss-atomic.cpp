@@ -101,6 +101,112 @@ struct LSSAtomicFixture
     sys.create(cp,neq,node_connectivity,starting_indices);
   }
 
+  /// Solve the reference system and compare with the result computed in octave
+  /// @param solution_strategy Builder name of the solution strategy, or empty for the default strategy without preconditioner
+  /// @param nb_solves Number of times the system is solved, starting from the same initial guess
+  void solve_reference_system(const std::string& solution_strategy, const int nb_solves)
+  {
+  // THE SERIAL IS EQUIVALENT WITH THE FOLLOWING OCTAVE/MATLAB CODE
+  // A =  [1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1]
+  // b =  [1; 1; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 10; 10]
+  // inv(A)*b
+  // WHICH RESULTS IN GID ORDER:
+
+    std::vector<Real> refvals(0);
+    refvals +=
+     1.00000000000000e+00,
+     1.00000000000000e+00,
+    -1.35789473684210e+01,
+    -1.35789473684210e+01,
+    -7.78947368421052e+00,
+    -7.78947368421052e+00,
+     9.68421052631579e+00,
+     9.68421052631579e+00,
+     1.26315789473684e+01,
+     1.26315789473684e+01,
+    -3.36842105263158e+00,
+    -3.36842105263158e+00,
+    -1.43157894736842e+01,
+    -1.43157894736842e+01,
+    -3.78947368421053e+00,
+    -3.78947368421052e+00,
+     1.24210526315789e+01,
+     1.24210526315789e+01,
+     1.00000000000000e+01,
+     1.00000000000000e+01;
+
+    // commpattern
+    if (irank==0)
+    {
+      gid += 0,1,2,3,4;
+      rank_updatable += 0,0,0,0,1;
+    } else {
+      gid += 3,4,5,6,7,8,9;
+      rank_updatable += 0,1,1,1,1,1,1;
+    }
+    boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
+    common::PE::CommPattern& cp = *cp_ptr;
+    cp.insert("gid",gid,1,false);
+    cp.setup(Handle<common::PE::CommWrapper>(cp.get_child("gid")),rank_updatable);
+
+    // lss
+    if (irank==0)
+    {
+      node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4;
+      starting_indices += 0,2,5,8,11,13;
+    } else {
+      node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4,5,4,5,6,5,6;
+      starting_indices +=  0,2,5,8,11,14,17,19;
+    }
+    boost::shared_ptr<System> sys(common::allocate_component<System>("sys"));
+    sys->options().option("matrix_builder").change_value(matrix_builder);
+    if (!solution_strategy.empty())
+      sys->options().option("solution_strategy").change_value(solution_strategy);
+    sys->create(cp,2,node_connectivity,starting_indices);
+
+    if (solution_strategy.empty())
+    {
+      sys->solution_strategy()->options().set("compute_residual", true);
+      sys->solution_strategy()->options().set("verbosity_level", 3);
+      sys->solution_strategy()->access_component("Parameters")->options().set("preconditioner_type", std::string("None"));
+      sys->solution_strategy()->access_component("Parameters/LinearSolverTypes/Belos/SolverTypes/BlockGMRES")->options().set("verbosity", 1);
+    }
+    else
+    {
+      sys->solution_strategy()->options().set("tolerance", 1e-12);
+    }
+
+    // set intital values and boundary conditions
+    sys->matrix()->reset(-0.5);
+    sys->solution()->reset(1.);
+    sys->rhs()->reset(0.);
+    if (irank==0)
+    {
+      std::vector<Real> diag(10,1.);
+      sys->set_diagonal(diag);
+      sys->dirichlet(0,0,1.);
+      sys->dirichlet(0,1,1.);
+    } else {
+      std::vector<Real> diag(14,1.);
+      sys->set_diagonal(diag);
+      sys->dirichlet(6,0,10.);
+      sys->dirichlet(6,1,10.);
+    }
+
+    // solve and check, again from the initial guess for the next solves with the same matrix
+    for (int solve_idx=0; solve_idx != nb_solves; ++solve_idx)
+    {
+      if (solve_idx != 0)
+        sys->solution()->reset(1.);
+      sys->solve();
+      std::vector<Real> vals;
+      sys->solution()->debug_data(vals);
+      for (int i=0; i<vals.size(); i++)
+        if (cp.isUpdatable()[i/neq])
+          BOOST_CHECK_CLOSE( vals[i], refvals[gid[i/neq]*neq], 1e-8);
+    }
+  }
+
   /// main solver selector
   std::string solvertype;
   std::string matrix_builder;
@@ -273,6 +379,67 @@ BOOST_AUTO_TEST_CASE( test_matrix_only )
 
 
 
+  // element access through the cached scatter maps gives the same result as add_values
+  if (irank==1)
+  {
+    LSS::BlockAccumulator ba, expected, result;
+    ba.resize(3,neq);
+    expected.resize(3,neq);
+    result.resize(3,neq);
+    ba.mat << 53., 54., 51., 52., 55., 56.,
+              59., 60., 57., 58., 61., 62.,
+              23., 24., 21., 22., 25., 26.,
+              29., 30., 27., 28., 31., 32.,
+              83., 84., 81., 82., 85., 86.,
+              89., 90., 87., 88., 91., 92.;
+    const Uint element_nodes[2][3] = { {5, 2, 8}, {3, 2, 7} };
+    for (Uint e=0; e<2; e++)
+    {
+      for (Uint i=0; i<3; i++) ba.indices[i]=element_nodes[e][i];
+      expected.indices = ba.indices;
+      result.indices = ba.indices;
+      mat->reset();
+      mat->add_values(ba);
+      mat->add_values(ba);
+      mat->get_values(expected);
+      mat->reset();
+      // the second call uses the cached map
+      mat->add_element_values(ba,*sys,e);
+      mat->add_element_values(ba,*sys,e);
+      mat->get_values(result);
+      for (int i=0; i<ba.mat.rows(); i++)
+        for (int j=0; j<ba.mat.cols(); j++)
+          BOOST_CHECK_EQUAL(result.mat(i,j),expected.mat(i,j));
+    }
+
+    // changed connectivity of an element that already has a map
+    for (Uint i=0; i<3; i++) ba.indices[i]=element_nodes[1][i];
+    expected.indices = ba.indices;
+    result.indices = ba.indices;
+    mat->reset();
+    mat->add_values(ba);
+    mat->get_values(expected);
+    mat->reset();
+    mat->add_element_values(ba,*sys,0);
+    mat->get_values(result);
+    for (int i=0; i<ba.mat.rows(); i++)
+      for (int j=0; j<ba.mat.cols(); j++)
+        BOOST_CHECK_EQUAL(result.mat(i,j),expected.mat(i,j));
+
+    // same result with the scatter maps disabled, as used for the before/after timings
+    if (mat->options().check("use_scatter_maps"))
+    {
+      mat->options().set("use_scatter_maps",false);
+      mat->reset();
+      mat->add_element_values(ba,*sys,0);
+      mat->get_values(result);
+      for (int i=0; i<ba.mat.rows(); i++)
+        for (int j=0; j<ba.mat.cols(); j++)
+          BOOST_CHECK_EQUAL(result.mat(i,j),expected.mat(i,j));
+      mat->options().set("use_scatter_maps",true);
+    }
+  }
+
   // performant access - out of range access does not fail
   mat->reset();
   if (irank==1)
@@ -869,93 +1036,16 @@ BOOST_AUTO_TEST_CASE( test_complete_system )
 
 BOOST_AUTO_TEST_CASE( solve_system )
 {
+  solve_reference_system("", 1);
+}
 
-// THE SERIAL IS EQUIVALENT WITH THE FOLLOWING OCTAVE/MATLAB CODE
-// A =  [1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5, 0, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, 1, -0.5, -0.5, -0.5; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -0.5, -0.5, -0.5, 1, -0.5, -0.5; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0; 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1]
-// b =  [1; 1; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 0; 10; 10]
-// inv(A)*b
-// WHICH RESULTS IN GID ORDER:
-
-  std::vector<Real> refvals(0);
-  refvals +=
-   1.00000000000000e+00,
-   1.00000000000000e+00,
-  -1.35789473684210e+01,
-  -1.35789473684210e+01,
-  -7.78947368421052e+00,
-  -7.78947368421052e+00,
-   9.68421052631579e+00,
-   9.68421052631579e+00,
-   1.26315789473684e+01,
-   1.26315789473684e+01,
-  -3.36842105263158e+00,
-  -3.36842105263158e+00,
-  -1.43157894736842e+01,
-  -1.43157894736842e+01,
-  -3.78947368421053e+00,
-  -3.78947368421052e+00,
-   1.24210526315789e+01,
-   1.24210526315789e+01,
-   1.00000000000000e+01,
-   1.00000000000000e+01;
-
-  // commpattern
-  if (irank==0)
-  {
-    gid += 0,1,2,3,4;
-    rank_updatable += 0,0,0,0,1;
-  } else {
-    gid += 3,4,5,6,7,8,9;
-    rank_updatable += 0,1,1,1,1,1,1;
-  }
-  boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
-  common::PE::CommPattern& cp = *cp_ptr;
-  cp.insert("gid",gid,1,false);
-  cp.setup(Handle<common::PE::CommWrapper>(cp.get_child("gid")),rank_updatable);
-
-  // lss
-  if (irank==0)
-  {
-    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4;
-    starting_indices += 0,2,5,8,11,13;
-  } else {
-    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4,5,4,5,6,5,6;
-    starting_indices +=  0,2,5,8,11,14,17,19;
-  }
-  boost::shared_ptr<System> sys(common::allocate_component<System>("sys"));
-  sys->options().option("matrix_builder").change_value(matrix_builder);
-  sys->create(cp,2,node_connectivity,starting_indices);
-
-  sys->solution_strategy()->options().set("compute_residual", true);
-  sys->solution_strategy()->options().set("verbosity_level", 3);
-  sys->solution_strategy()->access_component("Parameters")->options().set("preconditioner_type", std::string("None"));
-  sys->solution_strategy()->access_component("Parameters/LinearSolverTypes/Belos/SolverTypes/BlockGMRES")->options().set("verbosity", 1);
-
-  // set intital values and boundary conditions
-  sys->matrix()->reset(-0.5);
-  sys->solution()->reset(1.);
-  sys->rhs()->reset(0.);
-  if (irank==0)
-  {
-    std::vector<Real> diag(10,1.);
-    sys->set_diagonal(diag);
-    sys->dirichlet(0,0,1.);
-    sys->dirichlet(0,1,1.);
-  } else {
-    std::vector<Real> diag(14,1.);
-    sys->set_diagonal(diag);
-    sys->dirichlet(6,0,10.);
-    sys->dirichlet(6,1,10.);
-  }
-
-  // solve and check
-  sys->solve();
-  std::vector<Real> vals;
-  sys->solution()->debug_data(vals);
-  for (int i=0; i<vals.size(); i++)
-    if (cp.isUpdatable()[i/neq])
-      BOOST_CHECK_CLOSE( vals[i], refvals[gid[i/neq]*neq], 1e-8);
+////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( solve_system_mixed_precision )
+{
+  // The single precision preconditioner is only computed for the first solve
+  if(matrix_builder == "cf3.math.LSS.TrilinosCrsMatrix")
+    solve_reference_system("cf3.math.LSS.MixedPrecisionStrategy", 2);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
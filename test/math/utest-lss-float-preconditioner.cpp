@@ -0,0 +1,178 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::math::LSS::FloatBlockPreconditioner"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/BasicExceptions.hpp"
+
+#include "math/LSS/FloatBlockPreconditioner.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::math;
+using namespace cf3::math::LSS;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct FloatBlockPreconditionerFixture
+{
+  /// Append a row to the CRS arrays
+  void add_entry(const Uint column, const Real value)
+  {
+    columns.push_back(column);
+    values.push_back(value);
+  }
+
+  void end_row()
+  {
+    row_starts.push_back(columns.size());
+  }
+
+  /// 2D Poisson matrix on an n x n grid, with the diagonal stored last in each row
+  void build_poisson(const Uint n)
+  {
+    row_starts.assign(1, 0);
+    columns.clear();
+    values.clear();
+    for(Uint i = 0; i != n; ++i)
+    {
+      for(Uint j = 0; j != n; ++j)
+      {
+        const Uint row = i*n + j;
+        if(j+1 != n) add_entry(row+1, -1.);
+        if(i != 0)   add_entry(row-n, -1.);
+        if(j != 0)   add_entry(row-1, -1.);
+        if(i+1 != n) add_entry(row+n, -1.);
+        add_entry(row, 4.);
+        end_row();
+      }
+    }
+  }
+
+  /// Norm of b - A*x, using the double precision values
+  Real residual_norm(const std::vector<Real>& b, const std::vector<Real>& x) const
+  {
+    Real result = 0.;
+    for(Uint i = 0; i != b.size(); ++i)
+    {
+      Real r = b[i];
+      for(Uint p = row_starts[i]; p != row_starts[i+1]; ++p)
+        r -= values[p]*x[columns[p]];
+      result += r*r;
+    }
+    return std::sqrt(result);
+  }
+
+  std::vector<Uint> row_starts;
+  std::vector<Uint> columns;
+  std::vector<Real> values;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( FloatBlockPreconditionerSuite, FloatBlockPreconditionerFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+// ILU(0) is exact for a tridiagonal matrix
+BOOST_AUTO_TEST_CASE( Tridiagonal )
+{
+  const Uint n = 10;
+  row_starts.assign(1, 0);
+  for(Uint i = 0; i != n; ++i)
+  {
+    if(i != 0)   add_entry(i-1, -1.);
+    add_entry(i, 2.);
+    if(i+1 != n) add_entry(i+1, -1.);
+    end_row();
+  }
+
+  FloatBlockPreconditioner preconditioner;
+  preconditioner.set_matrix(row_starts, columns, values);
+  BOOST_CHECK_EQUAL(preconditioner.nb_rows(), n);
+
+  std::vector<Real> b(n, 1.);
+  std::vector<Real> x(n, 0.);
+  preconditioner.apply(&b[0], &x[0]);
+  for(Uint i = 0; i != n; ++i)
+    BOOST_CHECK_CLOSE(x[i], 0.5*(i+1)*(n-i), 1e-4);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( InnerGMRES )
+{
+  build_poisson(30);
+  FloatBlockPreconditioner preconditioner;
+  preconditioner.set_matrix(row_starts, columns, values);
+
+  const Uint n = preconditioner.nb_rows();
+  std::vector<Real> b(n, 1.);
+  std::vector<Real> x(n, 0.);
+  const Real b_norm = std::sqrt(static_cast<Real>(n));
+
+  // The ILU factors alone are only an approximation
+  preconditioner.apply(&b[0], &x[0]);
+  const Real ilu_residual = residual_norm(b, x);
+  BOOST_CHECK_EQUAL(preconditioner.inner_iterations(), 0u);
+  BOOST_CHECK_GT(ilu_residual, 1e-2*b_norm);
+
+  // The inner iterations reach the requested tolerance, within single precision
+  preconditioner.apply(&b[0], &x[0], 50, 1e-5);
+  BOOST_CHECK_GT(preconditioner.inner_iterations(), 0u);
+  BOOST_CHECK_LT(preconditioner.inner_iterations(), 50u);
+  BOOST_CHECK_LT(residual_norm(b, x), 1e-4*b_norm);
+
+  // A limited number of iterations still improves on the ILU factors
+  preconditioner.apply(&b[0], &x[0], 3, 1e-5);
+  BOOST_CHECK_EQUAL(preconditioner.inner_iterations(), 3u);
+  BOOST_CHECK_LT(residual_norm(b, x), ilu_residual);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ZeroPivot )
+{
+  // The first pivot is zero, the matrix itself is not singular
+  row_starts.assign(1, 0);
+  add_entry(0, 0.); add_entry(1, 1.); end_row();
+  add_entry(0, 1.); add_entry(1, 1.); end_row();
+
+  FloatBlockPreconditioner preconditioner;
+  preconditioner.set_matrix(row_starts, columns, values);
+
+  std::vector<Real> b(2, 1.);
+  std::vector<Real> x(2, 0.);
+  preconditioner.apply(&b[0], &x[0], 2, 1e-6);
+  BOOST_CHECK(std::abs(x[0]) < 1e-4);
+  BOOST_CHECK_CLOSE(x[1], 1., 1e-3);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( MissingDiagonal )
+{
+  row_starts.assign(1, 0);
+  add_entry(1, 1.); end_row();
+  add_entry(0, 1.); add_entry(1, 1.); end_row();
+
+  FloatBlockPreconditioner preconditioner;
+  BOOST_CHECK_THROW(preconditioner.set_matrix(row_starts, columns, values), common::BadValue);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
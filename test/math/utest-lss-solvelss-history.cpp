@@ -0,0 +1,180 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the extrapolated initial guess of the SolveLSS action"
+
+#include <boost/assign/std/vector.hpp>
+#include <boost/multi_array.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Builder.hpp"
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+
+#include "common/PE/CommPattern.hpp"
+#include "common/PE/CommWrapper.hpp"
+
+#include "math/MatrixTypes.hpp"
+#include "math/LSS/LibLSS.hpp"
+#include "math/LSS/SolutionStrategy.hpp"
+#include "math/LSS/SolveLSS.hpp"
+#include "math/LSS/System.hpp"
+#include "math/LSS/Vector.hpp"
+
+using namespace boost::assign;
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::common::PE;
+using namespace cf3::math;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Solution strategy that records the initial guess, and replaces it by a given solution
+class RecordingStrategy : public LSS::SolutionStrategy
+{
+public:
+  RecordingStrategy(const std::string& name) : LSS::SolutionStrategy(name)
+  {
+  }
+
+  static std::string type_name () { return "RecordingStrategy"; }
+
+  virtual void set_matrix(const Handle<LSS::Matrix>& matrix)
+  {
+  }
+
+  virtual void set_rhs(const Handle<LSS::Vector>& rhs)
+  {
+  }
+
+  virtual void set_solution(const Handle<LSS::Vector>& solution)
+  {
+    m_solution = solution;
+  }
+
+  virtual void solve()
+  {
+    initial_guess.resize(boost::extents[m_solution->blockrow_size()][m_solution->neq()]);
+    m_solution->get(initial_guess);
+    m_solution->set(solution);
+  }
+
+  virtual Real compute_residual()
+  {
+    return 0.;
+  }
+
+  /// Initial guess of the last solve
+  boost::multi_array<Real, 2> initial_guess;
+
+  /// Solution that the next solve results in
+  boost::multi_array<Real, 2> solution;
+
+private:
+  Handle<LSS::Vector> m_solution;
+};
+
+ComponentBuilder < RecordingStrategy, LSS::SolutionStrategy, LSS::LibLSS > RecordingStrategy_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct SolveLSSHistoryFixture
+{
+  /// Fill values with a*i + b, i being the index of the value in the vector
+  void fill(boost::multi_array<Real, 2>& values, const Real a, const Real b)
+  {
+    values.resize(boost::extents[nb_rows][neq]);
+    for(Uint i = 0; i != nb_rows; ++i)
+      for(Uint j = 0; j != neq; ++j)
+        values[i][j] = a*(i*neq + j) + b;
+  }
+
+  /// Check that the initial guess of the last solve is a*i + b
+  void check_initial_guess(const RecordingStrategy& strategy, const Real a, const Real b)
+  {
+    for(Uint i = 0; i != nb_rows; ++i)
+      for(Uint j = 0; j != neq; ++j)
+        BOOST_CHECK_CLOSE(strategy.initial_guess[i][j], a*(i*neq + j) + b, 1e-10);
+  }
+
+  Uint nb_rows;
+  Uint neq;
+};
+
+BOOST_FIXTURE_TEST_SUITE( SolveLSSHistorySuite, SolveLSSHistoryFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Extrapolation )
+{
+  Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+
+  Component& root = Core::instance().root();
+  LSS::SolveLSS& solve_action = *root.create_component<LSS::SolveLSS>("solve_action");
+  Handle<LSS::System> lss = root.create_component<LSS::System>("LSS");
+  CommPattern& cp = *root.create_component<CommPattern>("commpattern");
+
+  std::vector<Uint> gid, conn, startidx, rnk;
+  gid += 0,1,2,3,4,5,6,7,8,9;
+  rnk += 0,0,0,0,0,0,0,0,0,0;
+  conn += 0,2,1,2,2,7,3,8,4,5,5,2,6,0,7,1,8,7,9,8;
+  startidx += 0,2,4,6,8,10,12,14,16,18,20;
+  cp.insert("gid",gid,1,false);
+  cp.setup(cp.get_child("gid")->handle<common::PE::CommWrapper>(),rnk);
+
+  lss->options().set("matrix_builder", std::string("cf3.math.LSS.TrilinosFEVbrMatrix"));
+  lss->options().set("solution_strategy", std::string("cf3.math.LSS.RecordingStrategy"));
+  lss->create(cp, 4u, conn, startidx);
+
+  RecordingStrategy& strategy = dynamic_cast<RecordingStrategy&>(*lss->solution_strategy());
+  nb_rows = lss->solution()->blockrow_size();
+  neq = lss->solution()->neq();
+
+  solve_action.options().set("lss", lss);
+  solve_action.options().set("history_size", 2u);
+
+  // Step 0: nothing to extrapolate from yet
+  solve_action.options().set("step", 0u);
+  fill(strategy.solution, 1., 0.);
+  solve_action.execute();
+
+  // Step 1: starts from the solution of step 0
+  solve_action.options().set("step", 1u);
+  fill(strategy.solution, 2., 1.);
+  solve_action.execute();
+  check_initial_guess(strategy, 1., 0.);
+
+  // Step 2: linear extrapolation 2*x_1 - x_0
+  solve_action.options().set("step", 2u);
+  fill(strategy.solution, 4., 0.);
+  solve_action.execute();
+  check_initial_guess(strategy, 3., 2.);
+
+  // Second solve in step 2, as in an inner loop: starts from the current solution
+  fill(strategy.solution, 5., 1.);
+  solve_action.execute();
+  check_initial_guess(strategy, 4., 0.);
+
+  // Step 3: extrapolated from the last solution of each step, 2*x_2 - x_1
+  solve_action.options().set("step", 3u);
+  fill(strategy.solution, 0., 0.);
+  solve_action.execute();
+  check_initial_guess(strategy, 8., 1.);
+
+  // A jump in steps starts the history over, so the solution vector is used as is
+  solve_action.options().set("step", 5u);
+  fill(strategy.solution, 1., 1.);
+  solve_action.execute();
+  check_initial_guess(strategy, 0., 0.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
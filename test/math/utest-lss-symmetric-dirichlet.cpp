@@ -209,6 +209,72 @@ BOOST_AUTO_TEST_CASE( test_complete_system )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( test_batch )
+{
+  boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
+  common::PE::CommPattern& cp = *cp_ptr;
+  build_commpattern(cp);
+  boost::shared_ptr<LSS::System> sys(common::allocate_component<LSS::System>("sys"));
+  sys->options().option("matrix_builder").change_value(matrix_builder);
+  build_system(*sys,cp);
+
+  // The second pass reuses the pattern computed by the first one
+  for(Uint pass = 0; pass != 2; ++pass)
+  {
+    sys->reset();
+    sys->matrix()->set_row(0, 0, 2, 1);
+    sys->matrix()->set_row(1, 0, 2, 1);
+    sys->matrix()->set_row(2, 0, 2, 1);
+
+    sys->begin_dirichlet_batch();
+    if(irank == 0)
+      sys->dirichlet(1, 0, 10., true);
+    else
+      sys->dirichlet(0, 0, 10., true);
+    sys->end_dirichlet_batch();
+
+    Real val;
+    if(irank == 0)
+    {
+      sys->matrix()->get_value(0, 0, val);
+      BOOST_CHECK_EQUAL(val, 2.);
+      sys->matrix()->get_value(1, 0, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+      sys->matrix()->get_value(0, 1, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+      sys->matrix()->get_value(1, 1, val);
+      BOOST_CHECK_EQUAL(val, 1.);
+      sys->matrix()->get_value(2, 1, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+      sys->rhs()->get_value(0, val);
+      BOOST_CHECK_EQUAL(val, -10.);
+      sys->rhs()->get_value(1, val);
+      BOOST_CHECK_EQUAL(val, 10.);
+    }
+    else
+    {
+      sys->matrix()->get_value(0, 1, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+      sys->matrix()->get_value(1, 1, val);
+      BOOST_CHECK_EQUAL(val, 2.);
+      sys->matrix()->get_value(2, 1, val);
+      BOOST_CHECK_EQUAL(val, 1.);
+      sys->matrix()->get_value(1, 2, val);
+      BOOST_CHECK_EQUAL(val, 1.);
+      sys->matrix()->get_value(2, 2, val);
+      BOOST_CHECK_EQUAL(val, 2.);
+      sys->rhs()->get_value(0, val);
+      BOOST_CHECK_EQUAL(val, 10.);
+      sys->rhs()->get_value(1, val);
+      BOOST_CHECK_EQUAL(val, -10.);
+      sys->rhs()->get_value(2, val);
+      BOOST_CHECK_EQUAL(val, 0.);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   CFinfo.setFilterRankZero(true);
@@ -0,0 +1,250 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmarks face matching in mesh::actions::BuildFaces"
+
+#include <algorithm>
+#include <iostream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+#include "common/List.hpp"
+#include "common/Table.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/FaceMatcher.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+#include "mesh/actions/BuildFaces.hpp"
+
+#include "Tools/Testing/TimedTestFixture.hpp"
+
+using namespace boost::assign;
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct FaceBuilderBenchmarkFixture : Tools::Testing::TimedTestFixture
+{
+  /// Number of hexahedra in each direction
+  static const Uint nb_segments = 60;
+
+  static Handle< Mesh > mesh;
+};
+
+const Uint FaceBuilderBenchmarkFixture::nb_segments;
+Handle< Mesh > FaceBuilderBenchmarkFixture::mesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( FaceBuilderBenchmarkSuite, FaceBuilderBenchmarkFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( FaceMatcherLookup )
+{
+  FaceMatcher matcher(4);
+
+  // Insert enough faces to grow the table a few times
+  const Uint nb_faces = 1000;
+  Uint nodes[4];
+  for(Uint i = 0; i != nb_faces; ++i)
+  {
+    nodes[0] = i; nodes[1] = i+1; nodes[2] = i+2; nodes[3] = i+3;
+    BOOST_CHECK_EQUAL(matcher.find_or_insert(nodes, 4, i), i);
+  }
+  BOOST_CHECK_EQUAL(matcher.size(), nb_faces);
+
+  // Node order does not matter
+  for(Uint i = 0; i != nb_faces; ++i)
+  {
+    nodes[0] = i+2; nodes[1] = i+3; nodes[2] = i; nodes[3] = i+1;
+    BOOST_CHECK_EQUAL(matcher.find(nodes, 4), i);
+    BOOST_CHECK_EQUAL(matcher.find_or_insert(nodes, 4, nb_faces + i), i);
+  }
+  BOOST_CHECK_EQUAL(matcher.size(), nb_faces);
+
+  // A triangle is not the quadrilateral that contains its nodes
+  nodes[0] = 0; nodes[1] = 1; nodes[2] = 2;
+  BOOST_CHECK_EQUAL(matcher.find(nodes, 3), FaceMatcher::not_found);
+  BOOST_CHECK_EQUAL(matcher.find_or_insert(nodes, 3, nb_faces), nb_faces);
+  BOOST_CHECK_EQUAL(matcher.find(nodes, 3), nb_faces);
+
+  // But it lies on the first inserted face that has more nodes, including all of its own
+  BOOST_CHECK_EQUAL(matcher.find_containing(nodes, 3), 0u);
+  nodes[0] = 7; nodes[1] = 5;
+  BOOST_CHECK_EQUAL(matcher.find_containing(nodes, 2), 4u);
+  nodes[0] = 0; nodes[1] = 4;
+  BOOST_CHECK_EQUAL(matcher.find_containing(nodes, 2), FaceMatcher::not_found);
+  nodes[0] = 0; nodes[1] = 1; nodes[2] = 2; nodes[3] = 3;
+  BOOST_CHECK_EQUAL(matcher.find_containing(nodes, 4), FaceMatcher::not_found);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Must be run before the next tests
+BOOST_AUTO_TEST_CASE( CreateMesh )
+{
+  mesh = Core::instance().root().create_component<Mesh>("mesh");
+  std::vector<Real> lengths  = list_of(1.)(1.)(1.);
+  std::vector<Uint> nb_cells = list_of(nb_segments)(nb_segments)(nb_segments);
+  SimpleMeshGenerator& mesh_gen = *Core::instance().root().create_component<SimpleMeshGenerator>("mesh_gen");
+  mesh_gen.options().set("mesh",mesh->uri());
+  mesh_gen.options().set("lengths",lengths);
+  mesh_gen.options().set("nb_cells",nb_cells);
+  mesh_gen.execute();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Matches the faces of all cells the way FaceCellConnectivity did before FaceMatcher, counting the faces shared by the nodes
+void match_faces_baseline(const std::vector<Uint>& nodes, const std::vector<Uint>& offsets, const Uint nb_nodes, std::vector<Uint>& face_ids)
+{
+  std::vector< std::vector<Uint> > node_faces(nb_nodes);
+  const Uint nb_cell_faces = offsets.size() - 1;
+  face_ids.resize(nb_cell_faces);
+  Uint nb_faces = 0;
+  for(Uint f = 0; f != nb_cell_faces; ++f)
+  {
+    const Uint* face_nodes = &nodes[offsets[f]];
+    const Uint nb_face_nodes = offsets[f+1] - offsets[f];
+    bool found_face = false;
+    boost_foreach(const Uint face, node_faces[face_nodes[0]])
+    {
+      Uint nb_matched_nodes = 1;
+      for(Uint i = 1; i != nb_face_nodes; ++i)
+      {
+        if(std::find(node_faces[face_nodes[i]].begin(), node_faces[face_nodes[i]].end(), face) != node_faces[face_nodes[i]].end())
+          ++nb_matched_nodes;
+      }
+      if(nb_matched_nodes == nb_face_nodes)
+      {
+        face_ids[f] = face;
+        found_face = true;
+        break;
+      }
+    }
+    if(!found_face)
+    {
+      for(Uint i = 0; i != nb_face_nodes; ++i)
+        node_faces[face_nodes[i]].push_back(nb_faces);
+      face_ids[f] = nb_faces++;
+    }
+  }
+}
+
+// Compares FaceMatcher with the node counting it replaced, on the faces of all cells
+BOOST_AUTO_TEST_CASE( FaceMatchingBaseline )
+{
+  std::vector<Uint> nodes;
+  std::vector<Uint> offsets(1, 0);
+  Uint max_nb_face_nodes = 1;
+  boost_foreach(const Cells& cells, find_components_recursively<Cells>(mesh->topology()))
+  {
+    const ElementType& etype = cells.element_type();
+    boost_foreach(Connectivity::ConstRow elem_nodes, cells.geometry_space().connectivity().array())
+    {
+      for(Uint face_idx = 0; face_idx != etype.nb_faces(); ++face_idx)
+      {
+        boost_foreach(const Uint face_node_idx, etype.faces().nodes_range(face_idx))
+          nodes.push_back(elem_nodes[face_node_idx]);
+        offsets.push_back(nodes.size());
+        max_nb_face_nodes = std::max(max_nb_face_nodes, offsets.back() - offsets[offsets.size()-2]);
+      }
+    }
+  }
+  const Uint nb_cell_faces = offsets.size() - 1;
+
+  restart_timer();
+  std::vector<Uint> baseline_ids;
+  match_faces_baseline(nodes, offsets, mesh->geometry_fields().size(), baseline_ids);
+  const Real baseline_time = elapsed();
+
+  restart_timer();
+  std::vector<Uint> matcher_ids(nb_cell_faces);
+  FaceMatcher matcher(max_nb_face_nodes, nb_cell_faces / 2);
+  for(Uint f = 0; f != nb_cell_faces; ++f)
+    matcher_ids[f] = matcher.find_or_insert(&nodes[offsets[f]], offsets[f+1] - offsets[f], matcher.size());
+  const Real matcher_time = elapsed();
+
+  // Same faces, with the same numbering
+  const Uint n = nb_segments;
+  BOOST_CHECK_EQUAL(matcher.size(), 3*n*n*(n+1));
+  BOOST_CHECK(matcher_ids == baseline_ids);
+
+  std::cout << "<DartMeasurement name=\"FaceMatchingBaseline node counting time\" type=\"numeric/double\">" << baseline_time << "</DartMeasurement>" << std::endl;
+  std::cout << "<DartMeasurement name=\"FaceMatchingBaseline FaceMatcher time\" type=\"numeric/double\">" << matcher_time << "</DartMeasurement>" << std::endl;
+  if(matcher_time > 0.)
+    std::cout << "<DartMeasurement name=\"FaceMatchingBaseline speedup\" type=\"numeric/double\">" << baseline_time / matcher_time << "</DartMeasurement>" << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( FaceCellConnectivityBenchmark )
+{
+  Handle<FaceCellConnectivity> f2c = mesh->create_component<FaceCellConnectivity>("face_cell_connectivity");
+  f2c->setup(mesh->topology());
+
+  const Uint n = nb_segments;
+  BOOST_CHECK_EQUAL(f2c->size(), 3*n*n*(n+1));
+
+  Uint nb_inner_faces = 0;
+  for(Uint f = 0; f != f2c->size(); ++f)
+  {
+    if(!f2c->is_bdry_face()[f])
+      ++nb_inner_faces;
+  }
+  BOOST_CHECK_EQUAL(nb_inner_faces, 3*n*n*(n-1));
+
+  mesh->remove_component(*f2c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( BuildFacesBenchmark )
+{
+  boost::shared_ptr<BuildFaces> facebuilder = allocate_component<BuildFaces>("facebuilder");
+  facebuilder->set_mesh(*mesh);
+  facebuilder->execute();
+
+  const Uint n = nb_segments;
+  Uint nb_inner_faces = 0;
+  boost_foreach(const Elements& faces, find_components_recursively_with_tag<Elements>(mesh->topology(), mesh::Tags::inner_faces()))
+    nb_inner_faces += faces.size();
+  BOOST_CHECK_EQUAL(nb_inner_faces, 3*n*n*(n-1));
+
+  // Every boundary face was matched to a cell
+  const std::vector<std::string> boundaries = list_of("left")("right")("bottom")("top")("back")("front");
+  boost_foreach(const std::string& boundary, boundaries)
+  {
+    const Elements& faces = find_component<Elements>(find_component_recursively_with_name<Region>(mesh->topology(), boundary));
+    const FaceCellConnectivity& f2c = *faces.connectivity_face2cell();
+    BOOST_CHECK_EQUAL(f2c.size(), n*n);
+    for(Uint f = 0; f != f2c.size(); ++f)
+      BOOST_CHECK(is_not_null(f2c.connectivity()[f][0].comp));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,169 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::WallDistance"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/Core.hpp"
+
+#include "mesh/actions/WallDistance.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+using namespace boost::assign;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct WallDistanceFixture
+{
+  WallDistanceFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Unit square or cube with the given number of cells in each direction
+  Mesh& generate(const std::string& name, const Uint dim, const Uint nb_segments)
+  {
+    Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("generator_" + name);
+    mesh_generator->options().set("mesh",Core::instance().root().uri()/name);
+    mesh_generator->options().set("lengths",std::vector<Real>(dim,1.));
+    mesh_generator->options().set("nb_cells",std::vector<Uint>(dim,nb_segments));
+    return mesh_generator->generate();
+  }
+
+  /// Check that the distance is the distance to the planes x = 0 and y = 0
+  void check_distance(WallDistance& wall_distance, Mesh& mesh, const std::string& method)
+  {
+    std::vector<URI> walls = list_of(mesh.topology().get_child("left")->uri())(mesh.topology().get_child("bottom")->uri());
+    wall_distance.options().set("regions", walls);
+    wall_distance.options().set("method", method);
+    wall_distance.transform(mesh);
+
+    const Field& distance = *wall_distance.field();
+    const Field& coords = mesh.geometry_fields().coordinates();
+    BOOST_CHECK_EQUAL(&distance.dict(), &mesh.geometry_fields());
+    BOOST_CHECK_EQUAL(distance.size(), coords.size());
+    for(Uint i = 0; i != coords.size(); ++i)
+      BOOST_CHECK_SMALL(distance[i][0] - std::min(coords[i][XX], coords[i][YY]), 1e-12);
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( WallDistanceSuite, WallDistanceFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Exact2D )
+{
+  Mesh& mesh = generate("rect", 2, 20);
+  boost::shared_ptr<WallDistance> wall_distance = allocate_component<WallDistance>("wall_distance");
+  check_distance(*wall_distance, mesh, "exact");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Sweeping2D )
+{
+  Mesh& mesh = *Core::instance().root().get_child("rect")->handle<Mesh>();
+  boost::shared_ptr<WallDistance> wall_distance = allocate_component<WallDistance>("wall_distance");
+  check_distance(*wall_distance, mesh, "sweeping");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Exact3D )
+{
+  Mesh& mesh = generate("box", 3, 8);
+  boost::shared_ptr<WallDistance> wall_distance = allocate_component<WallDistance>("wall_distance");
+  check_distance(*wall_distance, mesh, "exact");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Sweeping3D )
+{
+  Mesh& mesh = *Core::instance().root().get_child("box")->handle<Mesh>();
+  boost::shared_ptr<WallDistance> wall_distance = allocate_component<WallDistance>("wall_distance");
+  check_distance(*wall_distance, mesh, "sweeping");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Cache )
+{
+  Mesh& mesh = *Core::instance().root().get_child("rect")->handle<Mesh>();
+  boost::shared_ptr<WallDistance> wall_distance = allocate_component<WallDistance>("wall_distance");
+  check_distance(*wall_distance, mesh, "exact");
+
+  // The field is not recomputed if nothing changed
+  Field& distance = const_cast<Field&>(*wall_distance->field());
+  distance[0][0] = -1.;
+  wall_distance->transform(mesh);
+  BOOST_CHECK_EQUAL(distance[0][0], -1.);
+
+  // Changing an option triggers the computation
+  wall_distance->options().set("method", std::string("sweeping"));
+  wall_distance->transform(mesh);
+  BOOST_CHECK_SMALL(distance[0][0], 1e-12);
+
+  // So does moving a point
+  Field& coords = mesh.geometry_fields().coordinates();
+  const Uint last = coords.size() - 1;
+  distance[0][0] = -1.;
+  coords[last][YY] += 0.5;
+  wall_distance->transform(mesh);
+  BOOST_CHECK_SMALL(distance[0][0], 1e-12);
+  coords[last][YY] -= 0.5;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( SweepingUnreached )
+{
+  // Without sweeps, the points away from the wall are never reached and need an exact query
+  Mesh& mesh = *Core::instance().root().get_child("rect")->handle<Mesh>();
+  boost::shared_ptr<WallDistance> wall_distance = allocate_component<WallDistance>("wall_distance");
+  wall_distance->options().set("max_sweeps", 0u);
+  check_distance(*wall_distance, mesh, "sweeping");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  Core::instance().terminate();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,128 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Parallel test module for cf3::mesh::checkpoint"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/List.hpp"
+#include "common/Table.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshMetadata.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/MeshWriter.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/checkpoint/Shared.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( CheckpointParallelSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  BOOST_CHECK(PE::Comm::instance().size() > 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteReadPartitioned )
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_ranks = PE::Comm::instance().size();
+  Component& root = Core::instance().root();
+
+  // Every rank generates its own part of the mesh, with different sizes per rank
+  Handle<MeshGenerator> generator = root.create_component<MeshGenerator>("generator", "cf3.mesh.SimpleMeshGenerator");
+  generator->options().set("mesh", root.uri()/"mesh");
+  generator->options().set("lengths", std::vector<Real>(2, 10.));
+  generator->options().set("nb_cells", std::vector<Uint>(2, 9));
+  generator->options().set("part", rank);
+  generator->options().set("nb_parts", nb_ranks);
+  Mesh& mesh = generator->generate();
+
+  Field& field = mesh.geometry_fields().create_field("u", "u[1]");
+  for(Uint i = 0; i != field.size(); ++i)
+    field[i][0] = 1000.*rank + mesh.geometry_fields().glb_idx()[i];
+  mesh.metadata()["iter"] = 7u;
+
+  boost::shared_ptr< MeshWriter > writer = build_component_abstract_type<MeshWriter>("cf3.mesh.checkpoint.Writer","writer");
+  writer->write_from_to(mesh, "parallel.cf3chk");
+  PE::Comm::instance().barrier();
+
+  // One shared file, with an index entry per rank
+  BOOST_CHECK(boost::filesystem::exists("parallel.cf3chk"));
+  BOOST_CHECK(!boost::filesystem::exists("parallel_P0.cf3chk"));
+  BOOST_CHECK(boost::filesystem::file_size("parallel.cf3chk") > checkpoint::Shared::header_size() + nb_ranks*checkpoint::Shared::index_entry_size());
+
+  Handle<Mesh> restarted = root.create_component<Mesh>("restarted");
+  boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.checkpoint.Reader","reader");
+  reader->read_mesh_into("parallel.cf3chk", *restarted);
+
+  BOOST_CHECK_EQUAL(restarted->metadata().properties().value<Uint>("iter"), 7u);
+
+  // Every rank gets back its own part
+  const Dictionary& geometry = mesh.geometry_fields();
+  const Dictionary& restarted_geometry = restarted->geometry_fields();
+  BOOST_REQUIRE_EQUAL(restarted_geometry.size(), geometry.size());
+  for(Uint i = 0; i != geometry.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(restarted_geometry.glb_idx()[i], geometry.glb_idx()[i]);
+    BOOST_CHECK_EQUAL(restarted_geometry.rank()[i], geometry.rank()[i]);
+    for(Uint d = 0; d != geometry.coordinates().row_size(); ++d)
+      BOOST_CHECK_EQUAL(restarted_geometry.coordinates()[i][d], geometry.coordinates()[i][d]);
+  }
+
+  BOOST_REQUIRE_EQUAL(restarted->elements().size(), mesh.elements().size());
+  for(Uint e = 0; e != mesh.elements().size(); ++e)
+  {
+    const Entities& original = *mesh.elements()[e];
+    const Entities& copy = *restarted->elements()[e];
+    BOOST_REQUIRE_EQUAL(copy.size(), original.size());
+    for(Uint i = 0; i != original.size(); ++i)
+    {
+      BOOST_CHECK_EQUAL(copy.glb_idx()[i], original.glb_idx()[i]);
+      BOOST_CHECK_EQUAL(copy.rank()[i], original.rank()[i]);
+      for(Uint n = 0; n != original.geometry_space().connectivity().row_size(); ++n)
+        BOOST_CHECK_EQUAL(copy.geometry_space().connectivity()[i][n], original.geometry_space().connectivity()[i][n]);
+    }
+  }
+
+  Handle<Field const> restarted_field(restarted_geometry.get_child("u"));
+  BOOST_REQUIRE(is_not_null(restarted_field));
+  for(Uint i = 0; i != field.size(); ++i)
+    BOOST_CHECK_EQUAL((*restarted_field)[i][0], field[i][0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Finalize )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,133 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::mesh::cf3mesh"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+#include "common/List.hpp"
+#include "common/Table.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/MeshWriter.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( CF3MeshSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteRead )
+{
+  Component& root = Core::instance().root();
+
+  Handle<Mesh> mesh = root.create_component<Mesh>("mesh");
+  Tools::MeshGeneration::create_rectangle(*mesh, 5., 5., 5, 5);
+
+  boost::shared_ptr< MeshWriter > writer = build_component_abstract_type<MeshWriter>("cf3.mesh.cf3mesh.Writer","writer");
+  writer->write_from_to(*mesh,"rectangle.cf3mesh");
+
+  Handle<Mesh> copy = root.create_component<Mesh>("copy");
+  boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.cf3mesh.Reader","reader");
+  reader->read_mesh_into("rectangle.cf3mesh", *copy);
+
+  BOOST_CHECK_EQUAL(copy->dimension(), mesh->dimension());
+  BOOST_CHECK_EQUAL(copy->geometry_fields().size(), mesh->geometry_fields().size());
+  for(Uint i = 0; i != mesh->geometry_fields().size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(copy->geometry_fields().glb_idx()[i], i);
+    for(Uint d = 0; d != mesh->dimension(); ++d)
+      BOOST_CHECK_EQUAL(copy->geometry_fields().coordinates()[i][d], mesh->geometry_fields().coordinates()[i][d]);
+  }
+
+  BOOST_CHECK_EQUAL(copy->elements().size(), mesh->elements().size());
+  for(Uint e = 0; e != mesh->elements().size(); ++e)
+  {
+    const Entities& original = *mesh->elements()[e];
+    const Entities& read = *copy->elements()[e];
+    BOOST_CHECK_EQUAL(read.uri().path().substr(copy->uri().path().size()), original.uri().path().substr(mesh->uri().path().size()));
+    BOOST_CHECK_EQUAL(read.derived_type_name(), original.derived_type_name());
+    BOOST_CHECK_EQUAL(read.element_type().derived_type_name(), original.element_type().derived_type_name());
+    BOOST_CHECK_EQUAL(read.size(), original.size());
+    for(Uint i = 0; i != original.size(); ++i)
+    {
+      for(Uint n = 0; n != original.geometry_space().connectivity().row_size(); ++n)
+        BOOST_CHECK_EQUAL(read.geometry_space().connectivity()[i][n], original.geometry_space().connectivity()[i][n]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ReadParts )
+{
+  Component& root = Core::instance().root();
+  const Mesh& mesh = *Handle<Mesh>(root.get_child("mesh"));
+  const Dictionary& geometry = mesh.geometry_fields();
+
+  // Read the file as two parts, as would be done by two processes
+  Uint nb_elements = 0;
+  for(Uint part = 0; part != 2; ++part)
+  {
+    Handle<Mesh> part_mesh = root.create_component<Mesh>("part"+to_str(part));
+    boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.cf3mesh.Reader","reader");
+    reader->options().set("part", part);
+    reader->options().set("nb_parts", 2u);
+    reader->read_mesh_into("rectangle.cf3mesh", *part_mesh);
+
+    const Dictionary& part_geometry = part_mesh->geometry_fields();
+    BOOST_CHECK(part_geometry.size() < geometry.size());
+    for(Uint i = 0; i != part_geometry.size(); ++i)
+    {
+      const Uint glb = part_geometry.glb_idx()[i];
+      BOOST_CHECK(part_geometry.rank()[i] < 2u);
+      for(Uint d = 0; d != mesh.dimension(); ++d)
+        BOOST_CHECK_EQUAL(part_geometry.coordinates()[i][d], geometry.coordinates()[glb][d]);
+    }
+
+    BOOST_CHECK_EQUAL(part_mesh->elements().size(), mesh.elements().size());
+    for(Uint e = 0; e != part_mesh->elements().size(); ++e)
+    {
+      const Entities& entities = *part_mesh->elements()[e];
+      nb_elements += entities.size();
+      for(Uint i = 0; i != entities.size(); ++i)
+      {
+        BOOST_CHECK_EQUAL(entities.rank()[i], part);
+        const Connectivity::ConstRow row = entities.geometry_space().connectivity()[i];
+        for(Uint n = 0; n != row.size(); ++n)
+          BOOST_CHECK(row[n] < part_geometry.size());
+      }
+    }
+  }
+
+  Uint total_nb_elements = 0;
+  for(Uint e = 0; e != mesh.elements().size(); ++e)
+    total_nb_elements += mesh.elements()[e]->size();
+  BOOST_CHECK_EQUAL(nb_elements, total_nb_elements);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,180 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for distributed reading with cf3::mesh::CGNS::Reader"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/MeshReader.hpp"
+
+#include "mesh/CGNS/Shared.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::common::PE;
+using namespace cf3::mesh;
+using namespace cf3::mesh::CGNS;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct CGNSDistributedTests_Fixture
+{
+  CGNSDistributedTests_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  int    m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( CGNSDistributedTests_TestSuite, CGNSDistributedTests_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  Comm::instance().init(m_argc,m_argv);
+  BOOST_CHECK_EQUAL(Comm::instance().size(), 2u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Unit square of 4x4 quads, with the bottom boundary in a separate section
+BOOST_AUTO_TEST_CASE( write_square )
+{
+  if (Comm::instance().rank() == 0)
+  {
+    const int n = 5;
+    double x[n*n], y[n*n];
+    for (int j=0; j<n; ++j)
+    {
+      for (int i=0; i<n; ++i)
+      {
+        x[i+j*n] = i/(n-1.);
+        y[i+j*n] = j/(n-1.);
+      }
+    }
+
+    cgsize_t quads[4*(n-1)*(n-1)];
+    int q = 0;
+    for (int j=0; j<n-1; ++j)
+    {
+      for (int i=0; i<n-1; ++i)
+      {
+        quads[q++] = i   + j*n     + 1;
+        quads[q++] = i+1 + j*n     + 1;
+        quads[q++] = i+1 + (j+1)*n + 1;
+        quads[q++] = i   + (j+1)*n + 1;
+      }
+    }
+
+    cgsize_t bars[2*(n-1)];
+    for (int i=0; i<n-1; ++i)
+    {
+      bars[2*i]   = i+1;
+      bars[2*i+1] = i+2;
+    }
+
+    int file, base, zone, coord, section, boco;
+    cgsize_t size[3] = { n*n, (n-1)*(n-1), 0 };
+    CALL_CGNS(cg_open("square_distributed.cgns",CG_MODE_WRITE,&file));
+    CALL_CGNS(cg_base_write(file,"Base",2,2,&base));
+    CALL_CGNS(cg_zone_write(file,base,"Zone",size,Unstructured,&zone));
+    CALL_CGNS(cg_coord_write(file,base,zone,RealDouble,"CoordinateX",x,&coord));
+    CALL_CGNS(cg_coord_write(file,base,zone,RealDouble,"CoordinateY",y,&coord));
+    CALL_CGNS(cg_section_write(file,base,zone,"Inner",QUAD_4,1,16,0,quads,&section));
+    CALL_CGNS(cg_section_write(file,base,zone,"BottomFaces",BAR_2,17,20,0,bars,&section));
+    cgsize_t range[2] = { 17, 20 };
+    CALL_CGNS(cg_boco_write(file,base,zone,"bottom",BCWall,ElementRange,2,range,&boco));
+    CALL_CGNS(cg_close(file));
+  }
+  Comm::instance().barrier();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( read_distributed )
+{
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.CGNS.Reader","meshreader");
+  meshreader->options().set("distributed",true);
+
+  Mesh& mesh = *Core::instance().root().create_component<Mesh>("square");
+  meshreader->read_mesh_into("square_distributed.cgns",mesh);
+
+  const Uint rank = Comm::instance().rank();
+  const Dictionary& nodes = mesh.geometry_fields();
+
+  // Every node is owned by exactly one rank
+  Uint nb_owned_nodes = 0;
+  for (Uint i=0; i<nodes.size(); ++i)
+  {
+    if (nodes.rank()[i] == rank)
+      ++nb_owned_nodes;
+  }
+  Uint total_nb_nodes = 0;
+  Comm::instance().all_reduce(PE::plus(), &nb_owned_nodes, 1, &total_nb_nodes);
+  BOOST_CHECK_EQUAL(total_nb_nodes, 25u);
+
+  // The local elements refer to the right coordinates: their areas add up to the unit square
+  Real area = 0.;
+  Uint nb_cells = 0;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(mesh.topology()))
+  {
+    if (elements.element_type().dimensionality() != 2)
+      continue;
+
+    const Connectivity& connectivity = elements.geometry_space().connectivity();
+    for (Uint e=0; e<connectivity.size(); ++e)
+    {
+      const Connectivity::ConstRow row = connectivity[e];
+      const Real dx = nodes.coordinates()[row[1]][XX] - nodes.coordinates()[row[0]][XX];
+      const Real dy = nodes.coordinates()[row[3]][YY] - nodes.coordinates()[row[0]][YY];
+      area += dx*dy;
+      ++nb_cells;
+    }
+  }
+  Real total_area = 0.;
+  Uint total_nb_cells = 0;
+  Comm::instance().all_reduce(PE::plus(), &area, 1, &total_area);
+  Comm::instance().all_reduce(PE::plus(), &nb_cells, 1, &total_nb_cells);
+  BOOST_CHECK_EQUAL(total_nb_cells, 16u);
+  BOOST_CHECK_CLOSE(total_area, 1., 1e-10);
+
+  // The boundary condition covers a complete section, which is renamed on all ranks
+  BOOST_CHECK(is_not_null(mesh.topology().get_child("bottom")));
+  BOOST_CHECK(is_null(mesh.topology().get_child("BottomFaces")));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize_mpi )
+{
+  Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -22,6 +22,7 @@
 #include "common/LibLoader.hpp"
 #include "common/Core.hpp"
 #include "common/Environment.hpp"
+#include "common/BoostFilesystem.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
@@ -30,6 +31,9 @@
 #include "mesh/MeshReader.hpp"
 #include "mesh/MeshWriter.hpp"
 #include "mesh/MeshTransformer.hpp"
+#include "mesh/MeshMetadata.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
 
 #include "mesh/CGNS/Shared.hpp"
 
@@ -779,6 +783,56 @@ BOOST_AUTO_TEST_CASE( WriteCNGS_mixed )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( WriteCGNS_time_series )
+{
+  Mesh& mesh = *Core::instance().root().get_child("quadtriag_mixed")->handle<Mesh>();
+  Field& field = mesh.geometry_fields().create_field("u", "u[1]");
+
+  boost::shared_ptr< MeshWriter > meshwriter = build_component_abstract_type<MeshWriter>("cf3.mesh.CGNS.Writer","meshwriter");
+  std::vector<URI> fields; fields.push_back(field.uri());
+  meshwriter->options().set("fields",fields);
+  meshwriter->options().set("mesh",mesh.handle<Mesh>());
+  meshwriter->options().set("file",URI("quadtriag-series.cgns"));
+  meshwriter->options().set("time_series",true);
+
+  for(Uint step = 0; step != 3; ++step)
+  {
+    mesh.metadata()["time"] = 0.5*step;
+    for(Uint i = 0; i != field.size(); ++i)
+      field[i][0] = step;
+    meshwriter->execute();
+  }
+
+  // The mesh is written once, with one solution per step and the times in BaseIterativeData_t
+  int file_idx, nb_solutions, nb_steps;
+  char name[33];
+  CALL_CGNS(cg_open("quadtriag-series.cgns",CG_MODE_READ,&file_idx));
+  CALL_CGNS(cg_nsols(file_idx,1,1,&nb_solutions));
+  BOOST_CHECK_EQUAL(nb_solutions, 3);
+  CALL_CGNS(cg_biter_read(file_idx,1,name,&nb_steps));
+  BOOST_CHECK_EQUAL(nb_steps, 3);
+  std::vector<double> times(nb_steps);
+  CALL_CGNS(cg_goto(file_idx,1,"BaseIterativeData_t",1,"end"));
+  CALL_CGNS(cg_array_read_as(1,RealDouble,&times[0]));
+  for(int step = 0; step != nb_steps; ++step)
+    BOOST_CHECK_EQUAL(times[step], 0.5*step);
+
+  // The values of the last step are in the last solution
+  cgsize_t range_min = 1;
+  cgsize_t range_max = field.size();
+  std::vector<double> values(field.size());
+  CALL_CGNS(cg_field_read(file_idx,1,1,nb_solutions,"u",RealDouble,&range_min,&range_max,&values[0]));
+  BOOST_CHECK_EQUAL(values[0], 2.);
+  CALL_CGNS(cg_close(file_idx));
+
+  // Moving the mesh continues the series in a new file, leaving the earlier steps with their mesh
+  mesh.geometry_fields().coordinates()[0][0] += 0.1;
+  meshwriter->execute();
+  BOOST_CHECK(boost::filesystem::exists("quadtriag-series_0003.cgns"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
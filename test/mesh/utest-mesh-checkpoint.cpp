@@ -0,0 +1,140 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::mesh::checkpoint"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Log.hpp"
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+#include "common/FindComponents.hpp"
+#include "common/List.hpp"
+#include "common/Table.hpp"
+
+#include "mesh/MeshReader.hpp"
+#include "mesh/MeshWriter.hpp"
+#include "mesh/MeshMetadata.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/actions/BuildFaces.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( CheckpointSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteReadCheckpoint )
+{
+  Component& root = Core::instance().root();
+
+  Handle<Mesh> mesh = root.create_component<Mesh>("mesh");
+  Tools::MeshGeneration::create_rectangle(*mesh, 5., 5., 5, 5);
+
+  boost::shared_ptr<actions::BuildFaces> build_faces = allocate_component<actions::BuildFaces>("build_faces");
+  build_faces->options().set("store_cell2face", true);
+  build_faces->transform(*mesh);
+
+  Dictionary& elems_P0 = mesh->create_discontinuous_space("elems_P0","cf3.mesh.LagrangeP0");
+  Field& cell_field = elems_P0.create_field("cell_field");
+  for(Uint i = 0; i != cell_field.size(); ++i)
+    cell_field[i][0] = static_cast<Real>(i);
+  cell_field.add_tag("test_tag");
+
+  Field& node_field = mesh->geometry_fields().create_field("node_field", "u[vector]");
+  for(Uint i = 0; i != node_field.size(); ++i)
+    node_field[i][1] = 2.*i;
+
+  mesh->metadata()["time"] = 1.5;
+  mesh->metadata()["iter"] = 3u;
+
+  boost::shared_ptr< MeshWriter > writer = build_component_abstract_type<MeshWriter>("cf3.mesh.checkpoint.Writer","writer");
+  writer->write_from_to(*mesh,"checkpoint.cf3chk");
+
+  Handle<Mesh> restarted = root.create_component<Mesh>("restarted");
+  boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.checkpoint.Reader","reader");
+  reader->read_mesh_into("checkpoint.cf3chk", *restarted);
+
+  // Metadata
+  BOOST_CHECK_EQUAL(restarted->metadata().properties().value<Real>("time"), 1.5);
+  BOOST_CHECK_EQUAL(restarted->metadata().properties().value<Uint>("iter"), 3u);
+
+  // Geometry and topology
+  BOOST_CHECK_EQUAL(restarted->dimension(), mesh->dimension());
+  BOOST_CHECK_EQUAL(restarted->geometry_fields().size(), mesh->geometry_fields().size());
+  BOOST_CHECK_EQUAL(restarted->elements().size(), mesh->elements().size());
+  for(Uint e = 0; e != mesh->elements().size(); ++e)
+  {
+    const Entities& original = *mesh->elements()[e];
+    const Entities& copy = *restarted->elements()[e];
+    BOOST_CHECK_EQUAL(copy.uri().path().substr(restarted->uri().path().size()), original.uri().path().substr(mesh->uri().path().size()));
+    BOOST_CHECK_EQUAL(copy.element_type().derived_type_name(), original.element_type().derived_type_name());
+    BOOST_CHECK_EQUAL(copy.size(), original.size());
+    for(Uint i = 0; i != original.size(); ++i)
+    {
+      BOOST_CHECK_EQUAL(copy.glb_idx()[i], original.glb_idx()[i]);
+      for(Uint n = 0; n != original.geometry_space().connectivity().row_size(); ++n)
+        BOOST_CHECK_EQUAL(copy.geometry_space().connectivity()[i][n], original.geometry_space().connectivity()[i][n]);
+    }
+
+    // Faces built by BuildFaces
+    BOOST_CHECK_EQUAL(is_null(copy.connectivity_face2cell()), is_null(original.connectivity_face2cell()));
+    if(is_not_null(original.connectivity_face2cell()))
+    {
+      const FaceCellConnectivity& original_f2c = *original.connectivity_face2cell();
+      const FaceCellConnectivity& copy_f2c = *copy.connectivity_face2cell();
+      BOOST_CHECK_EQUAL(copy_f2c.size(), original_f2c.size());
+      for(Uint f = 0; f != original_f2c.size(); ++f)
+      {
+        BOOST_CHECK_EQUAL(copy_f2c.is_bdry_face()[f], original_f2c.is_bdry_face()[f]);
+        BOOST_CHECK_EQUAL(copy_f2c.connectivity()[f][0].idx, original_f2c.connectivity()[f][0].idx);
+        BOOST_CHECK_EQUAL(copy_f2c.connectivity()[f][0].comp->entities_idx(), original_f2c.connectivity()[f][0].comp->entities_idx());
+      }
+    }
+    BOOST_CHECK_EQUAL(is_null(copy.connectivity_cell2face()), is_null(original.connectivity_cell2face()));
+  }
+
+  // Fields
+  Handle<Field const> restarted_node_field(restarted->geometry_fields().get_child("node_field"));
+  BOOST_CHECK(is_not_null(restarted_node_field));
+  BOOST_CHECK_EQUAL(restarted_node_field->row_size(), node_field.row_size());
+  for(Uint i = 0; i != node_field.size(); ++i)
+    BOOST_CHECK_EQUAL((*restarted_node_field)[i][1], node_field[i][1]);
+
+  Handle<Field const> restarted_cell_field(restarted->access_component("elems_P0/cell_field"));
+  BOOST_CHECK(is_not_null(restarted_cell_field));
+  BOOST_CHECK(restarted_cell_field->has_tag("test_tag"));
+  BOOST_CHECK_EQUAL(restarted_cell_field->size(), cell_field.size());
+  for(Uint i = 0; i != cell_field.size(); ++i)
+    BOOST_CHECK_EQUAL((*restarted_cell_field)[i][0], cell_field[i][0]);
+  BOOST_CHECK_EQUAL(restarted_cell_field->dict().spaces().size(), elems_P0.spaces().size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ReadIntoNonEmptyMesh )
+{
+  Handle<Mesh> restarted(Core::instance().root().get_child("restarted"));
+  boost::shared_ptr< MeshReader > reader = build_component_abstract_type<MeshReader>("cf3.mesh.checkpoint.Reader","reader");
+  BOOST_CHECK_THROW(reader->read_mesh_into("checkpoint.cf3chk", *restarted), SetupError);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
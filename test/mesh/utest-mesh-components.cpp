@@ -700,6 +700,111 @@ BOOST_AUTO_TEST_CASE ( DynTable_test_hard )
 
 }
 
+BOOST_AUTO_TEST_CASE ( ReserveTest )
+{
+  // Table: reserved rows are filled directly, without allocating buffers
+  boost::shared_ptr< Table<Uint> > table (allocate_component< Table<Uint> >("table"));
+  table->set_row_size(2);
+  Table<Uint>::Buffer table_buffer = table->create_buffer(3);
+  std::vector<Uint> row(2);
+  row[0] = 1; row[1] = 2;
+  table_buffer.add_row(row);
+  table_buffer.reserve(4);
+  BOOST_CHECK_EQUAL(table->size(), (Uint) 5);
+  for (Uint i=0; i<4; ++i)
+  {
+    row[0] = i; row[1] = 2*i;
+    BOOST_CHECK_EQUAL(table_buffer.add_row(row), 1+i);
+  }
+  BOOST_CHECK_EQUAL(table_buffer.buffers_count(), (Uint) 0);
+  table_buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), (Uint) 5);
+  BOOST_CHECK_EQUAL((*table)[4][1], (Uint) 6);
+
+  // Rows beyond the reservation go to the buffers, unused reserved rows are removed
+  table_buffer.reserve(2);
+  table_buffer.add_row(row);
+  table_buffer.add_row(row);
+  BOOST_CHECK_EQUAL(table_buffer.add_row(row), (Uint) 7);
+  table_buffer.rm_row(0);
+  table_buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), (Uint) 7);
+  BOOST_CHECK_EQUAL((*table)[0][0], (Uint) 3);
+  table_buffer.reserve(10);
+  row[0] = 11;
+  table_buffer.add_row(row);
+  table_buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), (Uint) 8);
+  BOOST_CHECK_EQUAL((*table)[7][0], (Uint) 11);
+
+  // Reserved rows filled by set_row() are kept, and skipped by add_row()
+  table_buffer.reserve(3);
+  row[0] = 100;
+  table_buffer.set_row(9,row);
+  row[0] = 101;
+  BOOST_CHECK_EQUAL(table_buffer.add_row(row), (Uint) 8);
+  row[0] = 102;
+  BOOST_CHECK_EQUAL(table_buffer.add_row(row), (Uint) 10);
+  table_buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), (Uint) 11);
+  BOOST_CHECK_EQUAL((*table)[9][0], (Uint) 100);
+  BOOST_CHECK_EQUAL((*table)[10][0], (Uint) 102);
+
+  // Pending removals are not flushed by reserve(), so row indices stay valid
+  table_buffer.rm_row(2);
+  table_buffer.reserve(2);
+  BOOST_CHECK_EQUAL(table->size(), (Uint) 13);
+  row[0] = 200;
+  BOOST_CHECK_EQUAL(table_buffer.add_row(row), (Uint) 11);
+  table_buffer.rm_row(3);
+  BOOST_CHECK_EQUAL(table_buffer.add_row(row), (Uint) 12);
+  table_buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), (Uint) 11);
+
+  // With buffered rows and removals, the reserved rows are allocated as one buffer
+  const Uint buffered_row = table_buffer.add_row(row);
+  table_buffer.rm_row(0);
+  table_buffer.reserve(5);
+  for (Uint i=0; i<5; ++i)
+    table_buffer.add_row(row);
+  BOOST_CHECK_EQUAL(table_buffer.buffers_count(), (Uint) 2);
+  BOOST_CHECK_EQUAL(table_buffer.get_row(buffered_row)[0], (Uint) 200);
+  table_buffer.flush();
+  BOOST_CHECK_EQUAL(table->size(), (Uint) 16);
+
+  // List
+  List<Uint>& list = *root.create_component< List<Uint> >("reserved_list");
+  List<Uint>::Buffer list_buffer = list.create_buffer(3);
+  list_buffer.reserve(3);
+  list_buffer.add_row(5);
+  list_buffer.add_row(6);
+  list_buffer.flush();
+  BOOST_CHECK_EQUAL(list.size(), (Uint) 2);
+  BOOST_CHECK_EQUAL(list[1], (Uint) 6);
+
+  // DynTable
+  DynTable<Uint>& dyn_table = *root.create_component< DynTable<Uint> >("reserved_dyn_table");
+  DynTable<Uint>::Buffer dyn_buffer = dyn_table.create_buffer(3);
+  dyn_buffer.reserve(2);
+  dyn_buffer.add_row(std::vector<Uint>(3,1));
+  dyn_buffer.add_row(std::vector<Uint>(1,2));
+  dyn_buffer.add_row(std::vector<Uint>(2,3));
+  dyn_buffer.flush();
+  BOOST_CHECK_EQUAL(dyn_table.size(), (Uint) 3);
+  BOOST_CHECK_EQUAL(dyn_table.row_size(0), (Uint) 3);
+  BOOST_CHECK_EQUAL(dyn_table.row_size(2), (Uint) 2);
+  BOOST_CHECK_EQUAL(dyn_table[2][1], (Uint) 3);
+
+  // set_row() sizes a reserved row that was not filled yet
+  dyn_buffer.reserve(2);
+  dyn_buffer.set_row(4,std::vector<Uint>(4,5));
+  BOOST_CHECK_EQUAL(dyn_buffer.add_row(std::vector<Uint>(1,4)), (Uint) 3);
+  dyn_buffer.flush();
+  BOOST_CHECK_EQUAL(dyn_table.size(), (Uint) 5);
+  BOOST_CHECK_EQUAL(dyn_table.row_size(4), (Uint) 4);
+  BOOST_CHECK_EQUAL(dyn_table[4][3], (Uint) 5);
+}
+
 
 BOOST_AUTO_TEST_CASE ( Mesh_test )
 {
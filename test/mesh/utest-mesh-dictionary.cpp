@@ -14,6 +14,8 @@
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/Core.hpp"
+#include "common/List.hpp"
+#include "common/FindComponents.hpp"
 
 #include "math/MatrixTypes.hpp"
 #include "math/VariablesDescriptor.hpp"
@@ -28,6 +30,7 @@
 #include "mesh/Space.hpp"
 #include "mesh/Faces.hpp"
 #include "mesh/Cells.hpp"
+#include "mesh/Tags.hpp"
 
 using namespace boost;
 using namespace cf3;
@@ -260,6 +263,57 @@ BOOST_AUTO_TEST_CASE( FieldVariables )
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( UsedNodesCache )
+{
+  Mesh& mesh = *m_mesh;
+  Dictionary& nodes = mesh.geometry_fields();
+  const Region& bottom = *mesh.topology().get_child("bottom")->handle<Region>();
+
+  boost::shared_ptr< List<Uint> const > used_nodes = nodes.used_nodes(bottom);
+  BOOST_CHECK_EQUAL( used_nodes->size() , 6u );
+  for (Uint i=1; i<used_nodes->size(); ++i)
+    BOOST_CHECK( (*used_nodes)[i-1] < (*used_nodes)[i] );
+
+  // Same list as long as the dictionary is unchanged
+  BOOST_CHECK( nodes.used_nodes(bottom) == used_nodes );
+  BOOST_CHECK_EQUAL( nodes.used_nodes(mesh.topology())->size() , nodes.size() );
+
+  // Rebuilt for a new revision
+  const Uint revision = nodes.revision();
+  mesh.update_structures();
+  BOOST_CHECK( nodes.revision() > revision );
+  BOOST_CHECK( nodes.used_nodes(bottom) != used_nodes );
+  BOOST_CHECK( nodes.used_nodes(bottom)->array() == used_nodes->array() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( EntitiesUsedNodes )
+{
+  Mesh& mesh = *m_mesh;
+  Region& bottom = *mesh.topology().get_child("bottom")->handle<Region>();
+  Elements& bottom_elements = *find_component_ptr_recursively<Elements>(bottom);
+
+  // A list that was not made by Entities::used_nodes is not trusted
+  if (Handle< List<Uint> > existing = find_component_ptr_with_tag< List<Uint> >(bottom, mesh::Tags::nodes_used()))
+    bottom.remove_component(*existing);
+  Handle< List<Uint> > foreign = bottom.create_component< List<Uint> >(mesh::Tags::nodes_used());
+  foreign->add_tag(mesh::Tags::nodes_used());
+  BOOST_CHECK_EQUAL( Entities::used_nodes(bottom).size() , 6u );
+
+  // Resizing the elements changes the connectivity, and with it the used nodes
+  const Uint revision = mesh.geometry_fields().revision();
+  bottom_elements.resize(1);
+  BOOST_CHECK( mesh.geometry_fields().revision() > revision );
+  BOOST_CHECK_EQUAL( Entities::used_nodes(bottom).size() , 2u );
+
+  // A component without entities uses no nodes
+  Component& empty = *mesh.create_component<Component>("empty");
+  BOOST_CHECK_EQUAL( Entities::used_nodes(empty).size() , 0u );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
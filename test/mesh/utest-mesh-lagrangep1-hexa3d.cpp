@@ -181,6 +181,40 @@ BOOST_AUTO_TEST_CASE( MappedCoordinates )
   }
 }
 
+BOOST_AUTO_TEST_CASE( MappedCoordinatesBatch )
+{
+  RealMatrix expected(4, ETYPE::dimensionality);
+  expected <<
+    0.1, 0.8, -0.4,
+    0., 0., 0.,
+    -0.9, 0.3, 0.7,
+    1., -1., 1.;
+
+  RealMatrix coords(expected.rows(), ETYPE::dimension);
+  ETYPE::SF::ValueT sf;
+  for(Uint i = 0; i != expected.rows(); ++i)
+  {
+    ETYPE::SF::compute_value(expected.row(i).transpose(), sf);
+    coords.row(i) = sf * skewed_nodes;
+  }
+
+  RealMatrix result;
+  ETYPE::compute_mapped_coordinates(coords, skewed_nodes, result);
+  BOOST_CHECK_EQUAL(result.rows(), expected.rows());
+
+  // The batch must give exactly the same result as the single point inversion
+  for(Uint i = 0; i != expected.rows(); ++i)
+  {
+    ETYPE::MappedCoordsT single;
+    ETYPE::compute_mapped_coordinate(coords.row(i).transpose(), skewed_nodes, single);
+    for(Uint j = 0; j != ETYPE::dimensionality; ++j)
+    {
+      BOOST_CHECK_EQUAL(result(i,j), single[j]);
+      BOOST_CHECK_SMALL(result(i,j) - expected(i,j), 1e-10);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( MappedGradient )
 {
   ETYPE::SF::GradientT expected;
@@ -280,6 +314,23 @@ BOOST_AUTO_TEST_CASE( Is_coord_in_element )
   BOOST_CHECK_EQUAL(ETYPE::is_coord_in_element(centroid*5.,skewed_nodes),false);
 }
 
+BOOST_AUTO_TEST_CASE( Are_coords_in_element )
+{
+  const ETYPE::CoordsT centroid = skewed_nodes.colwise().sum() / ETYPE::nb_nodes;
+
+  RealMatrix coords(4, ETYPE::dimension);
+  coords.row(0) = centroid;
+  coords.row(1) = skewed_nodes.row(6);
+  coords.row(2) = centroid*5.;  // outside the bounding box
+  coords.row(3) = skewed_nodes.row(0) - 0.1*(skewed_nodes.row(6) - skewed_nodes.row(0));
+
+  std::vector<bool> is_inside;
+  BOOST_CHECK_EQUAL(ETYPE::are_coords_in_element(coords, skewed_nodes, is_inside), 2u);
+  BOOST_CHECK_EQUAL(is_inside.size(), 4u);
+  for(Uint i = 0; i != is_inside.size(); ++i)
+    BOOST_CHECK_EQUAL(is_inside[i], ETYPE::is_coord_in_element(coords.row(i).transpose(), skewed_nodes));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -119,6 +119,23 @@ BOOST_AUTO_TEST_CASE( Octtree_creation )
   element = octtree.find_element(coord);
   BOOST_CHECK_EQUAL(element.idx,5u);
 
+  // Several coordinates at once, some in the same element, and one outside the mesh
+  RealMatrix coords(5,2);
+  coords << 1. , 1. ,
+            1.5, 0.5,
+            3. , 1. ,
+            1. , 3. ,
+            11., 1. ;
+  std::vector<Entity> elements;
+  std::vector<bool> found;
+  BOOST_CHECK_EQUAL(octtree.find_elements(coords,elements,found), 4u);
+  BOOST_CHECK_EQUAL(elements[0].idx,0u);
+  BOOST_CHECK_EQUAL(elements[1].idx,0u);
+  BOOST_CHECK_EQUAL(elements[2].idx,1u);
+  BOOST_CHECK_EQUAL(elements[3].idx,5u);
+  BOOST_CHECK(found[0] && found[1] && found[2] && found[3]);
+  BOOST_CHECK(!found[4]);
+
 
   Handle<StencilComputerOcttree> stencil_computer = Core::instance().root().create_component<StencilComputerOcttree>("stencilcomputer");  
   stencil_computer->options().set("dict", dict );
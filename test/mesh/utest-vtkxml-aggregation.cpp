@@ -0,0 +1,140 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for aggregated output of cf3::mesh::VTKXML::Writer"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <boost/cstdint.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+#include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshWriter.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Decompress the appended array that starts at the given position of the file contents
+std::vector<Real> read_array(const std::string& contents, std::size_t pos)
+{
+  boost::uint32_t header[3];
+  std::memcpy(header, &contents[pos], sizeof(header));
+  const boost::uint32_t nb_blocks = header[0];
+
+  std::vector<boost::uint32_t> block_sizes(nb_blocks);
+  if(nb_blocks != 0)
+    std::memcpy(&block_sizes[0], &contents[pos + sizeof(header)], nb_blocks*sizeof(boost::uint32_t));
+  pos += sizeof(header) + nb_blocks*sizeof(boost::uint32_t);
+
+  std::string raw;
+  for(Uint i = 0; i != nb_blocks; ++i)
+  {
+    boost::iostreams::filtering_istream block;
+    block.push(boost::iostreams::zlib_decompressor());
+    block.push(boost::iostreams::array_source(&contents[pos], block_sizes[i]));
+    std::stringstream decompressed;
+    decompressed << block.rdbuf();
+    raw += decompressed.str();
+    pos += block_sizes[i];
+  }
+
+  std::vector<Real> result(raw.size() / sizeof(Real));
+  if(!result.empty())
+    std::memcpy(&result[0], raw.data(), result.size()*sizeof(Real));
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( VTKXMLAggregationSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+}
+
+BOOST_AUTO_TEST_CASE( ReadBack )
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("mesh");
+  Tools::MeshGeneration::create_rectangle(*mesh, 5., 5., 5, 5);
+
+  // Field values that are different on every rank
+  Field& field = mesh->geometry_fields().create_field("u", "u[1]");
+  for(Uint i = 0; i != field.size(); ++i)
+    field[i][0] = 1000.*rank + i;
+
+  boost::shared_ptr< MeshWriter > vtk_writer = build_component_abstract_type<MeshWriter>("cf3.mesh.VTKXML.Writer","meshwriter");
+
+  std::vector<URI> fields; fields.push_back(field.uri());
+  vtk_writer->options().set("fields",fields);
+  vtk_writer->options().set("mesh",mesh);
+  vtk_writer->options().set("file",URI("aggregated.vtu"));
+  vtk_writer->options().set("aggregation_ratio",nb_procs);
+  vtk_writer->execute();
+
+  PE::Comm::instance().barrier();
+
+  if(rank != 0)
+    return;
+
+  std::ifstream file("aggregated_G0.vtu", std::ios_base::in | std::ios_base::binary);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const std::string contents = buffer.str();
+
+  const std::string appended_tag = "<AppendedData encoding=\"raw\">\n_";
+  const std::size_t data_begin = contents.find(appended_tag);
+  BOOST_REQUIRE(data_begin != std::string::npos);
+
+  // Each rank wrote one piece, in rank order, with its offsets shifted into the data of the group
+  Uint piece = 0;
+  for(std::size_t name_pos = contents.find("Name=\"u\""); name_pos < data_begin; name_pos = contents.find("Name=\"u\"", name_pos+1), ++piece)
+  {
+    const std::size_t offset_begin = contents.find("offset=\"", name_pos) + 8;
+    const std::size_t offset_end = contents.find("\"", offset_begin);
+    const boost::uint64_t offset = from_str<boost::uint64_t>(contents.substr(offset_begin, offset_end - offset_begin));
+
+    const std::vector<Real> values = read_array(contents, data_begin + appended_tag.size() + offset);
+    BOOST_REQUIRE_EQUAL(values.size(), field.size());
+    for(Uint i = 0; i != values.size(); ++i)
+      BOOST_CHECK_EQUAL(values[i], 1000.*piece + i);
+  }
+  BOOST_CHECK_EQUAL(piece, nb_procs);
+}
+
+BOOST_AUTO_TEST_CASE( Finalize )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
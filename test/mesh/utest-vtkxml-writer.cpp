@@ -7,14 +7,20 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for cf3::mesh::tecplot::Writer"
 
+#include <fstream>
+#include <sstream>
+
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include "common/BoostFilesystem.hpp"
 #include "common/Log.hpp"
 #include "common/Core.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionComponent.hpp"
 #include "common/OptionArray.hpp"
 #include "common/OptionURI.hpp"
+#include "common/StringConversion.hpp"
 #include "mesh/MeshWriter.hpp"
 
 #include "Tools/MeshGeneration/MeshGeneration.hpp"
@@ -23,6 +29,7 @@
 #include "common/Table.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
+#include "mesh/MeshMetadata.hpp"
 
 using namespace cf3;
 using namespace cf3::mesh;
@@ -54,6 +61,82 @@ BOOST_AUTO_TEST_CASE( WriteGrid )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( WriteAggregatedGrid )
+{
+  Handle<Mesh> mesh(Core::instance().root().get_child("mesh"));
+
+  boost::shared_ptr< MeshWriter > vtk_writer = build_component_abstract_type<MeshWriter>("cf3.mesh.VTKXML.Writer","meshwriter");
+
+  std::vector<URI> fields; fields.push_back(mesh->geometry_fields().coordinates().uri());
+  vtk_writer->options().set("fields",fields);
+  vtk_writer->options().set("mesh",mesh);
+  vtk_writer->options().set("file",URI("grid-aggregated.vtu"));
+  vtk_writer->options().set("aggregation_ratio",4u);
+  vtk_writer->execute();
+
+  // A single rank forms one group
+  BOOST_CHECK(boost::filesystem::exists("grid-aggregated_G0.vtu"));
+  BOOST_CHECK(boost::filesystem::exists("grid-aggregated.pvtu"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteTimeSeries )
+{
+  Handle<Mesh> mesh(Core::instance().root().get_child("mesh"));
+
+  boost::shared_ptr< MeshWriter > vtk_writer = build_component_abstract_type<MeshWriter>("cf3.mesh.VTKXML.Writer","meshwriter");
+
+  std::vector<URI> fields; fields.push_back(mesh->geometry_fields().coordinates().uri());
+  vtk_writer->options().set("fields",fields);
+  vtk_writer->options().set("mesh",mesh);
+  vtk_writer->options().set("file",URI("series.xmf"));
+  vtk_writer->options().set("time_series",true);
+
+  for(Uint step = 0; step != 3; ++step)
+  {
+    mesh->metadata()["time"] = 0.5*step;
+    vtk_writer->execute();
+  }
+
+  // Moving the mesh invalidates the stored geometry
+  mesh->geometry_fields().coordinates()[0][0] += 0.1;
+  vtk_writer->execute();
+
+  // The geometry is only written for the first step and after the move: 36 points and 25 quads
+  const Uint geometry_size = 36*3*sizeof(Real) + 25*4*4;
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size("series_0000_mesh_P0.bin"), geometry_size);
+  BOOST_CHECK(!boost::filesystem::exists("series_0001_mesh_P0.bin"));
+  BOOST_CHECK(!boost::filesystem::exists("series_0002_mesh_P0.bin"));
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size("series_0003_mesh_P0.bin"), geometry_size);
+
+  // Each step only holds the coordinates field, padded to 3 components
+  for(Uint step = 0; step != 4; ++step)
+    BOOST_CHECK_EQUAL(boost::filesystem::file_size("series_000" + to_str(step) + "_P0.bin"), 36*3*sizeof(Real));
+
+  std::ifstream xdmf_file("series.xmf");
+  std::stringstream xdmf;
+  xdmf << xdmf_file.rdbuf();
+  const std::string contents = xdmf.str();
+
+  // The steps before the move refer to the geometry of the first step
+  const std::size_t step_2 = contents.find("<Time Value=\"1\"/>");
+  const std::size_t step_3 = contents.find("<Time Value=\"1.5\"/>");
+  BOOST_REQUIRE(step_2 != std::string::npos);
+  BOOST_REQUIRE(step_3 != std::string::npos);
+  BOOST_CHECK(contents.find("series_0000_mesh_P0.bin", step_2) < step_3);
+  BOOST_CHECK(contents.find("series_0003_mesh_P0.bin", step_3) != std::string::npos);
+
+  // Each step was appended once, before the closing tags
+  std::size_t nb_steps = 0;
+  for(std::size_t pos = contents.find("<Time "); pos != std::string::npos; pos = contents.find("<Time ", pos + 1))
+    ++nb_steps;
+  BOOST_CHECK_EQUAL(nb_steps, 4u);
+  BOOST_CHECK(boost::algorithm::ends_with(contents, "</Grid>\n</Grid>\n</Domain>\n</Xdmf>\n"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
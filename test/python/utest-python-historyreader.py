@@ -0,0 +1,58 @@
+import struct
+
+import historyreader
+from check import *
+
+# Binary history file as written by cf3.solver.History with the option binary
+def schema(names):
+  result = b'SCHM' + struct.pack('<I', len(names))
+  for name in names:
+    result += struct.pack('<I', len(name)) + name.encode('ascii')
+  return result
+
+def data(columns):
+  result = b'DATA' + struct.pack('<I', len(columns[0]))
+  for column in columns:
+    result += struct.pack('<%dd' % len(column), *column)
+  return result
+
+contents = b'CF3HIST1' + struct.pack('<I', 1)
+contents += schema(['iter', 'residual'])
+contents += data([[0., 1., 2.], [1., 0.5, 0.25]])
+contents += schema(['iter', 'residual', 'cfl'])
+last_block = data([[3., 4., 5., 6.], [0.125, 0.0625, 0.03125, 0.015625], [10., 20., 30., 40.]])
+contents += last_block
+
+def write(filename, nb_bytes):
+  f = open(filename, 'wb')
+  f.write(contents[0:nb_bytes])
+  f.close()
+
+# Complete file
+write('utest-python-historyreader.cfh', len(contents))
+columns = historyreader.read('utest-python-historyreader.cfh')
+cf_check_equal(list(columns.keys()), ['iter', 'residual', 'cfl'], 'Wrong columns')
+cf_check_equal(list(columns['iter']), [0., 1., 2., 3., 4., 5., 6.], 'Wrong iterations')
+cf_check_equal(list(columns['cfl']), [0., 0., 0., 10., 20., 30., 40.], 'Wrong cfl')
+
+# Cut off in the middle of the second value of the last column: only the first row of the last block is complete
+write('utest-python-historyreader-truncated.cfh', len(contents) - 3*8 + 5)
+columns = historyreader.read('utest-python-historyreader-truncated.cfh')
+cf_check_equal(list(columns['iter']), [0., 1., 2., 3.], 'Wrong iterations in truncated file')
+cf_check_equal(list(columns['residual']), [1., 0.5, 0.25, 0.125], 'Wrong residual in truncated file')
+cf_check_equal(list(columns['cfl']), [0., 0., 0., 10.], 'Wrong cfl in truncated file')
+
+# Cut off before the last column: the last block has no complete rows
+write('utest-python-historyreader-truncated.cfh', len(contents) - 4*8 - 3)
+columns = historyreader.read('utest-python-historyreader-truncated.cfh')
+cf_check_equal(list(columns['iter']), [0., 1., 2.], 'Wrong iterations in truncated file')
+
+# Cut off in the header of the last block
+write('utest-python-historyreader-truncated.cfh', len(contents) - len(last_block) + 6)
+columns = historyreader.read('utest-python-historyreader-truncated.cfh')
+cf_check_equal(list(columns['residual']), [1., 0.5, 0.25], 'Wrong residual in truncated file')
+
+# Converting a truncated file
+historyreader.to_tsv('utest-python-historyreader-truncated.cfh', 'utest-python-historyreader-truncated.tsv')
+lines = open('utest-python-historyreader-truncated.tsv').readlines()
+cf_check_equal(len(lines), 4, 'Wrong number of lines in the converted file')
@@ -0,0 +1,132 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Parallel test module for the asynchronous output of cf3::solver::actions::PeriodicWriteMesh"
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Group.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshMetadata.hpp"
+
+#include "solver/actions/PeriodicWriteMesh.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Write nb_steps snapshots of a partitioned mesh, with the given staging memory on this rank,
+/// and check that the file of this rank has the field values of each snapshot
+void write_and_check(const std::string& name, const Uint staging_memory)
+{
+  const Uint rank = PE::Comm::instance().rank();
+
+  Group& root = *Core::instance().root().create_component<Group>(name);
+  Handle<MeshGenerator> generator = root.create_component<MeshGenerator>("generator", "cf3.mesh.SimpleMeshGenerator");
+  generator->options().set("mesh", root.uri()/"mesh");
+  generator->options().set("lengths", std::vector<Real>(2, 10.));
+  generator->options().set("nb_cells", std::vector<Uint>(2, 8));
+  generator->options().set("part", rank);
+  generator->options().set("nb_parts", PE::Comm::instance().size());
+  Mesh& mesh = generator->generate();
+  Field& field = mesh.geometry_fields().create_field("u", "u[1]");
+
+  Component& iterator = *root.create_component<Component>("iterator");
+  iterator.properties().add("iteration", 0u);
+
+  Handle<PeriodicWriteMesh> writer = root.create_component<PeriodicWriteMesh>("writer");
+  writer->options().set("mesh", mesh.handle<Mesh>());
+  writer->options().set("iterator", iterator.handle<Component>());
+  writer->options().set("saverate", 1u);
+  writer->options().set("filepath", URI(name + "-${iter}.msh"));
+  writer->options().set("asynchronous", true);
+  writer->options().set("staging_memory", staging_memory);
+
+  const Uint nb_steps = 4;
+  for(Uint step = 0; step != nb_steps; ++step)
+  {
+    iterator.properties()["iteration"] = step;
+    mesh.metadata()["iter"] = step;
+    mesh.metadata()["time"] = 0.5*step;
+    for(Uint i = 0; i != field.size(); ++i)
+      field[i][0] = 100.*rank + step;
+    writer->execute();
+  }
+  writer->flush();
+  PE::Comm::instance().barrier();
+
+  for(Uint step = 0; step != nb_steps; ++step)
+  {
+    const std::string filename = name + "-" + to_str(step) + "_P" + to_str(rank) + ".msh";
+    BOOST_REQUIRE(boost::filesystem::exists(filename));
+
+    std::ifstream file(filename.c_str());
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    std::stringstream header;
+    header << "$NodeData\n2\n\"u\"\n\"u\"\n1\n" << 0.5*step << "\n3\n" << step << "\n";
+    const std::size_t data_pos = contents.str().find(header.str());
+    BOOST_REQUIRE(data_pos != std::string::npos);
+
+    std::stringstream data(contents.str().substr(data_pos + header.str().size()));
+    Uint datasize, nb_nodes, node;
+    Real value;
+    data >> datasize >> nb_nodes >> node >> value;
+    BOOST_CHECK_EQUAL(value, 100.*rank + step);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( PeriodicWriteMeshParallelSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  BOOST_CHECK(PE::Comm::instance().size() > 1);
+}
+
+BOOST_AUTO_TEST_CASE( AsynchronousOnAllRanks )
+{
+  write_and_check("async-all", 1024u);
+}
+
+BOOST_AUTO_TEST_CASE( UnequalBudgets )
+{
+  // The snapshots don't fit the budget of rank 0 only: all ranks must take the same path
+  write_and_check("async-unequal", PE::Comm::instance().rank() == 0 ? 0u : 1024u);
+}
+
+BOOST_AUTO_TEST_CASE( Finalize )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
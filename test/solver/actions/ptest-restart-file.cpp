@@ -0,0 +1,139 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Parallel test module for cf3::solver::actions::WriteRestartFile and ReadRestartFile"
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Group.hpp"
+#include "common/OptionList.hpp"
+#include "common/Table.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshMetadata.hpp"
+
+#include "solver/History.hpp"
+#include "solver/Time.hpp"
+#include "solver/actions/ReadRestartFile.hpp"
+#include "solver/actions/WriteRestartFile.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+using namespace cf3::solver::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( RestartFileSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  BOOST_CHECK(PE::Comm::instance().size() > 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( WriteRead )
+{
+  const Uint rank = PE::Comm::instance().rank();
+  Component& root = Core::instance().root();
+
+  // State to write
+  Group& original = *root.create_component<Group>("original");
+  Handle<MeshGenerator> generator = original.create_component<MeshGenerator>("generator", "cf3.mesh.SimpleMeshGenerator");
+  generator->options().set("mesh", original.uri()/"mesh");
+  generator->options().set("lengths", std::vector<Real>(2, 10.));
+  generator->options().set("nb_cells", std::vector<Uint>(2, 8));
+  generator->options().set("part", rank);
+  generator->options().set("nb_parts", PE::Comm::instance().size());
+  Mesh& mesh = generator->generate();
+  Field& field = mesh.geometry_fields().create_field("u", "u[1]");
+  for(Uint i = 0; i != field.size(); ++i)
+    field[i][0] = 100.*rank + i;
+
+  Time& time = *original.create_component<Time>("Time");
+  time.options().set("time_step", 0.25);
+  time.options().set("current_time", 1.5);
+  time.options().set("iteration", 6u);
+
+  History& history = *original.create_component<History>("History");
+  history.options().set("dimension", 2u);
+  history.options().set("logging", false);
+  for(Uint i = 0; i != 3; ++i)
+  {
+    history.set("iteration", static_cast<Real>(i));
+    history.set("residual", 1. / (i+1));
+    history.save_entry();
+  }
+
+  WriteRestartFile& write = *original.create_component<WriteRestartFile>("WriteRestartFile");
+  write.options().set("mesh", mesh.handle<Mesh>());
+  write.options().set("time", time.handle<Time>());
+  write.options().set("history", history.handle<History>());
+  write.options().set("file", URI("restart-parallel.cf3chk"));
+  write.execute();
+
+  // The history is only stored by rank 0
+  BOOST_CHECK_EQUAL(mesh.metadata().check("history_data"), rank == 0);
+
+  // Restart into fresh components
+  Group& restarted = *root.create_component<Group>("restarted");
+  Mesh& restarted_mesh = *restarted.create_component<Mesh>("mesh");
+  Time& restarted_time = *restarted.create_component<Time>("Time");
+  History& restarted_history = *restarted.create_component<History>("History");
+  restarted_history.options().set("logging", false);
+
+  ReadRestartFile& read = *restarted.create_component<ReadRestartFile>("ReadRestartFile");
+  read.options().set("mesh", restarted_mesh.handle<Mesh>());
+  read.options().set("time", restarted_time.handle<Time>());
+  read.options().set("history", restarted_history.handle<History>());
+  read.options().set("file", URI("restart-parallel.cf3chk"));
+  read.execute();
+
+  BOOST_CHECK_EQUAL(restarted_time.dt(), 0.25);
+  BOOST_CHECK_EQUAL(restarted_time.current_time(), 1.5);
+  BOOST_CHECK_EQUAL(restarted_time.iter(), 6u);
+
+  Handle<Field const> restarted_field(restarted_mesh.geometry_fields().get_child("u"));
+  BOOST_REQUIRE(is_not_null(restarted_field));
+  BOOST_REQUIRE_EQUAL(restarted_field->size(), field.size());
+  for(Uint i = 0; i != field.size(); ++i)
+    BOOST_CHECK_EQUAL((*restarted_field)[i][0], field[i][0]);
+
+  // Every rank has the history of rank 0
+  BOOST_CHECK(restarted_history.variable_names() == history.variable_names());
+  BOOST_CHECK_EQUAL(restarted_history.options().value<Uint>("dimension"), 2u);
+  const Table<Real>& table = *history.table();
+  const Table<Real>& restarted_table = *restarted_history.table();
+  BOOST_REQUIRE_EQUAL(restarted_table.size(), table.size());
+  BOOST_REQUIRE_EQUAL(restarted_table.row_size(), table.row_size());
+  for(Uint i = 0; i != table.size(); ++i)
+    for(Uint j = 0; j != table.row_size(); ++j)
+      BOOST_CHECK_EQUAL(restarted_table[i][j], table[i][j]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Finalize )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,100 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the asynchronous output of cf3::solver::actions::PeriodicWriteMesh"
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Group.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/StringConversion.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshMetadata.hpp"
+
+#include "solver/actions/PeriodicWriteMesh.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( PeriodicWriteMeshSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( AsynchronousSnapshots )
+{
+  Group& root = *Core::instance().root().create_component<Group>("AsynchronousSnapshots");
+  Mesh& mesh = *root.create_component<Mesh>("mesh");
+  Tools::MeshGeneration::create_rectangle(mesh, 5., 5., 5, 5);
+  Field& field = mesh.geometry_fields().create_field("u", "u[1]");
+
+  Component& iterator = *root.create_component<Component>("iterator");
+  iterator.properties().add("iteration", 0u);
+
+  Handle<PeriodicWriteMesh> writer = root.create_component<PeriodicWriteMesh>("writer");
+  writer->options().set("mesh", mesh.handle<Mesh>());
+  writer->options().set("iterator", iterator.handle<Component>());
+  writer->options().set("saverate", 1u);
+  writer->options().set("filepath", URI("periodic-async-${iter}.msh"));
+  writer->options().set("asynchronous", true);
+
+  // Several snapshots are in flight while the metadata and the field change underneath
+  const Uint nb_steps = 5;
+  for(Uint step = 0; step != nb_steps; ++step)
+  {
+    iterator.properties()["iteration"] = step;
+    mesh.metadata()["iter"] = step;
+    mesh.metadata()["time"] = 0.5*step;
+    for(Uint i = 0; i != field.size(); ++i)
+      field[i][0] = step;
+    writer->execute();
+  }
+  writer->flush();
+
+  for(Uint step = 0; step != nb_steps; ++step)
+  {
+    const std::string filename = "periodic-async-" + to_str(step) + ".msh";
+    BOOST_REQUIRE(boost::filesystem::exists(filename));
+
+    std::ifstream file(filename.c_str());
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    // Time and iteration are the ones at the time of the snapshot
+    std::stringstream header;
+    header << "$NodeData\n2\n\"u\"\n\"u\"\n1\n" << 0.5*step << "\n3\n" << step << "\n";
+    const std::size_t data_pos = contents.str().find(header.str());
+    BOOST_REQUIRE(data_pos != std::string::npos);
+
+    // So are the field values: the first node line follows the number of nodes
+    std::stringstream data(contents.str().substr(data_pos + header.str().size()));
+    Uint datasize, nb_nodes, node;
+    Real value;
+    data >> datasize >> nb_nodes >> node >> value;
+    BOOST_CHECK_EQUAL(value, static_cast<Real>(step));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -748,6 +748,53 @@ BOOST_AUTO_TEST_CASE( NodeIndexLoop )
   BOOST_CHECK_EQUAL(total_sum, 24.);
 }
 
+BOOST_AUTO_TEST_CASE( CachedElementMatrix )
+{
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("cached_matrix_grid");
+  Tools::MeshGeneration::create_rectangle(*mesh, 1., 1., 3, 3);
+
+  mesh->geometry_fields().create_field( "Temperature", "Temperature" ).add_tag("solution");
+
+  FieldVariable<0, ScalarField > T("Temperature", "solution");
+
+  ElementMatrixCache cache;
+  int count = 0;
+  RealMatrix4 total;
+  RealMatrix4 first_total;
+
+  for(Uint i = 0; i != 3; ++i)
+  {
+    if(i == 2)
+      cache.invalidate();
+
+    total.setZero();
+    for_each_element< boost::mpl::vector1<LagrangeP1::Quad2D> >
+    (
+      mesh->topology(),
+      group
+      (
+        cache_element_matrix
+        (
+          cache, _A,
+          counter(count),
+          _A = _0,
+          element_quadrature(_A(T) += transpose(nabla(T))*nabla(T))
+        ),
+        lit(total) += _A
+      )
+    );
+
+    if(i == 0)
+      first_total = total;
+
+    // The element matrices are only computed on the first run and after invalidation
+    BOOST_CHECK_EQUAL(count, i == 2 ? 18 : 9);
+    for(Uint r = 0; r != 4; ++r)
+      for(Uint c = 0; c != 4; ++c)
+        BOOST_CHECK_CLOSE(total(r,c), first_total(r,c), 1e-10);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
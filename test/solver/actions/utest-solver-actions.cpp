@@ -13,6 +13,7 @@
 
 #include <boost/assign/list_of.hpp>
 
+#include "common/BoostFilesystem.hpp"
 #include "common/LibCommon.hpp"
 
 #include "common/Log.hpp"
@@ -21,6 +22,7 @@
 #include "common/Environment.hpp"
 #include "common/Group.hpp"
 #include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/MeshWriter.hpp"
@@ -28,6 +30,7 @@
 #include "mesh/MeshTransformer.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/LoadMesh.hpp"
+#include "mesh/MeshGenerator.hpp"
 #include "mesh/Cells.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Connectivity.hpp"
@@ -41,6 +44,10 @@
 #include "solver/actions/LoopOperation.hpp"
 #include "solver/actions/ComputeVolume.hpp"
 #include "solver/actions/ComputeArea.hpp"
+#include "solver/actions/ExtractSlice.hpp"
+#include "solver/actions/ExtractBoundary.hpp"
+#include "solver/actions/ExtractIsoSurface.hpp"
+#include "solver/actions/ExtractProbeLine.hpp"
 
 using namespace boost::assign;
 
@@ -264,6 +271,166 @@ BOOST_AUTO_TEST_CASE ( test_ForAllElementsT )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE ( test_Extracts )
+{
+  Component& root = Core::instance().root();
+  Handle<Mesh> mesh = root.create_component<Mesh>("extract_mesh");
+  Core::instance().tools().get_child("LoadMesh")->handle<LoadMesh>()->load_mesh_into("../../../resources/rotation-tg-p1.neu", *mesh);
+
+  Field& x_field = mesh->geometry_fields().create_field("x_field");
+  const Field& coords = mesh->geometry_fields().coordinates();
+  Real x_min = coords[0][XX], x_max = coords[0][XX];
+  for(Uint i = 0; i != coords.size(); ++i)
+  {
+    x_field[i][0] = coords[i][XX];
+    x_min = std::min(x_min, coords[i][XX]);
+    x_max = std::max(x_max, coords[i][XX]);
+  }
+  const Real x_mid = 0.5*(x_min + x_max);
+
+  Handle<Group> iterator = root.create_component<Group>("extract_iterator");
+  iterator->properties().add("iteration", 0u);
+
+  // Slice through the middle of the mesh
+  Handle<ExtractSlice> slice = root.create_component<ExtractSlice>("slice");
+  slice->options().set("mesh", mesh);
+  slice->options().set("iterator", iterator);
+  slice->options().set("saverate", 1u);
+  slice->options().set("file", URI("test_utest-actions_slice.msh"));
+  slice->options().set("origin", std::vector<Real>(list_of(x_mid)(0.)));
+  slice->options().set("normal", std::vector<Real>(list_of(1.)(0.)));
+  slice->execute();
+
+  const Mesh& slice_mesh = *slice->extracted();
+  BOOST_CHECK(slice_mesh.geometry_fields().size() > 0);
+  BOOST_CHECK(slice_mesh.topology().recursive_elements_count(true) > 0);
+  Handle<Field const> interpolated(slice_mesh.geometry_fields().get_child("x_field"));
+  BOOST_CHECK(is_not_null(interpolated));
+  for(Uint i = 0; i != slice_mesh.geometry_fields().size(); ++i)
+  {
+    BOOST_CHECK_SMALL(slice_mesh.geometry_fields().coordinates()[i][XX] - x_mid, 1e-10);
+    BOOST_CHECK_SMALL((*interpolated)[i][0] - x_mid, 1e-10);
+  }
+
+  // Boundary patch
+  Handle<ExtractBoundary> boundary = root.create_component<ExtractBoundary>("boundary");
+  boundary->options().set("mesh", mesh);
+  boundary->options().set("regions", std::vector<URI>(1, mesh->topology().uri()/URI("inlet")));
+  boundary->update();
+
+  Handle<Region const> inlet(mesh->topology().get_child("inlet"));
+  BOOST_CHECK_EQUAL(boundary->extracted()->topology().recursive_elements_count(true), inlet->recursive_elements_count(true));
+
+  // Iso-line of the x field, away from the slice
+  const Real x_quarter = x_min + 0.25*(x_max - x_min);
+  Handle<ExtractIsoSurface> iso = root.create_component<ExtractIsoSurface>("iso");
+  iso->options().set("mesh", mesh);
+  iso->options().set("field", x_field.uri());
+  iso->options().set("value", x_quarter);
+  iso->update();
+
+  const Mesh& iso_mesh = *iso->extracted();
+  BOOST_CHECK(iso_mesh.topology().recursive_elements_count(true) > 0);
+  Handle<Field const> iso_x(iso_mesh.geometry_fields().get_child("x_field"));
+  BOOST_REQUIRE(is_not_null(iso_x));
+  for(Uint i = 0; i != iso_mesh.geometry_fields().size(); ++i)
+  {
+    BOOST_CHECK_SMALL(iso_mesh.geometry_fields().coordinates()[i][XX] - x_quarter, 1e-10);
+    BOOST_CHECK_SMALL((*iso_x)[i][0] - x_quarter, 1e-10);
+  }
+
+  // Probe line across the mesh, through the middle in y
+  Real y_min = coords[0][YY], y_max = coords[0][YY];
+  for(Uint i = 0; i != coords.size(); ++i)
+  {
+    y_min = std::min(y_min, coords[i][YY]);
+    y_max = std::max(y_max, coords[i][YY]);
+  }
+  const Real y_mid = 0.5*(y_min + y_max);
+  Handle<ExtractProbeLine> probe = root.create_component<ExtractProbeLine>("probe");
+  probe->options().set("mesh", mesh);
+  probe->options().set("iterator", iterator);
+  probe->options().set("saverate", 1u);
+  probe->options().set("file", URI("test_utest-actions_probe_${iter}.tsv"));
+  probe->options().set("fields", std::vector<URI>(1, x_field.uri()));
+  probe->options().set("start", std::vector<Real>(list_of(x_min)(y_mid)));
+  probe->options().set("end", std::vector<Real>(list_of(x_max)(y_mid)));
+  probe->options().set("nb_points", 11u);
+  probe->execute();
+
+  BOOST_CHECK(boost::filesystem::exists("test_utest-actions_probe_0000.tsv"));
+  BOOST_REQUIRE_EQUAL(probe->columns().size(), 4u);
+  BOOST_CHECK_EQUAL(probe->columns()[0], "s");
+  BOOST_CHECK_EQUAL(probe->columns()[3], "x_field");
+  const RealMatrix& samples = probe->samples();
+  BOOST_CHECK(samples.rows() > 0);
+  for(Uint i = 0; i != samples.rows(); ++i)
+  {
+    BOOST_CHECK_SMALL(samples(i, 0) - (samples(i, 1) - x_min), 1e-10);
+    BOOST_CHECK_SMALL(samples(i, 2) - y_mid, 1e-10);
+    // The x field is linear, so the interpolation is exact
+    BOOST_CHECK_SMALL(samples(i, 3) - samples(i, 1), 1e-10);
+  }
+
+  root.remove_component(*mesh);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE ( test_Extracts3D )
+{
+  Component& root = Core::instance().root();
+  Handle<MeshGenerator> generator = root.create_component<MeshGenerator>("extract_generator", "cf3.mesh.SimpleMeshGenerator");
+  generator->options().set("mesh", root.uri()/"extract_mesh_3d");
+  generator->options().set("lengths", std::vector<Real>(3, 1.));
+  generator->options().set("nb_cells", std::vector<Uint>(3, 4));
+  Mesh& mesh = generator->generate();
+
+  Field& z_field = mesh.geometry_fields().create_field("z_field");
+  const Field& coords = mesh.geometry_fields().coordinates();
+  for(Uint i = 0; i != coords.size(); ++i)
+    z_field[i][0] = coords[i][ZZ];
+
+  // Horizontal cut that doesn't coincide with the nodes, so every column of hexahedra is cut
+  Handle<ExtractSlice> slice = root.create_component<ExtractSlice>("slice_3d");
+  slice->options().set("mesh", mesh.handle<Mesh>());
+  slice->options().set("origin", std::vector<Real>(list_of(0.)(0.)(0.3)));
+  slice->options().set("normal", std::vector<Real>(list_of(0.)(0.)(1.)));
+  slice->update();
+
+  const Mesh& slice_mesh = *slice->extracted();
+  BOOST_CHECK(slice_mesh.topology().recursive_elements_count(true) >= 16u);
+  Handle<Field const> interpolated(slice_mesh.geometry_fields().get_child("z_field"));
+  BOOST_REQUIRE(is_not_null(interpolated));
+  for(Uint i = 0; i != slice_mesh.geometry_fields().size(); ++i)
+  {
+    BOOST_CHECK_SMALL(slice_mesh.geometry_fields().coordinates()[i][ZZ] - 0.3, 1e-10);
+    BOOST_CHECK_SMALL((*interpolated)[i][0] - 0.3, 1e-10);
+  }
+
+  // Probe line along the diagonal of the cube
+  Handle<ExtractProbeLine> probe = root.create_component<ExtractProbeLine>("probe_3d");
+  probe->options().set("mesh", mesh.handle<Mesh>());
+  probe->options().set("fields", std::vector<URI>(1, z_field.uri()));
+  probe->options().set("start", std::vector<Real>(3, 0.));
+  probe->options().set("end", std::vector<Real>(3, 1.));
+  probe->options().set("nb_points", 5u);
+  probe->update();
+
+  const RealMatrix& samples = probe->samples();
+  BOOST_REQUIRE_EQUAL(samples.rows(), 5);
+  BOOST_REQUIRE_EQUAL(samples.cols(), 5);
+  for(Uint i = 0; i != samples.rows(); ++i)
+  {
+    BOOST_CHECK_SMALL(samples(i, 0) - 0.25*i*std::sqrt(3.), 1e-10);
+    BOOST_CHECK_SMALL(samples(i, 4) - 0.25*i, 1e-10);
+  }
+
+  root.remove_component(mesh);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
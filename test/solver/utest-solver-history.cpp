@@ -0,0 +1,169 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::solver::History"
+
+#include <fstream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/cstdint.hpp>
+
+#include "common/Core.hpp"
+#include "common/OptionList.hpp"
+#include "common/Table.hpp"
+
+#include "solver/History.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::solver;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Reads the parts of a binary history file
+struct BinaryHistoryFile
+{
+  BinaryHistoryFile(const std::string& filename) : file(filename.c_str(), std::ios_base::in | std::ios_base::binary) {}
+
+  std::string tag()
+  {
+    char result[4];
+    file.read(result, 4);
+    return std::string(result, 4);
+  }
+
+  Uint count()
+  {
+    boost::uint32_t result;
+    file.read(reinterpret_cast<char*>(&result), sizeof(result));
+    return result;
+  }
+
+  std::string name()
+  {
+    std::string result(count(), ' ');
+    file.read(&result[0], result.size());
+    return result;
+  }
+
+  Real value()
+  {
+    Real result;
+    file.read(reinterpret_cast<char*>(&result), sizeof(result));
+    return result;
+  }
+
+  std::ifstream file;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( HistorySuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( BinaryLog )
+{
+  {
+    History& history = *Core::instance().root().create_component<History>("history");
+    history.options().set("dimension", 2u);
+    history.options().set("binary", true);
+    history.options().set("buffer_rows", 2u);
+    history.options().set("file", URI("history.cfh"));
+
+    history.set("iter", 1.);
+    history.save_entry();
+    history.set("iter", 2.);
+    history.save_entry();
+    history.set("iter", 3.);
+    history.set("residual", 0.5);
+    history.save_entry();
+
+    // All entries are still in the table
+    BOOST_CHECK_EQUAL(history.table()->size(), 3u);
+    BOOST_CHECK_EQUAL(history.table()->row_size(), 2u);
+
+    Core::instance().root().remove_component("history");
+  }
+
+  BinaryHistoryFile file("history.cfh");
+  char magic[8];
+  file.file.read(magic, 8);
+  BOOST_CHECK_EQUAL(std::string(magic, 8), "CF3HIST1");
+  BOOST_CHECK_EQUAL(file.count(), 1u);
+
+  // The file starts with the first entry
+  BOOST_CHECK_EQUAL(file.tag(), "SCHM");
+  BOOST_CHECK_EQUAL(file.count(), 1u);
+  BOOST_CHECK_EQUAL(file.name(), "iter");
+  BOOST_CHECK_EQUAL(file.tag(), "DATA");
+  BOOST_CHECK_EQUAL(file.count(), 1u);
+  BOOST_CHECK_EQUAL(file.value(), 1.);
+
+  // The buffered entry is written before the new variable
+  BOOST_CHECK_EQUAL(file.tag(), "DATA");
+  BOOST_CHECK_EQUAL(file.count(), 1u);
+  BOOST_CHECK_EQUAL(file.value(), 2.);
+
+  BOOST_CHECK_EQUAL(file.tag(), "SCHM");
+  BOOST_CHECK_EQUAL(file.count(), 2u);
+  BOOST_CHECK_EQUAL(file.name(), "iter");
+  BOOST_CHECK_EQUAL(file.name(), "residual");
+
+  // Written when the history is destroyed
+  BOOST_CHECK_EQUAL(file.tag(), "DATA");
+  BOOST_CHECK_EQUAL(file.count(), 1u);
+  BOOST_CHECK_EQUAL(file.value(), 3.);
+  BOOST_CHECK_EQUAL(file.value(), 0.5);
+
+  file.file.peek();
+  BOOST_CHECK(file.file.eof());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Restore )
+{
+  History& history = *Core::instance().root().create_component<History>("restored_history");
+  history.options().set("logging", false);
+
+  std::vector<std::string> variables;
+  variables.push_back("iter");
+  variables.push_back("residual");
+  std::vector<Real> data;
+  data.push_back(1.); data.push_back(0.5);
+  data.push_back(2.); data.push_back(0.25);
+
+  // The data must have whole rows
+  std::vector<Real> partial_row(data.begin(), data.begin() + 3);
+  BOOST_CHECK_THROW(history.restore(2u, variables, partial_row), BadValue);
+
+  history.restore(2u, variables, data);
+  BOOST_CHECK_EQUAL(history.options().value<Uint>("dimension"), 2u);
+  BOOST_CHECK(history.variable_names() == variables);
+  BOOST_CHECK_EQUAL(history.table()->size(), 2u);
+  BOOST_CHECK_EQUAL((*history.table())[1][1], 0.25);
+
+  // The current entry starts from the last row, and new rows come after the restored ones
+  history.set("iter", 3.);
+  history.save_entry();
+  const Table<Real>& table = *history.table();
+  BOOST_REQUIRE_EQUAL(table.size(), 3u);
+  BOOST_CHECK_EQUAL(table[2][0], 3.);
+  BOOST_CHECK_EQUAL(table[2][1], 0.25);
+
+  // Only an empty history can be restored
+  BOOST_CHECK_THROW(history.restore(2u, variables, data), SetupError);
+
+  Core::instance().root().remove_component("restored_history");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////